@@ -46,8 +46,10 @@ ArchiveCA_Plugin::ArchiveCA_Plugin()
 
     qDebug() << "ArchiveCA_Plugin: Create (epics channel archiver retrieval)";
     archiverCommon = new ArchiverCommon();
+    scheduler = new ArchiverScheduler(this);
 
     connect(archiverCommon, SIGNAL(Signal_UpdateInterface(QMap<QString, indexes>)), this,SLOT(Callback_UpdateInterface(QMap<QString, indexes>)));
+    connect(archiverCommon, SIGNAL(Signal_AbortOutstandingRequests(QString)), this,SLOT(Callback_AbortOutstandingRequests(QString)));
     connect(this, SIGNAL(Signal_StopUpdateInterface()), archiverCommon,SLOT(stopUpdateInterface()));
     connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(closeEvent()));
 }
@@ -81,22 +83,13 @@ void ArchiveCA_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
     QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
 
     while (i != listOfIndexes.constEnd()) {
-        QThread *tmpThread = (QThread *) Q_NULLPTR;
         indexes indexNew = i.value();
         //qDebug() << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w << endl;
 
         nbVal = 0;
 
-        QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-        while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-            tmpThread = (QThread *) j.value();
-            ++j;
-        }
-
-        //qDebug() << "tmpThread" << tmpThread;
-
-        if((tmpThread != (QThread *) Q_NULLPTR) && tmpThread->isRunning()) {
-            //qDebug() << "workerthread is running" << tmpThread->isRunning();
+        if(scheduler->isScheduled(i.key())) {
+            //qDebug() << "request still queued or running";
         } else {
 
             // Get Index name if specified for this widget
@@ -111,20 +104,15 @@ void ArchiveCA_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
                 }
             }
 
-            WorkerCA *worker = new WorkerCA;
-            QThread *tmpThread = new QThread;
-            listOfThreads.insert(i.key(), tmpThread);
-            worker->moveToThread(tmpThread);
-            connect(tmpThread, SIGNAL(finished()), worker, SLOT(workerFinish()));
-            connect(tmpThread, SIGNAL(finished()), tmpThread, SLOT(deleteLater()) );
-            connect(this, SIGNAL(operate( QWidget *, indexes, const stdString)), worker,
-                    SLOT(getFromArchive(QWidget *, indexes, stdString)));
-            connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
-                    SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
-            tmpThread->start();
-
-            //qDebug() << "CA emit operate";
-            emit operate((QWidget *) messagewindowP ,indexNew, index_name);
+            // plots showing the same channel share one retrieval
+            if(archiverCommon->requestSeries(QString(index_name.c_str()), indexNew)) {
+                WorkerCA *worker = new WorkerCA;
+                worker->setRequest((QWidget *) messagewindowP ,indexNew, index_name);
+                connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
+                        SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
+
+                scheduler->schedule(i.key(), ArchiverScheduler::priority(indexNew.w, indexNew.secondsPast), worker);
+            }
         }
         ++i;
     }
@@ -134,29 +122,19 @@ void ArchiveCA_Plugin::handleResults(indexes indexNew, int nbVal, QVector<double
 {
     //qDebug() << "in CA handle results" << nbVal << TimerN.count();
 
+    // the result is also passed to the plots waiting for the same series, even when empty to end their wait
     if(nbVal > 0) {
         TimerN.resize(nbVal);
         YValsN.resize(nbVal);
-        archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
-        TimerN.resize(0);
-        YValsN.resize(0);
-    }
-
-    QList<QString> removeKeys;
-    removeKeys.clear();
-
-    QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-    while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-        QThread *tmpThread = (QThread*) j.value();
-        tmpThread->quit();
-        removeKeys.append(indexNew.key);
-        //qDebug() << tmpThread << "ca quit";
-        ++j;
     }
+    archiverCommon->finishSeries(indexNew, nbVal, TimerN, YValsN, backend);
+    TimerN.resize(0);
+    YValsN.resize(0);
+}
 
-    for(int i=0; i< removeKeys.count(); i++) {
-        listOfThreads.remove(removeKeys.at(i));
-    }
+void ArchiveCA_Plugin::Callback_AbortOutstandingRequests(QString key)
+{
+    scheduler->cancel(key);
 }
 
 // define data to be called
@@ -36,6 +36,8 @@
 #include "controlsinterface.h"
 #include "archiveCA_plugin.h"
 #include "archiverCommon.h"
+#include "archiverDecimation.h"
+#include "archiverScheduler.h"
 
 // Base
 #include <epicsVersion.h>
@@ -55,7 +57,7 @@
 static int precision;
 static RawValue::NumberFormat format = RawValue::DEFAULT;
 
-class Q_DECL_EXPORT WorkerCA : public QObject
+class Q_DECL_EXPORT WorkerCA : public ArchiverJob
 {
     Q_OBJECT
 
@@ -66,8 +68,23 @@ public:
         qRegisterMetaType<QVector<double> >("QVector<double>");
     }
 
+    // parameters of the request, executed when the scheduler runs this job
+    void setRequest(QWidget *w, indexes indexNew, stdString index_name) {
+        requestW = w;
+        requestIndex = indexNew;
+        requestIndexName = index_name;
+    }
+
+protected:
+    void run() {
+        getFromArchive(requestW, requestIndex, requestIndexName);
+    }
+
 private:
     QVector<double>  TimerN, YValsN;
+    QWidget *requestW;
+    indexes requestIndex;
+    stdString requestIndexName;
 
     void format_time(const epicsTime &time, stdString &text,  time_t &timeStamp)
     {
@@ -81,11 +98,6 @@ private:
 
 public slots:
 
-    void workerFinish() {
-        //qDebug() << "worker finish";
-        deleteLater();
-    }
-
     void getFromArchive(QWidget *w, indexes indexNew,  stdString index_name) {
 
         time_t timeStamp;
@@ -94,16 +106,22 @@ public slots:
         char  startTime[200], endTime[200];
 
         format = RawValue::DECIMAL;
-        time_t endSeconds, startSeconds;
+        time_t endSeconds, startSeconds, nowSeconds;
         MessageWindow *messagewindowP = (MessageWindow *) w;
 
         QMutex *mutex = indexNew.mutexP;
         mutex->lock();
 
         ftime(&now);
-        endSeconds = (time_t) ((double) now.time + (double) now.millitm / (double)1000);
+        nowSeconds = endSeconds = (time_t) ((double) now.time + (double) now.millitm / (double)1000);
         startSeconds = (time_t) (endSeconds - indexNew.secondsPast);
 
+        // when zoomed, only the visible range is read
+        if(indexNew.zoomed) {
+            startSeconds = (time_t) indexNew.zoomStartSeconds;
+            endSeconds = qMin((time_t) indexNew.zoomEndSeconds + 1, nowSeconds);
+        }
+
         timess_end = localtime(&endSeconds);
         sprintf(endTime,   "%02d/%02d/%04d %02d:%02d:%02d ", timess_end->tm_mon+1, timess_end->tm_mday, timess_end->tm_year+1900,
                 timess_end->tm_hour, timess_end->tm_min, timess_end->tm_sec);
@@ -160,8 +178,12 @@ public slots:
                 } else {
                     RawValue::getValueString( val, sheet.getType(0), sheet.getCount(0), value, &sheet.getInfo(0), format, precision);
                     QString value(val.c_str());
-                    if((timeStamp - endSeconds) >= -indexNew.secondsPast) {
-                        TimerN[nbVal] = (timeStamp - endSeconds) / 3600.0;
+                    if(timeStamp >= startSeconds) {
+                        if(nbVal >= TimerN.size()) {
+                            TimerN.resize(2 * nbVal + 1);
+                            YValsN.resize(2 * nbVal + 1);
+                        }
+                        TimerN[nbVal] = (timeStamp - nowSeconds) / 3600.0;
                         YValsN[nbVal] = value.toDouble();
                         nbVal++;
                     }
@@ -171,6 +193,10 @@ public slots:
             }
             ok = sheet.next();
         }
+
+        // this archive only delivers raw data, so reduce it to what the plot can display
+        nbVal = ArchiverDecimation::decimateM4(TimerN.data(), YValsN.data(), nbVal,
+                                               (startSeconds - nowSeconds) / 3600.0, (endSeconds - nowSeconds) / 3600.0, indexNew.plotWidth);
         emit resultReady(indexNew, nbVal, TimerN, YValsN, "");
 
         mutex->unlock();
@@ -216,13 +242,13 @@ protected:
 private slots:
     void updateValues();
     void Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes);
+    void Callback_AbortOutstandingRequests(QString key);
 
 public slots:
     void handleResults(indexes, int, QVector<double>, QVector<double>, QString backend);
     void closeEvent();
 
 signals:
-    void operate(QWidget*, const indexes, const stdString);
     void Signal_StopUpdateInterface();
 
 private:
@@ -230,7 +256,7 @@ private:
     MutexKnobData *mutexknobdataP;
     MessageWindow *messagewindowP;
     ArchiverCommon *archiverCommon;
-    QMap<QString, QThread*> listOfThreads;
+    ArchiverScheduler *scheduler;
 };
 
 #endif
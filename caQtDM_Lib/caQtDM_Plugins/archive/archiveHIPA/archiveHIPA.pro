@@ -21,9 +21,9 @@ INCLUDEPATH    += ../../
 INCLUDEPATH    += ../../../src
 INCLUDEPATH    += ../../../../caQtDM_QtControls/src/
 INCLUDEPATH    += $(QWTINCLUDE)
-HEADERS         = ../../controlsinterface.h archiveHIPA_plugin.h ../archiverCommon.h \
+HEADERS         = ../../controlsinterface.h archiveHIPA_plugin.h ../archiverCommon.h ../archiverDecimation.h ../archiverScheduler.h \
     hipaRetrieval.h
-SOURCES         = archiveHIPA_plugin.cpp ../archiverCommon.cpp \
+SOURCES         = archiveHIPA_plugin.cpp ../archiverCommon.cpp ../archiverDecimation.cpp ../archiverScheduler.cpp \
     hipaRetrieval.c
 TARGET          = archiveHIPA_plugin
 
@@ -36,9 +36,11 @@
 #include "controlsinterface.h"
 #include "archiveHIPA_plugin.h"
 #include "archiverCommon.h"
+#include "archiverDecimation.h"
+#include "archiverScheduler.h"
 #include "hipaRetrieval.h"
 
-class Q_DECL_EXPORT WorkerHIPA : public QObject
+class Q_DECL_EXPORT WorkerHIPA : public ArchiverJob
 {
     Q_OBJECT
 
@@ -48,16 +50,24 @@ public:
         qRegisterMetaType<QVector<double> >("QVector<double>");
     }
 
+    // parameters of the request, executed when the scheduler runs this job
+    void setRequest(QWidget *w, indexes indexNew) {
+        requestW = w;
+        requestIndex = indexNew;
+    }
+
+protected:
+    void run() {
+        getFromArchive(requestW, requestIndex);
+    }
+
 private:
     QVector<double>  TimerN, YValsN;
+    QWidget *requestW;
+    indexes requestIndex;
 
 public slots:
 
-    void workerFinish() {
-        //qDebug() << "worker finish";
-        deleteLater();
-    }
-
     void getFromArchive(QWidget *w, indexes indexNew) {
 
         Q_UNUSED(w);
@@ -106,6 +116,20 @@ public slots:
         free(Timer);
         free(YVals);
 
+        // the logging server only delivers raw data for a given time back, so crop to the zoomed range
+        // and reduce the data to what the plot can display
+        double xStart = -startHours;
+        double xEnd = 0.0;
+        if(indexNew.zoomed) {
+            struct timeb now;
+            ftime(&now);
+            double nowSeconds = (double) now.time + (double) now.millitm / (double)1000;
+            xStart = (indexNew.zoomStartSeconds - nowSeconds) / 3600.0;
+            xEnd = (indexNew.zoomEndSeconds - nowSeconds) / 3600.0;
+            nbVal = ArchiverDecimation::cropToRange(TimerN.data(), YValsN.data(), nbVal, xStart, xEnd);
+        }
+        nbVal = ArchiverDecimation::decimateM4(TimerN.data(), YValsN.data(), nbVal, xStart, xEnd, indexNew.plotWidth);
+
         //qDebug() << ">>>> hipa nbval=" << nbVal << TimerN.count() << k;
 
         emit resultReady(indexNew, nbVal, TimerN, YValsN, "");
@@ -154,19 +178,19 @@ public slots:
     void closeEvent();
 
 signals:
-    void operate(QWidget*, const indexes);
     void Signal_StopUpdateInterface();
 
 private slots:
     void updateValues();
     void Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes);
+    void Callback_AbortOutstandingRequests(QString key);
 
 private:
     QMutex mutex;
     MutexKnobData *mutexknobdataP;
     MessageWindow *messagewindowP;
     ArchiverCommon *archiverCommon;
-    QMap<QString, QThread*> listOfThreads;
+    ArchiverScheduler *scheduler;
 };
 
 #endif
@@ -36,17 +36,19 @@ HEADERS         = ../../controlsinterface.h \
     archivehttp_plugin.h \
 	httpretrieval.h \
 	../archiverGeneral.h \
+	../archiverDecimation.h \
+	../archiverScheduler.h \
 	httpperformancedata.h \
     urlhandlerhttp.h \
-    workerHttp.h \
-    workerHttpThread.h
+    workerHttp.h
 SOURCES         =  archivehttp_plugin.cpp \
     httpretrieval.cpp \
 	../archiverGeneral.cpp \
+	../archiverDecimation.cpp \
+	../archiverScheduler.cpp \
     httpperformancedata.cpp \
     urlhandlerhttp.cpp \
-    workerHttp.cpp \
-    workerHttpThread.cpp
+    workerHttp.cpp
 
 TARGET          = archiveHTTP_plugin
 
@@ -44,6 +44,7 @@ ArchiveHTTP_Plugin::ArchiveHTTP_Plugin()
     qRegisterMetaType<QVector<double> >("QVector<double>");
     qRegisterMetaType<QSharedPointer<HttpPerformanceData> >("QSharedPointer<HttpPerformanceData>");
     m_archiverGeneral = new ArchiverGeneral();
+    m_scheduler = new ArchiverScheduler(this);
 
     // This signal is used to update the specified channels, it is triggered regularly for all channels.
     connect(m_archiverGeneral,
@@ -296,6 +297,9 @@ void ArchiveHTTP_Plugin::updateCartesianAppended(int numberOfValues,
         ftime(&now);
         double endSeconds = (double) now.time + (double) now.millitm / (double) 1000;
         double startSeconds = endSeconds - indexNew.secondsPast;
+        if (indexNew.zoomed) {
+            startSeconds = indexNew.zoomStartSeconds;
+        }
 
         // Lock both indexes so the corresponding data isn't updated while we process it.
         m_mutexKnobDataP->DataLock(&kDataX);
@@ -309,18 +313,29 @@ void ArchiveHTTP_Plugin::updateCartesianAppended(int numberOfValues,
         kDataX.edata.monitorCount++;
         qstrncpy(kDataX.edata.fec, qasc(backend), sizeof(caqtdm_string_t));
         int offsetOfFirstNeededValue = -1;
+        int countOfNeededValues = 0;
+        int offsetOfFirstFollowingValue = -1;
+        int countOfFollowingValues = 0;
 
-        // If there is already useful data in the knobData, reuse it
+        // If there is already useful data in the knobData, reuse it.
+        // Stored values in front of and behind the new data are kept, so data requested again (e.g. after a zoom) replaces the stored data
+        // in its range. Values behind the new data exist when a long range is loaded in chunks, as the newest chunk arrives first.
         if (kDataX.edata.valueCount > 0) {
             alreadyStoredValues.resize(kDataX.edata.valueCount);
-            memcpy(alreadyStoredValues.data(), kDataX.edata.dataB, kDataX.edata.dataSize);
+            memcpy(alreadyStoredValues.data(), kDataX.edata.dataB, kDataX.edata.valueCount * sizeof(double));
             QVector<double>::iterator firstNeededX = std::upper_bound(alreadyStoredValues.begin(), alreadyStoredValues.end(), startSeconds * 1000);
+            QVector<double>::iterator lastNeededX = std::lower_bound(firstNeededX, alreadyStoredValues.end(), XValues.first());
+            QVector<double>::iterator firstFollowingX = std::upper_bound(lastNeededX, alreadyStoredValues.end(), XValues.last());
             offsetOfFirstNeededValue = std::distance(alreadyStoredValues.begin(), firstNeededX);
-            QVector<double> stillUsedValues(firstNeededX, alreadyStoredValues.end());
+            countOfNeededValues = std::distance(firstNeededX, lastNeededX);
+            offsetOfFirstFollowingValue = std::distance(alreadyStoredValues.begin(), firstFollowingX);
+            countOfFollowingValues = std::distance(firstFollowingX, alreadyStoredValues.end());
+            QVector<double> stillUsedValues(firstNeededX, lastNeededX);
             // Update the number of values according to the amount of reused values
-            numberOfValues += stillUsedValues.count();
-            // Add the new data to the reused data
+            numberOfValues += countOfNeededValues + countOfFollowingValues;
+            // Add the new data and the following stored data to the reused data
             stillUsedValues.append(XValues);
+            stillUsedValues += QVector<double>(firstFollowingX, alreadyStoredValues.end());
             XValues = std::move(stillUsedValues);
         }
 
@@ -347,14 +362,16 @@ void ArchiveHTTP_Plugin::updateCartesianAppended(int numberOfValues,
         qstrncpy(kDataY.edata.fec, qasc(backend), sizeof(caqtdm_string_t));
 
         // Here, we have to modify the reusing part slightly
-        if (kDataY.edata.valueCount > 0 && offsetOfFirstNeededValue != -1) {
+        if (kDataY.edata.valueCount >= offsetOfFirstFollowingValue + countOfFollowingValues && offsetOfFirstNeededValue != -1) {
             alreadyStoredValues.resize(kDataY.edata.valueCount);
-            memcpy(alreadyStoredValues.data(), kDataY.edata.dataB, kDataY.edata.dataSize);
+            memcpy(alreadyStoredValues.data(), kDataY.edata.dataB, kDataY.edata.valueCount * sizeof(double));
 
-            // Because this data does not contain a timestamp we can use, we just use the same offset as used in the X axis to ensure we get the corresponding elements.
+            // Because this data does not contain a timestamp we can use, we just use the same offsets as used in the X axis to ensure we get the corresponding elements.
             QVector<double>::iterator firstNeededY = alreadyStoredValues.begin() + offsetOfFirstNeededValue;
-            QVector<double> stillUsedValues(firstNeededY, alreadyStoredValues.end());
+            QVector<double>::iterator firstFollowingY = alreadyStoredValues.begin() + offsetOfFirstFollowingValue;
+            QVector<double> stillUsedValues(firstNeededY, firstNeededY + countOfNeededValues);
             stillUsedValues.append(YValues);
+            stillUsedValues += QVector<double>(firstFollowingY, firstFollowingY + countOfFollowingValues);
             YValues = std::move(stillUsedValues);
             // We don't have to calculate the number of values again as they are equal amongst both axes.
         }
@@ -381,12 +398,17 @@ void ArchiveHTTP_Plugin::handleResults(
     indexes indexNew, int valueCount, QVector<double> XVals, QVector<double> YVals, QVector<double> YMinVals, QVector<double> YMaxVals, QString backend, bool isFinalIteration)
 {
     QMutexLocker mutexLocker(&m_globalMutex);
-    QMap<QString, WorkerHttpThread*>::const_iterator listOfThreadsEntry = m_listOfThreads.constFind(indexNew.key);
-    if (listOfThreadsEntry == m_listOfThreads.constEnd()) {
+    // The worker is only deleted by the scheduler after this result was processed, so it is still valid here.
+    WorkerHTTP *worker = qobject_cast<WorkerHTTP *>(sender());
+    if (worker == Q_NULLPTR) {
         // This should never happen
         return;
     }
-    const bool isActive =  listOfThreadsEntry.value()->isActive();
+    // A cancelled worker belongs to a range that is not displayed anymore, its channel was already released
+    // in Callback_AbortOutstandingRequests and might be requested again by a new worker.
+    if (!worker->isActive()) {
+        return;
+    }
 
     XVals.resize(valueCount);
     YVals.resize(valueCount);
@@ -408,15 +430,13 @@ void ArchiveHTTP_Plugin::handleResults(
             keyStored.replace(".minY", "");
             keyStored.replace(".maxY", "");
             if (keyStored == indexInCheck.key) {
-                if (isActive) {
-                    // If we have binned data and the channel contains min/max then use the according values.
-                    if (tempI.key().contains(".minY") && indexNew.nrOfBins > 0) {
-                        updateCartesianAppended(valueCount, tempI.value(), XVals, YMinVals, backend);
-                    } else if (tempI.key().contains(".maxY") && indexNew.nrOfBins > 0) {
-                        updateCartesianAppended(valueCount, tempI.value(), XVals, YMaxVals, backend);
-                    } else {
-                        updateCartesianAppended(valueCount, tempI.value(), XVals, YVals, backend);
-                    }
+                // If we have binned data and the channel contains min/max then use the according values.
+                if (tempI.key().contains(".minY") && indexNew.nrOfBins > 0) {
+                    updateCartesianAppended(valueCount, tempI.value(), XVals, YMinVals, backend);
+                } else if (tempI.key().contains(".maxY") && indexNew.nrOfBins > 0) {
+                    updateCartesianAppended(valueCount, tempI.value(), XVals, YMaxVals, backend);
+                } else {
+                    updateCartesianAppended(valueCount, tempI.value(), XVals, YVals, backend);
                 }
             }
         }
@@ -424,13 +444,6 @@ void ArchiveHTTP_Plugin::handleResults(
     XVals.resize(0);
     YVals.resize(0);
     if (isFinalIteration) {
-        WorkerHttpThread *finishedThread = (WorkerHttpThread *) listOfThreadsEntry.value();
-        if (finishedThread != Q_NULLPTR) {
-            finishedThread->quit();
-            finishedThread->wait();
-        }
-        m_listOfThreads.remove(indexNew.key);
-
         QList<QString> removeKeys;
         m_regexStr.setPattern(CURVE_IDENTIFIER);
         for (QMap<QString, indexes>::const_iterator indexesToUpdateIterator = m_IndexesToUpdate.constBegin();
@@ -442,10 +455,9 @@ void ArchiveHTTP_Plugin::handleResults(
             keyStored.replace(".minY", "");
             keyStored.replace(".maxY", "");
             if (keyStored == indexInCheck.key) {
-                if (!isActive) {
-                    m_archiverGeneral->updateSecondsPast(indexesToUpdateIterator.value(), valueCount != 0);
-                }
-                removeKeys.append(indexesToUpdateIterator.key());;
+                // failed or empty requests back off to SECONDSTIMEOUT, a successful one resumes the original timing
+                m_archiverGeneral->updateSecondsPast(indexesToUpdateIterator.value(), worker->receivedValueCount() != 0);
+                removeKeys.append(indexesToUpdateIterator.key());
             }
         }
 
@@ -516,14 +528,19 @@ void ArchiveHTTP_Plugin::Callback_UpdateInterface(QMap<QString, indexes> listOfI
             QVariant var = w->property("nrOfBins");
             if (!var.isNull()) {
                 bool ok;
-                indexNew.nrOfBins = var.toInt(&ok);
-                if (!ok) {
-                    indexNew.nrOfBins = -1;
+                // "auto" requests one bin per pixel column of the plot canvas
+                if (var.toString().trimmed().compare("auto", Qt::CaseInsensitive) == 0) {
+                    indexNew.nrOfBins = indexNew.plotWidth;
+                } else {
+                    indexNew.nrOfBins = var.toInt(&ok);
+                    if (!ok) {
+                        indexNew.nrOfBins = -1;
+                    }
                 }
             } else if (indexNew.init) {
                 QString mess(
                     "ArchiveHTTP plugin -- no nrOfBins defined as dynamic property in widget "
-                    + w->objectName() + ", defaulting to maximum number of points");
+                    + w->objectName() + ", defaulting to raw data reduced to the plot width");
                 if (m_messageWindowP != (MessageWindow *) Q_NULLPTR) {
                     m_messageWindowP->postMsgEvent(QtWarningMsg, (char *) qasc(mess));
                 }
@@ -635,25 +652,13 @@ void ArchiveHTTP_Plugin::Callback_UpdateInterface(QMap<QString, indexes> listOfI
             }
         }
         WorkerHTTP *newWorker = new WorkerHTTP;
-        WorkerHttpThread *newWorkerThread = new WorkerHttpThread(newWorker);
-        m_listOfThreads.insert(i.key(), newWorkerThread);
-
-        newWorker->moveToThread(newWorkerThread);
-
-        connect(newWorkerThread, SIGNAL(finished()), newWorker, SLOT(workerFinish()));
-        connect(newWorkerThread, SIGNAL(finished()), newWorkerThread, SLOT(deleteLater()));
-        connect(this,
-                SIGNAL(operate(indexes, QString, MessageWindow *, MutexKnobData *, QSharedPointer<HttpPerformanceData>)),
-                newWorker,
-                SLOT(getFromArchive(indexes, QString, MessageWindow *, MutexKnobData *, QSharedPointer<HttpPerformanceData>)));
+        newWorker->setRequest(indexNew, index_name, m_messageWindowP, m_mutexKnobDataP, m_retrievalPerformancePerPV.value(i.key()));
         connect(newWorker,
                 SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QVector<double>, QVector<double>, QString, bool)),
                 this,
                 SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QVector<double>, QVector<double>, QString, bool)));
-        newWorkerThread->start();
 
-        emit operate(indexNew, index_name, m_messageWindowP, m_mutexKnobDataP, m_retrievalPerformancePerPV.value(i.key()));
-        disconnect(newWorker);
+        m_scheduler->schedule(i.key(), ArchiverScheduler::priority(indexNew.w, indexNew.secondsPast), newWorker);
         ++i;
     }
 }
@@ -663,14 +668,30 @@ void ArchiveHTTP_Plugin::Callback_AbortOutstandingRequests(QString key)
     QMutexLocker mutexLocker(&m_globalMutex);
     m_IsSuspended = true;
 
-    QMap<QString, WorkerHttpThread*>::iterator listOfThreadsEntry = m_listOfThreads.find(key);
-    if (listOfThreadsEntry != m_listOfThreads.end()) {
-        listOfThreadsEntry.value()->setIsActive(false);
-        HttpRetrieval *retrieval = listOfThreadsEntry.value()->getHttpRetrieval();
-        if (retrieval != Q_NULLPTR) {
-            retrieval->cancelDownload();
+    // Drops the request if it is still queued, otherwise the worker is marked inactive and its download is aborted.
+    m_scheduler->cancel(key);
+
+    // The results of a cancelled worker are ignored, so forget the channel here to request it again on the next update.
+    QString keyInCheck = key;
+    m_regexStr.setPattern(CURVE_IDENTIFIER);
+    keyInCheck.replace(m_regexStr, "");
+    keyInCheck.replace(".minY", "");
+    keyInCheck.replace(".maxY", "");
+    QList<QString> removeKeys;
+    for (QMap<QString, indexes>::const_iterator tempI = m_IndexesToUpdate.constBegin();
+         tempI != m_IndexesToUpdate.constEnd();
+         tempI++) {
+        QString keyStored = tempI.key();
+        keyStored.replace(m_regexStr, "");
+        keyStored.replace(".minY", "");
+        keyStored.replace(".maxY", "");
+        if (keyStored == keyInCheck) {
+            removeKeys.append(tempI.key());
         }
     }
+    for (int i = 0; i < removeKeys.count(); i++) {
+        m_IndexesToUpdate.remove(removeKeys.at(i));
+    }
 
     m_IsSuspended = false;
 }
@@ -33,8 +33,9 @@
 #include <QThread>
 #include <QTimer>
 #include "archiverGeneral.h"
+#include "archiverScheduler.h"
 #include "controlsinterface.h"
-#include "workerHttpThread.h"
+#include "workerHttp.h"
 
 class Q_DECL_EXPORT ArchiveHTTP_Plugin : public QObject, ControlsInterface
 {
@@ -141,18 +142,18 @@ public:
     // From hereon downwards everything is new, so not available through ControlsInterface (without cast)
 public slots:
     /*
-     * Processes received data, updates the cartesianPlot and destroys the worker & workerThread, if isFinalIteration is true.
+     * Processes received data, updates the cartesianPlot and forgets about the request, if isFinalIteration is true.
      * */
     void handleResults(indexes indexNew, int valueCount, QVector<double> XVals, QVector<double> YVals, QVector<double> YMinVals, QVector<double> YMaxVals, QString backend, bool isFinalIteration);
 
 signals:
-    void operate(const indexes, const QString, MessageWindow *, MutexKnobData *, QSharedPointer<HttpPerformanceData>);
     void Signal_StopUpdateInterface();
 
 private slots:
     /*
      * This routine is called everytime new knobData entries are to be updated.
-     * For each entry, it makes sure no redundant data is requested, and creates a new worker & workerThread to retrieve the data.
+     * For each entry, it makes sure no redundant data is requested, and schedules a new worker to retrieve the data.
+     * Workers run on the bounded thread pool of the ArchiverScheduler, visible plots are served first.
      * */
     void Callback_UpdateInterface(QMap<QString, indexes> listOfIndexes);
 
@@ -181,7 +182,7 @@ private:
     MutexKnobData *m_mutexKnobDataP;
     MessageWindow *m_messageWindowP;
     ArchiverGeneral *m_archiverGeneral;
-    QMap<QString, WorkerHttpThread*> m_listOfThreads;
+    ArchiverScheduler *m_scheduler;
     QMap<QString, indexes> m_IndexesToUpdate;
     QRegularExpression m_regexStr;
     bool m_IsSuspended;
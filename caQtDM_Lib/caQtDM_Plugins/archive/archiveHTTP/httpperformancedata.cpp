@@ -31,6 +31,8 @@ HttpPerformanceData::HttpPerformanceData()
     m_receivedContinueAt = false;
     m_inProgress = false;
     m_finishedSuccessfully = false;
+    m_numberOfRequests = 0;
+    m_isChunked = false;
 }
 
 
@@ -61,6 +63,16 @@ QString HttpPerformanceData::generateReport() {
     if (m_isBinned) {
         report += "Number of bins:                            " + QString::number(m_isBinned) + "<br>";
     }
+    if (!m_chunks.isEmpty()) {
+        report += "Loaded in chunks, newest first:     " + QString::number(m_chunks.count()) + "<br>";
+        for (int i = 0; i < m_chunks.count(); i++) {
+            const chunkData &chunk = m_chunks.at(i);
+            report += "  " + chunk.beginTime.toLocalTime().toString("HH:mm:ss yyyy-MM-dd") + " - "
+                      + chunk.endTime.toLocalTime().toString("HH:mm:ss yyyy-MM-dd") + ": "
+                      + QString::number(chunk.durationInMs) + "ms, displayed after " + QString::number(chunk.elapsedInMs) + "ms, "
+                      + QString::number(chunk.numberOfPoints) + " points<br>";
+        }
+    }
 
     return report;
 }
@@ -70,6 +82,7 @@ void HttpPerformanceData::addNewRequest(UrlHandlerHttp *urlHandler)
     QMutexLocker locker(&m_globalMutex);
     m_requestTimer.start();
     if (!m_inProgress) {
+        m_chunks.clear();
         m_beginTime = urlHandler->beginTime();
         m_endTime = urlHandler->endTime();
         m_isBinned = urlHandler->binned();
@@ -92,11 +105,50 @@ void HttpPerformanceData::addNewResponse(quint64 responseBytes, int httpStatusCo
         m_receivedContinueAt = true;
         m_lastRetrievedTime = continueAtTime;
     } else if (httpStatusCode == 200) {
-        m_finishedSuccessfully = true;
-        m_lastRetrievedTime = m_endTime;
-        m_inProgress = false;
+        // A chunked request is finished by finishChunkedRequest
+        if (!m_isChunked) {
+            m_finishedSuccessfully = true;
+            m_lastRetrievedTime = m_endTime;
+            m_inProgress = false;
+        }
     } else {
         m_finishedSuccessfully = false;
-        m_inProgress = false;
+        if (!m_isChunked) {
+            m_inProgress = false;
+        }
     }
 }
+
+void HttpPerformanceData::beginChunkedRequest(QDateTime beginTime, QDateTime endTime)
+{
+    QMutexLocker locker(&m_globalMutex);
+    m_chunks.clear();
+    m_beginTime = beginTime;
+    m_endTime = endTime;
+    m_receivedContinueAt = false;
+    m_finishedSuccessfully = true;
+    m_isChunked = true;
+    m_inProgress = true;
+}
+
+void HttpPerformanceData::addChunk(QDateTime beginTime, QDateTime endTime, qint64 durationInMs, qint64 elapsedInMs, int numberOfPoints)
+{
+    QMutexLocker locker(&m_globalMutex);
+    chunkData chunk;
+    chunk.beginTime = beginTime;
+    chunk.endTime = endTime;
+    chunk.durationInMs = durationInMs;
+    chunk.elapsedInMs = elapsedInMs;
+    chunk.numberOfPoints = numberOfPoints;
+    m_chunks.append(chunk);
+}
+
+void HttpPerformanceData::finishChunkedRequest()
+{
+    QMutexLocker locker(&m_globalMutex);
+    if (m_finishedSuccessfully) {
+        m_lastRetrievedTime = m_endTime;
+    }
+    m_isChunked = false;
+    m_inProgress = false;
+}
@@ -29,6 +29,7 @@
 
 #include "qdatetime.h"
 #include "qelapsedtimer.h"
+#include "qlist.h"
 #include "qmutex.h"
 #include "urlhandlerhttp.h"
 class HttpPerformanceData
@@ -52,7 +53,31 @@ public:
      * */
     void addNewResponse(quint64 responseBytes, int httpStatusCode, bool receivedContinueAt, QDateTime continueAtTime);
 
+    /*
+     * Starts a request for the range beginTime to endTime which is loaded in chunks.
+     * The request stays in progress until finishChunkedRequest is called.
+     * */
+    void beginChunkedRequest(QDateTime beginTime, QDateTime endTime);
+
+    /*
+     * Adds the timing of a completely received chunk, elapsedInMs is the time since the chunked request began.
+     * */
+    void addChunk(QDateTime beginTime, QDateTime endTime, qint64 durationInMs, qint64 elapsedInMs, int numberOfPoints);
+
+    /*
+     * Finishes a chunked request, also if it was cancelled before all chunks were received.
+     * */
+    void finishChunkedRequest();
+
 private:
+    typedef struct {
+        QDateTime beginTime;
+        QDateTime endTime;
+        qint64 durationInMs;
+        qint64 elapsedInMs;
+        int numberOfPoints;
+    } chunkData;
+
     QMutex m_globalMutex;
     QElapsedTimer m_requestTimer;
     bool m_finishedSuccessfully;
@@ -67,6 +92,8 @@ private:
     long m_responseTimeinMs;
     bool m_isBinned;
     int m_binCount;
+    bool m_isChunked;
+    QList<chunkData> m_chunks;
 };
 
 #endif // HTTPPERFORMANCEDATA_H
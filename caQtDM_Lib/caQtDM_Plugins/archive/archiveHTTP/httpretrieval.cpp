@@ -29,9 +29,12 @@
 #include <QFile>
 #include <QNetworkAccessManager>
 #include <QSslConfiguration>
+#include <QtEndian>
+#include <QThreadStorage>
 #include <QTimer>
 #include <QWaitCondition>
 #include <iostream>
+#include <string.h>
 #include <time.h>
 
 #ifdef MOBILE_ANDROID
@@ -63,13 +66,26 @@
 #include <unistd.h>
 #endif
 
+// One QNetworkAccessManager per worker thread. As the ArchiverScheduler keeps its threads alive, the manager and with it
+// the keep-alive connections it holds for every backend host are reused by all requests executed in that thread.
+static QThreadStorage<QNetworkAccessManager *> threadNetworkManagers;
+
+static QNetworkAccessManager *threadNetworkManager()
+{
+    if (!threadNetworkManagers.hasLocalData()) {
+        threadNetworkManagers.setLocalData(new QNetworkAccessManager());
+    }
+    return threadNetworkManagers.localData();
+}
+
 HttpRetrieval::HttpRetrieval()
 {
     m_retryAfter = 0;
     m_isFinished = false;
     m_totalNumberOfPoints = 0;
     m_isRedirected = false;
-    m_networkManager = new QNetworkAccessManager(this);
+    m_networkManager = threadNetworkManager();
+    m_networkReply = Q_NULLPTR;
     m_eventLoop = new QEventLoop(this);
     m_errorString = "";
     connect(this, SIGNAL(requestFinished()), this, SLOT(downloadFinished()));
@@ -84,7 +100,6 @@ HttpRetrieval::~HttpRetrieval()
     m_vecY.clear();
     m_vecMinY.clear();
     m_vecMaxY.clear();
-    delete m_networkManager;
     delete m_eventLoop;
     delete m_timeoutHelper;
 }
@@ -123,7 +138,17 @@ bool HttpRetrieval::requestUrl(
     request.setRawHeader("Content-Type", "application/json");
     request.setRawHeader("Timeout", "86400");
     request.setRawHeader("Accept-Encoding", "gzip, deflate");
+    // Prefer the compact binary format, backends that do not support it simply answer with json
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (qgetenv("CAQTDM_ARCHIVEHTTP_NOBINARY").isEmpty()) {
+        request.setRawHeader("Accept", HTTP_BINARY_CONTENT_TYPE ", application/json;q=0.9, */*;q=0.8");
+    } else {
+        request.setRawHeader("Accept", "*/*");
+    }
+#else
     request.setRawHeader("Accept", "*/*");
+#endif
+    request.setRawHeader("Connection", "keep-alive");
 
     // We want manual redirects to be able to save the redirected address.
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
@@ -131,8 +156,9 @@ bool HttpRetrieval::requestUrl(
     m_isFinished = false;
 
     if (!m_isAborted) {
-        connect(m_networkManager, SIGNAL(finished(QNetworkReply *)), this, SLOT(finishReply(QNetworkReply *)));
+        // The manager is shared with other requests of this thread, so only listen to our own reply.
         m_networkReply = m_networkManager->get(request);
+        connect(m_networkReply, SIGNAL(finished()), this, SLOT(replyFinished()));
 
         // Unlock the mutex so the cancelDownload function can now run as we have sent the request.
         m_globalMutex.unlock();
@@ -189,13 +215,11 @@ void HttpRetrieval::cancelDownload()
     m_isAborted = true;
 
     if (m_networkReply != Q_NULLPTR) {
+        disconnect(m_networkReply, Q_NULLPTR, this, Q_NULLPTR);
         m_networkReply->abort();
         m_networkReply->deleteLater();
         m_networkReply = Q_NULLPTR;
     }
-    if (m_networkManager != Q_NULLPTR) {
-        disconnect(m_networkManager);
-    }
 
     downloadFinished();
     m_globalMutex.unlock();
@@ -211,6 +235,14 @@ bool HttpRetrieval::isRedirected() const
     return m_isRedirected;
 }
 
+void HttpRetrieval::replyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+    if (reply != Q_NULLPTR) {
+        finishReply(reply);
+    }
+}
+
 void HttpRetrieval::finishReply(QNetworkReply *reply)
 {
     if (m_isAborted) {
@@ -317,41 +349,62 @@ void HttpRetrieval::finishReply(QNetworkReply *reply)
     ftime(&now);
     seconds = (double) now.time + (double) now.millitm / (double) 1000;
 
+    // If we got a valid reponse but a retry-after statement is present, save that
+    QByteArray retryAfterRawValue = reply->rawHeader("Retry-After");
+    bool conversionOk = false;
+    int retryAfterValue = retryAfterRawValue.toInt(&conversionOk);
+    if (conversionOk) {
+        m_retryAfter = retryAfterValue;
+        // If it isn't convertible to an integer, we also cannot wait for that amount...
+    }
+
+    // The backend answered in the binary format, anything else is treated as json
+    if (reply->header(QNetworkRequest::ContentTypeHeader).toString().startsWith(HTTP_BINARY_CONTENT_TYPE)) {
+        count = decodeBinaryResponse(out, seconds, m_secondsPast, m_isBinned, m_isAbsoluteTimeAxis,
+                                     m_vecX, m_vecY, m_vecMinY, m_vecMaxY, m_continueAt, m_errorString);
+    } else {
+        count = decodeJsonResponse(out, seconds, m_secondsPast, m_isBinned, m_isAbsoluteTimeAxis,
+                                   m_vecX, m_vecY, m_vecMinY, m_vecMaxY, m_continueAt, m_errorString);
+    }
+    if (count < 0) {
+        emit requestFinished();
+        return;
+    }
+
+    m_totalNumberOfPoints = count;
+    m_isFinished = true;
+    emit requestFinished();
+}
+
+int HttpRetrieval::decodeJsonResponse(const QByteArray &data, double seconds, int secondsPast, bool binned, bool absoluteTimeAxis,
+                                      QVector<double> &x, QVector<double> &y, QVector<double> &minY, QVector<double> &maxY,
+                                      QDateTime &continueAt, QString &errorString)
+{
     bool conversionOk = true;
     QJsonObject rootObject;
     try {
-        rootObject = QJsonDocument::fromJson(out).object();
+        rootObject = QJsonDocument::fromJson(data).object();
     } catch (...) {
         conversionOk = false;
     }
 
     // Did it go wrong?
     if (rootObject.isEmpty() || !conversionOk) {
-        m_errorString = QString("could not parse json string left=%1 right=%2")
-                          .arg(QString(out).left(20), QString(out).right(20));
-        emit requestFinished();
-        return;
+        errorString = QString("could not parse json string left=%1 right=%2")
+                          .arg(QString(data).left(20), QString(data).right(20));
+        return -1;
     }
 
     // Set continueAt so the worker can figure out whether to send another request or not
     if (rootObject.contains("continueAt")) {
-        m_continueAt = QDateTime::fromString(rootObject.value("continueAt").toString(), Qt::ISODate);
+        continueAt = QDateTime::fromString(rootObject.value("continueAt").toString(), Qt::ISODate);
     }
 
-    // If we got a valid reponse but a retry-after statement is present, save that
-    QByteArray retryAfterRawValue = reply->rawHeader("Retry-After");
-    conversionOk = false;
-    int retryAfterValue = retryAfterRawValue.toInt(&conversionOk);
-    if (conversionOk) {
-        m_retryAfter = retryAfterValue;
-        // If it isn't convertible to an integer, we also cannot wait for that amount...
-    }
-
-    // set count to zero, it will be incremented according to values
-    count = 0;
+    // count is incremented according to values
+    int count = 0;
     int secondsAnchor = rootObject.value("tsAnchor").toInt();
     double archiveTime = 0;
-    if (m_isBinned) {
+    if (binned) {
         QJsonValue minsObject = rootObject["mins"];
         QJsonValue maxsObject = rootObject["maxs"];
         QJsonValue avgsObject = rootObject["avgs"];
@@ -379,15 +432,15 @@ void HttpRetrieval::finishReply(QNetworkReply *reply)
             // fill in our data, yes this step is redundant (same code for binned and non binned), but to do this in a seperate loop would butcher performance
             if (archiveTime) {
                 // fill in our data
-                if ((seconds - archiveTime) < m_secondsPast) {
-                    if (!m_isAbsoluteTimeAxis) {
-                        m_vecX.append(-(seconds - archiveTime) / 3600.0);
+                if ((seconds - archiveTime) < secondsPast) {
+                    if (!absoluteTimeAxis) {
+                        x.append(-(seconds - archiveTime) / 3600.0);
                     } else {
-                        m_vecX.append(archiveTime * 1000);
+                        x.append(archiveTime * 1000);
                     }
-                    m_vecY.append(avg);
-                    m_vecMinY.append(min);
-                    m_vecMaxY.append(max);
+                    y.append(avg);
+                    minY.append(min);
+                    maxY.append(max);
                     count++;
                 }
             }
@@ -411,22 +464,103 @@ void HttpRetrieval::finishReply(QNetworkReply *reply)
             // fill in our data, yes this step is redundant (same code for binned and non binned), but to do this in a seperate loop would butcher performance
             if (archiveTime) {
                 // fill in our data
-                if ((seconds - archiveTime) < m_secondsPast) {
-                    if (!m_isAbsoluteTimeAxis) {
-                        m_vecX.append(-(seconds - archiveTime) / 3600.0);
+                if ((seconds - archiveTime) < secondsPast) {
+                    if (!absoluteTimeAxis) {
+                        x.append(-(seconds - archiveTime) / 3600.0);
                     } else {
-                        m_vecX.append(archiveTime * 1000);
+                        x.append(archiveTime * 1000);
                     }
-                    m_vecY.append(value);
+                    y.append(value);
                     count++;
                 }
             }
         }
     }
 
-    m_totalNumberOfPoints = count;
-    m_isFinished = true;
-    emit requestFinished();
+    return count;
+}
+
+int HttpRetrieval::decodeBinaryResponse(const QByteArray &data, double seconds, int secondsPast, bool binned, bool absoluteTimeAxis,
+                                        QVector<double> &x, QVector<double> &y, QVector<double> &minY, QVector<double> &maxY,
+                                        QDateTime &continueAt, QString &errorString)
+{
+    if (data.size() < HTTP_BINARY_HEADER_SIZE || !data.startsWith(HTTP_BINARY_MAGIC)) {
+        errorString = QString("could not parse binary response of %1 bytes, header is missing").arg(data.size());
+        return -1;
+    }
+
+    const uchar *header = reinterpret_cast<const uchar *>(data.constData());
+    const quint32 version = qFromLittleEndian<quint32>(header + 4);
+    const quint32 flags = qFromLittleEndian<quint32>(header + 8);
+    const quint32 numberOfPoints = qFromLittleEndian<quint32>(header + 12);
+    const qint64 secondsAnchor = qFromLittleEndian<qint64>(header + 16);
+    const qint64 continueAtMs = qFromLittleEndian<qint64>(header + 24);
+    const bool responseBinned = (flags & HTTP_BINARY_FLAG_BINNED) != 0;
+    const int numberOfColumns = responseBinned ? 5 : 2;
+
+    if (version != HTTP_BINARY_VERSION) {
+        errorString = QString("binary response has unsupported version %1").arg(version);
+        return -1;
+    }
+    if (responseBinned != binned) {
+        errorString = QString("binary response contains %1 data, but %2 data was requested")
+                          .arg(responseBinned ? "binned" : "raw", binned ? "binned" : "raw");
+        return -1;
+    }
+    if ((qint64) data.size() != HTTP_BINARY_HEADER_SIZE + (qint64) numberOfColumns * numberOfPoints * (qint64) sizeof(double)) {
+        errorString = QString("binary response of %1 bytes does not match %2 points").arg(data.size()).arg(numberOfPoints);
+        return -1;
+    }
+
+    if (continueAtMs > 0) {
+        continueAt = QDateTime::fromMSecsSinceEpoch(continueAtMs);
+    }
+
+    // The columns are read directly from the response buffer. QByteArray allocates its data suitably aligned for doubles
+    // and the header keeps that alignment; only if that is not the case the columns are copied once.
+    QByteArray aligned;
+    const char *payload = data.constData() + HTTP_BINARY_HEADER_SIZE;
+    if (reinterpret_cast<quintptr>(payload) % sizeof(double) != 0) {
+        aligned = data.mid(HTTP_BINARY_HEADER_SIZE);
+        payload = aligned.constData();
+    }
+    const double *columns = reinterpret_cast<const double *>(payload);
+    const int n = (int) numberOfPoints;
+
+    // raw: tsMs, values    binned: ts1Ms, ts2Ms, mins, maxs, avgs
+    const double *ts1Ms = columns;
+    const double *ts2Ms = binned ? columns + n : columns;
+    const double *values = binned ? columns + 4 * n : columns + n;
+
+    // The timestamps are sorted, so only the leading points can be older than requested
+    int first = 0;
+    while (first < n && (seconds - (secondsAnchor + (ts1Ms[first] + ts2Ms[first]) / 2000.0)) >= secondsPast) {
+        first++;
+    }
+    const int count = n - first;
+
+    const int offset = x.size();
+    x.resize(offset + count);
+    y.resize(offset + count);
+    memcpy(y.data() + offset, values + first, count * sizeof(double));
+    if (binned) {
+        minY.resize(offset + count);
+        maxY.resize(offset + count);
+        memcpy(minY.data() + offset, columns + 2 * n + first, count * sizeof(double));
+        memcpy(maxY.data() + offset, columns + 3 * n + first, count * sizeof(double));
+    }
+
+    double *timeX = x.data() + offset;
+    for (int i = 0; i < count; i++) {
+        const double archiveTime = secondsAnchor + (ts1Ms[first + i] + ts2Ms[first + i]) / 2000.0;
+        if (!absoluteTimeAxis) {
+            timeX[i] = -(seconds - archiveTime) / 3600.0;
+        } else {
+            timeX[i] = archiveTime * 1000;
+        }
+    }
+
+    return count;
 }
 
 const QString HttpRetrieval::parseError(QNetworkReply::NetworkError error)
@@ -41,6 +41,24 @@
 #include <QJsonObject>
 #include <QJsonValue>
 
+/*
+ * Binary transfer format, requested through the Accept header in favour of json. All values are little endian.
+ *   offset  0  char[4]  magic "F64C"
+ *   offset  4  quint32  version, currently 1
+ *   offset  8  quint32  flags, bit 0 is set for binned data
+ *   offset 12  quint32  number of points n
+ *   offset 16  qint64   tsAnchor in seconds since epoch
+ *   offset 24  qint64   continueAt in milliseconds since epoch, 0 if the response is complete
+ *   offset 32  double   columns of n values each, raw: tsMs, values; binned: ts1Ms, ts2Ms, mins, maxs, avgs
+ * The timestamps are relative to tsAnchor and sorted. The header keeps the columns 8 byte aligned.
+ * Can be disabled with the environment variable CAQTDM_ARCHIVEHTTP_NOBINARY.
+ * */
+#define HTTP_BINARY_CONTENT_TYPE "application/x-float64-columnar"
+#define HTTP_BINARY_MAGIC "F64C"
+#define HTTP_BINARY_VERSION 1
+#define HTTP_BINARY_HEADER_SIZE 32
+#define HTTP_BINARY_FLAG_BINNED 0x1
+
 // Used for debugging on Linux
 #define PRINTFLUSH(...) \
     do { \
@@ -124,6 +142,22 @@ public:
      * */
     int retryAfter() const;
 
+    /*
+     * Decodes a json response and appends the points younger than secondsPast to the vectors, minY and maxY only for binned data.
+     * Returns the number of points appended, or -1 with errorString set if the response can not be parsed.
+     * */
+    static int decodeJsonResponse(const QByteArray &data, double seconds, int secondsPast, bool binned, bool absoluteTimeAxis,
+                                  QVector<double> &x, QVector<double> &y, QVector<double> &minY, QVector<double> &maxY,
+                                  QDateTime &continueAt, QString &errorString);
+
+    /*
+     * Decodes a response in the binary transfer format like decodeJsonResponse.
+     * The columns are read in place from data, each one is copied once into its vector.
+     * */
+    static int decodeBinaryResponse(const QByteArray &data, double seconds, int secondsPast, bool binned, bool absoluteTimeAxis,
+                                    QVector<double> &x, QVector<double> &y, QVector<double> &minY, QVector<double> &maxY,
+                                    QDateTime &continueAt, QString &errorString);
+
 signals:
     /*
      * Signal to indicate the processing of the network request has finished.
@@ -131,6 +165,11 @@ signals:
     void requestFinished();
 
 protected slots:
+    /*
+     * Forwards the finished reply of this retrieval to finishReply.
+     * */
+    void replyFinished();
+
     /*
      * Parses the reply and saves the data
      * */
@@ -25,6 +25,7 @@
 
 #include <workerHttp.h>
 
+#include <QElapsedTimer>
 #include <QList>
 #include <QMap>
 #include <QMutex>
@@ -32,9 +33,11 @@
 #include <QThread>
 #include <QTimer>
 
+#include "archiverDecimation.h"
 #include "archiverGeneral.h"
 #include "httpretrieval.h"
 #include "urlhandlerhttp.h"
+#include <math.h>
 
 WorkerHTTP::WorkerHTTP()
 {
@@ -44,20 +47,47 @@ WorkerHTTP::WorkerHTTP()
     m_requestAgain = false;
     m_vecX.clear();
     m_vecY.clear();
-    m_isActive = true;
+    m_isActive.storeRelease(1);
+    m_receivedValueCount.storeRelease(0);
+    m_requestMessageWindow = Q_NULLPTR;
+    m_requestMutexKnobData = Q_NULLPTR;
 }
 
 WorkerHTTP::~WorkerHTTP()
 {
 }
 
-void WorkerHTTP::workerFinish()
+void WorkerHTTP::setRequest(indexes indexNew,
+                            QString index_name,
+                            MessageWindow *messageWindow,
+                            MutexKnobData *mutexKnobDataP,
+                            QSharedPointer<HttpPerformanceData> httpPerformanceData)
 {
-    deleteLater();
+    m_requestIndex = indexNew;
+    m_requestIndexName = index_name;
+    m_requestMessageWindow = messageWindow;
+    m_requestMutexKnobData = mutexKnobDataP;
+    m_requestPerformanceData = httpPerformanceData;
+}
+
+void WorkerHTTP::run()
+{
+    getFromArchive(m_requestIndex, m_requestIndexName, m_requestMessageWindow, m_requestMutexKnobData, m_requestPerformanceData);
+}
+
+void WorkerHTTP::cancel()
+{
+    setIsActive(false);
+    // The worker thread replaces and deletes the retrieval only while holding the same mutex, see getFromArchive.
+    QMutexLocker locker(&m_retrievalMutex);
+    if (m_httpRetrieval != Q_NULLPTR) {
+        m_httpRetrieval->cancelDownload();
+    }
 }
 
 HttpRetrieval *WorkerHTTP::getArchive()
 {
+    QMutexLocker locker(&m_retrievalMutex);
     return m_httpRetrieval;
 }
 
@@ -71,22 +101,46 @@ void WorkerHTTP::getFromArchive(indexes indexNew,
     m_mutexKnobDataPtr = mutexKnobDataP;
     QString key = indexNew.pv;
     int nbVal = 0;
+    m_receivedValueCount.storeRelease(0);
 
     struct timeb now;
     ftime(&now);
 
-    double endSeconds = (double) now.time + (double) now.millitm / (double) 1000;
+    const double nowSeconds = (double) now.time + (double) now.millitm / (double) 1000;
+    double endSeconds = nowSeconds;
     double startSeconds = endSeconds - indexNew.secondsPast;
 
+    // If the user zoomed into the plot, only request the visible range, so we get a higher resolution there.
+    if (indexNew.zoomed) {
+        startSeconds = indexNew.zoomStartSeconds;
+        endSeconds = qMin(indexNew.zoomEndSeconds, nowSeconds);
+    }
+    const double windowStartSeconds = startSeconds;
+    const double windowEndSeconds = endSeconds;
+
     bool isBinned = (indexNew.nrOfBins > 0);
 
     // If there is a valid caCartesianPlot associated with this request, update the limits to display the requested range.
+    // When zoomed, the zoomer owns the scale, so leave it alone.
     if (caCartesianPlot *caCartesianWidget = qobject_cast<caCartesianPlot *>((QWidget *) indexNew.w)) {
-        setCartesianLimits(caCartesianWidget, startSeconds, endSeconds);
+        if (!indexNew.zoomed) {
+            setCartesianLimits(caCartesianWidget, startSeconds, endSeconds);
+        }
     }
 
     // Calculate the number of bins per second to be able to maintain the initial bin density if we receive a continueAt
-    double nrOfBinsPerSecond = static_cast<double>(indexNew.nrOfBins) / static_cast<double>(indexNew.secondsPast);
+    double nrOfBinsPerSecond = static_cast<double>(indexNew.nrOfBins) / qMax(windowEndSeconds - windowStartSeconds, 1.0);
+
+    // Raw data is reduced to the first, min, max and last point of every pixel column, the column grid is given
+    // by the displayed range in the units of the X axis (milliseconds since epoch or hours relative to now)
+    double decimationStartX, decimationEndX;
+    if (indexNew.timeAxis) {
+        decimationStartX = windowStartSeconds * 1000;
+        decimationEndX = windowEndSeconds * 1000;
+    } else {
+        decimationStartX = -(nowSeconds - windowStartSeconds) / 3600.0;
+        decimationEndX = -(nowSeconds - windowEndSeconds) / 3600.0;
+    }
 
     // Initialize urlhandler with all parameters except startSeconds, as this will be changed
     UrlHandlerHttp *urlHandler = initializeNewUrlHandler(index_name,
@@ -97,204 +151,276 @@ void WorkerHTTP::getFromArchive(indexes indexNew,
 
     // Figure out if mutexKnobData already holds data we are about to request.
     // If it does, make sure to update the startSeconds to when our saved data stops.
-    startSeconds = updateStartSecondsFromMutexKnobData(indexNew.indexX, startSeconds);
-
-    do {
-        // Clear data
-        m_vecX.clear();
-        m_vecY.clear();
-        m_vecMinY.clear();
-        m_vecMaxY.clear();
-        nbVal = 0;
-
-        // If requestAgain is set, then this isn't the first iteration, so wait a bit before stressing the backend again
-        if (m_requestAgain) {
-            if (m_retryAfter != 0) {
-                // Wait as long as the server requested
-                QThread::sleep(m_retryAfter);
-            } else {
-                // Just wait for a second
-                QThread::sleep(1);
-            }
-        }
-        m_retryAfter = 0;
-        m_requestAgain = false;
+    // This is not done after a zoom or a zoom reset, as then the stored data covers a different range and resolution.
+    if (!indexNew.zoomed && !indexNew.fullReload) {
+        startSeconds = updateStartSecondsFromMutexKnobData(indexNew.indexX, startSeconds);
+    }
 
-        // Set bin count according to initial density, so the density is consitent across multiple succeeding requests
-        double timeDifference = endSeconds - startSeconds;
-        urlHandler->setBinCount(int(timeDifference * nrOfBinsPerSecond));
-        // When the bin count is less than one, then not enough time has passed to make another request
-        bool binCountLessThanOne = urlHandler->binCount() < 1;
+    // Long ranges are loaded in chunks, newest first, so the plot shows the recent data while older data is still loading.
+    // Regular updates only request the last few seconds and therefore are done in a single chunk.
+    const double loadStartSeconds = startSeconds;
+    const double loadEndSeconds = endSeconds;
+    const int numberOfChunks = qBound(1, int(ceil((loadEndSeconds - loadStartSeconds) / HTTP_CHUNK_MIN_SECONDS)), HTTP_CHUNK_MAX_COUNT);
+    const double chunkSeconds = (loadEndSeconds - loadStartSeconds) / numberOfChunks;
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    if (numberOfChunks > 1) {
+        httpPerformanceData->beginChunkedRequest(QDateTime::fromSecsSinceEpoch(loadStartSeconds),
+                                                 QDateTime::fromSecsSinceEpoch(loadEndSeconds));
+    }
 
-        // Set Begin Time within loop to modify it if we get a continueAt
-        urlHandler->setBeginTime(QDateTime::fromSecsSinceEpoch(startSeconds));
+    for (int chunk = 0; chunk < numberOfChunks && isActive(); chunk++) {
+        const bool isNewestChunk = (chunk == 0);
+        const bool isOldestChunk = (chunk == numberOfChunks - 1);
+        endSeconds = loadEndSeconds - chunk * chunkSeconds;
+        startSeconds = isOldestChunk ? loadStartSeconds : endSeconds - chunkSeconds;
+        urlHandler->setEndTime(QDateTime::fromSecsSinceEpoch(endSeconds));
+        const double chunkStartSeconds = startSeconds;
+        QElapsedTimer chunkTimer;
+        chunkTimer.start();
+        int chunkValueCount = 0;
+
+        do {
+            // Clear data
+            m_vecX.clear();
+            m_vecY.clear();
+            m_vecMinY.clear();
+            m_vecMaxY.clear();
+            nbVal = 0;
 
-        // Make sure previous HttpRetrieval is deleted, however, if the previous HttpRetrieval contains an abort, dont proceed
-        // This is done in case an abort was initiated after the previous HttpRetrieval returned and it therefore went unnoticed.
-        bool previousHttpRetrievalAborted = false;
-        if (m_httpRetrieval != Q_NULLPTR) {
-            // save the pointer to a temporary variable so we don't have a memory leak
-            HttpRetrieval *lastHttpRetrieval = m_httpRetrieval;
-            if (m_httpRetrieval->isAborted()) {
-                previousHttpRetrievalAborted = true;
+            // If requestAgain is set, then this isn't the first iteration, so wait a bit before stressing the backend again
+            if (m_requestAgain) {
+                if (m_retryAfter != 0) {
+                    // Wait as long as the server requested
+                    QThread::sleep(m_retryAfter);
+                } else {
+                    // Just wait for a second
+                    QThread::sleep(1);
+                }
             }
-            // Assign a new HttpRetrieval to our publicly accessible member without deleting it so an abort would never be referencing a null pointer.
-            m_httpRetrieval = new HttpRetrieval();
-            // Because we saved the pointer in this temporary variable, we can now safely delete it without the risk of it being referenced.
-            delete lastHttpRetrieval;
-        } else {
-            // Create our HttpRetrieval
-            m_httpRetrieval = new HttpRetrieval();
-        }
+            m_retryAfter = 0;
+            m_requestAgain = false;
 
-        bool readdata_ok;
-        // If the previous retrieval aborted, don't even request.
-        // If the bin Count is less than one and we have binned data, don't even request.
-        if (!previousHttpRetrievalAborted && !(binCountLessThanOne && isBinned)) {
-            httpPerformanceData->addNewRequest(urlHandler);
-            readdata_ok = m_httpRetrieval->requestUrl(urlHandler->assembleUrl(),
-                                                      urlHandler->backend(),
-                                                      timeDifference,
-                                                      isBinned,
-                                                      indexNew.timeAxis,
-                                                      key);
-            if (m_httpRetrieval->isRedirected()) {
-                QUrl url = QUrl(m_httpRetrieval->getRedirectedUrl());
-                // Messages in case of a redirect and set the widget to the correct location
-                // with a reload of the panel this information get lost.
-                if (messageWindow != (MessageWindow *) Q_NULLPTR) {
-                    QString mess("ArchiveHTTP plugin -- redirect: ");
-                    mess.append(key);
-                    mess.append(" to ");
-                    mess.append(url.toString());
-                    messageWindow->postMsgEvent(QtDebugMsg, (char *) qasc(mess));
+            // Set bin count according to initial density, so the density is consitent across multiple succeeding requests
+            double timeDifference = endSeconds - startSeconds;
+            urlHandler->setBinCount(int(timeDifference * nrOfBinsPerSecond));
+            // When the bin count is less than one, then not enough time has passed to make another request
+            bool binCountLessThanOne = urlHandler->binCount() < 1;
+
+            // Set Begin Time within loop to modify it if we get a continueAt
+            urlHandler->setBeginTime(QDateTime::fromSecsSinceEpoch(startSeconds));
+
+            // Make sure previous HttpRetrieval is deleted, however, if the previous HttpRetrieval contains an abort, dont proceed
+            // This is done in case an abort was initiated after the previous HttpRetrieval returned and it therefore went unnoticed.
+            bool previousHttpRetrievalAborted = false;
+            {
+                // The swap is done under the lock, so a concurrent cancel either aborts the old retrieval before it is deleted or the new one.
+                QMutexLocker retrievalLocker(&m_retrievalMutex);
+                if (m_httpRetrieval != Q_NULLPTR) {
+                    if (m_httpRetrieval->isAborted()) {
+                        previousHttpRetrievalAborted = true;
+                    }
+                    delete m_httpRetrieval;
                 }
-
-                // Set a dynamic property containing the new url so the next update doesnt run into the same error again
-                indexNew.w->setProperty("archiverIndex", QVariant(url.toString()));
-                // Update the url for the next request
-                urlHandler->setUrl(url);
-                // Make sure we do another request
-                m_requestAgain = true;
-                readdata_ok = false;
+                m_httpRetrieval = new HttpRetrieval();
             }
-        } else {
-            readdata_ok = false;
-        }
 
-        if (readdata_ok) {
-            httpPerformanceData->addNewResponse(m_httpRetrieval->responseSizeKB(),
-                                                m_httpRetrieval->httpStatusCode(),
-                                                m_httpRetrieval->hasContinueAt(),
-                                                m_httpRetrieval->continueAt());
-            if (m_httpRetrieval->getCount() > 0) {
-                if (isBinned) {
-                    // Get the data
-                    m_httpRetrieval->getBinnedDataAppended(m_vecX, m_vecY, m_vecMinY, m_vecMaxY);
-                    // Because we have binned data the latest point is faulty as it does not contain as much data as the others
-                    // Due to this, there might be unproportional spikes, so remove the last point if there are more than one.
-                    // Also only do this if there is no continueAt, because if there is the last received point isn't actually the latest one and therefore not affected by this problem.
-                    if (!m_httpRetrieval->hasContinueAt() && m_httpRetrieval->getCount() > 1) {
-                        m_vecX.removeLast();
-                        m_vecY.removeLast();
-                        m_vecMinY.removeLast();
-                        m_vecMaxY.removeLast();
+            bool readdata_ok;
+            // If the previous retrieval aborted, don't even request.
+            // If the bin Count is less than one and we have binned data, don't even request.
+            if (!previousHttpRetrievalAborted && !(binCountLessThanOne && isBinned)) {
+                httpPerformanceData->addNewRequest(urlHandler);
+                readdata_ok = m_httpRetrieval->requestUrl(urlHandler->assembleUrl(),
+                                                          urlHandler->backend(),
+                                                          nowSeconds - startSeconds,
+                                                          isBinned,
+                                                          indexNew.timeAxis,
+                                                          key);
+                if (m_httpRetrieval->isRedirected()) {
+                    QUrl url = QUrl(m_httpRetrieval->getRedirectedUrl());
+                    // Messages in case of a redirect and set the widget to the correct location
+                    // with a reload of the panel this information get lost.
+                    if (messageWindow != (MessageWindow *) Q_NULLPTR) {
+                        QString mess("ArchiveHTTP plugin -- redirect: ");
+                        mess.append(key);
+                        mess.append(" to ");
+                        mess.append(url.toString());
+                        messageWindow->postMsgEvent(QtDebugMsg, (char *) qasc(mess));
                     }
-                } else {
-                    // Get the data
-                    m_httpRetrieval->getDataAppended(m_vecX, m_vecY);
+
+                    // Set a dynamic property containing the new url so the next update doesnt run into the same error again
+                    indexNew.w->setProperty("archiverIndex", QVariant(url.toString()));
+                    // Update the url for the next request
+                    urlHandler->setUrl(url);
+                    // Make sure we do another request
+                    m_requestAgain = true;
+                    readdata_ok = false;
                 }
+            } else {
+                readdata_ok = false;
             }
-            if (m_httpRetrieval->hasContinueAt()) {
-                // We don't care if it's only a couple of seconds, might as well be transmission delay
-                if (endSeconds - m_httpRetrieval->continueAt().toSecsSinceEpoch() > 30) {
-                    startSeconds = m_httpRetrieval->continueAt().toSecsSinceEpoch();
-                    m_requestAgain = true;
 
-                    if (m_httpRetrieval->retryAfter() != 0) {
-                        // If the API told us how long to wait, follow that instruction
-                        m_retryAfter = m_httpRetrieval->retryAfter();
-                        if (m_retryAfter > 5) {
-                            // We are not stalling for more than 5 seconds, and as long as we get a valid response, the server isn't fully at capacity, yet, so request again in 5 secs. :)
-                            m_retryAfter = 5;
+            if (readdata_ok) {
+                httpPerformanceData->addNewResponse(m_httpRetrieval->responseSizeKB(),
+                                                    m_httpRetrieval->httpStatusCode(),
+                                                    m_httpRetrieval->hasContinueAt(),
+                                                    m_httpRetrieval->continueAt());
+                if (m_httpRetrieval->getCount() > 0) {
+                    if (isBinned) {
+                        // Get the data
+                        m_httpRetrieval->getBinnedDataAppended(m_vecX, m_vecY, m_vecMinY, m_vecMaxY);
+                        // Because we have binned data the latest point is faulty as it does not contain as much data as the others
+                        // Due to this, there might be unproportional spikes, so remove the last point if there are more than one.
+                        // Also only do this if there is no continueAt, because if there is the last received point isn't actually the latest one and therefore not affected by this problem.
+                        // Older chunks end before now, so their last bin is complete.
+                        if (isNewestChunk && !m_httpRetrieval->hasContinueAt() && m_httpRetrieval->getCount() > 1) {
+                            m_vecX.removeLast();
+                            m_vecY.removeLast();
+                            m_vecMinY.removeLast();
+                            m_vecMaxY.removeLast();
+                        }
+                    } else {
+                        // Get the data
+                        m_httpRetrieval->getDataAppended(m_vecX, m_vecY);
+                        // The backend can not bin for us, so reduce the data to what the plot can display.
+                        int decimatedCount = ArchiverDecimation::decimateM4(m_vecX.data(), m_vecY.data(), m_vecX.count(),
+                                                                            decimationStartX, decimationEndX, indexNew.plotWidth);
+                        m_vecX.resize(decimatedCount);
+                        m_vecY.resize(decimatedCount);
+                    }
+                }
+                if (m_httpRetrieval->hasContinueAt()) {
+                    // We don't care if it's only a couple of seconds, might as well be transmission delay
+                    if (endSeconds - m_httpRetrieval->continueAt().toSecsSinceEpoch() > 30) {
+                        startSeconds = m_httpRetrieval->continueAt().toSecsSinceEpoch();
+                        m_requestAgain = true;
+
+                        if (m_httpRetrieval->retryAfter() != 0) {
+                            // If the API told us how long to wait, follow that instruction
+                            m_retryAfter = m_httpRetrieval->retryAfter();
+                            if (m_retryAfter > 5) {
+                                // We are not stalling for more than 5 seconds, and as long as we get a valid response, the server isn't fully at capacity, yet, so request again in 5 secs. :)
+                                m_retryAfter = 5;
+                            }
                         }
                     }
                 }
-            }
 
-            nbVal = m_vecX.count();
-            if (nbVal != m_vecY.count()) {
-                // API is messing with us
-                throw;
-            }
-        } else {
-            httpPerformanceData->addNewResponse(m_httpRetrieval->responseSizeKB(),
-                                                m_httpRetrieval->httpStatusCode(),
-                                                m_httpRetrieval->hasContinueAt(),
-                                                m_httpRetrieval->continueAt());
-            // If we intentionally did not send out a request because the bin count was too low, don't generate an error
-            // If the request was redirected, an error has already been displayed but the request is not aborted, so don't generate an error
-            if (!(binCountLessThanOne && isBinned) && !m_httpRetrieval->isRedirected()) {
-                if (messageWindow != (MessageWindow *) Q_NULLPTR) {
-                    QString mess("ArchiveHTTP plugin -- lastError: ");
-                    if (previousHttpRetrievalAborted) {
-                        mess.append(" request was aborted ");
-                    } else {
-                        mess.append(m_httpRetrieval->lastError());
+                nbVal = m_vecX.count();
+                if (nbVal != m_vecY.count()) {
+                    // API is messing with us, skip this chunk and go on with the next one
+                    if (messageWindow != (MessageWindow *) Q_NULLPTR) {
+                        QString mess("ArchiveHTTP plugin -- lastError: ");
+                        mess.append(QString("got %1 times and %2 values").arg(nbVal).arg(m_vecY.count()));
+                        mess.append(" for pv: ");
+                        mess.append(key);
+                        mess = QString(mess.toHtmlEscaped());
+                        messageWindow->postMsgEvent(QtFatalMsg, (char *) qasc(mess));
+                    }
+                    m_vecX.clear();
+                    m_vecY.clear();
+                    m_vecMinY.clear();
+                    m_vecMaxY.clear();
+                    nbVal = 0;
+                    m_requestAgain = false;
+                }
+            } else {
+                httpPerformanceData->addNewResponse(m_httpRetrieval->responseSizeKB(),
+                                                    m_httpRetrieval->httpStatusCode(),
+                                                    m_httpRetrieval->hasContinueAt(),
+                                                    m_httpRetrieval->continueAt());
+                // If we intentionally did not send out a request because the bin count was too low, don't generate an error
+                // If the request was redirected, an error has already been displayed but the request is not aborted, so don't generate an error
+                if (!(binCountLessThanOne && isBinned) && !m_httpRetrieval->isRedirected()) {
+                    if (messageWindow != (MessageWindow *) Q_NULLPTR) {
+                        QString mess("ArchiveHTTP plugin -- lastError: ");
+                        if (previousHttpRetrievalAborted) {
+                            mess.append(" request was aborted ");
+                        } else {
+                            mess.append(m_httpRetrieval->lastError());
+                        }
+                        mess.append(" for pv: ");
+                        mess.append(key);
+                        mess = QString(mess.toHtmlEscaped());
+                        messageWindow->postMsgEvent(QtFatalMsg, (char *) qasc(mess));
                     }
-                    mess.append(" for pv: ");
-                    mess.append(key);
-                    mess = QString(mess.toHtmlEscaped());
-                    messageWindow->postMsgEvent(QtFatalMsg, (char *) qasc(mess));
                 }
-            }
 
-            // If the server is temporarily at capacity, try again, but only if the request wasn't aborted.
-            if (!previousHttpRetrievalAborted) {
-                if (m_httpRetrieval->retryAfter() != 0) {
-                    // Set this to indicate we are trying again.
-                    m_requestAgain = true;
-                    m_retryAfter = m_httpRetrieval->retryAfter();
-                    if (m_httpRetrieval->retryAfter() > 5) {
-                        // Nope, we are not waiting this long... Just finish so it is requested again on the next update iteration, being at least 10 secs from now
-                        m_requestAgain = false;
+                // If the server is temporarily at capacity, try again, but only if the request wasn't aborted.
+                if (!previousHttpRetrievalAborted) {
+                    if (m_httpRetrieval->retryAfter() != 0) {
+                        // Set this to indicate we are trying again.
+                        m_requestAgain = true;
+                        m_retryAfter = m_httpRetrieval->retryAfter();
+                        if (m_httpRetrieval->retryAfter() > 5) {
+                            // Nope, we are not waiting this long... Just finish so it is requested again on the next update iteration, being at least 10 secs from now
+                            m_requestAgain = false;
+                        }
                     }
                 }
             }
+            // Check if the thread was marked as inactive to cancel everything if needed.
+            if (!isActive()) {
+                // Set requestAgain to false because we don't want any more updates.
+                m_requestAgain = false;
+                // set data count to 0 to clarify this data is not needed.
+                nbVal = 0;
+            }
+            chunkValueCount += nbVal;
+            m_receivedValueCount.fetchAndAddRelease(nbVal);
+            // Only the oldest chunk finishes the update, unless the worker was cancelled.
+            emit resultReady(indexNew,
+                             nbVal,
+                             m_vecX,
+                             m_vecY,
+                             m_vecMinY,
+                             m_vecMaxY,
+                             m_httpRetrieval->getBackend(),
+                             !m_requestAgain && (isOldestChunk || !isActive()));
+        } while (m_requestAgain);
+
+        if (numberOfChunks > 1) {
+            httpPerformanceData->addChunk(QDateTime::fromSecsSinceEpoch(chunkStartSeconds),
+                                          QDateTime::fromSecsSinceEpoch(endSeconds),
+                                          chunkTimer.elapsed(),
+                                          loadTimer.elapsed(),
+                                          chunkValueCount);
         }
-        // Check if the thread was marked as inactive to cancel everything if needed.
-        if (!m_isActive) {
-            // Set requestAgain to false because we don't want any more updates.
-            m_requestAgain = false;
-            // set data count to 0 to clarify this data is not needed.
-            nbVal = 0;
-        }
-        emit resultReady(indexNew,
-                         nbVal,
-                         m_vecX,
-                         m_vecY,
-                         m_vecMinY,
-                         m_vecMaxY,
-                         m_httpRetrieval->getBackend(),
-                         !m_requestAgain);
-    } while (m_requestAgain);
+    }
+    if (numberOfChunks > 1) {
+        httpPerformanceData->finishChunkedRequest();
+    }
 
     m_vecX.clear();
     m_vecY.clear();
     m_vecMinY.clear();
     m_vecMaxY.clear();
     urlHandler->deleteLater();
-    m_httpRetrieval->deleteLater();
+    // Reset the member under the lock before deleting, so a late cancel does not reference a deleted HttpRetrieval.
+    HttpRetrieval *lastHttpRetrieval;
+    {
+        QMutexLocker retrievalLocker(&m_retrievalMutex);
+        lastHttpRetrieval = m_httpRetrieval;
+        m_httpRetrieval = Q_NULLPTR;
+    }
+    if (lastHttpRetrieval != Q_NULLPTR) {
+        lastHttpRetrieval->deleteLater();
+    }
 }
 
 bool WorkerHTTP::isActive() const
 {
-    return m_isActive;
+    return m_isActive.loadAcquire() != 0;
 }
 
 void WorkerHTTP::setIsActive(bool newIsActive)
 {
-    m_isActive = newIsActive;
+    m_isActive.storeRelease(newIsActive ? 1 : 0);
+}
+
+int WorkerHTTP::receivedValueCount() const
+{
+    return m_receivedValueCount.loadAcquire();
 }
 
 void WorkerHTTP::setCartesianLimits(caCartesianPlot *cartesianWidget,
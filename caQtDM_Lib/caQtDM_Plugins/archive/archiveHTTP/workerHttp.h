@@ -26,11 +26,20 @@
 #ifndef WORKERHTTP_H
 #define WORKERHTTP_H
 
+#include <QAtomicInt>
+#include <QMutex>
+
 #include "archiverGeneral.h"
+#include "archiverScheduler.h"
 #include "httpperformancedata.h"
 #include "httpretrieval.h"
 
-class Q_DECL_EXPORT WorkerHTTP : public QObject
+// Ranges longer than this are loaded in several chunks, newest first
+#define HTTP_CHUNK_MIN_SECONDS 3600
+// Upper limit for the number of chunks of one load
+#define HTTP_CHUNK_MAX_COUNT 8
+
+class Q_DECL_EXPORT WorkerHTTP : public ArchiverJob
 {
     Q_OBJECT
 
@@ -49,12 +58,26 @@ public:
      * */
     void setIsActive(bool newIsActive);
 
-public slots:
     /*
-     * This function is used to delete the worker when the thread finishes.
+     * Returns the number of values received by all chunks of the last getFromArchive so far.
+     * */
+    int receivedValueCount() const;
+
+    /*
+     * Stores the parameters for getFromArchive, which is called once the scheduler runs this worker.
      * */
-    void workerFinish();
+    void setRequest(indexes indexNew,
+                    QString index_name,
+                    MessageWindow *messageWindow,
+                    MutexKnobData *mutexKnobDataP,
+                    QSharedPointer<HttpPerformanceData> httpPerformanceData);
 
+    /*
+     * Marks this worker as inactive and aborts the currently running network request.
+     * */
+    void cancel();
+
+public slots:
     /*
      * Returns the httpRetrieval currently associated to the worker
      * This function is dangerous and should only be used with extreme caution
@@ -64,6 +87,8 @@ public slots:
     /*
      * Starts a network request to the given index_name and emits the signal resultReady when new data has arrived.
      * As long as the response contains a continueAt, this function keeps requesting additional data until all initially requested data is received.
+     * Long ranges are split into chunks which are requested newest first, every chunk is emitted as soon as it arrives.
+     * A cancel aborts the running request and skips the remaining chunks.
      * */
     void getFromArchive(indexes indexNew,
                         QString index_name,
@@ -71,6 +96,9 @@ public slots:
                         MutexKnobData *mutexKnobDataP,
                         QSharedPointer<HttpPerformanceData> httpPerformanceData);
 
+protected:
+    void run();
+
 signals:
     /*
      * Signal to indicate new result data is ready. It only contains the data from the current iteration, so no old data.
@@ -100,8 +128,17 @@ private:
     HttpRetrieval *m_httpRetrieval;
     bool m_requestAgain;
     QMutex m_globalMutex;
+    // Guards m_httpRetrieval, which is replaced by the worker thread while cancel() is called from the gui thread.
+    QMutex m_retrievalMutex;
     int m_retryAfter;
-    bool m_isActive;
+    QAtomicInt m_isActive;
+    QAtomicInt m_receivedValueCount;
+
+    indexes m_requestIndex;
+    QString m_requestIndexName;
+    MessageWindow *m_requestMessageWindow;
+    MutexKnobData *m_requestMutexKnobData;
+    QSharedPointer<HttpPerformanceData> m_requestPerformanceData;
 };
 
 #endif // WORKERHTTP_H
@@ -44,8 +44,10 @@ ArchivePRO_Plugin::ArchivePRO_Plugin()
 
     qDebug() << "ArchivePro_Plugin: Create (logging retrieval)";
     archiverCommon = new ArchiverCommon();
+    scheduler = new ArchiverScheduler(this);
 
     connect(archiverCommon, SIGNAL(Signal_UpdateInterface(QMap<QString, indexes>)), this,SLOT(Callback_UpdateInterface(QMap<QString, indexes>)));
+    connect(archiverCommon, SIGNAL(Signal_AbortOutstandingRequests(QString)), this,SLOT(Callback_AbortOutstandingRequests(QString)));
     connect(this, SIGNAL(Signal_StopUpdateInterface()), archiverCommon,SLOT(stopUpdateInterface()));
     connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(closeEvent()));
 }
@@ -71,35 +73,21 @@ void ArchivePRO_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfI
     QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
 
     while (i != listOfIndexes.constEnd()) {
-        QThread *tmpThread = (QThread *) Q_NULLPTR;
         indexes indexNew = i.value();
         //qDebug() << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w << endl;
 
-        QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-        while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-            tmpThread = (QThread *) j.value();
-            ++j;
-        }
-
-        //qDebug() << "tmpThread" << tmpThread;
-
-        if((tmpThread != (QThread *) Q_NULLPTR) && tmpThread->isRunning()) {
-            //qDebug() << "workerthread is running" << tmpThread->isRunning();
+        if(scheduler->isScheduled(i.key())) {
+            //qDebug() << "request still queued or running";
         } else {
-            WorkerPRO *worker = new WorkerPRO;
-            QThread *tmpThread = new QThread;
-            listOfThreads.insert(i.key(), tmpThread);
-            worker->moveToThread(tmpThread);
-            connect(tmpThread, SIGNAL(finished()), worker, SLOT(workerFinish()));
-            connect(tmpThread, SIGNAL(finished()), tmpThread, SLOT(deleteLater()) );
-            connect(this, SIGNAL(operate( QWidget *, indexes)), worker,
-                          SLOT(getFromArchive(QWidget *, indexes)));
-            connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
-                            SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
-            tmpThread->start();
-
-            //qDebug() << "PRO emit operate";
-            emit operate((QWidget *) messagewindowP ,indexNew);
+            // plots showing the same channel share one retrieval
+            if(archiverCommon->requestSeries(pluginName(), indexNew)) {
+                WorkerPRO *worker = new WorkerPRO;
+                worker->setRequest((QWidget *) messagewindowP ,indexNew);
+                connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
+                                SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
+
+                scheduler->schedule(i.key(), ArchiverScheduler::priority(indexNew.w, indexNew.secondsPast), worker);
+            }
         }
         ++i;
     }
@@ -109,29 +97,19 @@ void ArchivePRO_Plugin::handleResults(indexes indexNew, int nbVal, QVector<doubl
 {
     //qDebug() << "in PRO handle results" << nbVal << TimerN.count();
 
+    // the result is also passed to the plots waiting for the same series, even when empty to end their wait
     if(nbVal > 0) {
         TimerN.resize(nbVal);
         YValsN.resize(nbVal);
-        archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
-        TimerN.resize(0);
-        YValsN.resize(0);
-    }
-
-    QList<QString> removeKeys;
-    removeKeys.clear();
-
-    QMap<QString, QThread *>::iterator j = listOfThreads.find(indexNew.key);
-    while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-        QThread *tmpThread = (QThread*) j.value();
-        tmpThread->quit();
-        //qDebug() << tmpThread << "pro quit";
-        removeKeys.append(indexNew.key);
-        ++j;
     }
+    archiverCommon->finishSeries(indexNew, nbVal, TimerN, YValsN, backend);
+    TimerN.resize(0);
+    YValsN.resize(0);
+}
 
-    for(int i=0; i< removeKeys.count(); i++) {
-        listOfThreads.remove(removeKeys.at(i));
-    }
+void ArchivePRO_Plugin::Callback_AbortOutstandingRequests(QString key)
+{
+    scheduler->cancel(key);
 }
 
 // define data to be called
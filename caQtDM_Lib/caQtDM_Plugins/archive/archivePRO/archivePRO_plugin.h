@@ -36,9 +36,11 @@
 #include "controlsinterface.h"
 #include "archivePRO_plugin.h"
 #include "archiverCommon.h"
+#include "archiverDecimation.h"
+#include "archiverScheduler.h"
 #include "proRetrieval.h"
 
-class Q_DECL_EXPORT WorkerPRO : public QObject
+class Q_DECL_EXPORT WorkerPRO : public ArchiverJob
 {
     Q_OBJECT
 
@@ -48,15 +50,24 @@ public:
         qRegisterMetaType<QVector<double> >("QVector<double>");
     }
 
+    // parameters of the request, executed when the scheduler runs this job
+    void setRequest(QWidget *w, indexes indexNew) {
+        requestW = w;
+        requestIndex = indexNew;
+    }
+
+protected:
+    void run() {
+        getFromArchive(requestW, requestIndex);
+    }
+
 private:
     QVector<double>  TimerN, YValsN;
+    QWidget *requestW;
+    indexes requestIndex;
 
 public slots:
 
-    void workerFinish() {
-        deleteLater();
-    }
-
     void getFromArchive(QWidget *w, indexes indexNew) {
 
         Q_UNUSED(w);
@@ -104,6 +115,20 @@ public slots:
         free(Timer);
         free(YVals);
 
+        // the logging server only delivers raw data for a given time back, so crop to the zoomed range
+        // and reduce the data to what the plot can display
+        double xStart = -startHours;
+        double xEnd = 0.0;
+        if(indexNew.zoomed) {
+            struct timeb now;
+            ftime(&now);
+            double nowSeconds = (double) now.time + (double) now.millitm / (double)1000;
+            xStart = (indexNew.zoomStartSeconds - nowSeconds) / 3600.0;
+            xEnd = (indexNew.zoomEndSeconds - nowSeconds) / 3600.0;
+            nbVal = ArchiverDecimation::cropToRange(TimerN.data(), YValsN.data(), nbVal, xStart, xEnd);
+        }
+        nbVal = ArchiverDecimation::decimateM4(TimerN.data(), YValsN.data(), nbVal, xStart, xEnd, indexNew.plotWidth);
+
         //qDebug() << "pro nbval=" << nbVal;
 
         emit resultReady(indexNew, nbVal, TimerN, YValsN, "");
@@ -151,12 +176,12 @@ public slots:
     void handleResults(indexes, int, QVector<double>, QVector<double>, QString backend);
 
 signals:
-    void operate(QWidget*, const indexes);
     void Signal_StopUpdateInterface();
 
 private slots:
     void updateValues();
     void Callback_UpdateInterface( QMap<QString, indexes> listOfIndexes);
+    void Callback_AbortOutstandingRequests(QString key);
     void closeEvent();
 
 private:
@@ -164,7 +189,7 @@ private:
     MutexKnobData *mutexknobdataP;
     MessageWindow *messagewindowP;
     ArchiverCommon *archiverCommon;
-    QMap<QString, QThread*> listOfThreads;
+    ArchiverScheduler *scheduler;
 };
 
 #endif
@@ -32,8 +32,8 @@ android {
    INCLUDEPATH += $(ANDROIDFUNCTIONSINCLUDE)
 }
 
-HEADERS         = ../../controlsinterface.h archiveSF_plugin.h sfRetrieval.h ../archiverCommon.h
-SOURCES         =  archiveSF_plugin.cpp sfRetrieval.cpp ../archiverCommon.cpp
+HEADERS         = ../../controlsinterface.h archiveSF_plugin.h sfRetrieval.h ../archiverCommon.h ../archiverDecimation.h ../archiverScheduler.h
+SOURCES         =  archiveSF_plugin.cpp sfRetrieval.cpp ../archiverCommon.cpp ../archiverDecimation.cpp ../archiverScheduler.cpp
 TARGET          = archiveSF_plugin
 
 
@@ -46,6 +46,7 @@ ArchiveSF_Plugin::ArchiveSF_Plugin()
 
     qDebug() << "ArchiveSF_Plugin: Create (http-retrieval)";
     archiverCommon = new ArchiverCommon();
+    scheduler = new ArchiverScheduler(this);
 
     connect(archiverCommon, SIGNAL(Signal_UpdateInterface(QMap<QString, indexes>)), this,SLOT(Callback_UpdateInterface(QMap<QString, indexes>)));
     connect(archiverCommon, SIGNAL(Signal_AbortOutstandingRequests(QString)), this,SLOT(Callback_AbortOutstandingRequests(QString)));
@@ -75,23 +76,9 @@ void ArchiveSF_Plugin::Callback_AbortOutstandingRequests(QString key)
 {
     suspend = true;
     //qDebug()  << "Callback_AbortOutstandingRequests for key" << key;
-    
-    WorkerSfThread *tmpThread = (WorkerSfThread *) Q_NULLPTR;
-    QMap<QString, WorkerSfThread *>::iterator j = listOfThreads.find(key);
-    while (j !=listOfThreads.end() && j.key() == key) {
-        tmpThread = (WorkerSfThread *) j.value();
-        if(tmpThread != (WorkerSfThread *) Q_NULLPTR) {
-            sfRetrieval *retrieval = tmpThread->getArchive();
-            tmpThread->quit();
-            if(retrieval != (sfRetrieval *) Q_NULLPTR){
-                //qDebug()  << "retrieval->cancelDownload()"<< retrieval;
-                retrieval->cancelDownload();
-                retrieval->deleteLater();
-            }
 
-        }
-        ++j;
-    }
+    // drops the request when still queued, otherwise the running download is cancelled
+    scheduler->cancel(key);
 
    QApplication::processEvents();
    suspend = false;
@@ -111,19 +98,11 @@ void ArchiveSF_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
     QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
 
     while (i != listOfIndexes.constEnd()) {
-        
-        WorkerSfThread *tmpThread = (WorkerSfThread *) Q_NULLPTR;
         indexes indexNew = i.value();
         //qDebug() <<" -------------" << i.key() << ": " << indexNew.indexX << indexNew.indexY << indexNew.pv << indexNew.w;
-        
-        QMap<QString, WorkerSfThread *>::iterator j = listOfThreads.find(indexNew.key);
-        while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-            tmpThread = (WorkerSfThread *) j.value();
-            ++j;
-        }
-        
-        if((tmpThread != (WorkerSfThread *) Q_NULLPTR) && tmpThread->isRunning()) {
-            //qDebug() << "thread is running" << tmpThread << tmpThread->isRunning();
+
+        if(scheduler->isScheduled(i.key())) {
+            //qDebug() << "request still queued or running";
 
         } else {
 
@@ -183,24 +162,15 @@ void ArchiveSF_Plugin::Callback_UpdateInterface( QMap<QString, indexes> listOfIn
                 }
             }
 
-            WorkerSF *worker = new WorkerSF;
-            WorkerSfThread *tmpThread = new WorkerSfThread(worker);
-            //qDebug() << "tmpThread new" << tmpThread;
-            listOfThreads.insert(i.key(), tmpThread);;
-
-            worker->moveToThread(tmpThread);
+            // plots showing the same channel share one retrieval
+            if(archiverCommon->requestSeries(index_name, indexNew)) {
+                WorkerSF *worker = new WorkerSF;
+                worker->setRequest((QWidget *) messagewindowP, indexNew, index_name, messagewindowP);
+                connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
+                               SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
 
-            connect(tmpThread, SIGNAL(finished()), worker, SLOT(workerFinish()));
-            connect(tmpThread, SIGNAL(finished()), tmpThread, SLOT(deleteLater()) );
-            connect(this, SIGNAL(operate( QWidget *, indexes, QString, MessageWindow *)), worker,
-                          SLOT(getFromArchive(QWidget *, indexes,  QString, MessageWindow *)));
-            connect(worker, SIGNAL(resultReady(indexes, int, QVector<double>, QVector<double>, QString)), this,
-                           SLOT(handleResults(indexes, int, QVector<double>, QVector<double>, QString)));
-            tmpThread->start();
-
-            emit operate((QWidget *) messagewindowP, indexNew, index_name, messagewindowP);
-
-            disconnect(worker);
+                scheduler->schedule(i.key(), ArchiverScheduler::priority(indexNew.w, indexNew.secondsPast), worker);
+            }
         }
 
         ++i;
@@ -217,30 +187,18 @@ void ArchiveSF_Plugin::handleResults(indexes indexNew, int nbVal, QVector<double
     YValsN.resize(nbVal);
 
     //qDebug() << "handle cartesian";
-    if(nbVal > 0) archiverCommon->updateCartesian(nbVal, indexNew, TimerN, YValsN, backend);
+    // the result is also passed to the plots waiting for the same series
+    QList<indexes> served = archiverCommon->finishSeries(indexNew, nbVal, TimerN, YValsN, backend);
     TimerN.resize(0);
     YValsN.resize(0);
 
     //qDebug() << "handle cartesian fisnished";
-    QList<QString> removeKeys;
-    removeKeys.clear();
-    
-    QMap<QString, WorkerSfThread *>::iterator j = listOfThreads.find(indexNew.key);
-    while (j !=listOfThreads.end() && j.key() == indexNew.key) {
-        WorkerSfThread *tmpThread = (WorkerSfThread*) j.value();
-        tmpThread->quit();
-        removeKeys.append(indexNew.key);
-        //qDebug() << tmpThread << "sf quit";
-        ++j;
-    }
 
-    for(int i=0; i< removeKeys.count(); i++) {
-        listOfThreads.remove(removeKeys.at(i));
+    for(int j = 0; j < served.count(); j++) {
+        if(nbVal == 0) archiverCommon->updateSecondsPast(served.at(j), false);
+        else archiverCommon->updateSecondsPast(served.at(j), true);
     }
 
-    if(nbVal == 0) archiverCommon->updateSecondsPast(indexNew, false);
-    else archiverCommon->updateSecondsPast(indexNew, true);
-
     //qDebug() << "in sf handle results finished";
 }
 
@@ -36,10 +36,11 @@
 #include "controlsinterface.h"
 #include "archiveSF_plugin.h"
 #include "archiverCommon.h"
+#include "archiverScheduler.h"
 #include "sfRetrieval.h"
 
 
-class Q_DECL_EXPORT WorkerSF : public QObject
+class Q_DECL_EXPORT WorkerSF : public ArchiverJob
 {
     Q_OBJECT
 
@@ -55,25 +56,45 @@ public:
         //qDebug() << "WorkerSF::~WorkerSF()";
     }
 
-private:
-    QVector<double>  TimerN, YValsN;
+    // parameters of the request, executed when the scheduler runs this job
+    void setRequest(QWidget *w, indexes indexNew, QString index_name, MessageWindow *messageWindow) {
+        requestW = w;
+        requestIndex = indexNew;
+        requestIndexName = index_name;
+        requestMessageWindow = messageWindow;
+    }
 
-public slots:
+    void cancel() {
+        QMutexLocker locker(&retrievalMutex);
+        if(fromArchive != (sfRetrieval *) Q_NULLPTR) fromArchive->cancelDownload();
+    }
 
-    void workerFinish() {
-        deleteLater();
+protected:
+    void run() {
+        getFromArchive(requestW, requestIndex, requestIndexName, requestMessageWindow);
     }
 
-    sfRetrieval* getArchive() {
-        return fromArchive;
+private:
+    QVector<double>  TimerN, YValsN;
+    QWidget *requestW;
+    indexes requestIndex;
+    QString requestIndexName;
+    MessageWindow *requestMessageWindow;
+    QMutex retrievalMutex;
+
+    void setArchive(sfRetrieval *retrieval) {
+        QMutexLocker locker(&retrievalMutex);
+        fromArchive = retrieval;
     }
 
+public slots:
+
     void getFromArchive(QWidget *w, indexes indexNew,  QString index_name, MessageWindow * messageWindow) {
 
         Q_UNUSED(w);
 
-        QMutex *mutex = indexNew.mutexP;
-        mutex->lock();
+        // requests run in parallel on the scheduler threads, every request has its own sfRetrieval,
+        // so there is no need to serialize them with the common mutex anymore
 
         struct timeb now;
         QUrl url = QUrl(index_name);
@@ -86,6 +107,14 @@ public slots:
         ftime(&now);
         double endSeconds = (double) now.time + (double) now.millitm / (double)1000;
         double startSeconds = endSeconds - indexNew.secondsPast;
+        int secondsPast = indexNew.secondsPast;
+
+        // when zoomed, only the visible range is requested, at the resolution of the plot
+        if(indexNew.zoomed) {
+            startSeconds = indexNew.zoomStartSeconds;
+            endSeconds = qMin(indexNew.zoomEndSeconds, endSeconds);
+            secondsPast = (int) ((double) now.time + (double) now.millitm / (double)1000 - startSeconds) + 1;
+        }
 #ifdef CSV
         QString response ="'response':{'format':'csv'}";
 #else
@@ -105,18 +134,19 @@ public slots:
             isBinned = true;
             agg = tr(", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'nrOfBins' : %1}").arg(indexNew.nrOfBins);
         } else {
+            // one bin per pixel column of the plot, more can not be displayed anyway;
+            // plotWidth is never below DECIMATION_MIN_COLUMNS, so the former fixed PT1S binning is not needed anymore
             isBinned = true;
-            agg = ", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'durationPerBin' : 'PT1S'}";
-            //agg = "";
+            agg = tr(", 'aggregation': {'aggregationType':'value', 'aggregations':['min','mean','max'], 'nrOfBins' : %1}").arg(indexNew.plotWidth);
         }
         QString total = "{" + response + "," + range + "," + channels + "," + fields + agg + "}";
         total = total.replace("'", "\"");
         QByteArray json_str = total.toUtf8();
 
-        fromArchive = new sfRetrieval();
+        setArchive(new sfRetrieval());
 
         //qDebug() << "fromArchive pointer=" << fromArchive << indexNew.timeAxis;
-        bool readdata_ok=fromArchive->requestUrl(url, json_str, indexNew.secondsPast, isBinned, indexNew.timeAxis, key);
+        bool readdata_ok=fromArchive->requestUrl(url, json_str, secondsPast, isBinned, indexNew.timeAxis, key);
 
         if (fromArchive->is_Redirected()){
           url=QUrl(fromArchive->getRedirected_Url());
@@ -131,8 +161,8 @@ public slots:
           indexNew.w->setProperty("archiverIndex",QVariant(url.toString()));
           //qDebug()<< "archiv PV"<<indexNew.pv;
           fromArchive->deleteLater();
-          fromArchive = new sfRetrieval();
-          readdata_ok=fromArchive->requestUrl(url, json_str, indexNew.secondsPast, isBinned, indexNew.timeAxis, key);
+          setArchive(new sfRetrieval());
+          readdata_ok=fromArchive->requestUrl(url, json_str, secondsPast, isBinned, indexNew.timeAxis, key);
         }
 
         if(readdata_ok) {
@@ -162,8 +192,8 @@ public slots:
 
         emit resultReady(indexNew, nbVal, TimerN, YValsN, fromArchive->getBackend());
 
-        mutex->unlock();
         fromArchive->deleteLater();
+        setArchive((sfRetrieval *) Q_NULLPTR);
     }
 
 signals:
@@ -176,34 +206,6 @@ private:
 
 };
 
-class Q_DECL_EXPORT WorkerSfThread : public QThread
-{
-    Q_OBJECT
-
-public:
-    WorkerSfThread(WorkerSF *worker) {
-        pworker = worker;
-        //qDebug() << "myThread::myThread()";
-    }
-        //qDebug() << "myThread::~myThread()";
-    ~WorkerSfThread() {
-    }
-    WorkerSF *workersf() {
-        return pworker;
-    }
-
-    sfRetrieval *getArchive() {
-        if(pworker != (WorkerSF *) Q_NULLPTR) {
-            return pworker->getArchive();
-        } else {
-            return (sfRetrieval *) Q_NULLPTR;
-        }
-    }
-
-private:
-    WorkerSF *pworker;
-};
-
 class Q_DECL_EXPORT ArchiveSF_Plugin : public QObject, ControlsInterface
 {
     Q_OBJECT
@@ -237,7 +239,6 @@ public slots:
     void handleResults(indexes, int, QVector<double>, QVector<double>, QString);
 
 signals:
-    void operate(QWidget*, const indexes, const QString, MessageWindow *);
     void Signal_StopUpdateInterface();
 
 private slots:
@@ -250,7 +251,7 @@ private:
     MutexKnobData *mutexknobdataP;
     MessageWindow *messagewindowP;
     ArchiverCommon *archiverCommon;
-    QMap<QString, WorkerSfThread*> listOfThreads;
+    ArchiverScheduler *scheduler;
     bool suspend;
 };
 
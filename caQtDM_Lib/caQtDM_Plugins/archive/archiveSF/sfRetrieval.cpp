@@ -26,6 +26,7 @@
 #include <QApplication>
 #include <QNetworkAccessManager>
 #include <QSslConfiguration>
+#include <QThreadStorage>
 #include <iostream>
 #include <QFile>
 #include <QDir>
@@ -55,11 +56,22 @@
 #endif
 
 
+// one network access manager per worker thread, so the keep-alive connections to the data api are reused
+// by all requests running in the long living threads of the archive scheduler
+static QThreadStorage<QNetworkAccessManager *> threadNetworkManagers;
+
+static QNetworkAccessManager *threadNetworkManager()
+{
+    if(!threadNetworkManagers.hasLocalData()) threadNetworkManagers.setLocalData(new QNetworkAccessManager());
+    return threadNetworkManagers.localData();
+}
+
 sfRetrieval::sfRetrieval()
 {
     finished = false;
     intern_is_Redirected = false;
-    manager = new QNetworkAccessManager(this);
+    manager = threadNetworkManager();
+    reply = Q_NULLPTR;
     eventLoop = new QEventLoop(this);
     errorString = "";
     //qDebug() << QTime::currentTime().toString() << this << "constructor";
@@ -113,7 +125,8 @@ bool sfRetrieval::requestUrl(const QUrl url, const QByteArray &json, int seconds
 
     //qDebug() << "requesturl reply" << reply;
 
-    connect(manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(finishReply(QNetworkReply*)));
+    // the manager is shared within this thread, so only listen to our own reply
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
 
     finished = false;
     QTimer *timeoutHelper = new QTimer(this);
@@ -138,8 +151,8 @@ void sfRetrieval::cancelDownload()
     totalCount = 0;
     aborted = true;
 
-    disconnect(manager);
     if( reply != Q_NULLPTR ) {
+        disconnect(reply, 0, this, 0);
         //qDebug() << QTime::currentTime().toString() << this << PV << "!!!!!!!!!!!!!!!!! abort networkreply for";
         reply->abort();
         reply->deleteLater();
@@ -162,6 +175,12 @@ int sfRetrieval::downloadFinished()
     return finished;
 }
 
+void sfRetrieval::replyFinished()
+{
+    QNetworkReply *finishedReply = qobject_cast<QNetworkReply *>(sender());
+    if(finishedReply != Q_NULLPTR) finishReply(finishedReply);
+}
+
 void sfRetrieval::finishReply(QNetworkReply *reply)
 {
     if(aborted) return;
@@ -68,6 +68,7 @@ signals:
     void requestFinished();
 
 protected slots:
+    void replyFinished();
     void finishReply(QNetworkReply*);
     const QString parseError(QNetworkReply::NetworkError error);
     int downloadFinished();
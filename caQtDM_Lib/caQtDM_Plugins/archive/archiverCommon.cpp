@@ -23,6 +23,7 @@
  *    anton.mezger@psi.ch
  */
 #include "archiverCommon.h"
+#include "archiverDecimation.h"
 #include <QApplication>
 #include <QDebug>
 #include <QThread>
@@ -30,6 +31,38 @@
 #define SECONDSSLEEP 3600   // 1 hour
 #define SECONDSTIMEOUT 60.5 // 1 minute
 
+// points per second needed by the plot of this index
+static double seriesResolution(const indexes &index)
+{
+    int columns = (index.nrOfBins > 0) ? index.nrOfBins : index.plotWidth;
+    return (double) columns / (double) qMax(index.secondsPast, 1);
+}
+
+// returns the first point of a series in the time range of the given index, age is the time in seconds since the series was stored.
+// the series is sorted by time, so the points older than the range are all at its start and a view is given by the offset alone
+static int seriesStart(const QVector<double> &XVals, int count, const indexes &index, double nowSeconds, double age)
+{
+    int first = 0;
+    int last = count;
+    while (first < last) {
+        int middle = first + (last - first) / 2;
+        double x = XVals.at(middle);
+        bool older;
+        // x is given in milliseconds since epoch for a time axis, otherwise in hours relative to the time it was stored
+        if (index.timeAxis) {
+            older = x < (nowSeconds - index.secondsPast) * 1000.0;
+        } else {
+            older = x - age / 3600.0 < -index.secondsPast / 3600.0;
+        }
+        if (older) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
 // constructor
 ArchiverCommon::ArchiverCommon()
 {
@@ -84,6 +117,8 @@ void ArchiverCommon::updateInterface()
         //QDebug() << (__FILE__) << ":" << (__LINE__) << "|" << i.key() << diff << indexNew.updateSeconds;
         if (diff >= indexNew.updateSeconds) {
             ftime(&indexNew.lastUpdateTime);
+            // the number of pixel columns is used by the workers to limit the amount of data requested and plotted
+            indexNew.plotWidth = ArchiverDecimation::plotWidth(indexNew.w);
             listOfIndexes.insert(i.key(), indexNew);
             listOfIndexesToBeExecuted.insert(i.key(), indexNew);
         }
@@ -95,7 +130,7 @@ void ArchiverCommon::updateInterface()
     if (listOfIndexesToBeExecuted.count() > 0) {
         emit Signal_UpdateInterface(listOfIndexesToBeExecuted);
 
-        // and set the init field of index to false
+        // and set the init field of index to false, fullReload only for the indexes just executed
         QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
         while (i != listOfIndexes.constEnd()) {
             indexes indexNew = i.value();
@@ -103,6 +138,10 @@ void ArchiverCommon::updateInterface()
                 indexNew.init = false;
                 listOfIndexes.insert(i.key(), indexNew);
             }
+            if (indexNew.fullReload && listOfIndexesToBeExecuted.contains(i.key())) {
+                indexNew.fullReload = false;
+                listOfIndexes.insert(i.key(), indexNew);
+            }
             ++i;
         }
     }
@@ -213,7 +252,17 @@ int ArchiverCommon::pvAddMonitor(int index, knobData *kData, int rate, int skip)
             } else {
                 index.timeAxis = false;
             }
+            // when the user zooms, only the visible range has to be requested again
+            connect(ww, SIGNAL(zoomedToRect(QRectF)), this, SLOT(Callback_ZoomedToRect(QRectF)), Qt::UniqueConnection);
+            connect(ww, SIGNAL(zoomHasReset()), this, SLOT(Callback_ZoomHasReset()), Qt::UniqueConnection);
         }
+        index.plotWidth = DECIMATION_MIN_COLUMNS;
+        index.zoomed = false;
+        index.zoomStartSeconds = index.zoomEndSeconds = 0.0;
+        index.fullReload = false;
+        index.nrOfBins = -1;
+        index.backend = "";
+        index.seriesKey = "";
         if (!alreadyProcessedIndexes.contains(key) && !alreadyProcessedIndexes.contains(possibleXKeyForMinY) && !alreadyProcessedIndexes.contains(possibleXKeyForMaxY)) {
             alreadyProcessedIndexes.insert(key, index);
         } else if (!listOfIndexes.contains(key) && !listOfIndexes.contains(possibleXKeyForMinY) && !listOfIndexes.contains(possibleXKeyForMaxY)) {
@@ -262,6 +311,31 @@ int ArchiverCommon::pvAddMonitor(int index, knobData *kData, int rate, int skip)
     return true;
 }
 
+void ArchiverCommon::Callback_ZoomedToRect(const QRectF &rect)
+{
+    QWidget *w = qobject_cast<QWidget *>(sender());
+    if (w == (QWidget *) Q_NULLPTR) {
+        return;
+    }
+
+    QMutexLocker locker(&m_globalMutex);
+    struct timeb now;
+    ftime(&now);
+    double nowSeconds = (double) now.time + (double) now.millitm / (double) 1000;
+    ArchiverDecimation::zoomToRect(listOfIndexes, w, rect, nowSeconds);
+}
+
+void ArchiverCommon::Callback_ZoomHasReset()
+{
+    QWidget *w = qobject_cast<QWidget *>(sender());
+    if (w == (QWidget *) Q_NULLPTR) {
+        return;
+    }
+
+    QMutexLocker locker(&m_globalMutex);
+    ArchiverDecimation::resetZoom(listOfIndexes, w);
+}
+
 void ArchiverCommon::updateSecondsPast(indexes indexNew, bool original)
 {
     QMutexLocker locker(&m_globalMutex);
@@ -286,7 +360,7 @@ void ArchiverCommon::updateSecondsPast(indexes indexNew, bool original)
 }
 
 void ArchiverCommon::updateCartesian(
-    int nbVal, indexes indexNew, QVector<double> XValsN, QVector<double> YValsN, QString backend)
+    int nbVal, indexes indexNew, QVector<double> XValsN, QVector<double> YValsN, QString backend, int first, double xShift)
 {
     QMutexLocker locker(&m_globalMutex);
     //qDebug() << (__FILE__) << ":" << (__LINE__) << "|" << "ArchiverCommon::updateCartesian";
@@ -309,7 +383,15 @@ void ArchiverCommon::updateCartesian(
             kData.edata.dataB = (void *) malloc(nbVal * sizeof(double));
             kData.edata.dataSize = nbVal * sizeof(double);
         }
-        memcpy(kData.edata.dataB, &XValsN[0], nbVal * sizeof(double));
+        // constData does not detach the vectors, which may be shared with a stored series
+        if (xShift == 0.0) {
+            memcpy(kData.edata.dataB, XValsN.constData() + first, nbVal * sizeof(double));
+        } else {
+            double *x = (double *) kData.edata.dataB;
+            for (int i = 0; i < nbVal; i++) {
+                x[i] = XValsN.at(first + i) - xShift;
+            }
+        }
         kData.edata.valueCount = nbVal;
         mutexknobdataP->SetMutexKnobDataReceived(&kData);
         mutexknobdataP->DataUnlock(&kData);
@@ -331,13 +413,212 @@ void ArchiverCommon::updateCartesian(
             kData.edata.dataB = (void *) malloc(nbVal * sizeof(double));
             kData.edata.dataSize = nbVal * sizeof(double);
         }
-        memcpy(kData.edata.dataB, &YValsN[0], nbVal * sizeof(double));
+        memcpy(kData.edata.dataB, YValsN.constData() + first, nbVal * sizeof(double));
         kData.edata.valueCount = nbVal;
         mutexknobdataP->SetMutexKnobDataReceived(&kData);
         mutexknobdataP->DataUnlock(&kData);
     }
 }
 
+bool ArchiverCommon::requestSeries(const QString &source, indexes &indexNew)
+{
+    // a zoomed plot requests its own time range, this is not shared
+    if (indexNew.zoomed) {
+        indexNew.seriesKey = "";
+        return true;
+    }
+
+    QMutexLocker locker(&m_seriesMutex);
+    struct timeb now;
+    ftime(&now);
+    double nowSeconds = (double) now.time + (double) now.millitm / (double) 1000;
+    double resolution = seriesResolution(indexNew);
+
+    // the time range is not part of the key, a shorter range is served as a view on a longer series
+    indexNew.seriesKey = QString("%1|%2|%3|%4|%5").arg(source, indexNew.backend, indexNew.pv).arg(indexNew.nrOfBins).arg(indexNew.timeAxis);
+    archiveSeries &series = listOfSeries[indexNew.seriesKey];
+    if (series.subscribers.isEmpty()) {
+        series.storedAt = 0.0;
+        series.secondsPast = 0;
+        series.resolution = 0.0;
+        series.requestSecondsPast = 0;
+        series.requestResolution = 0.0;
+    }
+    if (!series.subscribers.contains(indexNew.key)) {
+        series.subscribers.append(indexNew.key);
+    }
+
+    // a running retrieval covers our range, so wait for its result
+    if (!series.requestKey.isEmpty() && series.requestKey != indexNew.key && series.requestSecondsPast >= indexNew.secondsPast
+        && series.requestResolution >= resolution) {
+        for (int i = 0; i < series.waiting.count(); i++) {
+            if (series.waiting.at(i).key == indexNew.key) {
+                return false;
+            }
+        }
+        series.waiting.append(indexNew);
+        return false;
+    }
+
+    // the stored series is recent enough and covers our range, so take a view on it
+    double age = nowSeconds - series.storedAt;
+    if (series.storedAt > 0.0 && age < indexNew.updateSeconds && series.secondsPast >= indexNew.secondsPast + age
+        && series.resolution >= resolution) {
+        pendingViews.append(indexNew);
+        // we are called while the interface is updated, so the data is delivered afterwards
+        QMetaObject::invokeMethod(this, "deliverSeriesViews", Qt::QueuedConnection);
+        return false;
+    }
+
+    if (series.requestKey.isEmpty()) {
+        series.requestKey = indexNew.key;
+        series.requestSecondsPast = indexNew.secondsPast;
+        series.requestResolution = resolution;
+    }
+    return true;
+}
+
+QList<indexes> ArchiverCommon::finishSeries(indexes indexNew, int nbVal, QVector<double> XValsN, QVector<double> YValsN, QString backend)
+{
+    QList<indexes> served;
+    QList<indexes> waiting;
+    struct timeb now;
+    ftime(&now);
+    double nowSeconds = (double) now.time + (double) now.millitm / (double) 1000;
+
+    if (indexNew.seriesKey.isEmpty()) {
+        served.append(indexNew);
+    } else {
+        QMutexLocker locker(&m_seriesMutex);
+        QMap<QString, archiveSeries>::iterator i = listOfSeries.find(indexNew.seriesKey);
+        if (i == listOfSeries.end()) {
+            // all plots using this series are gone
+            return served;
+        }
+        archiveSeries &series = i.value();
+        if (series.requestKey == indexNew.key) {
+            waiting = series.waiting;
+            series.waiting.clear();
+            series.requestKey = "";
+        }
+
+        // keep the longer series unless it is outdated
+        if (nbVal > 0 && (indexNew.secondsPast >= series.secondsPast || nowSeconds - series.storedAt >= indexNew.updateSeconds)) {
+            series.XVals = XValsN.mid(0, nbVal);
+            series.YVals = YValsN.mid(0, nbVal);
+            series.backend = backend;
+            series.storedAt = nowSeconds;
+            series.secondsPast = indexNew.secondsPast;
+            series.resolution = seriesResolution(indexNew);
+        }
+
+        if (series.subscribers.contains(indexNew.key)) {
+            served.append(indexNew);
+        }
+        for (int j = 0; j < waiting.count(); j++) {
+            if (series.subscribers.contains(waiting.at(j).key)) {
+                served.append(waiting.at(j));
+            }
+        }
+    }
+
+    // the data is passed on without holding the series mutex, as updateCartesian takes the global mutex
+    for (int j = 0; j < served.count(); j++) {
+        if (nbVal <= 0) {
+            continue;
+        }
+        if (served.at(j).key == indexNew.key) {
+            updateCartesian(nbVal, indexNew, XValsN, YValsN, backend);
+        } else {
+            // a shorter range is the tail of the result
+            int first = seriesStart(XValsN, nbVal, served.at(j), nowSeconds, 0.0);
+            updateCartesian(nbVal - first, served.at(j), XValsN, YValsN, backend, first);
+        }
+    }
+    return served;
+}
+
+void ArchiverCommon::deliverSeriesViews()
+{
+    QList<indexes> views;
+    {
+        QMutexLocker locker(&m_seriesMutex);
+        views = pendingViews;
+        pendingViews.clear();
+    }
+
+    struct timeb now;
+    ftime(&now);
+    double nowSeconds = (double) now.time + (double) now.millitm / (double) 1000;
+
+    for (int i = 0; i < views.count(); i++) {
+        QVector<double> XVals, YVals;
+        QString backend;
+        double storedAt;
+        {
+            QMutexLocker locker(&m_seriesMutex);
+            QMap<QString, archiveSeries>::const_iterator j = listOfSeries.constFind(views.at(i).seriesKey);
+            if (j == listOfSeries.constEnd() || !j.value().subscribers.contains(views.at(i).key)) {
+                continue;
+            }
+            // the vectors are implicitly shared, so no data is copied here
+            XVals = j.value().XVals;
+            YVals = j.value().YVals;
+            backend = j.value().backend;
+            storedAt = j.value().storedAt;
+        }
+        // the plot gets the tail of the series covering its range, the relative time axis moved by the age of the series
+        double age = nowSeconds - storedAt;
+        int count = qMin(XVals.count(), YVals.count());
+        int first = seriesStart(XVals, count, views.at(i), nowSeconds, age);
+        int nbVal = count - first;
+        updateCartesian(nbVal, views.at(i), XVals, YVals, backend, first, views.at(i).timeAxis ? 0.0 : age / 3600.0);
+    }
+}
+
+bool ArchiverCommon::releaseSeries(const QString &key, QStringList &orphanedRequests)
+{
+    QMutexLocker locker(&m_seriesMutex);
+    bool keepRequest = false;
+
+    for (int i = pendingViews.count() - 1; i >= 0; i--) {
+        if (pendingViews.at(i).key == key) {
+            pendingViews.removeAt(i);
+        }
+    }
+
+    QMap<QString, archiveSeries>::iterator i = listOfSeries.begin();
+    while (i != listOfSeries.end()) {
+        archiveSeries &series = i.value();
+        series.subscribers.removeAll(key);
+        for (int j = series.waiting.count() - 1; j >= 0; j--) {
+            if (series.waiting.at(j).key == key) {
+                series.waiting.removeAt(j);
+            }
+        }
+
+        if (!series.requestKey.isEmpty()) {
+            if (!series.waiting.isEmpty()) {
+                // the retrieval is still needed by the waiting plots
+                if (series.requestKey == key) {
+                    keepRequest = true;
+                }
+            } else if (series.requestKey == key || !series.subscribers.contains(series.requestKey)) {
+                // nobody needs the result of this retrieval anymore
+                orphanedRequests.append(series.requestKey);
+                series.requestKey = "";
+            }
+        }
+
+        if (series.subscribers.isEmpty() && series.requestKey.isEmpty()) {
+            i = listOfSeries.erase(i);
+        } else {
+            ++i;
+        }
+    }
+    return keepRequest;
+}
+
 // caQtDM_Lib will call this routine for getting rid of a monitor
 int ArchiverCommon::pvClearMonitor(knobData *kData)
 {
@@ -374,11 +655,24 @@ int ArchiverCommon::pvClearMonitor(knobData *kData)
             }
         }
         if (found) {
+            // a retrieval other plots are waiting for is kept running
+            bool keepRequest = false;
+            QStringList orphanedRequests;
             for (int i = 0; i < removeKeys.count(); i++) {
                 listOfIndexes.remove(removeKeys.at(i));
                 alreadyProcessedIndexes.remove(removeKeys.at(i));
+                if (releaseSeries(removeKeys.at(i), orphanedRequests)) {
+                    keepRequest = true;
+                }
+            }
+            if (!keepRequest) {
+                emit Signal_AbortOutstandingRequests(key);
+            }
+            for (int i = 0; i < orphanedRequests.count(); i++) {
+                if (orphanedRequests.at(i) != key) {
+                    emit Signal_AbortOutstandingRequests(orphanedRequests.at(i));
+                }
             }
-            emit Signal_AbortOutstandingRequests(key);
         }
     }
 
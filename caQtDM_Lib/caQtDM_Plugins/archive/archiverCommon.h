@@ -29,8 +29,10 @@
 #include <QMap>
 #include <QMutex>
 #include <QObject>
+#include <QStringList>
 #include <QThread>
 #include <QTimer>
+#include <QVector>
 #include "MessageWindow.h"
 #include "cacartesianplot.h"
 #include "mutexKnobData.h"
@@ -52,6 +54,12 @@ struct indexes
     QString backend;
     int updateSecondsOrig;
     bool timeAxis;
+    int plotWidth;           // width of the plot canvas in pixels, used to decimate the data
+    bool zoomed;             // plot is zoomed, only the zoomed time range is requested
+    double zoomStartSeconds; // start of the zoomed range in seconds since epoch
+    double zoomEndSeconds;   // end of the zoomed range in seconds since epoch
+    bool fullReload;         // set when the whole range has to be requested again, e.g. after a zoom reset
+    QString seriesKey;       // shared series this index is retrieved for, empty when the retrieval is not shared
 };
 #define CHAR_ARRAY_LENGTH 200
 
@@ -72,12 +80,24 @@ public:
     int pvClearEvent(void *ptr);
     int pvAddEvent(void *ptr);
     int TerminateIO() { return true; }
+    // passes nbVal points from first on to the plot, xShift is subtracted from the x values
     void updateCartesian(int nbVal,
                          indexes indexNew,
                          QVector<double> XValsN,
                          QVector<double> YValsN,
-                         QString backend);
+                         QString backend,
+                         int first = 0,
+                         double xShift = 0.0);
     void updateSecondsPast(indexes indexNew, bool original);
+
+    // Plots showing the same channel from the same source share one retrieval and one series in memory.
+    // Returns true if a retrieval has to be scheduled for this index, otherwise the index waits for a running
+    // retrieval or gets a view on the stored series. source identifies the archive, e.g. its url or index file.
+    bool requestSeries(const QString &source, indexes &indexNew);
+
+    // Stores the result of a retrieval and passes it to all indexes waiting for it.
+    // Returns the indexes that got the result, including indexNew unless it was removed in the meantime.
+    QList<indexes> finishSeries(indexes indexNew, int nbVal, QVector<double> XValsN, QVector<double> YValsN, QString backend);
     QTimer *timer;
 
     QMutex* globalMutex();
@@ -90,8 +110,28 @@ signals:
 private slots:
     void updateInterface();
     void stopUpdateInterface();
+    void Callback_ZoomedToRect(const QRectF &rect);
+    void Callback_ZoomHasReset();
+    void deliverSeriesViews();
 
 private:
+    typedef struct
+    {
+        QVector<double> XVals;   // x in plot units, as delivered by the retrieval
+        QVector<double> YVals;
+        QString backend;
+        double storedAt;         // seconds since epoch when the series was stored, 0 if nothing is stored yet
+        int secondsPast;         // time range covered by the stored series
+        double resolution;       // points per second the stored series was retrieved for
+        QString requestKey;      // index whose retrieval is running for this series, empty if none
+        int requestSecondsPast;
+        double requestResolution;
+        QStringList subscribers; // indexes using this series, the series is removed with the last one
+        QList<indexes> waiting;  // indexes waiting for the running retrieval
+    } archiveSeries;
+
+    bool releaseSeries(const QString &key, QStringList &orphanedRequests);
+
     typedef struct
     {
         char Dev[40];
@@ -104,6 +144,10 @@ private:
     QMap<QString, indexes> listOfIndexes;
     QMap<QString, indexes> alreadyProcessedIndexes; // used to prevent Indexes from being processed twice
 
+    QMutex m_seriesMutex;                 // protects the shared series, never held while taking m_globalMutex
+    QMap<QString, archiveSeries> listOfSeries;
+    QList<indexes> pendingViews;          // indexes to be served from a stored series
+
     bool timerRunning;
 };
 
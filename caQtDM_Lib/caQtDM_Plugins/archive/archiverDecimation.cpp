@@ -0,0 +1,114 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#include "archiverDecimation.h"
+#include "cacartesianplot.h"
+#include <QtNumeric>
+#include <math.h>
+
+int ArchiverDecimation::plotWidth(QWidget *w)
+{
+    int width = 0;
+    if (caCartesianPlot *plot = qobject_cast<caCartesianPlot *>(w)) {
+        width = plot->canvas()->width();
+    } else if (w != (QWidget *) Q_NULLPTR) {
+        width = w->width();
+    }
+    return qMax(width, DECIMATION_MIN_COLUMNS);
+}
+
+int ArchiverDecimation::decimateM4(double *x, double *y, int count, double xStart, double xEnd, int columns)
+{
+    // Nothing to gain if there are not more points than we would emit anyway
+    if (columns < 1 || count <= 4 * columns || !(xEnd > xStart)) {
+        return count;
+    }
+
+    const double columnWidth = (xEnd - xStart) / (double) columns;
+    int written = 0;
+    int i = 0;
+
+    // The output is written into the same arrays. This is safe because every column emits at most as many points
+    // as it consumed and the emitted points are written in ascending order, so we never overwrite an unread point.
+    while (i < count) {
+        // A point without valid x can not be assigned to a column, so keep it as it is.
+        if (qIsNaN(x[i])) {
+            x[written] = x[i];
+            y[written] = y[i];
+            written++;
+            i++;
+            continue;
+        }
+
+        const double column = floor((x[i] - xStart) / columnWidth);
+        const int first = i;
+        int last = i;
+        int minIndex = -1;
+        int maxIndex = -1;
+
+        while (i < count && !qIsNaN(x[i]) && floor((x[i] - xStart) / columnWidth) == column) {
+            if (!qIsNaN(y[i])) {
+                if (minIndex < 0 || y[i] < y[minIndex]) {
+                    minIndex = i;
+                }
+                if (maxIndex < 0 || y[i] > y[maxIndex]) {
+                    maxIndex = i;
+                }
+            }
+            last = i;
+            i++;
+        }
+
+        // Collect first, min, max and last in ascending order without duplicates
+        int keep[4];
+        int nbKeep = 0;
+        int candidates[4] = {first, qMin(minIndex, maxIndex), qMax(minIndex, maxIndex), last};
+        for (int j = 0; j < 4; j++) {
+            if (candidates[j] < 0) {
+                continue;
+            }
+            if (nbKeep > 0 && candidates[j] <= keep[nbKeep - 1]) {
+                continue;
+            }
+            keep[nbKeep++] = candidates[j];
+        }
+
+        for (int j = 0; j < nbKeep; j++) {
+            x[written] = x[keep[j]];
+            y[written] = y[keep[j]];
+            written++;
+        }
+    }
+
+    return written;
+}
+
+int ArchiverDecimation::cropToRange(double *x, double *y, int count, double xStart, double xEnd)
+{
+    int written = 0;
+    for (int i = 0; i < count; i++) {
+        if (x[i] >= xStart && x[i] <= xEnd) {
+            x[written] = x[i];
+            y[written] = y[i];
+            written++;
+        }
+    }
+    return written;
+}
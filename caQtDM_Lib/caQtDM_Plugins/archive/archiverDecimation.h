@@ -0,0 +1,111 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#ifndef ARCHIVERDECIMATION_H
+#define ARCHIVERDECIMATION_H
+
+#include <QMap>
+#include <QRectF>
+#include <QStringList>
+#include <QWidget>
+
+// lower bound for the number of pixel columns, used when the widget is not yet laid out
+#define DECIMATION_MIN_COLUMNS 100
+
+class Q_DECL_EXPORT ArchiverDecimation
+{
+public:
+    /*
+     * Returns the width in pixels of the plot canvas of the given caCartesianPlot, or the widget width otherwise.
+     * Must be called from the GUI thread.
+     * */
+    static int plotWidth(QWidget *w);
+
+    /*
+     * Reduces the monotonic series x/y in place to the first, minimum, maximum and last point (M4) of every pixel column,
+     * where the range xStart to xEnd is split into the given number of columns. Columns outside this range are reduced
+     * with the same column width. Returns the new number of points, which is at most 4 points per column.
+     * */
+    static int decimateM4(double *x, double *y, int count, double xStart, double xEnd, int columns);
+
+    /*
+     * Removes all points with x outside of xStart to xEnd in place and returns the new number of points.
+     * */
+    static int cropToRange(double *x, double *y, int count, double xStart, double xEnd);
+
+    /*
+     * Marks all indexes of the plot w as zoomed to rect, given in the units of the X axis (milliseconds since epoch
+     * for a time axis, otherwise hours relative to now), and forces their update at the next timer tick.
+     * Templated on the index struct, as ArchiverCommon and ArchiverGeneral each define their own.
+     * Returns the keys of the changed indexes. The caller holds the mutex of the list.
+     * */
+    template <typename Index>
+    static QStringList zoomToRect(QMap<QString, Index> &listOfIndexes, QWidget *w, const QRectF &rect, double nowSeconds)
+    {
+        QStringList keys;
+        typename QMap<QString, Index>::iterator i = listOfIndexes.begin();
+        while (i != listOfIndexes.end()) {
+            Index &index = i.value();
+            if (index.w == w) {
+                double startSeconds, endSeconds;
+                if (index.timeAxis) {
+                    startSeconds = rect.left() / 1000.0;
+                    endSeconds = rect.right() / 1000.0;
+                } else {
+                    startSeconds = nowSeconds + rect.left() * 3600.0;
+                    endSeconds = nowSeconds + rect.right() * 3600.0;
+                }
+                if (endSeconds > startSeconds) {
+                    index.zoomStartSeconds = startSeconds;
+                    index.zoomEndSeconds = endSeconds;
+                    index.zoomed = true;
+                    index.lastUpdateTime.time = 0;
+                    keys.append(i.key());
+                }
+            }
+            ++i;
+        }
+        return keys;
+    }
+
+    /*
+     * Resets the zoom of all indexes of the plot w, their whole range is requested again at the next timer tick.
+     * Returns the keys of the changed indexes. The caller holds the mutex of the list.
+     * */
+    template <typename Index>
+    static QStringList resetZoom(QMap<QString, Index> &listOfIndexes, QWidget *w)
+    {
+        QStringList keys;
+        typename QMap<QString, Index>::iterator i = listOfIndexes.begin();
+        while (i != listOfIndexes.end()) {
+            Index &index = i.value();
+            if (index.w == w) {
+                index.zoomed = false;
+                index.fullReload = true;
+                index.lastUpdateTime.time = 0;
+                keys.append(i.key());
+            }
+            ++i;
+        }
+        return keys;
+    }
+};
+
+#endif // ARCHIVERDECIMATION_H
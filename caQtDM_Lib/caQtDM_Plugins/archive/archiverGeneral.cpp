@@ -29,6 +29,7 @@
  */
 
 #include "archiverGeneral.h"
+#include "archiverDecimation.h"
 #include "QtWidgets/qapplication.h"
 #include <QApplication>
 #include <QDebug>
@@ -90,6 +91,8 @@ void ArchiverGeneral::updateInterface()
         //QDebug() << (__FILE__) << ":" << (__LINE__) << "|" << i.key() << diff << indexNew.updateSeconds;
         if (diff >= indexNew.updateSeconds) {
             ftime(&indexNew.lastUpdateTime);
+            // the number of pixel columns is used by the workers to limit the amount of data requested and plotted
+            indexNew.plotWidth = ArchiverDecimation::plotWidth(indexNew.w);
             listOfIndexes.insert(i.key(), indexNew);
             listOfIndexesToBeExecuted.insert(i.key(), indexNew);
         }
@@ -101,7 +104,7 @@ void ArchiverGeneral::updateInterface()
     if (listOfIndexesToBeExecuted.count() > 0) {
         emit Signal_UpdateInterface(listOfIndexesToBeExecuted);
 
-        // and set the init field of index to false
+        // and set the init field of index to false, fullReload only for the indexes just executed
         QMap<QString, indexes>::const_iterator i = listOfIndexes.constBegin();
         while (i != listOfIndexes.constEnd()) {
             indexes indexNew = i.value();
@@ -109,6 +112,10 @@ void ArchiverGeneral::updateInterface()
                 indexNew.init = false;
                 listOfIndexes.insert(i.key(), indexNew);
             }
+            if (indexNew.fullReload && listOfIndexesToBeExecuted.contains(i.key())) {
+                indexNew.fullReload = false;
+                listOfIndexes.insert(i.key(), indexNew);
+            }
             ++i;
         }
     }
@@ -218,7 +225,14 @@ int ArchiverGeneral::pvAddMonitor(int index, knobData *kData, int rate, int skip
             } else {
                 index.timeAxis = false;
             }
+            // when the user zooms, only the visible range has to be requested again
+            connect(ww, SIGNAL(zoomedToRect(QRectF)), this, SLOT(Callback_ZoomedToRect(QRectF)), Qt::UniqueConnection);
+            connect(ww, SIGNAL(zoomHasReset()), this, SLOT(Callback_ZoomHasReset()), Qt::UniqueConnection);
         }
+        index.plotWidth = DECIMATION_MIN_COLUMNS;
+        index.zoomed = false;
+        index.zoomStartSeconds = index.zoomEndSeconds = 0.0;
+        index.fullReload = false;
         if (!alreadyProcessedIndexes.contains(key) && !alreadyProcessedIndexes.contains(possibleXKeyForMinY) && !alreadyProcessedIndexes.contains(possibleXKeyForMaxY)) {
             // The first time a channel for a curve is added, it will be stored here
             alreadyProcessedIndexes.insert(key, index);
@@ -270,6 +284,38 @@ int ArchiverGeneral::pvAddMonitor(int index, knobData *kData, int rate, int skip
     return true;
 }
 
+void ArchiverGeneral::Callback_ZoomedToRect(const QRectF &rect)
+{
+    QWidget *w = qobject_cast<QWidget *>(sender());
+    if (w == (QWidget *) Q_NULLPTR) {
+        return;
+    }
+
+    QMutexLocker locker(&m_globalMutex);
+    struct timeb now;
+    ftime(&now);
+    double nowSeconds = (double) now.time + (double) now.millitm / (double) 1000;
+    // a load of the previous range is not needed anymore
+    const QStringList keys = ArchiverDecimation::zoomToRect(listOfIndexes, w, rect, nowSeconds);
+    for (int i = 0; i < keys.count(); i++) {
+        emit Signal_AbortOutstandingRequests(keys.at(i));
+    }
+}
+
+void ArchiverGeneral::Callback_ZoomHasReset()
+{
+    QWidget *w = qobject_cast<QWidget *>(sender());
+    if (w == (QWidget *) Q_NULLPTR) {
+        return;
+    }
+
+    QMutexLocker locker(&m_globalMutex);
+    const QStringList keys = ArchiverDecimation::resetZoom(listOfIndexes, w);
+    for (int i = 0; i < keys.count(); i++) {
+        emit Signal_AbortOutstandingRequests(keys.at(i));
+    }
+}
+
 void ArchiverGeneral::updateSecondsPast(indexes indexNew, bool original)
 {
     QMutexLocker locker(&m_globalMutex);
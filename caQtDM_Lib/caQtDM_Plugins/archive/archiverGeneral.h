@@ -58,6 +58,11 @@ struct indexes
     QString backend;
     int updateSecondsOrig;
     bool timeAxis;
+    int plotWidth;           // width of the plot canvas in pixels, used to decimate the data
+    bool zoomed;             // plot is zoomed, only the zoomed time range is requested
+    double zoomStartSeconds; // start of the zoomed range in seconds since epoch
+    double zoomEndSeconds;   // end of the zoomed range in seconds since epoch
+    bool fullReload;         // set when the whole range has to be requested again, e.g. after a zoom reset
 };
 #define CHAR_ARRAY_LENGTH 200
 
@@ -96,6 +101,8 @@ signals:
 private slots:
     void updateInterface();
     void stopUpdateInterface();
+    void Callback_ZoomedToRect(const QRectF &rect);
+    void Callback_ZoomHasReset();
 
 private:
     typedef struct
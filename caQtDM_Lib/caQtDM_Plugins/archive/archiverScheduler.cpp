@@ -0,0 +1,177 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#include "archiverScheduler.h"
+#include <QDebug>
+
+ArchiverScheduler::ArchiverScheduler(QObject *parent) : QObject(parent)
+{
+    bool ok = false;
+    m_maxThreads = qgetenv("CAQTDM_ARCHIVE_MAXTHREADS").toInt(&ok);
+    if (!ok || m_maxThreads < 1) {
+        m_maxThreads = ARCHIVE_DEFAULT_THREADS;
+    }
+}
+
+ArchiverScheduler::~ArchiverScheduler()
+{
+    for (int i = 0; i < m_pendingJobs.count(); i++) {
+        delete m_pendingJobs.at(i).job;
+    }
+    m_pendingJobs.clear();
+
+    QMultiMap<QString, ArchiverJob *>::const_iterator i = m_runningJobs.constBegin();
+    while (i != m_runningJobs.constEnd()) {
+        i.value()->cancel();
+        ++i;
+    }
+
+    // Running requests were told to cancel, so they return soon. Their threads are waited for,
+    // destroying a running thread would abort the application.
+    for (int i = 0; i < m_threads.count(); i++) {
+        QThread *thread = m_threads.at(i);
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+
+    // the jobs whose jobDone was not handled any more, their threads are gone
+    QMap<ArchiverJob *, QThread *>::const_iterator j = m_jobThreads.constBegin();
+    while (j != m_jobThreads.constEnd()) {
+        delete j.key();
+        ++j;
+    }
+}
+
+int ArchiverScheduler::priority(QWidget *w, int secondsPast)
+{
+    int priority = 0;
+    if (w != (QWidget *) 0 && w->isVisible() && !w->visibleRegion().isEmpty()) {
+        priority += ARCHIVE_PRIORITY_VISIBLE;
+    }
+    // the shorter the window, the faster the request and the more likely the user is looking at recent data
+    priority += qMax(0, ARCHIVE_PRIORITY_VISIBLE - 1 - secondsPast / 60);
+    return priority;
+}
+
+void ArchiverScheduler::schedule(const QString &key, int priority, ArchiverJob *job)
+{
+    pendingJob pending;
+    pending.key = key;
+    pending.priority = priority;
+    pending.job = job;
+
+    // keep the queue sorted by priority, jobs with equal priority are executed in the order they were scheduled
+    int position = m_pendingJobs.count();
+    for (int i = 0; i < m_pendingJobs.count(); i++) {
+        if (m_pendingJobs.at(i).priority < priority) {
+            position = i;
+            break;
+        }
+    }
+    m_pendingJobs.insert(position, pending);
+
+    dispatch();
+}
+
+bool ArchiverScheduler::isScheduled(const QString &key) const
+{
+    if (m_runningJobs.contains(key)) {
+        return true;
+    }
+    for (int i = 0; i < m_pendingJobs.count(); i++) {
+        if (m_pendingJobs.at(i).key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ArchiverScheduler::cancel(const QString &key)
+{
+    bool removed = false;
+    for (int i = m_pendingJobs.count() - 1; i >= 0; i--) {
+        if (m_pendingJobs.at(i).key == key) {
+            // the job was never moved to a worker thread, so it can be deleted right away
+            delete m_pendingJobs.at(i).job;
+            m_pendingJobs.removeAt(i);
+            removed = true;
+        }
+    }
+
+    // every job still running for the key, also the ones cancelled before
+    QList<ArchiverJob *> running = m_runningJobs.values(key);
+    for (int i = 0; i < running.count(); i++) {
+        running.at(i)->cancel();
+    }
+
+    return removed;
+}
+
+void ArchiverScheduler::jobDone()
+{
+    ArchiverJob *job = qobject_cast<ArchiverJob *>(sender());
+    if (job == (ArchiverJob *) 0) {
+        return;
+    }
+
+    QMultiMap<QString, ArchiverJob *>::iterator i = m_runningJobs.begin();
+    while (i != m_runningJobs.end()) {
+        if (i.value() == job) {
+            i = m_runningJobs.erase(i);
+        } else {
+            ++i;
+        }
+    }
+
+    QThread *thread = m_jobThreads.take(job);
+    if (thread != (QThread *) 0) {
+        m_idleThreads.append(thread);
+    }
+
+    // the job lives in the worker thread, so let it be deleted there
+    job->deleteLater();
+
+    dispatch();
+}
+
+void ArchiverScheduler::dispatch()
+{
+    while (!m_pendingJobs.isEmpty()) {
+        QThread *thread;
+        if (!m_idleThreads.isEmpty()) {
+            thread = m_idleThreads.takeFirst();
+        } else if (m_threads.count() < m_maxThreads) {
+            thread = new QThread;
+            thread->start();
+            m_threads.append(thread);
+        } else {
+            return;
+        }
+
+        pendingJob pending = m_pendingJobs.takeFirst();
+        m_runningJobs.insert(pending.key, pending.job);
+        m_jobThreads.insert(pending.job, thread);
+
+        pending.job->moveToThread(thread);
+        connect(pending.job, SIGNAL(jobDone()), this, SLOT(jobDone()), Qt::QueuedConnection);
+        QMetaObject::invokeMethod(pending.job, "start", Qt::QueuedConnection);
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#ifndef ARCHIVERSCHEDULER_H
+#define ARCHIVERSCHEDULER_H
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QThread>
+#include <QWidget>
+
+// number of worker threads used when the environment variable CAQTDM_ARCHIVE_MAXTHREADS is not set
+#define ARCHIVE_DEFAULT_THREADS 4
+// priority bonus for requests of plots that are currently visible
+#define ARCHIVE_PRIORITY_VISIBLE 1000000
+
+/*
+ * Base class for a single archive request, executed by the ArchiverScheduler in one of its worker threads.
+ * */
+class Q_DECL_EXPORT ArchiverJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    ArchiverJob() {}
+    virtual ~ArchiverJob() {}
+
+    /*
+     * Called from the GUI thread when the result of this job is not needed anymore.
+     * Implementations should make run() return as soon as possible.
+     * */
+    virtual void cancel() {}
+
+public slots:
+    /*
+     * Executes the job in the thread it was moved to and signals the scheduler when done.
+     * */
+    void start()
+    {
+        run();
+        emit jobDone();
+    }
+
+signals:
+    void jobDone();
+
+protected:
+    virtual void run() = 0;
+};
+
+/*
+ * Executes archive requests on a bounded number of long living worker threads.
+ * Pending requests are ordered by priority, so visible plots and short (recent) time windows are served first.
+ * All functions must be called from the thread the scheduler lives in, usually the GUI thread.
+ * */
+class Q_DECL_EXPORT ArchiverScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    ArchiverScheduler(QObject *parent = 0);
+    ~ArchiverScheduler();
+
+    /*
+     * Returns the priority for a request of the given plot, visible plots come first, then shorter time windows.
+     * */
+    static int priority(QWidget *w, int secondsPast);
+
+    /*
+     * Queues the job under the given key, the scheduler takes ownership of the job.
+     * */
+    void schedule(const QString &key, int priority, ArchiverJob *job);
+
+    /*
+     * Returns whether a job for the given key is queued or running.
+     * */
+    bool isScheduled(const QString &key) const;
+
+    /*
+     * Removes a queued job for the given key, or cancels it if it is already running.
+     * Returns true if a queued job was removed, so it will never report any result.
+     * */
+    bool cancel(const QString &key);
+
+private slots:
+    void jobDone();
+
+private:
+    typedef struct {
+        QString key;
+        int priority;
+        ArchiverJob *job;
+    } pendingJob;
+
+    void dispatch();
+
+    int m_maxThreads;
+    QList<QThread *> m_threads;
+    QList<QThread *> m_idleThreads;
+    QList<pendingJob> m_pendingJobs;
+    // a key can have a cancelled job still running besides the one scheduled again
+    QMultiMap<QString, ArchiverJob *> m_runningJobs;
+    QMap<ArchiverJob *, QThread *> m_jobThreads;
+};
+
+#endif // ARCHIVERSCHEDULER_H
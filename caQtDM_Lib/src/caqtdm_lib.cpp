@@ -1544,6 +1544,13 @@ void CaQtDM_Lib::HandleWidget(QWidget *w1, QString macro, bool firstPass, bool t
         // if we need to write channels from the camera widget, we do it by timer and slot
         connect(cameraWidget, SIGNAL(WriteDetectedValuesSignal(QWidget*)), this, SLOT(Callback_WriteDetectedValues(QWidget*)));
 
+        // statistics of the region of interest go to soft channels, with the macros replaced in their names
+        if(!cameraWidget->getROIStatisticsChannels().isEmpty()) {
+            QString channels = treatMacro(map, cameraWidget->getROIStatisticsChannels(), &doNothing, w1->objectName());
+            cameraWidget->setROIStatisticsChannels(channels);
+            connect(cameraWidget, SIGNAL(ROIStatisticsSignal(QWidget*)), this, SLOT(Callback_ROIStatistics(QWidget*)));
+        }
+
         // addmonitor normally will add a tooltip to show the pv; however here we have more than one pv
         QString tooltip;
         QString pvs1= "";
@@ -9555,6 +9562,33 @@ void CaQtDM_Lib::StripPlotsVerticalAlign()
    }
 }
 
+/**
+ * the statistics of the camera region of interest into the soft channels given for them
+ */
+void CaQtDM_Lib::Callback_ROIStatistics(QWidget* child)
+{
+    double values[ROISTATISTICS_VALUES];
+    QVector<double> projectionX, projectionY;
+
+    caCamera *cameraWidget = qobject_cast<caCamera *>(child);
+    if(cameraWidget == (caCamera *) Q_NULLPTR) return;
+    if(!cameraWidget->getROIStatistics(values, projectionX, projectionY)) return;
+
+    // sum, mean, centroid x, centroid y, rms width x, rms width y, x projection, y projection
+    QStringList channels = cameraWidget->getROIStatisticsChannels().split(";");
+    for(int i=0; i < channels.count() && i < ROISTATISTICS_VALUES + 2; i++) {
+        QString pv = channels.at(i).trimmed();
+        if(pv.isEmpty()) continue;
+        if(i < ROISTATISTICS_VALUES) {
+            mutexKnobDataP->UpdateSoftPV(pv, values[i], myWidget, 0, 1);
+        } else if(i == ROISTATISTICS_VALUES) {
+            mutexKnobDataP->UpdateSoftPVArray(pv, projectionX.constData(), (int) projectionX.size(), myWidget);
+        } else {
+            mutexKnobDataP->UpdateSoftPVArray(pv, projectionY.constData(), (int) projectionY.size(), myWidget);
+        }
+    }
+}
+
 void CaQtDM_Lib::Callback_WriteDetectedValues(QWidget* child)
 {
     double x,y,w,h;
@@ -393,6 +393,57 @@ void MutexKnobData::UpdateSoftPV(QString pv, double value, QWidget *w, int dataI
 
 }
 
+/**
+ * update all elements of a waveform softpv at once, like UpdateSoftPV does it element by element
+ */
+void MutexKnobData::UpdateSoftPVArray(QString pv, const double *values, int dataCount, QWidget *w)
+{
+    if(dataCount <= 0 || values == (const double *) Q_NULLPTR) return;
+
+    QString asc=SoftPV_Name(pv, w);
+    QMap<QString, int>::const_iterator name = softPV_WidgetList.find(asc);
+    if(name != softPV_WidgetList.end()) {
+        knobData *ptr = GetMutexKnobDataPtr(name.value());
+        ptr->edata.fieldtype = caDOUBLE;
+        ptr->edata.precision = 3;
+        ptr->edata.upper_disp_limit=0.0;
+        ptr->edata.lower_disp_limit=0.0;
+        if((int) (dataCount * sizeof(double)) != ptr->edata.dataSize) {
+            if(ptr->edata.dataB != (void*) Q_NULLPTR) free(ptr->edata.dataB);
+            ptr->edata.dataB = (void*) malloc(dataCount * sizeof(double));
+        }
+        ptr->edata.dataSize = dataCount * (int) sizeof(double);
+        ptr->edata.valueCount = dataCount;
+        memcpy(ptr->edata.dataB, values, dataCount * sizeof(double));
+    }
+
+    // and update everywhere where this soft channel is also used on this main window
+    QMapIterator<QString, softlist> i(softPV_List);
+    softlist softstruct;
+    while (i.hasNext()) {
+        i.next();
+        softstruct = i.value();
+        if(pv == softstruct.pv) {
+            int indx = softstruct.index;
+            if(KnobData[indx].index != -1 && KnobData[indx].pv == pv && softstruct.w == w) {
+                if((int) (dataCount * sizeof(double)) !=  KnobData[indx].edata.dataSize) {
+                    if( KnobData[indx].edata.dataB != (void*) Q_NULLPTR) free( KnobData[indx].edata.dataB);
+                    KnobData[indx].edata.dataB = (void*) malloc(dataCount * sizeof(double));
+                }
+                KnobData[indx].edata.dataSize = dataCount * sizeof(double);
+                KnobData[indx].edata.valueCount = dataCount;
+                memcpy(KnobData[indx].edata.dataB, values, dataCount * sizeof(double));
+                KnobData[indx].edata.rvalue = values[0];
+                KnobData[indx].edata.fieldtype = caDOUBLE;
+                KnobData[indx].edata.precision = 3;
+                KnobData[indx].edata.connected = true;
+                KnobData[indx].edata.upper_disp_limit=0.0;
+                KnobData[indx].edata.lower_disp_limit=0.0;
+            }
+        }
+    }
+}
+
 /**
  * get the index to the data for the softpv
  */
@@ -82,6 +82,7 @@ public:
     void InsertSoftPV(QString pv, int num, QWidget* w);
     void RemoveSoftPV(QString pv, QWidget *w, int indx);
     void UpdateSoftPV(QString pv, double value, QWidget *w, int dataIndex, int dataCount);
+    void UpdateSoftPVArray(QString pv, const double *values, int dataCount, QWidget *w);
     bool getSoftPV(QString pv, int *indx, QWidget *w);
     void BuildSoftPVList(QWidget *w);
 
@@ -56,6 +56,15 @@ RC_FILE = ./src/qtcontrols.rc
 #INCLUDEPATH += /opt/intel/parallel/vtune_amplifier_xe_2013/include
 #LIBS += /opt/intel/parallel/vtune_amplifier_xe_2013/lib32/libittnotify.a
 
+# caCamera decodes jpg frames with libjpeg-turbo when CAQTDM_TURBOJPEG points to its installation
+_CAQTDM_TURBOJPEG = $$(CAQTDM_TURBOJPEG)
+!isEmpty(_CAQTDM_TURBOJPEG) {
+   message( "Configuring caCamera for libjpeg-turbo" )
+   DEFINES += CAQTDM_TURBOJPEG
+   INCLUDEPATH += $$(CAQTDM_TURBOJPEG)/include
+   LIBS += -L$$(CAQTDM_TURBOJPEG)/lib -lturbojpeg
+}
+
 
 PRE_TARGETDEPS += \
      moc/moc_caslider.cpp \
@@ -119,10 +128,16 @@ SOURCES	+= \
     src/cascriptbutton.cpp \
     src/cadoubletabwidget.cpp \
     src/stripplotthread.cpp \
+    src/stripplothistory.cpp \
     src/cawaterfallplot.cpp \
     src/snumeric.cpp \
     src/caspinbox.cpp \
     src/qwtplotcurvenan.cpp \
+    src/qwtplotcurvedecimated.cpp \
+    src/replotscheduler.cpp \
+    src/camerakernels.cpp \
+    src/cameracodecs.cpp \
+    src/imageframecache.cpp \
     src/cawavetable.cpp \
     src/specialFunctions.cpp \
     src/caclock.cpp \
@@ -235,10 +250,16 @@ HEADERS	+= \
     src/cascriptbutton.h \
     src/cadoubletabwidget.h \
     src/stripplotthread.h \
+    src/stripplothistory.h \
     src/cawaterfallplot.h \
     src/snumeric.h \
     src/caspinbox.h \
     src/qwtplotcurvenan.h \
+    src/qwtplotcurvedecimated.h \
+    src/replotscheduler.h \
+    src/camerakernels.h \
+    src/cameracodecs.h \
+    src/imageframecache.h \
     src/cawavetable.h \
     src/capolylinedialog.h \
     src/specialFunctions.h \
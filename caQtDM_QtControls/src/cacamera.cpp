@@ -54,6 +54,10 @@
 #include <zlib.h>
 #endif
 
+#ifdef CAQTDM_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
 // Clamp out of range values
 #define CLAMP(t) (((t)>255)?255:(((t)<0)?0:(t)))
 
@@ -73,9 +77,51 @@ caCamera::caCamera(QWidget *parent) : QWidget(parent)
     m_verticalScroll = -1;
     m_horizontalScroll = -1;
 
-    rgb = (uint*)Q_NULLPTR;
+    source.data = (const uchar *) Q_NULLPTR;
+    source.size = 0;
+    imageBits = (uchar *) Q_NULLPTR;
+    imageStride = 0;
+    rowBuffersPerThread = 0;
+    codecScratchPerThread = 0;
+    turboJpeg = Q_NULLPTR;
+    visibleBinning = decodeBinning = 1;
+    decodePart = false;
+    statRunning = statValid = false;
+    valueTableGrey = true;
+    valueTableMin = valueTableMax = 0;
+
+    frontImage = (QImage *)Q_NULLPTR;
+    decodeRunning = framePending = resizePending = intensityPending = false;
+    lastFrameKept = regionPending = false;
+    pendingDatatype = decodeDatatype = -1;
+    lastColormode = Mono;
+    lastDatatype = -1;
+    decodedFrames = droppedFrames = 0;
+    decodeLatency = latencySum = 0.0;
+    latencyCount = 0;
+#ifndef QT_NO_CONCURRENT
+    decodeWatcher = new QFutureWatcher<QImage *>(this);
+    connect(decodeWatcher, SIGNAL(finished()), this, SLOT(decodeFinished()));
+#endif
+    rateTimer = new QTimer(this);
+    rateTimer->setSingleShot(true);
+    connect(rateTimer, SIGNAL(timeout()), this, SLOT(pendingDue()));
+    regionTimer = new QTimer(this);
+    regionTimer->setSingleShot(true);
+    connect(regionTimer, SIGNAL(timeout()), this, SLOT(redecodeVisible()));
+    busyNs = 0;
+    arrivedFrames = 0;
+    effectiveRate = 0.0;
+    adaptiveRate = 0.0;
+    qualityBinning = 1;
+    calmSeconds = 0;
+    loadWindow.start();
 
     thisSimpleView = false;
+    thisDecodeWorker = false;
+    thisDecodeVisible = false;
+    thisMaxDisplayRate = 0.0;
+    thisAdaptiveQuality = false;
     thisShowBoxes = false;
     thisFitToSize = No;
     savedSize = 0;
@@ -156,16 +202,14 @@ void caCamera::setPackingModeStrings()
 
 void caCamera::setCompressionModeStrings()
 {
-#if QT_VERSION < QT_VERSION_CHECK(4, 7, 0)
-    compressionModeString <<  "non" << "Zlib";
-#else
-    compressionModeString <<  "non" << "Zlib" << "JPG";
-#endif
+    // JPG is refused when decoding with qt before 4.7, but keeps its place for the modes after it
+    compressionModeString <<  "non" << "Zlib" << "JPG" << "LZ4" << "BSLZ4";
 }
 
 void caCamera::setDecodemodeStr(QString mode)
 {
     if(mode.length() == 0) return;
+    waitForDecode();
     //printf("colormodeset with %s\n", qasc(mode));
     for(int i = 0; i< colorModeString.count(); i++) {
         if(mode == colorModeString.at(i)) {
@@ -191,6 +235,7 @@ bool caCamera::testDecodemodeStr(QString mode)
 void caCamera::setPackingmodeStr(QString mode)
 {
     if(mode.length() == 0) return;
+    waitForDecode();
     //printf("Packingmodeset with %s\n", qasc(mode));
     for(int i = 0; i< packingModeString.count(); i++) {
         if(mode == packingModeString.at(i)) {
@@ -215,6 +260,7 @@ bool caCamera::testPackingmodeStr(QString mode)
 void caCamera::setCompressionmodeStr(QString mode)
 {
     if(mode.length() == 0) return;
+    waitForDecode();
     //printf("Packingmodeset with %s\n", qasc(mode));
     for(int i = 0; i< compressionModeString.count(); i++) {
         if(mode == compressionModeString.at(i)) {
@@ -238,6 +284,7 @@ bool caCamera::testCompressionmodeStr(QString mode)
 
 void caCamera::setDecodemodeNum(int mode)
 {
+    waitForDecode();
     //printf("colormodeset with %d\n", mode);
     m_init = true;
     thisColormode = (colormode) mode;
@@ -246,6 +293,7 @@ void caCamera::setDecodemodeNum(int mode)
 
 void caCamera::setDecodemodeNum(double mode)
 {
+    waitForDecode();
     //printf("colormodeset with %d\n", (int) mode);
     int intermed = (int)mode;
     m_init = true;
@@ -257,6 +305,7 @@ void caCamera::setDecodemodeNum(double mode)
 
 void caCamera::setPackingmodeNum(int mode)
 {
+    waitForDecode();
     //printf("packingmodeset with %d\n", mode);
     thisPackingmode = (packingmode) mode;
     if(packingmodeCombo != (QComboBox*)Q_NULLPTR) packingmodeCombo->setCurrentIndex(thisPackingmode);
@@ -264,6 +313,7 @@ void caCamera::setPackingmodeNum(int mode)
 
 void caCamera::setPackingmodeNum(double mode)
 {
+    waitForDecode();
     //printf("packingmodeset with %d\n", (int) mode);
     int intermed = (int)mode;
     thisPackingmode = (packingmode) intermed;// direct not allowed on Windows (C2440)
@@ -274,6 +324,7 @@ void caCamera::setPackingmodeNum(double mode)
 
 void caCamera::setCompressionmodeNum(int mode)
 {
+    waitForDecode();
     //printf("compressionmodeset with %d\n", mode);
     thisCompressionmode = (compressionmode) mode;
     if(compressionmodeCombo != (QComboBox*)Q_NULLPTR)
@@ -283,6 +334,7 @@ void caCamera::setCompressionmodeNum(int mode)
 
 void caCamera::setCompressionmodeNum(double mode)
 {
+    waitForDecode();
     //printf("compressionmodeset with %d\n", (int) mode);
     int intermed = (int)mode;
     thisCompressionmode = (compressionmode) intermed;
@@ -380,15 +432,42 @@ void caCamera::initWidgets()
 
 caCamera::~caCamera()
 {
+    waitForDecode();
+    delete frontImage;
+#ifdef CAQTDM_TURBOJPEG
+    if(turboJpeg != Q_NULLPTR) tjDestroy((tjhandle) turboJpeg);
+#endif
     deleteWidgets();
     initWidgets();
 }
 
 void caCamera::timerEvent(QTimerEvent *)
 {
-    QString text= "%1 U/s (%2,%3)";
-    if(m_datatype >=0) text = text.arg(UpdatesPerSecond).arg(colorModeString.at(thisColormode)).arg(caTypeStr[m_datatype]);
-    else  text = text.arg(UpdatesPerSecond).arg(colorModeString.at(thisColormode)).arg("");
+    // a running decode may have switched the modes temporarily, show the ones of the last decoded frame
+    colormode mode = decodeRunning ? lastColormode : thisColormode;
+    short datatype = decodeRunning ? lastDatatype : m_datatype;
+
+    // frames shown, frames arrived and part of the time spent decoding since the last time
+    const double seconds = qMax((double) loadWindow.restart() / 1000.0, 0.001);
+    const double busy = (double) busyNs / 1.0e9 / seconds;
+    const double arrived = (double) arrivedFrames / seconds;
+    effectiveRate = (double) UpdatesPerSecond / seconds;
+    busyNs = 0;
+    arrivedFrames = 0;
+    adaptQuality(busy, arrived, effectiveRate);
+
+    QString text= "%1 fps (%2,%3)";
+    if(datatype >=0) text = text.arg(effectiveRate, 0, 'f', 1).arg(colorModeString.at(mode)).arg(caTypeStr[datatype]);
+    else  text = text.arg(effectiveRate, 0, 'f', 1).arg(colorModeString.at(mode)).arg("");
+
+    decodeLatency = (latencyCount > 0) ? latencySum / (double) latencyCount : 0.0;
+    latencySum = 0.0;
+    latencyCount = 0;
+    const double rate = displayRate();
+    if(decodeWorker() || rate > 0.0) text += QString(" %1 dropped %2 ms").arg(droppedFrames).arg(decodeLatency, 0, 'f', 1);
+    if(rate > 0.0) text += QString(" max %1 fps").arg(rate, 0, 'f', 1);
+    if(qualityBinning > 1) text += QString(" 1:%1").arg(qualityBinning);
+
     if(nbUpdatesText != (caLabel*)Q_NULLPTR) nbUpdatesText->setText(text);
     UpdatesPerSecond = 0;
 }
@@ -521,49 +600,56 @@ bool caCamera::eventFilter(QObject *obj, QEvent *event)
     if(buttonPressed) imageW->updateSelectionBox(selectionPoints, selectionInProgress);
 
     if(buttonPressed && (savedData != (char*)Q_NULLPTR)) {
-        double Xnew, Ynew, Xmax, Ymax;
-        bool validIntensity = true;
-        int Zvalue = 0;
+        // the data is in use by the decode worker, the intensity is looked up when it is done
+        if(decodeRunning) intensityPending = true;
+        else showIntensity();
+    }
 
-        Coordinates(Xpos, Ypos, Xnew, Ynew, Xmax, Ymax);
+    return false;
+}
 
-        // find intensity
-        switch (m_datatype) {
-        case caCHAR:
-            Zvalue = zValueImage((uchar*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew, validIntensity);
-            break;
-        case caINT:
-            Zvalue = zValueImage((ushort*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/2, validIntensity);
-            break;
-        case caLONG:
-            Zvalue = zValueImage((uint*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/4, validIntensity);
-            break;
-        case caFLOAT:
-            Zvalue = zValueImage((float*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/4, validIntensity);
-            break;
-        case caDOUBLE:
-            Zvalue = zValueImage((double*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/8, validIntensity);
-            break;
-        default:
-            break;
-        }
+void caCamera::showIntensity()
+{
+    double Xnew, Ynew, Xmax, Ymax;
+    bool validIntensity = true;
+    int Zvalue = 0;
 
-        if(validIntensity) {
-            if(Zvalue >=0) {
-                QString strng = "(%1,%2,%3)";
-                strng = strng.arg(int(Xnew)).arg(int(Ynew)).arg(Zvalue);
-                updateIntensity(strng);
-            } else {
-                QString strng = "(%1,%2)";
-                strng = strng.arg(int(Xnew)).arg(int(Ynew));
-                updateIntensity(strng);
-            }
+    Coordinates(Xpos, Ypos, Xnew, Ynew, Xmax, Ymax);
+
+    // find intensity
+    switch (m_datatype) {
+    case caCHAR:
+        Zvalue = zValueImage((uchar*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew, validIntensity);
+        break;
+    case caINT:
+        Zvalue = zValueImage((ushort*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/2, validIntensity);
+        break;
+    case caLONG:
+        Zvalue = zValueImage((uint*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/4, validIntensity);
+        break;
+    case caFLOAT:
+        Zvalue = zValueImage((float*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/4, validIntensity);
+        break;
+    case caDOUBLE:
+        Zvalue = zValueImage((double*) savedData, thisColormode, Xnew, Ynew, Xmax, Ymax, savedSizeNew/8, validIntensity);
+        break;
+    default:
+        break;
+    }
+
+    if(validIntensity) {
+        if(Zvalue >=0) {
+            QString strng = "(%1,%2,%3)";
+            strng = strng.arg(int(Xnew)).arg(int(Ynew)).arg(Zvalue);
+            updateIntensity(strng);
         } else {
-            updateIntensity("invalid");
+            QString strng = "(%1,%2)";
+            strng = strng.arg(int(Xnew)).arg(int(Ynew));
+            updateIntensity(strng);
         }
+    } else {
+        updateIntensity("invalid");
     }
-
-    return false;
 }
 
 void caCamera::colormodeComboSlot(int num)
@@ -582,6 +668,7 @@ void caCamera::compressionmodeComboSlot(int num) {
 
 void caCamera::setup()
 {
+    waitForDecode();
     deleteWidgets();
     initWidgets();
     // labels and texts for horizontal layout containing information of the image
@@ -784,7 +871,8 @@ void caCamera::setup()
 
 void caCamera::scrollAreaMoved(int)
 {
-    if(image != (QImage *)Q_NULLPTR)  imageW->update();
+    if(image != (QImage *)Q_NULLPTR || frontImage != (QImage *)Q_NULLPTR)  imageW->update();
+    if(decodeVisible()) regionTimer->start(REGION_DELAY);
 }
 
 
@@ -855,6 +943,7 @@ void caCamera::zoomNow()
         scrollArea->horizontalScrollBar()->setValue(posX - scrollArea->horizontalScrollBar()->pageStep()/2);
         scrollArea->verticalScrollBar()->setValue(posY - scrollArea->verticalScrollBar()->pageStep()/2);
     }
+    if(decodeVisible()) regionTimer->start(REGION_DELAY);
 }
 
 void caCamera::zoomIn(int level)
@@ -941,7 +1030,9 @@ bool caCamera::isAlphaMinLevel()
 
 void caCamera::setColormap(colormap const &map)
 {
+    waitForDecode();
     thisColormap = map;
+    valueTable.clear();
     colorMaps colormaps;
     setPropertyVisible(customcolormap, false);
     setPropertyVisible(discretecolormap, false);
@@ -986,11 +1077,13 @@ void caCamera::setColormap(colormap const &map)
 
 void caCamera::setWidth(int width)
 {
+    waitForDecode();
     m_width = width;
     m_widthDefined = true;
 }
 void caCamera::setHeight(int height)
 {
+    waitForDecode();
     m_height = height;
     m_heightDefined = true;
 }
@@ -998,6 +1091,7 @@ void caCamera::setHeight(int height)
 void caCamera::resizeEvent(QResizeEvent *e)
 {
     if(thisSimpleView) return;
+    if(decodeVisible()) regionTimer->start(REGION_DELAY);
 
     if(m_widthDefined && m_heightDefined) {
         if(!thisFitToSize) {
@@ -1022,7 +1116,7 @@ void caCamera::resizeEvent(QResizeEvent *e)
             P3 = QPointF(Xnew, Ynew);
         }
     }
-    if(image != (QImage *) Q_NULLPTR)  imageW->rescaleSelectionBox(scaleFactor);
+    if(image != (QImage *) Q_NULLPTR || frontImage != (QImage *)Q_NULLPTR)  imageW->rescaleSelectionBox(scaleFactor);
 }
 
 void caCamera::updateImage(const QImage &image, bool valuesPresent[], double values[], double scaleFactor,
@@ -1089,74 +1183,171 @@ void caCamera::dataProcessing(double value, int id)
 
 void caCamera::MinMaxLock(SyncMinMax* MinMax, uint Max[2], uint Min[2])
 {
-    MinMax->MinMaxLock->lock();
+    MinMax->MinMaxLock.lock();
     MinMax->Max[(Max[1] > MinMax->Max[1])] = Max[1];
     MinMax->Min[(Min[1] < MinMax->Min[1])] = Min[1];
-    MinMax->MinMaxLock->unlock();
+    MinMax->MinMaxLock.unlock();
 }
 
-void caCamera::MinMaxImageLock(QVector<uint> LineData, int y, QSize resultSize, SyncMinMax* MinMax)
+void caCamera::InitLoopdata(int &ystart, int &yend, long &i, int increment, int sector, int sectorcount, QSize resultSize, uint Max[2], uint Min[2])
 {
-    MinMax->imageLock->lock();
-    if(image != (QImage *) Q_NULLPTR) {
-        if (image->height()>y){
-            uint *scanLine = reinterpret_cast<uint *>(image->scanLine(y));
-            if (scanLine){
-                memcpy(scanLine, LineData.constData(), resultSize.width() * sizeof(uint));
-            }
-        }
+    Max[1] = 0;
+    Min[1] = 65535;
+
+    ystart = sector * resultSize.height() / sectorcount;
+    yend = ((sector + 1) * resultSize.height()) / sectorcount;
+    // start of block to treat
+    i = resultSize.width() * ystart * increment;
+}
+
+// size of the elements shuffled in BSLZ4 frames, the size of a pixel value in the mode the data is converted with
+// it can be given with the dynamic property compressionElementSize
+int caCamera::compressedElementSize()
+{
+    QVariant size = this->property("compressionElementSize");
+    if(size.isValid() && size.toInt() > 0) return size.toInt();
+
+    switch (thisColormode) {
+    case Mono:
+        if(m_datatype == caINT) return 2;
+        if(m_datatype == caLONG || m_datatype == caFLOAT) return 4;
+        if(m_datatype == caDOUBLE) return 8;
+        return 1;
+    case Mono12p:
+    case BayerRG_12:
+    case BayerGB_12:
+    case BayerGR_12:
+    case BayerBG_12:
+        return (thisPackingmode == packNo) ? 2 : 1;
+    default:
+        return 1;
     }
-    MinMax->imageLock->unlock();
 }
 
-void caCamera::MinMaxImageLockBlock(uint *LineData, int ystart, int yend, QSize resultSize, SyncMinMax* MinMax)
+// the blocks sector, sector + sectorcount and so on of an LZ4 or BSLZ4 frame
+bool caCamera::decompressBlocks(int sector, int sectorcount, const uchar *frame, int elementSize, bool shuffled)
 {
-    MinMax->imageLock->lock();
-    if(image != (QImage *) Q_NULLPTR) {
-        for(int i=ystart; i<yend; ++i) {
-            if (i<image->height()){
-                uint *scanLine = reinterpret_cast<uint *>(image->scanLine(i));
-                if (scanLine) {
-                    memcpy(scanLine, &LineData[(i-ystart) * resultSize.width()], resultSize.width() * sizeof(uint));
-                }
-            }
+    uchar *dst = (uchar *) decompressedData.data();
+    uchar *scratch = shuffled ? (uchar *) codecScratch.data() + sector * codecScratchPerThread : (uchar *) Q_NULLPTR;
+    bool valid = true;
+    for(int k = sector; k < codecBlocks.size(); k += sectorcount) {
+        const CameraCodecs::block &b = codecBlocks.at(k);
+        if(!CameraCodecs::decompressBlock(frame, dst, b, elementSize, shuffled, scratch)) {
+            // a broken block is black
+            memset(dst + b.target, 0, b.targetSize);
+            valid = false;
         }
     }
-    MinMax->imageLock->unlock();
+    return valid;
 }
 
-void caCamera::InitLoopdata(int &ystart, int &yend, long &i, int increment, int sector, int sectorcount, QSize resultSize, uint Max[2], uint Min[2])
+// jpg frames with libjpeg-turbo, the grey values go straight into decompressedData, which keeps its buffer for the next frame
+bool caCamera::decodeTurboJpeg(const uchar *data, int size)
 {
-    Max[1] = 0;
-    Min[1] = 65535;
+#ifdef CAQTDM_TURBOJPEG
+    if(data == (const uchar *) Q_NULLPTR || size <= 0) return false;
+    if(turboJpeg == Q_NULLPTR) turboJpeg = (void *) tjInitDecompress();
+    if(turboJpeg == Q_NULLPTR) return false;
 
-    ystart = sector * resultSize.height() / sectorcount;
-    yend = ((sector + 1) * resultSize.height()) / sectorcount;
-    // start of block to treat
-    i = resultSize.width() * ystart * increment;
+    int width, height, subsampling, colorspace;
+    if(tjDecompressHeader3((tjhandle) turboJpeg, (uchar *) data, (ulong) size, &width, &height, &subsampling, &colorspace) != 0) return false;
+    decompressedData.resize(width * height);
+    return tjDecompress2((tjhandle) turboJpeg, (uchar *) data, (ulong) size, (uchar *) decompressedData.data(),
+                         width, width, height, TJPF_GRAY, TJFLAG_FASTDCT) == 0;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+    return false;
+#endif
 }
 
 void caCamera::reallocate_central_image()
 {
 
     imageMutex.lock();
+    const int width = (m_width + decodeBinning - 1) / decodeBinning;
+    const int height = (m_height + decodeBinning - 1) / decodeBinning;
     if(image != (QImage *)Q_NULLPTR){
-        if ((image->width()!=m_width)||(image->height()!=m_height)){
+        if ((image->width()!=width)||(image->height()!=height)){
             delete image;
             image = (QImage *)Q_NULLPTR;
         }
     }
-    if (image == (QImage *)Q_NULLPTR)
-        image = new QImage(m_width,m_height,QImage::Format_RGB32);
+    if (image == (QImage *)Q_NULLPTR) {
+        image = new QImage(width,height,QImage::Format_RGB32);
+        // when only the visible part is converted, the rest has to be defined too
+        image->fill(Qt::black);
+    }
     imageMutex.unlock();
 }
 
+// colors for all values of 8 or 16 bit data, computed like calcImageMono does for a single pixel
+// the table only changes with the colormap or with the range, so usually it is just kept
+void caCamera::updateValueTable(int size)
+{
+    const bool grey = (thisColormap == as_is || thisColormap == color_to_mono);
+    if(valueTable.size() == size && valueTableGrey == grey && valueTableMin == minvalue && valueTableMax == maxvalue) return;
+
+    valueTableGrey = grey;
+    valueTableMin = minvalue;
+    valueTableMax = maxvalue;
+    valueTable.resize(size);
+
+    if(grey) {
+        const float correction =  (float) 255 / (float) (maxvalue - minvalue);
+        for(int v = 0; v < size; v++) {
+            int indx1 = v * correction;
+            if(indx1 > 255) indx1 = 255;
+            valueTable[v] = qRgb(indx1,indx1,indx1);
+        }
+    } else {
+        const float correction =  (float)(ColormapSize-1) / (float) (maxvalue - minvalue);
+        for(int v = 0; v < size; v++) {
+            int indx1 = ((uint) v < minvalue) ? 0 : (int) ((float) (v - (int) minvalue) * correction);
+            if(indx1 < 0) indx1 = 0;
+            if(indx1 >= ColormapSize) indx1=ColormapSize -1;
+            valueTable[v] = ColorMap[indx1];
+        }
+    }
+}
+
 // I leave the code now as it was, while here we use uint and in calcimage QVector<uint>. I can merge later on.
 template <typename pureData>
 void caCamera::calcImageMono (pureData *ptr,  uint *LineData, long &i, int &ystart, int &yend, float correction, int datasize, QSize resultSize,
                               uint Max[2], uint Min[2])
 {
     if(ptr &&(i > datasize)) return;
+
+    // 8 and 16 bit data, the color is taken from the value table
+    if(sizeof(pureData) <= 2 && valueTable.size() == (1 << (8 * sizeof(pureData)))) {
+        const uint *table = valueTable.constData();
+        if(i < datasize) {
+            const long count = qMin((long) (yend-ystart)*resultSize.width(), (long) datasize - i);
+            if(CameraKernels::monoTable(ptr + i, LineData, count, table, Max[1], Min[1])) {
+                i += count;
+                return;
+            }
+            for(int k=0; k<(yend-ystart)*resultSize.width(); ++k) {
+                Max[(ptr[i] > Max[1])] = ptr[i];
+                Min[(ptr[i] < Min[1])] = ptr[i];
+                LineData[k] = table[(uint) ptr[i]];
+                ++i;
+                if(i >= datasize) break;
+            }
+        }
+        return;
+    }
+
+    // 32 bit and float data
+    if(i < datasize) {
+        const long count = qMin((long) (yend-ystart)*resultSize.width(), (long) datasize - i);
+        const uint *colors = (thisColormap == as_is || thisColormap == color_to_mono) ? (const uint *) Q_NULLPTR : ColorMap;
+        if(CameraKernels::monoScale(ptr + i, LineData, count, correction, minvalue, colors, ColormapSize, Max[1], Min[1])) {
+            i += count;
+            return;
+        }
+    }
+
     if(thisColormap == as_is || thisColormap == color_to_mono) {
         if(i < datasize) {
             for(int k=0; k<(yend-ystart)*resultSize.width(); ++k) {
@@ -1190,8 +1381,34 @@ void caCamera::calcImageMono (pureData *ptr,  uint *LineData, long &i, int &ysta
     }
 }
 
-template <typename pureData> void caCamera::calcImage (pureData *ptr,  colormode mode,  QVector<uint> &LineData, long &i, int &ystart, int &yend,
-                                                       float correction, int datasize, QSize resultSize, SyncMinMax *MinMax, uint Max[2], uint Min[2])
+// the rows ystart to yend of decodeRect, when binned every decodeBinning'th value is first copied to samples
+template <typename pureData>
+void caCamera::calcImageMonoRegion (pureData *ptr, int ystart, int yend, float correction, long datasize, QSize resultSize,
+                                    ushort *samples, uint Max[2], uint Min[2])
+{
+    const int b = decodeBinning;
+    const int count = decodeRect.width();
+    pureData *row = (pureData *) samples;
+
+    for (int y = ystart; y < yend; ++y) {
+        uint *LineData = imageRow(y) + decodeRect.left();
+        const long first = (long) y * b * resultSize.width() + (long) decodeRect.left() * b;
+        if(first >= datasize) break;
+        long i = 0;
+        int y0 = 0, y1 = 1;
+        if(b == 1) {
+            i = first;
+            calcImageMono(ptr, LineData, i, y0, y1, correction, datasize, QSize(count, 1), Max, Min);
+        } else {
+            const int n = (int) qMin((long) count, (datasize - first + b - 1) / b);
+            for(int k = 0; k < n; k++) row[k] = ptr[first + (long) k * b];
+            calcImageMono(row, LineData, i, y0, y1, correction, n, QSize(n, 1), Max, Min);
+        }
+    }
+}
+
+template <typename pureData> void caCamera::calcImage (pureData *ptr,  colormode mode, long &i, int &ystart, int &yend,
+                                                       float correction, int datasize, QSize resultSize, uint Max[2], uint Min[2])
 {
     int offset1 = 1;            // pixel
     int offset2 = 2;
@@ -1221,22 +1438,30 @@ template <typename pureData> void caCamera::calcImage (pureData *ptr,  colormode
     //printf("width=%d height=%d datasize=%d\n", resultSize.width(), yend, datasize);
 
     if(thisColormap == as_is || thisColormap > color_to_mono) {
+        const long rowSize = 3 * (long) resultSize.width();
         for (int y = ystart; y < yend; ++y) {
-            for (int x = 0; x < resultSize.width(); ++x) {
-                uint intensity = qMax(qMax(ptr[i], ptr[i+offset1]), ptr[i+offset2]);
-                LineData[x] =  qRgb((int) (ptr[i] * redcoeff), (int) (ptr[i+offset1] * greencoeff), (int) (ptr[i+offset2] * bluecoeff));
-                i += dataAdvance;
-                Max[(intensity > Max[1])] = intensity;
-                Min[(intensity < Min[1])] = intensity;
-                if ((i + offset2 + offset3) >= datasize) break;
+            uint *LineData = imageRow(y);
+            // a complete row of interleaved 32 bit values at once
+            if(dataAdvance == 3 && (i + rowSize + offset2) < datasize &&
+                    CameraKernels::rgbScale(ptr + i, LineData, resultSize.width(), redcoeff, greencoeff, bluecoeff, Max[1], Min[1])) {
+                i += rowSize;
+            } else {
+                for (int x = 0; x < resultSize.width(); ++x) {
+                    uint intensity = qMax(qMax(ptr[i], ptr[i+offset1]), ptr[i+offset2]);
+                    LineData[x] =  qRgb((int) (ptr[i] * redcoeff), (int) (ptr[i+offset1] * greencoeff), (int) (ptr[i+offset2] * bluecoeff));
+                    i += dataAdvance;
+                    Max[(intensity > Max[1])] = intensity;
+                    Min[(intensity < Min[1])] = intensity;
+                    if ((i + offset2 + offset3) >= datasize) break;
+                }
             }
             i += offset3;
             if((i + offset2 + offset3) >= datasize) break;
-            MinMaxImageLock(LineData, y, resultSize, MinMax);
         }
         // convert to mono
     } else {
         for (int y = ystart; y < yend; ++y) {
+            uint *LineData = imageRow(y);
             for (int x = 0; x < resultSize.width(); ++x) {
                 uint intensity = qMax(qMax(ptr[i], ptr[i+offset1]), ptr[i+offset2] );
                 int average =(int) 2.2 * (0.2989 * ptr[i] * correction + 0.5870 * ptr[i+offset1] * correction + 0.1140 * ptr[i+offset2] * correction);
@@ -1248,7 +1473,6 @@ template <typename pureData> void caCamera::calcImage (pureData *ptr,  colormode
             }
             i += offset3;
             if ((i + offset2 + offset3) >= datasize) break;
-            MinMaxImageLock(LineData, y, resultSize, MinMax);
         }
     }
 }
@@ -1270,10 +1494,48 @@ void caCamera::CameraDataConvert(int sector, int sectorcount, SyncMinMax* MinMax
 
     if(thisColormode == Mono) {
 
-        uint *LineData;
+        if(thisColormap == as_is || thisColormap == color_to_mono) {
+            correction =  (float) 255 / (float) (maxvalue - minvalue);
+        } else {
+            correction =  (float)(ColormapSize-1) / (float) (maxvalue - minvalue);
+        }
+
+        // the rows of the statistics region belonging to this sector, the thread reads them anyway
+        if(statRunning) roiStatisticsSector(sector, sectorcount, datasize/elementSize, (ushort *) Q_NULLPTR);
+
+        // only the visible part, row by row
+        if(decodePart) {
+            InitLoopdata(ystart, yend, i, 1, sector, sectorcount, decodeRect.size(), Max, Min);
+            ystart += decodeRect.top();
+            yend += decodeRect.top();
+            ushort *samples = rowBuffers.data() + sector * rowBuffersPerThread;
+            switch (m_datatype) {
+            case caCHAR:
+                calcImageMonoRegion ((uchar*) savedData, ystart, yend, correction, datasize, resultSize, samples, Max, Min);
+                break;
+            case caINT:
+                calcImageMonoRegion ((ushort*) savedData, ystart, yend, correction, datasize/elementSize, resultSize, samples, Max, Min);
+                break;
+            case caLONG:
+                calcImageMonoRegion ((uint*) savedData, ystart, yend, correction, datasize/elementSize, resultSize, samples, Max, Min);
+                break;
+            case caFLOAT:
+                calcImageMonoRegion ((float*) savedData, ystart, yend, correction, datasize/elementSize, resultSize, samples, Max, Min);
+                break;
+            case caDOUBLE:
+                calcImageMonoRegion ((double*) savedData, ystart, yend, correction, datasize/elementSize, resultSize, samples, Max, Min);
+                break;
+            default:
+                printf("caCamera -- data format not supported\n");
+            }
+            MinMaxLock(MinMax, Max, Min);
+            return;
+        }
+
         int elementAdvance = 1;
         InitLoopdata(ystart, yend, i, elementAdvance, sector, sectorcount, resultSize, Max, Min);
-        LineData = (uint *) malloc(resultSize.width() * sizeof(uint) * (yend-ystart));
+        // the rows of the sector are one block in the image
+        uint *LineData = imageRow(ystart);
 
         // instead of testing in the big loop, subtract 10 lines when sizes do not fit
         bool notOK = true;
@@ -1284,7 +1546,6 @@ void caCamera::CameraDataConvert(int sector, int sectorcount, SyncMinMax* MinMax
                 yend -= 10;
                 if(yend < ystart) {
                     printf("caCamera -- something really wrong between datasize and image width and height\n");
-                    free (LineData);
                     return;
                 }
                 if(writeIt) {
@@ -1297,44 +1558,33 @@ void caCamera::CameraDataConvert(int sector, int sectorcount, SyncMinMax* MinMax
             }
         }
 
-        if(thisColormap == as_is || thisColormap == color_to_mono) {
-            correction =  (float) 255 / (float) (maxvalue - minvalue);
-        } else {
-            correction =  (float)(ColormapSize-1) / (float) (maxvalue - minvalue);
-        }
-
         switch (m_datatype) {
         case caCHAR:
             if((ulong) i*sizeof(uchar) >= (uint) datasize){
-                free(LineData);
                 return;
             }
             calcImageMono ((uchar*) savedData, LineData, i, ystart, yend, correction, datasize, resultSize, Max, Min);
             break;
         case caINT:
             if((ulong) i*sizeof(ushort) >= (uint) datasize) {
-                free(LineData);
                 return;
             }
             calcImageMono ((ushort*) savedData, LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
             break;
         case caLONG:
             if((ulong) i*sizeof(uint) >= (uint) datasize) {
-                free(LineData);
                 return;
             }
             calcImageMono ((uint*) savedData, LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
             break;
         case caFLOAT:
             if((ulong) i*sizeof(float) >= (uint) datasize) {
-                free(LineData);
                 return;
             }
             calcImageMono ((float*) savedData,  LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
             break;
         case caDOUBLE:
             if((ulong) i*sizeof(double) >= (uint) datasize) {
-                free(LineData);
                 return;
             }
             calcImageMono ((double*) savedData, LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
@@ -1343,34 +1593,29 @@ void caCamera::CameraDataConvert(int sector, int sectorcount, SyncMinMax* MinMax
             printf("caCamera -- data format not supported\n");
         }
 
-        MinMaxImageLockBlock(LineData, ystart, yend, resultSize, MinMax);
         MinMaxLock(MinMax, Max, Min);
-        free(LineData);
     } else  {
-        QVector<uint> LineData;
-
         if(maxvalue != 0) correction = 255.0 / (float) maxvalue;
 
         int increment = 1;
         if(thisColormode == RGB1_CA) increment = 3; // 3 elements RGB
         if(thisColormode == RGB2_CA) increment = 3; // 3 Lines RGB
-        LineData.resize(resultSize.width());
         InitLoopdata(ystart, yend, i, increment, sector, sectorcount, resultSize, Max, Min);
         switch (m_datatype) {
         case caCHAR:
-            calcImage ((uchar*) savedData, thisColormode, LineData, i, ystart, yend, correction, datasize, resultSize, MinMax, Max, Min);
+            calcImage ((uchar*) savedData, thisColormode, i, ystart, yend, correction, datasize, resultSize, Max, Min);
             break;
         case caINT:
-            calcImage ((ushort*) savedData, thisColormode, LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, MinMax, Max, Min);
+            calcImage ((ushort*) savedData, thisColormode, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
             break;
         case caLONG:
-            calcImage ((uint*) savedData, thisColormode, LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, MinMax, Max, Min);
+            calcImage ((uint*) savedData, thisColormode, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
             break;
         case caFLOAT:
-            calcImage ((float*) savedData, thisColormode, LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, MinMax, Max, Min);
+            calcImage ((float*) savedData, thisColormode, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
             break;
         case caDOUBLE:
-            calcImage ((double*) savedData, thisColormode, LineData, i, ystart, yend, correction, datasize/elementSize, resultSize, MinMax, Max, Min);
+            calcImage ((double*) savedData, thisColormode, i, ystart, yend, correction, datasize/elementSize, resultSize, Max, Min);
             break;
         default:
             printf("caCamera -- data format not supported\n");
@@ -1380,512 +1625,158 @@ void caCamera::CameraDataConvert(int sector, int sectorcount, SyncMinMax* MinMax
     }
 }
 
-/*
- * 1394-Based Digital Camera Control Library
- *
- * Bayer pattern decoding functions
- *
- * Written by Damien Douxchamps and Frederic Devernay
- * The original VNG and AHD Bayer decoding are from Dave Coffin's DCR
- *
- * This library is free software; you can redistribute it and/or
- * modify it under the terms of the GNU Lesser General Public
- * License as published by the Free Software Foundation; either
- * version 2.1 of the License, or (at your option) any later version.
- */
-
-template <typename pureData> void caCamera::FilterBayer(pureData *bayer, uint *rgb, int sx, int sy, int tile,int datasize)
-{
-    const int bayerStep = sx;
-    const int rgbStep = 3 * sx;
-    uchar *rgbStart=(uchar *)rgb;
-    uchar *bayerStart=(uchar *)bayer;
-
-    int width = sx;
-    int height = sy;
-    int blue = tile == BAYER_COLORFILTER_BGGR || tile == BAYER_COLORFILTER_GBRG ? -1 : 1;
-    int start_with_green = tile == BAYER_COLORFILTER_GBRG|| tile == BAYER_COLORFILTER_GRBG;
-    int i, iinc, imax;
-
-    if ((tile > BAYER_COLORFILTER_MAX) || (tile < BAYER_COLORFILTER_MIN)) {
-        printf("caCamera -- bayer, invalid filter\n");
-        return;
-    }
-
-    /* add black border */
-    imax = sx * sy * 3;
-    for (i = sx * (sy - 1) * 3; i < imax; i++) {
-        rgb[i] = 0;
-    }
-    iinc = (sx - 1) * 3;
-    for (i = (sx - 1) * 3; i < imax; i += iinc) {
-        rgb[i++] = 0;
-        rgb[i++] = 0;
-        rgb[i++] = 0;
-    }
-
-    rgb += 1;
-    height -= 1;
-    width -= 1;
-    for (; height--; bayer += bayerStep, rgb += rgbStep) {
-        pureData *bayerEnd = bayer + width;
-        if (((uchar *)(rgb+rgbStep)<((uchar *)rgbStart+3*m_width*m_height*sizeof(uint)))&&((uchar *)(bayer+bayerStep)<((uchar *)bayerStart+datasize))){
-            if (start_with_green) {
-                rgb[-blue] = bayer[1];
-                rgb[0] = bayer[bayerStep + 1];
-                rgb[blue] = bayer[bayerStep];
-                bayer++;
-                rgb += 3;
-            }
-
-            if (blue > 0) {
-                for (; bayer <= bayerEnd - 2; bayer += 2, rgb += 6) {
-                    rgb[-1] = bayer[0];
-                    rgb[0] = bayer[1];
-                    rgb[1] = bayer[bayerStep + 1];
-
-                    rgb[2] = bayer[2];
-                    rgb[3] = bayer[bayerStep + 2];
-                    rgb[4] = bayer[bayerStep + 1];
-                }
-            } else {
-                for (; bayer <= bayerEnd - 2; bayer += 2, rgb += 6) {
-
-                    rgb[1] = bayer[0];
-                    rgb[0] = bayer[1];
-                    rgb[-1] = bayer[bayerStep + 1];
-
-                    rgb[4] = bayer[2];
-                    rgb[3] = bayer[bayerStep + 2];
-                    rgb[2] = bayer[bayerStep + 1];
-
-                }
-            }
-
-            if (bayer < bayerEnd) {
-                rgb[-blue] = bayer[0];
-                rgb[0] = bayer[1];
-                rgb[blue] = bayer[bayerStep + 1];
-                bayer++;
-                rgb += 3;
-            }
-
-            bayer -= width;
-            rgb -= width * 3;
-
-            blue = -blue;
-            start_with_green = !start_with_green;
-        }
-    }
-
-    return;
-}
-
-//https://en.wikipedia.org/wiki/Chroma_subsampling
-//https://en.wikipedia.org/wiki/YCbCr
-#define GET_R_FROM_YUV(y,cb,cr) 298.082*y/256 +                      408.583 * cr / 256 - 222.291 ;
-#define GET_G_FROM_YUV(y,cb,cr) 298.082*y/256 - 100.291 * cb / 256 - 208.120 * cr / 256 + 135.576 ;
-#define GET_B_FROM_YUV(y,cb,cr) 298.082*y/256 + 561.412 * cb / 256                      - 276.836 ;
-
-//#define GET_R_FROM_YUV(y,u,v) y + 1.370705 * (v-128);
-//#define GET_G_FROM_YUV(y,u,v) y - 0.698001 * (v-128) - 0.337633 * (u -128);
-//#define GET_B_FROM_YUV(y,u,v) y + 1.732446 * (u-128);
-
-void caCamera::PROC_YUYV422(uchar *YUV, uint *rgb, int sx, int sy, int datasize)  // 4 bytes for 2 pixels
-{
-    long max_data=(long)YUV + datasize;
-    if ((sx==0)||(sy==0)) return;
-    for (long i = 0; i < (sx) * sy / 2; ++i) {
-        int Y1, Cr, Y2, Cb;
-        long r,g,b;
-        long min=0;
-        // Extract YCbCr components
-        Y1 = YUV[0];
-        Cb = YUV[1];
-        Y2 = YUV[2];
-        Cr = YUV[3];
-
-        YUV += 4;
-
-        r=GET_R_FROM_YUV(Y1,Cb,Cr);
-        g=GET_G_FROM_YUV(Y1,Cb,Cr);
-        b=GET_B_FROM_YUV(Y1,Cb,Cr);
-
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-
-        //        if (i<9){
-        //            printf("(%i)Y1: %x Y2: %x Cr: %x Cb: %x\n",i,Y1,Y2,Cr,Cb);
-        //            printf("\t R: %x G: %x B: %x ",rgb[0],rgb[1],rgb[2]);
-        //        }
-
-        rgb += 3;
-        r=GET_R_FROM_YUV(Y2,Cb,Cr);
-        g=GET_G_FROM_YUV(Y2,Cb,Cr);
-        b=GET_B_FROM_YUV(Y2,Cb,Cr);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-
-        rgb += 3;
-        //        if (i<9){
-        //            printf("R2: %x G2: %x B2: %x \n",rgb[0],rgb[1],rgb[2]);
-        //        }
-        if (max_data<(long)YUV) break;
-    }
-}
-
-void caCamera::PROC_UYVY422(uchar *YUV, uint *rgb, int sx, int sy, int datasize)  // 4 bytes for 4 pixels
-{
-    long max_data=(long)YUV + datasize;
-    if ((sx==0)||(sy==0)) return;
-    for (int i = 0; i < sx * sy / 4; ++i) {
-        int y0, u0, y1, v0, y2, u2, y3, v2;
-
-        // Extract yuv components
-        u0 = YUV[0];
-        y0 = YUV[1];
-        v0 = YUV[2];
-        y1 = YUV[3];
-        u2 = YUV[4];
-        y2 = YUV[5];
-        v2 = YUV[6];
-        y3 = YUV[7];
-        YUV += 8;
-
-        rgb[0] = GET_R_FROM_YUV(y0,u0,v0);
-        rgb[1] = GET_G_FROM_YUV(y0,u0,v0);
-        rgb[2] = GET_B_FROM_YUV(y0,u0,v0);
-        rgb += 3;
-        rgb[0] = GET_R_FROM_YUV(y1,u0,v0);
-        rgb[1] = GET_G_FROM_YUV(y1,u0,v0);
-        rgb[2] = GET_B_FROM_YUV(y1,u0,v0);
-        rgb += 3;
-        rgb[0] = GET_R_FROM_YUV(y2,u2,v2);
-        rgb[1] = GET_G_FROM_YUV(y2,u2,v2);
-        rgb[2] = GET_B_FROM_YUV(y2,u2,v2);
-        rgb += 3;
-        rgb[0] = GET_R_FROM_YUV(y3,u2,v2);
-        rgb[1] = GET_G_FROM_YUV(y3,u2,v2);
-        rgb[2] = GET_B_FROM_YUV(y3,u2,v2);
-        rgb += 3;
-        if (max_data<(long)YUV) break;
-    }
-}
-
-void caCamera::PROC_YYUYYV411(uchar *YUV, uint *rgb, int sx, int sy, int datasize)  // 6 bytes for 4 pixels
-{
-    long max_data=(long)YUV + datasize;
-    if ((sx==0)||(sy==0)) return;
-    for (long i = 0; i < (sx) * sy / 4; ++i) {
-        int Y1, U, Y2, V, Y3, Y4;
-
-        long r,g,b;
-        long min=0;
-        // Extract YCbCr components
-        Y1 = YUV[0];
-        Y2 = YUV[1];
-        U  = YUV[2];
-        Y3 = YUV[3];
-        Y4 = YUV[4];
-        V  = YUV[5];
-
-        YUV += 6;
-
-        r=GET_R_FROM_YUV(Y1,U,V);
-        g=GET_G_FROM_YUV(Y1,U,V);
-        b=GET_B_FROM_YUV(Y1,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        r=GET_R_FROM_YUV(Y2,U,V);
-        g=GET_G_FROM_YUV(Y2,U,V);
-        b=GET_B_FROM_YUV(Y2,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        r=GET_R_FROM_YUV(Y3,U,V);
-        g=GET_G_FROM_YUV(Y3,U,V);
-        b=GET_B_FROM_YUV(Y3,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        r=GET_R_FROM_YUV(Y4,U,V);
-        g=GET_G_FROM_YUV(Y4,U,V);
-        b=GET_B_FROM_YUV(Y4,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        if (max_data<(long)YUV) break;
-    }
-}
-
-void caCamera::PROC_UYYVYY411(uchar *YUV, uint *rgb, int sx, int sy, int datasize)  // 6 bytes for 4 pixels
-{
-    long max_data=(long)YUV + datasize;
-    if ((sx==0)||(sy==0)) return;
-    for (long i = 0; i < (sx) * sy / 4; ++i) {
-        int Y1, U, Y2, V, Y3, Y4;
-        long r,g,b;
-
-        long min=0;
-        // Extract YCbCr components
-        U  = YUV[0];
-        Y1 = YUV[1];
-        Y2 = YUV[2];
-        V  = YUV[3];
-        Y3 = YUV[4];
-        Y4 = YUV[5];
-        YUV += 6;
-
-        r=GET_R_FROM_YUV(Y1,U,V);
-        g=GET_G_FROM_YUV(Y1,U,V);
-        b=GET_B_FROM_YUV(Y1,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        r=GET_R_FROM_YUV(Y2,U,V);
-        g=GET_G_FROM_YUV(Y2,U,V);
-        b=GET_B_FROM_YUV(Y2,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        r=GET_R_FROM_YUV(Y3,U,V);
-        g=GET_G_FROM_YUV(Y3,U,V);
-        b=GET_B_FROM_YUV(Y3,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        r=GET_R_FROM_YUV(Y4,U,V);
-        g=GET_G_FROM_YUV(Y4,U,V);
-        b=GET_B_FROM_YUV(Y4,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-        if (max_data<(long)YUV) break;
-
-    }
-}
-
-void caCamera::PROC_YUV444(uchar *YUV, uint *rgb, int sx, int sy, int datasize)  // 3 bytes for 1 pixels
+// packed mono data, every thread unpacks its own rows of decodeRect and takes their colors from the value table
+void caCamera::CameraPackedConvert(int sector, int sectorcount, SyncMinMax* MinMax, QSize resultSize, int datasize)
 {
-    long max_data=(long)YUV + datasize;
-    if ((sx==0)||(sy==0)||(YUV==NULL)||(rgb==NULL)) return;
-    for (long i = 0; i < (sx) * sy ; ++i) {
-        int Y, U, V;
-        long r,g,b;
-        long min=0;
-        Y  = YUV[0];
-        U  = YUV[1];
-        V  = YUV[2];
-
-        YUV += 3;
-
-        r=GET_R_FROM_YUV(Y,U,V);
-        g=GET_G_FROM_YUV(Y,U,V);
-        b=GET_B_FROM_YUV(Y,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        if (max_data<=(long)YUV) return;
+    Q_UNUSED(datasize);
+    uint Max[2], Min[2];
+    int ystart, yend;
+    long i;
 
+    if(source.data == (const uchar *) Q_NULLPTR || valueTable.size() < 65536 || rowBuffersPerThread < resultSize.width()) return;
+
+    InitLoopdata(ystart, yend, i, 1, sector, sectorcount, decodeRect.size(), Max, Min);
+    ystart += decodeRect.top();
+    yend += decodeRect.top();
+    const int width = resultSize.width();
+    const int b = decodeBinning;
+    const int count = decodeRect.width();
+    const long span = (long) (count - 1) * b + 1;       // pixels of the frame holding the ones of a row
+    ushort *values = rowBuffers.data() + sector * rowBuffersPerThread;
+
+    // the rows of the statistics region belonging to this sector, unpacked behind the row of the conversion
+    if(statRunning) roiStatisticsSector(sector, sectorcount, 0, values + m_width);
+
+    for (int y = ystart; y < yend; ++y) {
+        uint *LineData = imageRow(y) + decodeRect.left();
+        const long unpacked = CameraKernels::unpack(source.packing, source.data, source.size,
+                                                    (long) y * b * width + (long) decodeRect.left() * b, span, values);
+        const long n = (unpacked + b - 1) / b;
+        for(long k = 1; k < n && b > 1; k++) values[k] = values[k * b];
+        CameraKernels::monoTable(values, LineData, n, valueTable.constData(), Max[1], Min[1]);
+        // pixels missing in the data are black
+        if(n < count) memset(LineData + n, 0, (count - n) * sizeof(uint));
     }
-}
-
-void caCamera::PROC_UVY444(uchar *YUV, uint *rgb, int sx, int sy, int datasize)  // 3 bytes for 1 pixels
-{
-    //printf("datatype=PROC_UVY444 colormode=%d %s (%x)(%x) %i %i\n", thisColormode, qasc(colorModeString.at(thisColormode)),(long)YUV,(long)rgb,sx, sy);
-    long max_data=(long)YUV + datasize;
-
-    if ((sx==0)||(sy==0)) return;
-    for (long i = 0; i < (sx) * sy ; ++i) {
-        int Y, U, V;
-        long r,g,b;
-        long min=0;
-        U =  YUV[0];
-        Y  = YUV[1];
-        V  = YUV[2];
-
-        YUV += 3;
 
-        r=GET_R_FROM_YUV(Y,U,V);
-        g=GET_G_FROM_YUV(Y,U,V);
-        b=GET_B_FROM_YUV(Y,U,V);
-        rgb[0]=qMax(min,r);
-        rgb[1]=qMax(min,g);
-        rgb[2]=qMax(min,b);
-        rgb += 3;
-
-        if (max_data<=(long)YUV) return;
-
-    }
+    MinMaxLock(MinMax, Max, Min);
 }
 
-void caCamera::PROC_RGB8(uchar *RGB,rgb_interpretation rgb_type, uint *rgb, int sx, int sy, int datasize)  // 3 bytes for 1 pixels
+// count bayer values of a row from column x on in 16 bit, false when the data does not contain all of them
+bool caCamera::bayerRow(int row, int width, int x, int count, ushort *values)
 {
-    int rgb_matrix[5][3]={{0,1,2},  //COLOR_RGB
-                          {2,1,0},  //COLOR_GBR
-                          {1,0,2},  //COLOR_GRB
-                          {2,1,0},  //COLOR_BGR
-                          {1,2,0}   //COLOR_BRG
-                         };
-    long max_data=(long)RGB + datasize;
-
-    if ((sx==0)||(sy==0)) return;
-    for (long i = 0; i < (sx) * sy ; ++i) {
-        int R, G, B;
-
-        R =  RGB[rgb_matrix[rgb_type][0]];
-        G  = RGB[rgb_matrix[rgb_type][1]];
-        B  = RGB[rgb_matrix[rgb_type][2]];
-
-        RGB += 3;
-
-        rgb[0]=R;
-        rgb[1]=G;
-        rgb[2]=B;
-        rgb += 3;
-
-        if (max_data<=(long)RGB) return;
-
+    const long first = (long) row * width + x;
+    if(source.bits == 8) {
+        if(first + count > source.size) return false;
+        const uchar *data = source.data + first;
+        for(int k = 0; k < count; k++) values[k] = data[k];
+        return true;
+    } else if(!source.packed) {
+        if(2 * (first + count) > source.size) return false;
+        memcpy(values, source.data + 2 * first, count * sizeof(ushort));
+        return true;
     }
+    return CameraKernels::unpack(source.packing, source.data, source.size, first, count, values) == count;
 }
 
-void caCamera::PROC_RGBA8(uchar *RGBA,rgb_interpretation rgb_type, uint *rgb, int sx, int sy, int datasize)
+// bayer, yuv and 8 bit rgb data, every thread converts its rows straight from the received data
+// a row goes through separate red, green and blue values and is then scaled like calcImage does for rgb data
+void caCamera::CameraColorConvert(int sector, int sectorcount, SyncMinMax* MinMax, QSize resultSize, int datasize)
 {
-    int rgb_matrix[5][4]={{0,1,2,3},  //COLOR_RGB
-                          {2,1,0,3},  //COLOR_GBR
-                          {1,0,2,3},  //COLOR_GRB
-                          {2,1,0,3},  //COLOR_BGR
-                          {1,2,0,3}   //COLOR_BRG
-                         };
-
-    long max_data=(long)RGBA + datasize;
-
-    if ((sx==0)||(sy==0)) return;
-    for (long i = 0; i < (sx) * sy ; ++i) {
-        int R, G, B, A;
-
-        R =  RGBA[rgb_matrix[rgb_type][0]];
-        G  = RGBA[rgb_matrix[rgb_type][1]];
-        B  = RGBA[rgb_matrix[rgb_type][2]];
-        A  = RGBA[rgb_matrix[rgb_type][3]];
-
-        RGBA += 4;
-
-        rgb[0]=R;
-        rgb[1]=G;
-        rgb[2]=B;
-        rgb += 3;
-
-        if (max_data<=(long)RGBA) return;
-
-    }
-}
+    Q_UNUSED(datasize);
+    uint Max[2], Min[2];
+    int ystart, yend;
+    long i;
 
+    const int width = resultSize.width();
+    if(source.data == (const uchar *) Q_NULLPTR || rowBuffersPerThread < 5 * width) return;
 
+    InitLoopdata(ystart, yend, i, 1, sector, sectorcount, decodeRect.size(), Max, Min);
+    ystart += decodeRect.top();
+    yend += decodeRect.top();
+    const int b = decodeBinning;
+    const int count = decodeRect.width();
+    const int xs = decodeRect.left() * b;               // first column of the frame
+    const int span = (count - 1) * b + 1;               // columns of the frame holding the pixels of a row
+    // the interpolation also reads the column to the right and starts on an even column to keep the pattern
+    const int bx = xs & ~1;
+    const int bcount = qMin(width, xs + span + 1) - bx;
 
-void caCamera::buf_unpack_12bitpacked_msb(void* target, void* source, size_t destcount, size_t targetcount)
-{
-    size_t x1, x2;
-    unsigned char b0, b1, b2;
-    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 3, x2 = x2 + 2) {
-        b0 = ((char*) source) [x1];
-        b1 = ((char*) source) [x1 + 1];
-        b2 = ((char*) source) [x1 + 2];
-        ((unsigned short*) target) [x2] = (b1 & 0xf) + (b0 << 4);   // valid for Mono12Packet on IOC
-        ((unsigned short*) target) [x2 + 1] = ((b1 & 0xf0) >> 4) + (b2 << 4);
-        if (targetcount<x1+3) return;
-    }
-}
+    float correction = 1.0;
+    if(maxvalue != 0) correction = 255.0 / (float) maxvalue;
+    const float redcoeff = correction * thisRedCoefficient;
+    const float greencoeff = correction * thisGreenCoefficient;
+    const float bluecoeff = correction * thisBlueCoefficient;
+
+    ushort *red = rowBuffers.data() + sector * rowBuffersPerThread;
+    ushort *green = red + width;
+    ushort *blue = green + width;
+    ushort *top = blue + width;
+    ushort *bottom = top + width;
+    int loaded = -1;                // bayer row held in bottom
+
+    for (int y = ystart; y < yend; ++y) {
+        uint *LineData = imageRow(y) + decodeRect.left();
+        const int sy = y * b;                           // row of the frame
+        if(source.bayer) {
+            // the last row has no row below, it stays black like the rows missing in the data
+            bool ok = (sy + 1 < resultSize.height());
+            if(ok) {
+                if(loaded == sy) qSwap(top, bottom);
+                else ok = bayerRow(sy, width, bx, bcount, top);
+                loaded = -1;
+                if(ok && bayerRow(sy + 1, width, bx, bcount, bottom)) loaded = sy + 1;
+                else ok = false;
+            }
+            if(ok) {
+                // the colors of the rows alternate
+                const bool odd = (sy & 1) != 0;
+                const bool redTop = (source.redFirst != odd);
+                CameraKernels::demosaicRow(top, bottom, bcount, source.greenFirst != odd, redTop ? red : blue, green, redTop ? blue : red);
+                if(b > 1 || bx != xs) {
+                    for(int k = 0; k < count; k++) {
+                        const int x = xs - bx + k * b;
+                        red[k] = red[x];
+                        green[k] = green[x];
+                        blue[k] = blue[x];
+                    }
+                }
+            } else {
+                memset(red, 0, 3 * width * sizeof(ushort));
+            }
+        } else if(b == 1) {
+            CameraKernels::colorRow(source.format, source.data, source.size, (long) sy * width + xs, count, red, green, blue);
+        } else {
+            for(int k = 0; k < count; k++) {
+                CameraKernels::colorRow(source.format, source.data, source.size, (long) sy * width + xs + (long) k * b, 1, red + k, green + k, blue + k);
+            }
+        }
 
-void caCamera::buf_unpack_12bitpacked_lsb(void* target, void* source, size_t destcount, size_t targetcount)
-{
-    size_t x1, x2;
-    unsigned char b0, b1, b2;
-    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 3, x2 = x2 + 2) {
-        b0 = ((char*) source) [x1];
-        b1 = ((char*) source) [x1 + 1];
-        b2 = ((char*) source) [x1 + 2];
-        ((unsigned short*) target) [x2] = ((b1 & 0xf)<<8) + (b0);   // valid for our actual basler camera
-        ((unsigned short*) target) [x2 + 1] = ((b1 & 0xf0) >> 4) + (b2 << 4);
-        if (targetcount<x1+3) return;
+        if(thisColormap == as_is || thisColormap > color_to_mono) {
+            CameraKernels::rgbPlanarScale(red, green, blue, LineData, count, redcoeff, greencoeff, bluecoeff, Max[1], Min[1]);
+        } else {
+            for (int x = 0; x < count; ++x) {
+                uint intensity = qMax(qMax(red[x], green[x]), blue[x]);
+                int average =(int) 2.2 * (0.2989 * red[x] * correction + 0.5870 * green[x] * correction + 0.1140 * blue[x] * correction);
+                LineData[x] =  qRgb(average, average, average);
+                Max[(intensity > Max[1])] = intensity;
+                Min[(intensity < Min[1])] = intensity;
+            }
+        }
     }
-}
 
-void caCamera::buf_unpack_10bitpacked(void* target, void* source, size_t destcount, size_t targetcount)
-{
-    size_t x1, x2;
-    unsigned char b0, b1, b2;
-    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 3, x2 = x2 + 2) {
-        b0 = ((char*) source) [x1];
-        b1 = ((char*) source) [x1 + 1];
-        b2 = ((char*) source) [x1 + 2];
-        ((unsigned short*) target) [x2] = ((b1 & 0x30) >> 4 ) + (b0 << 2);
-        ((unsigned short*) target) [x2 + 1] = ((b1 & 0x03) ) + (b2  << 2);
-        if (targetcount<x1+3) return;
-    }
+    MinMaxLock(MinMax, Max, Min);
 }
 
-void caCamera::buf_unpack_10bitp(void* target, void* source, size_t destcount, size_t targetcount)
-{
-    size_t x1, x2;
-    unsigned char b0, b1, b2, b3, b4;
-    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 5, x2 = x2 + 4) {
-        b0 = ((char*) source) [x1];
-        b1 = ((char*) source) [x1 + 1];
-        b2 = ((char*) source) [x1 + 2];
-        b3 = ((char*) source) [x1 + 3];
-        b4 = ((char*) source) [x1 + 4];
-
-        //((unsigned short*) target) [x2] = ((b1 & 0xC0)>>6) + (b0<<2);   // valid for our actual basler camera
-        //((unsigned short*) target) [x2 + 1] = ((b1 & 0x3F)<<4) + ((b2 & 0xF0) >> 4);
-        //((unsigned short*) target) [x2 + 2] = ((b2 & 0x0F)<<6) + ((b3 & 0xFC) >> 2);
-        //((unsigned short*) target) [x2 + 3] = ((b1 & 0x03)<<8) + (b4);
-
-        ((unsigned short*) target) [x2] = ((b1 & 0x03)) + (b0);   // valid for our actual basler camera
-        ((unsigned short*) target) [x2 + 1] = ((b1 & 0xFC)>>2) + ((b2 & 0x0F) << 6);
-        ((unsigned short*) target) [x2 + 2] = ((b2 & 0xF0)>>4) + ((b3 & 0x1F) << 4);
-        ((unsigned short*) target) [x2 + 3] = ((b3 & 0xC0)>>6) + (b4<<2);
-
-
-        if (targetcount<x1+5) return;
-    }
-}
-
-
-
-
-
-
 QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
 {
     QSize resultSize;
     uint Max[2], Min[2];
-    int tile = BAYER_COLORFILTER_BGGR;// bayer tile
     bool bayerMode = false;
     bool yuvMode = false;
     bool monoMode = false;
 
     m_datatype = datatype;
+    statValid = false;
 
     //__itt_event mark_event;
 
@@ -1899,6 +1790,19 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
     resultSize.setWidth(m_width);
     resultSize.setHeight(m_height);
 
+#ifndef QT_NO_CONCURRENT
+    int threadcounter=QThread::idealThreadCount()*2/3;  // seems to be a magic number
+    if(threadcounter < 1) threadcounter = 1;
+#else
+    int threadcounter = 1;
+#endif
+
+    // the 3 channel rgb formats are always converted completely
+    // the others are binned for the zoom or by the adaptation under overload, whichever is coarser
+    const bool completeOnly = (thisColormode == RGB1_CA || thisColormode == RGB2_CA || thisColormode == RGB3_CA);
+    if(completeOnly) decodeBinning = 1;
+    else decodeBinning = qMax(visibleBinning, qualityBinning);
+
     switch (thisCompressionmode){
     case non:{
         decompressedData.resize(0);
@@ -1931,29 +1835,36 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
         break;
     }
     case JPG:{
+#ifdef CAQTDM_TURBOJPEG
+        if(decodeTurboJpeg((const uchar *) data, datasize)) {
+            data = decompressedData.data();
+            savedData = data;
+            datasize = decompressedData.size();
+            savedSizeNew = savedSize = datasize;
+            thisColormode = Mono8;
+            m_datatype = caCHAR;
+            break;
+        }
+#endif
 #if QT_VERSION < QT_VERSION_CHECK(4, 7, 0)
         printf("not yet supported colormode = JPG\n");
         return (QImage *) Q_NULLPTR;
 #else
-        QByteArray qdata=QByteArray((const char*)data,datasize);
+        // the compressed data is read in place and decoded into the image of the last frame, which keeps its buffer
+        // as long as size and format stay the same; the pixels are then converted from there
+        QByteArray qdata=QByteArray::fromRawData((const char*)data,datasize);
         QBuffer databuffer(&qdata);
         QImageReader qimg;
         qimg.setDecideFormatFromContent(true);
         qimg.setDevice(&databuffer);
-        if (qimg.canRead()){
-            QImage* jimage= new QImage(qimg.read());
+        if (qimg.canRead() && qimg.read(&decompressedImage)){
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            decompressedData.resize(jimage->byteCount());
-            memcpy((void*)decompressedData.constData(),(void*)jimage->constBits(),jimage->byteCount());
-            datasize=jimage->byteCount();
-            //printf("datasize=%d:%d:%d (%i)\n",datasize,decompressedData.size(),jimage->byteCount(),jimage->format());
+            datasize=decompressedImage.byteCount();
 #else
-            decompressedData.resize(jimage->sizeInBytes());
-            memcpy((void*)decompressedData.constData(),(void*)jimage->constBits(),jimage->sizeInBytes());
-            datasize=jimage->sizeInBytes();
+            datasize=decompressedImage.sizeInBytes();
 #endif
-            delete jimage;
-            data=(char*)decompressedData.constData();
+            //printf("datasize=%d (%i)\n",datasize,decompressedImage.format());
+            data=(char*)decompressedImage.constBits();
             savedData = data;
             savedSizeNew = savedSize = datasize;
             thisColormode = Mono8;
@@ -1967,7 +1878,53 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
 
         }
 #endif
+        break;
+    }
+    case LZ4:
+    case BSLZ4:{
+        // the blocks are decompressed by the threads straight into the data that is converted afterwards
+        const bool shuffled = (thisCompressionmode == BSLZ4);
+        const int elementSize = shuffled ? compressedElementSize() : 1;
+        const long total = CameraCodecs::blocks((const uchar *) data, datasize, elementSize, codecBlocks);
+        if(total <= 0) {
+            qDebug() << "caCamera: invalid" << compressionModeString.at(thisCompressionmode) << "frame";
+            return (QImage *) Q_NULLPTR;
+        }
+        decompressedData.resize((int) total);
+
+        codecScratchPerThread = 0;
+        if(shuffled) {
+            for(int k = 0; k < codecBlocks.size(); k++) codecScratchPerThread = qMax(codecScratchPerThread, codecBlocks.at(k).targetSize);
+            if(codecScratch.size() < threadcounter * codecScratchPerThread) codecScratch.resize((int) (threadcounter * codecScratchPerThread));
+        }
+
+        bool valid = true;
+#ifndef QT_NO_CONCURRENT
+        if(codecBlocks.size() > 1 && threadcounter > 1) {
+            QFutureSynchronizer<bool> Blocks;
+            for (int x=0;x<threadcounter;x++){
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+                Blocks.addFuture(QtConcurrent::run(this, &caCamera::decompressBlocks, x, threadcounter, (const uchar *) data, elementSize, shuffled));
+#else
+                Blocks.addFuture(QtConcurrent::run(&caCamera::decompressBlocks, this, x, threadcounter, (const uchar *) data, elementSize, shuffled));
+#endif
+            }
+            Blocks.waitForFinished();
+            for(int x=0; x<Blocks.futures().size(); x++) valid = valid && Blocks.futures().at(x).result();
+        } else {
+            valid = decompressBlocks(0, 1, (const uchar *) data, elementSize, shuffled);
+        }
+#else
+        valid = decompressBlocks(0, 1, (const uchar *) data, elementSize, shuffled);
+#endif
+        if(!valid) {
+            qDebug() << "caCamera: error decompressing" << compressionModeString.at(thisCompressionmode) << "image data";
+        }
 
+        data = decompressedData.data();
+        savedData = data;
+        datasize = (int) total;
+        break;
     }
     }
 
@@ -1989,16 +1946,13 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
         maxvalue = 0xFFFFFFFF;
         ftime(&timeRef);
 
-        if(rgb != (uint*)Q_NULLPTR) free(rgb);
-        ulong rgbsize = 3*m_width*m_height*sizeof(uint);
-        rgb = (uint *) malloc(rgbsize);
-
-        //printf("rgb(%x) size now define to %d uints => %d chars, received %d chars\n",rgb, 3*m_width*m_height, rgbsize, datasize);
-        //fflush(stdout);
-
-        // force resize
-        QResizeEvent *re = new QResizeEvent(size(), size());
-        resizeEvent(re);
+        // force resize, from the decode worker this is left to decodeFinished
+        if(decodeRunning) {
+            resizePending = true;
+        } else {
+            QResizeEvent *re = new QResizeEvent(size(), size());
+            resizeEvent(re);
+        }
     }
 
 
@@ -2007,27 +1961,36 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
 
     if(data == (void*)Q_NULLPTR) return (QImage *) Q_NULLPTR;
     if(datasize == 0) return (QImage *) Q_NULLPTR;
-    if(rgb == (uint *)Q_NULLPTR) {
-        printf("caCamera -- could not allocate rgb buffer\n");
-        return (QImage *) Q_NULLPTR;
-    }
-
 
+    // the threads write straight into the scanlines of image, with the double buffering it is not shared any more
+    // and is only detached here when it still is
+    reallocate_central_image();
+    imageBits = image->bits();
+    imageStride = image->bytesPerLine();
+
+    // the part of image to convert, all of it without decodeVisible
+    const QRect imageRect(0, 0, image->width(), image->height());
+    decodeRect = imageRect;
+    if(!visibleRect.isNull() && !completeOnly) {
+        const int b = decodeBinning;
+        decodeRect = QRect(QPoint(visibleRect.left() / b, visibleRect.top() / b), QPoint(visibleRect.right() / b, visibleRect.bottom() / b)) & imageRect;
+        if(decodeRect.isEmpty()) decodeRect = imageRect;
+    }
+    decodePart = (decodeRect != imageRect || decodeBinning > 1);
 
     SyncMinMax MinMax;
     MinMax.Max[1] = 0;
     MinMax.Min[1] = 65535;
-    MinMax.MinMaxLock=new QMutex();
-    MinMax.imageLock=new QMutex();
 
     colormode auxMode = thisColormode;
     short auxDatatype = m_datatype;
 
-    int sx = m_width; // resultSize.width();
-    int sy = m_height;// resultSize.height();
-
     void (caCamera::*CameraDataConvert) (int sector, int sectorcount, SyncMinMax* MinMax, QSize resultSize, int datasize) = NULL;
 
+    source.data = (const uchar *) data;
+    source.size = datasize;
+    source.bayer = source.packed = false;
+
     //printf("datatype=%d %s colormode=%d %s\n", datatype, caTypeStr[datatype], thisColormode, qasc(colorModeString.at(thisColormode)));
    // printf("thisColormode %i\n",thisColormode);
     fflush(stdout);
@@ -2038,38 +2001,32 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
         CameraDataConvert = &caCamera::CameraDataConvert;
         break;
 
-    case Mono12p:{
+    case Mono12p:
         bitsPerElement = 16;
         monoMode=true;
         thisColormode = Mono;
         m_datatype = caINT;
-        if(thisPackingmode == LSB12Bit) buf_unpack_12bitpacked_lsb(rgb, (uchar*) data, sx*sy*2,datasize);
-        if(thisPackingmode == MSB12Bit) buf_unpack_12bitpacked_msb(rgb, (uchar*) data, sx*sy*2,datasize);
-        if(thisPackingmode == packNo)   memcpy(rgb,data,datasize);
-        savedData= (char *) rgb;
-        savedSizeNew = 2*sx*sy*sizeof(uint);
-        CameraDataConvert = &caCamera::CameraDataConvert;
-        break;
+        savedData = data;
+        savedSizeNew = datasize;
+        if(thisPackingmode == packNo) {
+            CameraDataConvert = &caCamera::CameraDataConvert;
+        } else {
+            source.packed = true;
+            source.packing = (thisPackingmode == LSB12Bit) ? CameraKernels::packed12lsb : CameraKernels::packed12msb;
+            CameraDataConvert = &caCamera::CameraPackedConvert;
         }
-    case Mono10p:
-        bitsPerElement = 10;
-        monoMode=true;
-        thisColormode = Mono;
-        m_datatype = caINT;
-        buf_unpack_10bitp(rgb, (uchar*) data, sx*sy*2,datasize);
-        savedData= (char *) rgb;
-        savedSizeNew = 2*sx*sy*sizeof(uint);
-        CameraDataConvert = &caCamera::CameraDataConvert;
         break;
+    case Mono10p:
     case Mono10Packed:
         bitsPerElement = 10;
         monoMode=true;
+        source.packed = true;
+        source.packing = (thisColormode == Mono10p) ? CameraKernels::packed10p : CameraKernels::packed10;
         thisColormode = Mono;
         m_datatype = caINT;
-        buf_unpack_10bitpacked(rgb, (uchar*) data, sx*sy*2,datasize);
-        savedData= (char *) rgb;
-        savedSizeNew = 2*sx*sy*sizeof(uint);
-        CameraDataConvert = &caCamera::CameraDataConvert;
+        savedData = data;
+        savedSizeNew = datasize;
+        CameraDataConvert = &caCamera::CameraPackedConvert;
         break;
 
     case Mono8:
@@ -2097,39 +2054,27 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
     case BayerGR_12:
     case BayerBG_12:
         bayerMode = true;
+        source.bayer = true;
         // which tile to use
-        if     ((thisColormode == BayerRG_8) || (thisColormode == BayerRG_12)) tile = BAYER_COLORFILTER_RGGB;
-        else if((thisColormode == BayerGB_8) || (thisColormode == BayerGB_12)) tile = BAYER_COLORFILTER_GBRG;
-        else if((thisColormode == BayerGR_8) || (thisColormode == BayerGR_12)) tile = BAYER_COLORFILTER_GRBG;
-        else if((thisColormode == BayerBG_8) || (thisColormode == BayerBG_12)) tile = BAYER_COLORFILTER_BGGR;
+        source.greenFirst = (thisColormode == BayerGB_8) || (thisColormode == BayerGB_12) || (thisColormode == BayerGR_8) || (thisColormode == BayerGR_12);
+        source.redFirst = (thisColormode == BayerRG_8) || (thisColormode == BayerRG_12) || (thisColormode == BayerGR_8) || (thisColormode == BayerGR_12);
         // how many bits per element and packing
         if((thisColormode == BayerRG_8) || (thisColormode == BayerGB_8) || (thisColormode == BayerGR_8) || (thisColormode == BayerBG_8)) {
             bitsPerElement = 8;
-        } else if((thisColormode == BayerRG_12) || (thisColormode == BayerGB_12) || (thisColormode == BayerGR_12) || (thisColormode == BayerBG_12)) {
+        } else {
             bitsPerElement = 12;
+            source.packed = (thisPackingmode > packNo);
+            source.packing = (thisPackingmode == LSB12Bit) ? CameraKernels::packed12lsb : CameraKernels::packed12msb;
         }
+        source.bits = bitsPerElement;
         thisColormode = RGB1_CA;
         m_datatype = caLONG;
 
-        //printf("bitsperlement=%d datasize=%d sx=%d sy=%d\n",bitsPerElement,  datasize, sx, sy);
+        //printf("bitsperlement=%d datasize=%d\n",bitsPerElement,  datasize);
         //fflush(stdout);
-        if(bitsPerElement == 8) {
-            FilterBayer((uchar *) data, rgb, sx, sy, tile,datasize);
-        } else if((bitsPerElement == 12) && (thisPackingmode == packNo)) {
-            FilterBayer((ushort *) data, rgb, sx, sy, tile,datasize);
-        } else if((bitsPerElement == 12) && (thisPackingmode > packNo)) {
-            int unpacked_datasize=2*sizeof(ushort) * datasize + 1;
-            ushort *unpacked = (ushort *) malloc(unpacked_datasize);
-            if(thisPackingmode == LSB12Bit) buf_unpack_12bitpacked_lsb(unpacked, (uchar*) data, sx*sy*2,datasize);
-            else buf_unpack_12bitpacked_msb(unpacked, (uchar*) data, sx*sy*2,datasize);
-            FilterBayer((ushort *) unpacked, rgb, sx, sy, tile, unpacked_datasize);
-            free(unpacked);
-        }
-
-        savedData= (char *) rgb;
-        savedSizeNew = 3*sx*sy*sizeof(uint);
-
-        CameraDataConvert = &caCamera::CameraDataConvert;
+        savedData = data;
+        savedSizeNew = datasize;
+        CameraDataConvert = &caCamera::CameraColorConvert;
         break;
 
     case RGB_8:
@@ -2138,16 +2083,16 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
     case BGRA_8:
         bayerMode = true;
 
-        if(thisColormode == RGB_8) PROC_RGB8((uchar *) data, COLOR_RGB ,rgb, sx, sy,datasize);
-        else if(thisColormode == BGR_8) PROC_RGB8((uchar *) data, COLOR_BGR ,rgb, sx, sy,datasize);
-        else if(thisColormode == RGBA_8) PROC_RGBA8((uchar *) data, COLOR_RGB ,rgb, sx, sy,datasize);
-        else if(thisColormode == BGRA_8) PROC_RGBA8((uchar *) data, COLOR_BGR ,rgb, sx, sy,datasize);
+        if(thisColormode == RGB_8) source.format = CameraKernels::rgb8;
+        else if(thisColormode == BGR_8) source.format = CameraKernels::bgr8;
+        else if(thisColormode == RGBA_8) source.format = CameraKernels::rgba8;
+        else source.format = CameraKernels::bgra8;
 
         thisColormode = RGB1_CA;
         m_datatype = caLONG;
-        savedData= (char *) rgb;
-        savedSizeNew = 3*sx*sy*sizeof(uint);
-        CameraDataConvert = &caCamera::CameraDataConvert;
+        savedData = data;
+        savedSizeNew = datasize;
+        CameraDataConvert = &caCamera::CameraColorConvert;
         break;
 
     case YUV411:
@@ -2156,35 +2101,18 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
         yuvMode = true;
 
         if(thisColormode == YUV411) {
-
-            if (thisPackingmode==Reversed){
-                PROC_UYYVYY411((uchar *) data, rgb, sx, sy,datasize);
-            } else{
-                PROC_YYUYYV411((uchar *) data, rgb, sx, sy,datasize);
-            }
-
+            source.format = (thisPackingmode == Reversed) ? CameraKernels::uyyvyy411 : CameraKernels::yyuyyv411;
         } else if(thisColormode == YUV422) {
-
-            if (thisPackingmode==Reversed){
-                PROC_UYVY422((uchar *) data, rgb, sx, sy,datasize);
-            } else{
-                PROC_YUYV422((uchar *) data, rgb, sx, sy,datasize);
-            }
-
-        } else if(thisColormode == YUV444) {
-
-            if (thisPackingmode==Reversed){
-                PROC_UVY444((uchar *) data, rgb, sx, sy,datasize);
-            } else{
-                PROC_YUV444((uchar *) data, rgb, sx, sy,datasize);
-            }
+            source.format = (thisPackingmode == Reversed) ? CameraKernels::uyvy422 : CameraKernels::yuyv422;
+        } else {
+            source.format = (thisPackingmode == Reversed) ? CameraKernels::uvy444 : CameraKernels::yuv444;
         }
 
         thisColormode = RGB1_CA;
         m_datatype = caLONG;
-        savedData= (char *) rgb;
-        savedSizeNew = 3*sx*sy*sizeof(uint);
-        CameraDataConvert = &caCamera::CameraDataConvert;
+        savedData = data;
+        savedSizeNew = datasize;
+        CameraDataConvert = &caCamera::CameraColorConvert;
         break;
 
     case YUV421:
@@ -2207,20 +2135,34 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
         painter.drawText(5, 10 + 7 * lineHeight, "HW Ref.:  Basler acA4600-10uc/acA1300-30gc  ");
         painter.drawText(5, 10 + 8 * lineHeight, "HW Ref.:  Prosilica GC1660C  ");
 
-        delete MinMax.MinMaxLock;
-        delete MinMax.imageLock;
-
         return image;
     }
 
+    // statistics for mono data, also when packed, every thread keeps its own x projection
+    statRunning = false;
+    if(!statRect.isEmpty() && thisColormode == Mono) {
+        statRect &= QRect(0, 0, m_width, m_height);
+        statRunning = !statRect.isEmpty();
+    }
+    if(statRunning) {
+        statProjY.fill(0.0, statRect.height());
+        statSectorProjX.resize(threadcounter * statRect.width());
+    }
+
+    // the value table is shared by the threads, so it has to be ready before they start
+    if(thisColormode == Mono && m_datatype == caCHAR) updateValueTable(256);
+    else if(thisColormode == Mono && m_datatype == caINT) updateValueTable(65536);
+
+    // rows for the color conversion and the samples of the binned mono conversion, only allocated again when the width grows
+    // every thread starts on 8 bytes, so that the samples can also be 32 and 64 bit values
+    rowBuffersPerThread = (5 * m_width + 3) & ~3;
+    if(rowBuffers.size() < threadcounter * rowBuffersPerThread) rowBuffers.resize(threadcounter * rowBuffersPerThread);
+
 #ifndef QT_NO_CONCURRENT
 
     //mark_event = __itt_event_create( "User Mark", 9 );
     //__itt_event_start( mark_event );
 
-    int threadcounter=QThread::idealThreadCount()*2/3;  // seems to be a magic number
-    if(threadcounter < 1) threadcounter = 1;
-
     QFutureSynchronizer<void> Sectors;
     for (int x=0;x<threadcounter;x++){
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -2239,8 +2181,8 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
     (this->*CameraDataConvert)(0, 1, &MinMax, resultSize, savedSizeNew);
 #endif
 
-    delete MinMax.MinMaxLock;
-    delete MinMax.imageLock;
+    if(statRunning) roiStatisticsFinish(threadcounter);
+
     Max[1]=MinMax.Max[1];
     Min[1]=MinMax.Min[1];
 
@@ -2261,15 +2203,347 @@ QImage *caCamera::showImageCalc(int datasize, char *data, short datatype)
     return image;
 }
 
+// with the property decodeWorker or the environment variable CAQTDM_CAMERA_DECODEWORKER
+// the frames are decoded off the gui thread, a frame coming while the worker is busy replaces the one still waiting
+bool caCamera::decodeWorker()
+{
+#ifndef QT_NO_CONCURRENT
+    if(thisDecodeWorker) return true;
+    return !qgetenv("CAQTDM_CAMERA_DECODEWORKER").isEmpty();
+#else
+    return false;
+#endif
+}
+
+// with the property decodeVisible or the environment variable CAQTDM_CAMERA_DECODEVISIBLE only the part of the frame
+// shown in the scroll area is converted, and only every n'th pixel of every n'th row when it is shown at less than 1/n of its size
+bool caCamera::decodeVisible()
+{
+    if(thisDecodeVisible) return true;
+    return !qgetenv("CAQTDM_CAMERA_DECODEVISIBLE").isEmpty();
+}
+
+// called in the gui thread before a frame is decoded, the decoding uses the region of that time
+void caCamera::updateDecodeRegion()
+{
+    visibleRect = QRect();
+    visibleBinning = 1;
+    if(!decodeVisible() || m_width <= 0 || m_height <= 0 || imageW == (ImageWidget *) Q_NULLPTR) return;
+
+    double scale = scaleFactor;
+    if(thisFitToSize) {
+        // the whole image is fitted into the widget
+        scale = qMin((double) imageW->width() / (double) m_width, (double) imageW->height() / (double) m_height);
+    } else if(scrollArea != (QScrollArea *) Q_NULLPTR && scale > 0.0) {
+        // the viewport with a margin, so that scrolling a little does not show pixels of older frames
+        const int margin = 32;
+        const int x = scrollArea->horizontalScrollBar()->value() - margin;
+        const int y = scrollArea->verticalScrollBar()->value() - margin;
+        const int w = scrollArea->viewport()->width() + 2 * margin;
+        const int h = scrollArea->viewport()->height() + 2 * margin;
+        visibleRect = QRect(qFloor(x / scale), qFloor(y / scale), qCeil(w / scale) + 1, qCeil(h / scale) + 1) & QRect(0, 0, m_width, m_height);
+        if(visibleRect.isEmpty()) visibleRect = QRect();
+    }
+    if(scale > 0.0 && scale < 1.0) visibleBinning = qMax(1, (int) floor(1.0 / scale));
+}
+
+// called in the gui thread before a frame is decoded, like updateDecodeRegion; the statistics are computed for the region
+// read back from the roi channels, else for the one selected, else for the whole frame and only when soft channels are given for them
+void caCamera::updateStatisticsRegion()
+{
+    statRect = QRect();
+    if(getROIStatisticsChannels().isEmpty() || m_width <= 0 || m_height <= 0) return;
+
+    QRect region;
+    if(readvaluesPresent[0] && readvaluesPresent[1] && readvaluesPresent[2] && readvaluesPresent[3]) {
+        if(thisROIreadtype == xy1_xy2 || thisROIreadtype == xyUpleft_xyLowright) {
+            region = QRect(QPoint(qRound(readvalues[0]), qRound(readvalues[1])), QPoint(qRound(readvalues[2]), qRound(readvalues[3]))).normalized();
+        } else if(thisROIreadtype == xycenter_width_height) {
+            region = QRect(qRound(readvalues[0] - readvalues[2] / 2.0), qRound(readvalues[1] - readvalues[3] / 2.0), qRound(readvalues[2]), qRound(readvalues[3]));
+        }
+    }
+    if(region.isEmpty() && thisROIwritetype != none && thisROIwritetype != xy_only && P1 != P2) {
+        region = QRect(QPoint(qRound(P1.x()), qRound(P1.y())), QPoint(qRound(P2.x()), qRound(P2.y()))).normalized();
+    }
+    region &= QRect(0, 0, m_width, m_height);
+    statRect = region.isEmpty() ? QRect(0, 0, m_width, m_height) : region;
+}
+
+// sums of the rows ystart to yend of statRect into statProjY and of their columns into projX
+template <typename pureData> void caCamera::roiStatisticsRows (pureData *ptr, long datasize, int ystart, int yend, double *projX)
+{
+    const int count = statRect.width();
+    for (int y = ystart; y < yend; y++) {
+        const long first = (long) y * m_width + statRect.left();
+        if(first + count > datasize) break;
+        const pureData *row = ptr + first;
+        double rowSum = 0.0;
+        for (int x = 0; x < count; x++) {
+            const double value = (double) row[x];
+            rowSum += value;
+            projX[x] += value;
+        }
+        statProjY[y - statRect.top()] = rowSum;
+    }
+}
+
+// like roiStatisticsRows for packed data, every row is unpacked into values first
+void caCamera::roiStatisticsPackedRows (int ystart, int yend, ushort *values, double *projX)
+{
+    const int count = statRect.width();
+    for (int y = ystart; y < yend; y++) {
+        const long first = (long) y * m_width + statRect.left();
+        if(CameraKernels::unpack(source.packing, source.data, source.size, first, count, values) < count) break;
+        double rowSum = 0.0;
+        for (int x = 0; x < count; x++) {
+            const double value = (double) values[x];
+            rowSum += value;
+            projX[x] += value;
+        }
+        statProjY[y - statRect.top()] = rowSum;
+    }
+}
+
+// datasize is the number of values for unpacked data, values a row of statRect for unpacking packed data
+void caCamera::roiStatisticsSector(int sector, int sectorcount, int datasize, ushort *values)
+{
+    const int ystart = statRect.top() + sector * statRect.height() / sectorcount;
+    const int yend = statRect.top() + (sector + 1) * statRect.height() / sectorcount;
+    double *projX = statSectorProjX.data() + (long) sector * statRect.width();
+    for (int x = 0; x < statRect.width(); x++) projX[x] = 0.0;
+
+    if(source.packed) {
+        if(values != (ushort *) Q_NULLPTR) roiStatisticsPackedRows (ystart, yend, values, projX);
+        return;
+    }
+
+    switch (m_datatype) {
+    case caCHAR:
+        roiStatisticsRows ((uchar*) savedData, datasize, ystart, yend, projX);
+        break;
+    case caINT:
+        roiStatisticsRows ((ushort*) savedData, datasize, ystart, yend, projX);
+        break;
+    case caLONG:
+        roiStatisticsRows ((uint*) savedData, datasize, ystart, yend, projX);
+        break;
+    case caFLOAT:
+        roiStatisticsRows ((float*) savedData, datasize, ystart, yend, projX);
+        break;
+    case caDOUBLE:
+        roiStatisticsRows ((double*) savedData, datasize, ystart, yend, projX);
+        break;
+    default:
+        break;
+    }
+}
+
+// after the threads: the x projections of the sectors added, the moments taken from the projections
+void caCamera::roiStatisticsFinish(int sectorcount)
+{
+    const int width = statRect.width();
+    const int height = statRect.height();
+    statProjX.fill(0.0, width);
+    for (int s = 0; s < sectorcount; s++) {
+        const double *projX = statSectorProjX.constData() + (long) s * width;
+        for (int x = 0; x < width; x++) statProjX[x] += projX[x];
+    }
+
+    double sum = 0.0, sumX = 0.0, sumY = 0.0;
+    for (int x = 0; x < width; x++) sumX += statProjX.at(x) * (double) (statRect.left() + x);
+    for (int y = 0; y < height; y++) {
+        sum += statProjY.at(y);
+        sumY += statProjY.at(y) * (double) (statRect.top() + y);
+    }
+
+    statValues[0] = sum;
+    statValues[1] = sum / ((double) width * (double) height);
+    if(sum != 0.0) {
+        const double centerX = sumX / sum;
+        const double centerY = sumY / sum;
+        double varX = 0.0, varY = 0.0;
+        for (int x = 0; x < width; x++) {
+            const double d = (double) (statRect.left() + x) - centerX;
+            varX += statProjX.at(x) * d * d;
+        }
+        for (int y = 0; y < height; y++) {
+            const double d = (double) (statRect.top() + y) - centerY;
+            varY += statProjY.at(y) * d * d;
+        }
+        statValues[2] = centerX;
+        statValues[3] = centerY;
+        statValues[4] = sqrt(qMax(0.0, varX / sum));
+        statValues[5] = sqrt(qMax(0.0, varY / sum));
+    } else {
+        statValues[2] = statValues[3] = statValues[4] = statValues[5] = qQNaN();
+    }
+    statValid = true;
+}
+
+bool caCamera::getROIStatistics(double values[ROISTATISTICS_VALUES], QVector<double> &projectionX, QVector<double> &projectionY)
+{
+    if(!statValid) return false;
+    for (int i = 0; i < ROISTATISTICS_VALUES; i++) values[i] = statValues[i];
+    projectionX = statProjX;
+    projectionY = statProjY;
+    return true;
+}
+
+// with the property maxDisplayRate or the environment variable CAQTDM_CAMERA_MAXRATE at most that many frames per second
+// are decoded, lowered further by the adaptation; 0 for no limit, the property left at 0 uses the environment variable
+double caCamera::displayRate()
+{
+    double rate = thisMaxDisplayRate;
+    if(rate <= 0.0) {
+        QByteArray env = qgetenv("CAQTDM_CAMERA_MAXRATE");
+        if(!env.isEmpty()) rate = env.toDouble();
+    }
+    if(rate < 0.0) rate = 0.0;
+    if(adaptiveRate > 0.0 && (rate <= 0.0 || adaptiveRate < rate)) rate = adaptiveRate;
+    return rate;
+}
+
+// with the property adaptiveQuality or the environment variable CAQTDM_CAMERA_ADAPTIVE frames are dropped under overload,
+// then decoded subsampled, and the full quality is restored when the load falls
+bool caCamera::adaptiveQuality()
+{
+    if(thisAdaptiveQuality) return true;
+    return !qgetenv("CAQTDM_CAMERA_ADAPTIVE").isEmpty();
+}
+
+// called every second with the part of the time spent decoding, the frames per second arrived and shown
+void caCamera::adaptQuality(double busy, double arrived, double shown)
+{
+    if(!adaptiveQuality()) {
+        adaptiveRate = 0.0;
+        qualityBinning = 1;
+        calmSeconds = 0;
+        return;
+    }
+
+    if(busy > ADAPTIVE_BUSY_HIGH) {
+        // first fewer frames down to the lowest rate, then every n'th pixel of every n'th row
+        calmSeconds = 0;
+        const double current = (adaptiveRate > 0.0) ? adaptiveRate : shown;
+        if(current > ADAPTIVE_MIN_RATE) {
+            adaptiveRate = qMax(ADAPTIVE_MIN_RATE, current * 0.7);
+        } else if(qualityBinning < ADAPTIVE_MAX_BINNING) {
+            adaptiveRate = ADAPTIVE_MIN_RATE;
+            qualityBinning *= 2;
+        }
+    } else if(busy < ADAPTIVE_BUSY_LOW && (adaptiveRate > 0.0 || qualityBinning > 1)) {
+        // back in the reverse order after some calm seconds, a step is only taken when its load stays below the limit
+        if(++calmSeconds < 3) return;
+        calmSeconds = 0;
+        if(qualityBinning > 1) {
+            if(busy * 4.0 < ADAPTIVE_BUSY_HIGH) qualityBinning /= 2;
+        } else if(busy * 1.5 < ADAPTIVE_BUSY_HIGH) {
+            adaptiveRate *= 1.5;
+            if(adaptiveRate >= arrived) adaptiveRate = 0.0;
+        }
+    } else {
+        calmSeconds = 0;
+    }
+}
+
+// ms to wait before the next frame may be decoded
+int caCamera::frameDelay()
+{
+    const double rate = displayRate();
+    if(rate <= 0.0 || !lastDecodeStart.isValid()) return 0;
+    const qint64 wait = (qint64) (1000.0 / rate) - lastDecodeStart.elapsed();
+    return (wait > 0) ? (int) wait : 0;
+}
+
 void caCamera::showImage(int datasize, char *data, short datatype)
 {
-    //QElapsedTimer timer;
-    //timer.start();
+    arrivedFrames++;
+    const int delay = frameDelay();
+    if(decodeRunning || decodeWorker() || delay > 0 || rateTimer->isActive()) {
+        // the data belongs to the channel, so the frame is copied into the waiting buffer
+        if(framePending) droppedFrames++;
+        if(data == (char *) Q_NULLPTR) datasize = 0;
+        pendingBuffer.resize(datasize);
+        if(datasize > 0) memcpy(pendingBuffer.data(), data, datasize);
+        pendingDatatype = datatype;
+        pendingTimer.start();
+        framePending = true;
+        // a frame decoded now would come too early, the newest one waiting is decoded when it is time
+        if(decodeRunning || rateTimer->isActive()) return;
+        if(delay > 0) {
+            rateTimer->start(delay);
+            return;
+        }
+        startDecode();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    lastDecodeStart.start();
+    lastFrameKept = decodeVisible();
+    if(lastFrameKept) {
+        // kept to be decoded again when another region is shown, the data belongs to the channel
+        if(data == (char *) Q_NULLPTR) datasize = 0;
+        decodeBuffer.resize(datasize);
+        if(datasize > 0) memcpy(decodeBuffer.data(), data, datasize);
+        decodeDatatype = datatype;
+        data = decodeBuffer.data();
+    }
+    updateDecodeRegion();
+    updateStatisticsRegion();
     QImage *localimage = showImageCalc(datasize, data, datatype);
     //printf("Image timer 1 : %d (%x) milliseconds \n", (int) timer.elapsed(),image);
     //fflush(stdout);
 
-    if(localimage != (QImage *)Q_NULLPTR) updateImage(*localimage, readvaluesPresent, readvalues, scaleFactor, X, Y);
+    imageDecoded(localimage, timer);
+    busyNs += timer.nsecsElapsed();
+}
+
+// the frame waiting in pendingBuffer decoded in the gui thread, from decodeBuffer that stays as long as savedData may point into it
+void caCamera::decodePendingNow()
+{
+    qSwap(decodeBuffer, pendingBuffer);
+    decodeDatatype = pendingDatatype;
+    lastFrameKept = true;
+    framePending = false;
+
+    QElapsedTimer timer;
+    timer.start();
+    lastDecodeStart.start();
+    updateDecodeRegion();
+    updateStatisticsRegion();
+    QImage *localimage = showImageCalc(decodeBuffer.size(), decodeBuffer.data(), pendingDatatype);
+    imageDecoded(localimage, pendingTimer);
+    busyNs += timer.nsecsElapsed();
+}
+
+// the waiting frame is decoded when its time has come and nothing else is decoded
+void caCamera::pendingDue()
+{
+    if(decodeRunning || !framePending) return;
+    const int delay = frameDelay();
+    if(delay > 0) {
+        rateTimer->start(delay);
+        return;
+    }
+    if(decodeWorker()) startDecode();
+    else decodePendingNow();
+}
+
+void caCamera::imageDecoded(QImage *localimage, const QElapsedTimer &arrival)
+{
+    // the new image goes to the front, the next frame is converted into the one shown until now
+    // which the image widget does not hold any more, so it is not copied when written
+    if(localimage != (QImage *)Q_NULLPTR && localimage == image) {
+        image = frontImage;
+        frontImage = localimage;
+    }
+    if(localimage != (QImage *)Q_NULLPTR) {
+        imageW->setBinning(decodeBinning, QSize(m_width, m_height));
+        updateImage(*localimage, readvaluesPresent, readvalues, scaleFactor, X, Y);
+    }
+    if(statValid) emit ROIStatisticsSignal(this);
 
     if(getAutomateChecked()) {
         updateMax(maxvalue);
@@ -2288,6 +2562,99 @@ void caCamera::showImage(int datasize, char *data, short datatype)
     }
 
     UpdatesPerSecond++;
+    decodedFrames++;
+    latencySum += (double) arrival.nsecsElapsed() / 1.0e6;
+    latencyCount++;
+}
+
+void caCamera::startDecode()
+{
+#ifndef QT_NO_CONCURRENT
+    qSwap(decodeBuffer, pendingBuffer);
+    decodeDatatype = pendingDatatype;
+    lastFrameKept = true;
+    decodeTimer = pendingTimer;
+    framePending = false;
+    decodeRunning = true;
+    lastDecodeStart.start();
+    updateDecodeRegion();
+    updateStatisticsRegion();
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    decodeWatcher->setFuture(QtConcurrent::run(this, &caCamera::decodeImage, pendingDatatype));
+#else
+    decodeWatcher->setFuture(QtConcurrent::run(&caCamera::decodeImage, this, pendingDatatype));
+#endif
+#endif
+}
+
+// runs in the decode worker, the widgets are only touched again in decodeFinished
+QImage *caCamera::decodeImage(short datatype)
+{
+    return showImageCalc(decodeBuffer.size(), (char *) decodeBuffer.constData(), datatype);
+}
+
+// the settings used by the decode worker are only changed when it is done
+void caCamera::waitForDecode()
+{
+#ifndef QT_NO_CONCURRENT
+    if(decodeRunning) decodeWatcher->waitForFinished();
+#endif
+}
+
+void caCamera::decodeFinished()
+{
+#ifndef QT_NO_CONCURRENT
+    QImage *localimage = decodeWatcher->result();
+    decodeRunning = false;
+    lastColormode = thisColormode;
+    lastDatatype = m_datatype;
+
+    if(resizePending) {
+        resizePending = false;
+        QResizeEvent re(size(), size());
+        resizeEvent(&re);
+    }
+
+    imageDecoded(localimage, decodeTimer);
+    busyNs += lastDecodeStart.nsecsElapsed();
+
+    if(intensityPending) {
+        intensityPending = false;
+        if(savedData != (char*)Q_NULLPTR) showIntensity();
+    }
+
+    if(framePending) pendingDue();
+    else if(regionPending) redecodeVisible();
+#endif
+}
+
+// with decodeVisible only the region shown was decoded, when scrolling, zooming or resizing shows another one
+// the last frame is decoded again for it; a frame waiting is decoded for the new region anyway
+void caCamera::redecodeVisible()
+{
+    if(!decodeVisible() || !lastFrameKept || decodeBuffer.isEmpty() || framePending) return;
+    if(decodeRunning) {
+        regionPending = true;
+        return;
+    }
+    regionPending = false;
+
+    const QRect lastRect = visibleRect;
+    const int lastBinning = visibleBinning;
+    updateDecodeRegion();
+    if(visibleRect == lastRect && visibleBinning == lastBinning) return;
+
+    // the same frame again, its statistics were already given
+    statRect = QRect();
+    QImage *localimage = showImageCalc(decodeBuffer.size(), decodeBuffer.data(), decodeDatatype);
+    if(localimage != (QImage *)Q_NULLPTR && localimage == image) {
+        image = frontImage;
+        frontImage = localimage;
+    }
+    if(localimage != (QImage *)Q_NULLPTR) {
+        imageW->setBinning(decodeBinning, QSize(m_width, m_height));
+        updateImage(*localimage, readvaluesPresent, readvalues, scaleFactor, X, Y);
+    }
 }
 
 void caCamera::setData(double *array, int size, int curvIndex, int curvType, int curvXY)
@@ -60,15 +60,33 @@
 #endif
 
 #include <stdint.h>
+#include <QElapsedTimer>
+#ifndef QT_NO_CONCURRENT
+#include <QFutureWatcher>
+#endif
 
 #include "colormaps.h"
+#include "camerakernels.h"
+#include "cameracodecs.h"
 #include "caPropHandleDefs.h"
 
+// sum, mean, centroid x and y, rms width x and y of the region of interest
+#define ROISTATISTICS_VALUES 6
+
+// adaptation under overload: part of the time spent decoding above which frames are dropped, then subsampled,
+// below which the quality is restored step by step, the lowest rate before subsampling and the largest binning
+#define ADAPTIVE_BUSY_HIGH 0.7
+#define ADAPTIVE_BUSY_LOW 0.35
+#define ADAPTIVE_MIN_RATE 5.0
+#define ADAPTIVE_MAX_BINNING 4
+
+// ms after the last scroll, zoom or resize before decodeVisible decodes the last frame again for the region shown
+#define REGION_DELAY 50
+
 struct SyncMinMax{
     uint Max[2];
     uint Min[2];
-    QMutex * MinMaxLock;
-    QMutex * imageLock;
+    QMutex MinMaxLock;
 };
 
 class QTCON_EXPORT caCamera : public QWidget
@@ -115,6 +133,12 @@ class QTCON_EXPORT caCamera : public QWidget
     Q_PROPERTY(QString channelXaverage  READ getPV_Xaverage WRITE setPV_Xaverage)
     Q_PROPERTY(QString channelYaverage  READ getPV_Yaverage WRITE setPV_Yaverage)
 
+    Q_PROPERTY(bool decodeWorker READ getDecodeWorker WRITE setDecodeWorker)
+    Q_PROPERTY(bool decodeVisible READ getDecodeVisible WRITE setDecodeVisible)
+    Q_PROPERTY(double maxDisplayRate READ getMaxDisplayRate WRITE setMaxDisplayRate)
+    Q_PROPERTY(bool adaptiveQuality READ getAdaptiveQuality WRITE setAdaptiveQuality)
+    Q_PROPERTY(QString roiStatisticsChannels READ getROIStatisticsChannels WRITE setROIStatisticsChannels)
+
     // this will prevent user interference
     Q_PROPERTY(QString styleSheet READ styleSheet WRITE noStyle DESIGNABLE false)
 
@@ -143,7 +167,7 @@ public:
 
     enum packingmode {packNo, MSB12Bit, LSB12Bit, Reversed};
 
-    enum compressionmode {non = 0, Zlib, JPG };
+    enum compressionmode {non = 0, Zlib, JPG, LZ4, BSLZ4};
 
     enum Properties { customcolormap = 0, discretecolormap};
 
@@ -157,12 +181,12 @@ public:
     void showImage(int datasize, char *data, short datatype);
 
     colormode getColormode() const {return thisColormode;}
-    void setColormode(colormode const &mode) {thisColormode = mode; if(colormodeCombo != (QComboBox*)Q_NULLPTR) colormodeCombo->setCurrentIndex(mode);}
+    void setColormode(colormode const &mode) {waitForDecode(); thisColormode = mode; if(colormodeCombo != (QComboBox*)Q_NULLPTR) colormodeCombo->setCurrentIndex(mode);}
 
-    void setPackmode(packingmode mode) {thisPackingmode = mode; if(packingmodeCombo != (QComboBox*)Q_NULLPTR) packingmodeCombo->setCurrentIndex(mode);}
+    void setPackmode(packingmode mode) {waitForDecode(); thisPackingmode = mode; if(packingmodeCombo != (QComboBox*)Q_NULLPTR) packingmodeCombo->setCurrentIndex(mode);}
     packingmode getPackmode() {return thisPackingmode;}
 
-    void setCompressionmode(compressionmode mode) {thisCompressionmode = mode; if(compressionmodeCombo != (QComboBox*)Q_NULLPTR) compressionmodeCombo->setCurrentIndex(mode);}
+    void setCompressionmode(compressionmode mode) {waitForDecode(); thisCompressionmode = mode; if(compressionmodeCombo != (QComboBox*)Q_NULLPTR) compressionmodeCombo->setCurrentIndex(mode);}
     compressionmode getCompressionmode() {return thisCompressionmode;}
 
     void setShowComboBoxes(bool show) {if(colormodesWidget == (QWidget *)Q_NULLPTR)return; thisShowBoxes = show;  if(thisShowBoxes) colormodesWidget->show(); else colormodesWidget->hide();}
@@ -236,6 +260,15 @@ public:
     bool getSimpleView() { return thisSimpleView;}
     void setSimpleView(bool simpleV) {thisSimpleView = simpleV; setup();}
 
+    bool getDecodeWorker() const {return thisDecodeWorker;}
+    void setDecodeWorker(bool worker) {thisDecodeWorker = worker;}
+    bool getDecodeVisible() const {return thisDecodeVisible;}
+    void setDecodeVisible(bool visible) {thisDecodeVisible = visible;}
+    double getMaxDisplayRate() const {return thisMaxDisplayRate;}
+    void setMaxDisplayRate(double rate) {thisMaxDisplayRate = qMax(0.0, rate);}
+    bool getAdaptiveQuality() const {return thisAdaptiveQuality;}
+    void setAdaptiveQuality(bool adaptive) {thisAdaptiveQuality = adaptive;}
+
     QString getMinLevel() const {return thisMinLevel;}
     bool isAlphaMinLevel();
 
@@ -263,6 +296,19 @@ public:
     bool testPackingmodeStr(QString mode);
     bool testCompressionmodeStr(QString mode);
 
+    // frames decoded and frames dropped by the decode worker since the start
+    // and the average time in ms from the arrival of a frame to its display during the last second
+    qint64 getDecodedFrames() const {return decodedFrames;}
+    qint64 getDroppedFrames() const {return droppedFrames;}
+    double getDecodeLatency() const {return decodeLatency;}
+
+    // statistics of the region of interest computed with the last mono frame, followed by its x and y projections
+    // the soft channels getting them are given with the property roiStatisticsChannels, separated by ;
+    // color frames (rgb, bayer and yuv) give no statistics
+    QString getROIStatisticsChannels() const {return thisROIStatisticsChannels;}
+    void setROIStatisticsChannels(QString const &channels) {thisROIStatisticsChannels = channels;}
+    bool getROIStatistics(double values[ROISTATISTICS_VALUES], QVector<double> &projectionX, QVector<double> &projectionY);
+
 public slots:
     void animation(QRect p) {
 #include "animationcode.h"
@@ -300,6 +346,7 @@ public slots:
 */
 signals:
    void WriteDetectedValuesSignal(QWidget*);
+   void ROIStatisticsSignal(QWidget*);
 
 private slots:
     void zoomIn(int level = 1);
@@ -310,6 +357,9 @@ private slots:
     void colormodeComboSlot(int);
     void packingmodeComboSlot(int);
     void compressionmodeComboSlot(int);
+    void decodeFinished();
+    void pendingDue();
+    void redecodeVisible();
 
 protected:
     void resizeEvent(QResizeEvent *event);
@@ -317,57 +367,42 @@ protected:
 
 private:
 
-    typedef enum {
-        BAYER_COLORFILTER_RGGB = 512,
-        BAYER_COLORFILTER_GBRG,
-        BAYER_COLORFILTER_GRBG,
-        BAYER_COLORFILTER_BGGR
-    } bayerFilter;
-#define BAYER_COLORFILTER_MIN        BAYER_COLORFILTER_RGGB
-#define BAYER_COLORFILTER_MAX        BAYER_COLORFILTER_BGGR
-#define BAYER_COLORFILTER_NUM       (BAYER_COLORFILTER_MAX - BAYER_COLORFILTER_MIN + 1)
-
-
-    typedef enum {
-        COLOR_RGB,
-        COLOR_GBR,
-        COLOR_GRB,
-        COLOR_BGR,
-        COLOR_BRG
-    } rgb_interpretation;
+    // packed, bayer, yuv and 8 bit rgb frames are converted straight from the received data, row by row in the threads
+    typedef struct {
+        const uchar *data;
+        long size;
+        bool bayer;
+        bool greenFirst;                    // bayer, the first row starts with green
+        bool redFirst;                      // bayer, the first row has red
+        int bits;                           // bayer, 8 or 12
+        bool packed;                        // packed mono or 12 bit bayer
+        CameraKernels::packing packing;
+        CameraKernels::colorFormat format;  // yuv and rgb
+    } rawFrame;
 
     template <typename pureData>
     void fillData(pureData *array, int size, int curvIndex, int curvType, int curvXY);
     QVarLengthArray<double> X;
     QVarLengthArray<double> Y;
 
-    void buf_unpack_12bitpacked_lsb(void* target, void* source, size_t destcount, size_t targetcount);
-    void buf_unpack_12bitpacked_msb(void* target, void* source, size_t destcount, size_t targetcount);
-    void buf_unpack_10bitpacked(void* target, void* source, size_t destcount, size_t targetcount);
-    void buf_unpack_10bitp(void* target, void* source, size_t destcount, size_t targetcount);
-
     template <typename pureData>
-    void calcImage (pureData *ptr,  colormode mode, QVector<uint> &LineData, long &i, int &ystart, int &yend, float correction,
-                    int datasize, QSize resultSize, SyncMinMax* MinMax, uint Max[2], uint Min[2]);
+    void calcImage (pureData *ptr,  colormode mode, long &i, int &ystart, int &yend, float correction,
+                    int datasize, QSize resultSize, uint Max[2], uint Min[2]);
 
     template <typename pureData>
     void calcImageMono (pureData *ptr,  uint *LineData, long &i, int &ystart, int &yend, float correction, int datasize, QSize resultSize,
                         uint Max[2], uint Min[2]);
 
-    template <typename pureData> void FilterBayer(pureData *bayer, uint *rgb, int sx, int sy, int tile,int datasize);
-
     template <typename pureData>
-    int zValueImage(pureData *ptr, colormode mode, double xnew, double ynew, double xmax, double ymax, int datasize, bool &validIntensity);
+    void calcImageMonoRegion (pureData *ptr, int ystart, int yend, float correction, long datasize, QSize resultSize,
+                              ushort *samples, uint Max[2], uint Min[2]);
 
-    void PROC_UYVY422(uchar *YUV, uint *rgb, int sx, int sy, int datasize);
-    void PROC_YUYV422(uchar *YUV, uint *rgb, int sx, int sy, int datasize);
-    void PROC_YYUYYV411(uchar *YUV, uint *rgb, int sx, int sy, int datasize);
-    void PROC_UYYVYY411(uchar *YUV, uint *rgb, int sx, int sy, int datasize);
-    void PROC_YUV444(uchar *YUV, uint *rgb, int sx, int sy, int datasize);
-    void PROC_UVY444(uchar *YUV, uint *rgb, int sx, int sy, int datasize);
+    template <typename pureData>
+    void roiStatisticsRows (pureData *ptr, long datasize, int ystart, int yend, double *projX);
+    void roiStatisticsPackedRows (int ystart, int yend, ushort *values, double *projX);
 
-    void PROC_RGB8(uchar *RGB,rgb_interpretation rgb_type, uint *rgb, int sx, int sy, int datasize);
-    void PROC_RGBA8(uchar *RGBA,rgb_interpretation rgb_type, uint *rgb, int sx, int sy, int datasize);
+    template <typename pureData>
+    int zValueImage(pureData *ptr, colormode mode, double xnew, double ynew, double xmax, double ymax, int datasize, bool &validIntensity);
 
     bool eventFilter(QObject *obj, QEvent *event);
     void Coordinates(int posX, int posY, double &newX, double &newY, double &maxX, double &maxY);
@@ -378,13 +413,37 @@ private:
     void setCompressionModeStrings();
 
     void CameraDataConvert(int sector, int sectorcount, SyncMinMax *MinMax, QSize resultSize, int datasize);
+    void CameraPackedConvert(int sector, int sectorcount, SyncMinMax *MinMax, QSize resultSize, int datasize);
+    void CameraColorConvert(int sector, int sectorcount, SyncMinMax *MinMax, QSize resultSize, int datasize);
+    bool bayerRow(int row, int width, int x, int count, ushort *values);
     void MinMaxLock(SyncMinMax* MinMax, uint Max[2], uint Min[2]);
-    void MinMaxImageLock(QVector<uint> LineData, int y, QSize resultSize, SyncMinMax* MinMax);
-    void MinMaxImageLockBlock(uint *LineData, int ystart, int yend, QSize resultSize, SyncMinMax* MinMax);
+    void updateValueTable(int size);
     void InitLoopdata(int &ystart, int &yend, long &i, int increment, int sector, int sectorcount,
                          QSize resultSize, uint Max[2], uint Min[2]);
 
     void reallocate_central_image();
+
+    int compressedElementSize();
+    bool decompressBlocks(int sector, int sectorcount, const uchar *frame, int elementSize, bool shuffled);
+    bool decodeTurboJpeg(const uchar *data, int size);
+
+    bool decodeWorker();
+    bool decodeVisible();
+    void updateDecodeRegion();
+    void updateStatisticsRegion();
+    double displayRate();
+    bool adaptiveQuality();
+    void adaptQuality(double busy, double arrived, double shown);
+    int frameDelay();
+    void decodePendingNow();
+    void roiStatisticsSector(int sector, int sectorcount, int datasize, ushort *values);
+    void roiStatisticsFinish(int sectorcount);
+    void startDecode();
+    QImage *decodeImage(short datatype);
+    void waitForDecode();
+    void imageDecoded(QImage *localimage, const QElapsedTimer &arrival);
+    void showIntensity();
+
     bool buttonPressed;
     QString  thisPV_Mode, thisPV_Packing;
     QString thisPV_Data, thisPV_Width, thisPV_Height;
@@ -403,12 +462,49 @@ private:
     QImage *image;
     QMutex imageMutex;
     QByteArray decompressedData;
+    QImage decompressedImage;
+    // blocks of an LZ4 or BSLZ4 frame and the scratch of every thread for the bit shuffling
+    QVector<CameraCodecs::block> codecBlocks;
+    QByteArray codecScratch;
+    long codecScratchPerThread;
+    void *turboJpeg;                        // libjpeg-turbo handle, created with the first jpg frame
+
+    // scanlines of image for the conversion threads, set before they start
+    // image has 32 bit pixels, so its rows follow each other without padding
+    uchar *imageBits;
+    int imageStride;
+    uint *imageRow(int y) {return (uint *) (imageBits + (long) y * imageStride);}
+    // rows of separate channels for the color conversion, rowBuffersPerThread for every thread
+    QVector<ushort> rowBuffers;
+    int rowBuffersPerThread;
+
+    // part of the frame in the scroll area and the binning for the zoom, set in the gui thread before a frame is decoded
+    QRect visibleRect;
+    int visibleBinning;
+    // part of image converted by the threads, image holds every decodeBinning'th pixel of the frame
+    QRect decodeRect;
+    int decodeBinning;
+    bool decodePart;
+
+    // region of the frame for the statistics, set in the gui thread before a frame is decoded, empty when they are not wanted
+    // every thread sums its rows into statProjY and the columns into its own part of statSectorProjX
+    // in a pass of its own, as the region does not follow decodeRect and the binning skips values
+    QString thisROIStatisticsChannels;
+    QRect statRect;
+    bool statRunning, statValid;
+    QVector<double> statProjX, statProjY, statSectorProjX;
+    double statValues[ROISTATISTICS_VALUES];
 
     int Xpos, Ypos;
     bool m_init;
     enum { ColormapSize = 256 };
     uint ColorMap[ColormapSize];
 
+    // color of every value for 8 and 16 bit mono data, built for the current colormap and range before the conversion threads start
+    QVector<uint> valueTable;
+    bool valueTableGrey;
+    uint valueTableMin, valueTableMax;
+
     bool m_widthDefined;
     bool m_heightDefined;
     short m_datatype;
@@ -465,6 +561,10 @@ private:
     QPoint selectionPoints[2];
     bool _AccessW;
     bool thisSimpleView;
+    bool thisDecodeWorker;
+    bool thisDecodeVisible;
+    double thisMaxDisplayRate;
+    bool thisAdaptiveQuality;
     bool thisInitialAutomatic;
     bool thisDiscreteMap;
     bool designerVisible[10];
@@ -485,7 +585,37 @@ private:
     float thisGreenCoefficient;
     float thisBlueCoefficient;
 
-     uint *rgb;
+    rawFrame source;
+
+    // decode worker: the newest frame waits in pendingBuffer while decodeBuffer is decoded into image,
+    // the finished image becomes frontImage and the one shown before is decoded into next
+#ifndef QT_NO_CONCURRENT
+    QFutureWatcher<QImage *> *decodeWatcher;
+#endif
+    QImage *frontImage;
+    QByteArray decodeBuffer, pendingBuffer;
+    short pendingDatatype, decodeDatatype;
+    QElapsedTimer pendingTimer, decodeTimer;
+    bool decodeRunning, framePending, resizePending, intensityPending;
+    // decodeVisible: decodeBuffer holds the last frame, decoded again by regionTimer when another region is shown
+    QTimer *regionTimer;
+    bool lastFrameKept, regionPending;
+    colormode lastColormode;
+    short lastDatatype;
+    qint64 decodedFrames, droppedFrames;
+    double decodeLatency, latencySum;
+    int latencyCount;
+
+    // display rate: frames coming before their time wait in pendingBuffer until rateTimer fires
+    // the time spent decoding and the frames arrived are summed up for the adaptation every second
+    QTimer *rateTimer;
+    QElapsedTimer lastDecodeStart, loadWindow;
+    qint64 busyNs;
+    int arrivedFrames;
+    double effectiveRate;
+    double adaptiveRate;                    // 0 when the adaptation does not drop frames
+    int qualityBinning;                     // binning added by the adaptation, 1 for full quality
+    int calmSeconds;
 };
 
 #endif
@@ -31,7 +31,11 @@
 
 #include "cacartesianplot.h"
 #include "plotHelperClasses.h"
+#include "replotscheduler.h"
 #include <QtCore>
+#ifndef QT_NO_CONCURRENT
+#include <qtconcurrentrun.h>
+#endif
 
 caCartesianPlot::caCartesianPlot(QWidget *parent) : QwtPlot(parent)
 {
@@ -46,6 +50,8 @@ caCartesianPlot::caCartesianPlot(QWidget *parent) : QwtPlot(parent)
     thisTriggerNow = true;
     thisCountNumber = 0;
     thisXaxisSyncGroup = 0;
+    thisDecimation = false;
+    thisPreparation = LongWaveforms;
     thisXticks = 5;
     symbolSizeFactor = 1.0;
 
@@ -117,6 +123,7 @@ caCartesianPlot::caCartesianPlot(QWidget *parent) : QwtPlot(parent)
     // curves
     for(int i=0; i < curveCount; i++) {
         thisPV[i]=QStringList();
+        accumulType[i] = XY_both;
         curve[i].setLegendAttribute(QwtPlotCurve::LegendShowLine, true);
         curve[i].setItemAttribute(QwtPlotItem::Legend, false);
         curve[i].setStyle(QwtPlotCurve::Lines);
@@ -126,8 +133,17 @@ caCartesianPlot::caCartesianPlot(QWidget *parent) : QwtPlot(parent)
 #if QWT_VERSION >= 0x060100
         curve[i].setRenderThreadCount( 0 ); // 0: use QThread::idealThreadCount()
 #endif
+        pendingSamples[i].index = -1;
+        pendingSamples[i].series = Q_NULLPTR;
+        samplesGeneration[i] = 0;
     }
 
+    samplesRunning = false;
+#ifndef QT_NO_CONCURRENT
+    samplesWatcher = new QFutureWatcher<samplesJob>(this);
+    connect(samplesWatcher, SIGNAL(finished()), this, SLOT(samplesPrepared()));
+#endif
+
     setStyle_1(Lines);
     setStyle_2(Lines);
     setStyle_3(Lines);
@@ -181,6 +197,12 @@ caCartesianPlot::caCartesianPlot(QWidget *parent) : QwtPlot(parent)
 
 caCartesianPlot::~caCartesianPlot()
 {
+#ifndef QT_NO_CONCURRENT
+    if(samplesRunning) {
+        samplesWatcher->waitForFinished();
+        delete samplesWatcher->result().series;
+    }
+#endif
     delete plotGrid;
     delete zoomer;
     delete lgd;
@@ -304,8 +326,10 @@ void caCartesianPlot::erasePlots()
      for(int i=0; i < curveCount; i++) {
          X[i].clear();
          Y[i].clear();
-         accumulX[i].clear();
-         accumulY[i].clear();
+         accumul[i].clear();
+         // waveforms still being prepared are dropped
+         pendingSamples[i].index = -1;
+         samplesGeneration[i]++;
          setSamplesData(i, X[i].data(), Y[i].data(), Y[i].size(), true);
      }
      replot();
@@ -397,6 +421,13 @@ void caCartesianPlot::fillData(pureData *array, int size, int curvIndex, int cur
     }
 }
 
+#define SMALLEST -1.e20
+#define BIGGEST 1.e20
+
+// from this size on waveforms are prepared in a worker thread when backgroundPreparation is LongWaveforms,
+// for smaller ones the hand over to the thread costs more than the preparation itself
+#define BACKGROUND_PREPARATION_SIZE 20000
+
 void caCartesianPlot::displayData(int curvIndex, int curvType)
 {
     if(thisToBeTriggered) {
@@ -409,6 +440,7 @@ void caCartesianPlot::displayData(int curvIndex, int curvType)
     }
     // draw curve
     if(X[curvIndex].size() > 0 && Y[curvIndex].size() > 0) {
+        bool queued = false;
 
         // x vector, y scalar
         if(X[curvIndex].size() > 1 && Y[curvIndex].size() == 1) {
@@ -423,7 +455,8 @@ void caCartesianPlot::displayData(int curvIndex, int curvType)
             double *data = Y[curvIndex].data();
             for(int i=0; i < X[curvIndex].size(); i++) data[i] = aux;
             if(thisCountNumber > 0) nbPoints = qMin(thisCountNumber, X[curvIndex].size());
-            setSamplesData(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints, true);
+            queued = setSamplesDataLater(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints);
+            if(!queued) setSamplesData(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints, true);
 
         // x scalar, y vector
         } else if(X[curvIndex].size() == 1 && Y[curvIndex].size() > 1) {
@@ -438,7 +471,8 @@ void caCartesianPlot::displayData(int curvIndex, int curvType)
             double *data = X[curvIndex].data();
             for(int i=0; i < Y[curvIndex].size(); i++) data[i] = aux;  // and set values to first datapoint
             if(thisCountNumber > 0) nbPoints = qMin(thisCountNumber, Y[curvIndex].size());
-            setSamplesData(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints, true);
+            queued = setSamplesDataLater(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints);
+            if(!queued) setSamplesData(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints, true);
 
         // x scalar, y scalar
         } else if(X[curvIndex].size() == 1 && Y[curvIndex].size() == 1) {
@@ -449,69 +483,41 @@ void caCartesianPlot::displayData(int curvIndex, int curvType)
 
             // scalar scalar more than one point specified
             } else {
-                double *dataX, *dataY;
+                // a changed count keeps the newest points
+                accumul[curvIndex].setCapacity(thisCountNumber);
+
                 if(thisPlotMode == PlotNPointsAndStop) {
                     //printf("when count reached then we stop plotting\n");
 
-                    if(accumulX[curvIndex].size() >= thisCountNumber) return;
-                } else {
-                    //printf("array size=%d wanted count=%d\n", accumulX[curvIndex].size(), thisCountNumber);
-
-                    if(accumulX[curvIndex].size() > thisCountNumber) {
-                        //printf("it seems that the count number changed and is less than before?\n");
-                        accumulX[curvIndex].clear();
-                        accumulY[curvIndex].clear();
-                    }
-                    //printf("accumulate until count, then shift down and add point\n");
-
-                    if(accumulX[curvIndex].size() >= thisCountNumber) {
-                        dataX = accumulX[curvIndex].data();
-                        dataY = accumulY[curvIndex].data();
-                        //shift and remove last point
-
-                        // shift the X array and remove last point from X array
-                        if(curvType == X_only) {
-                            for(int i=0; i < accumulX[curvIndex].size() -1; i++)  {
-                                dataX[i] = dataX[i+1];
-                            }
-                            accumulX[curvIndex].removeLast();
-
-                        // shift the Y array and remove last point from Y array
-                        } else if (curvType == Y_only) {
-                            for(int i=0; i < accumulX[curvIndex].size() -1; i++)  {
-                                dataY[i] = dataY[i+1];
-                            }
-                            accumulY[curvIndex].removeLast();
-
-                        // shift the two arrays and remove last point from both
-                        } else {
-                            for(int i=0; i < accumulX[curvIndex].size() -1; i++)  {
-                                dataX[i] = dataX[i+1];
-                                dataY[i] = dataY[i+1];
-                            }
-                            accumulX[curvIndex].removeLast();
-                            accumulY[curvIndex].removeLast();
-                        }
-                    }
+                    if(accumul[curvIndex].size() >= thisCountNumber) return;
+                }
+                //printf("accumulate until count, then drop the oldest and add point\n");
+
+                // add new point, the channel not given is replaced by the index
+                double newX = (curvType == Y_only) ? 0.0 : X[curvIndex].at(0);
+                double newY = (curvType == X_only) ? 0.0 : Y[curvIndex].at(0);
+
+                // in case of autoscaling and you have infinite values, things will go wrong
+                if(thisXscaling == Auto && (newX < SMALLEST || newX > BIGGEST)) {
+                    setXscaling(User); setAxisScale(xBottom, -10.0, 10.0);
+                    newX = qBound(SMALLEST, newX, BIGGEST);
+                    emit getAutoScaleXMin(-10.0);
+                    emit getAutoScaleXMax(10.0);
+                    printf("caCartesianPlot::displayData: infinite x value detected, scale set to -10 to 10\n");
+                    fflush(stdout);
                 }
-                dataX = X[curvIndex].data();
-                dataY = Y[curvIndex].data();
-
-                // add new point
-                if(curvType == X_only) {
-                    if(accumulX[curvIndex].size() < thisCountNumber)
-                        accumulY[curvIndex].append(accumulY[curvIndex].size());
-                    accumulX[curvIndex].append(dataX[0]);
-                } else if (curvType == Y_only) {
-                    if(accumulX[curvIndex].size() < thisCountNumber)
-                        accumulX[curvIndex].append(accumulX[curvIndex].size());
-                    accumulY[curvIndex].append(dataY[0]);
-                } else {
-                    accumulX[curvIndex].append(dataX[0]);
-                    accumulY[curvIndex].append(dataY[0]);
+                if(thisYscaling == Auto && (newY < SMALLEST || newY > BIGGEST)) {
+                    setYscaling(User); setAxisScale(yLeft, -10.0, 10.0);
+                    newY = qBound(SMALLEST, newY, BIGGEST);
+                    emit getAutoScaleYMin(-10.0);
+                    emit getAutoScaleYMax(10.0);
+                    printf("caCartesianPlot::displayData: infinite y value detected, scale set to -10 to 10\n");
+                    fflush(stdout);
                 }
 
-                setSamplesData(curvIndex, accumulX[curvIndex].data(), accumulY[curvIndex].data(), accumulY[curvIndex].size(), true);
+                accumul[curvIndex].append(newX, newY);
+                accumulType[curvIndex] = curvType;
+                setAccumulatedData(curvIndex);
             }
 
         // x vector, y vector
@@ -519,49 +525,87 @@ void caCartesianPlot::displayData(int curvIndex, int curvType)
             //printf("x vector, y vector curv=%d\n", curvIndex);
             int nbPoints = qMin(X[curvIndex].size(), Y[curvIndex].size());
             if(thisCountNumber > 0) nbPoints = qMin(thisCountNumber, nbPoints);
-            setSamplesData(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints, true);
+            queued = setSamplesDataLater(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints);
+            if(!queued) setSamplesData(curvIndex, X[curvIndex].data(), Y[curvIndex].data(), nbPoints, true);
         }
 
-        zoomer->setZoomBase();
+        // the plot is updated when the preparation is done
+        if(queued) return;
 
-        replot();
-        if (thisXscaling==Auto){
-            emit getAutoScaleXMin(axisScaleDiv(xBottom).lowerBound());
-            emit getAutoScaleXMax(axisScaleDiv(xBottom).upperBound());
-        }
-        if (thisYscaling==Auto){
-            emit getAutoScaleYMin(axisScaleDiv(yLeft).lowerBound());
-            emit getAutoScaleYMax(axisScaleDiv(yLeft).upperBound());
-        }
+        refreshPlot();
     }
 }
 
-#define SMALLEST -1.e20
-#define BIGGEST 1.e20
+// the scales follow the new data at once, the drawing is left to the replot scheduler
+void caCartesianPlot::refreshPlot()
+{
+    updateAxes();
+    zoomer->setZoomBase(false);
+
+    if(!ReplotScheduler::instance()->schedule(this)) replot();
+    if (thisXscaling==Auto){
+        emit getAutoScaleXMin(axisScaleDiv(xBottom).lowerBound());
+        emit getAutoScaleXMax(axisScaleDiv(xBottom).upperBound());
+    }
+    if (thisYscaling==Auto){
+        emit getAutoScaleYMin(axisScaleDiv(yLeft).lowerBound());
+        emit getAutoScaleYMax(axisScaleDiv(yLeft).upperBound());
+    }
+}
 
 // this routine will prevent that we have problems with negative values when logarithmic scale
 // and will keep the values in order to switch between log and linear scale
 void caCartesianPlot::setSamplesData(int index, double *x, double *y, int size, bool saveFlag)
 {
+    samplesJob job = prepareSamples(samplesJobFor(index, x, y, size, saveFlag));
+    applySamples(job);
+}
+
+// copy of the waveform with the settings of the plot, so that it can be prepared in any thread
+caCartesianPlot::samplesJob caCartesianPlot::samplesJobFor(int index, const double *x, const double *y, int size, bool saveFlag)
+{
+    samplesJob job;
+    job.index = index;
+    job.generation = samplesGeneration[index];
+    job.saveFlag = saveFlag;
+    job.autoX = (thisXscaling == Auto);
+    job.autoY = (thisYscaling == Auto);
+    job.logX = (thisXtype == log10);
+    job.logY = (thisYtype == log10);
+    // the decimation can only be done in advance when the x scale does not follow the data
+    job.decimate = decimationEnabled() && !job.autoX;
+    job.xMap = canvasMap(xBottom);
+    job.x.resize(qMax(size, 0));
+    job.y.resize(qMax(size, 0));
+    if(size > 0) {
+        memcpy(job.x.data(), x, size*sizeof(double));
+        memcpy(job.y.data(), y, size*sizeof(double));
+    }
+    job.infiniteX = job.infiniteY = false;
+    job.series = Q_NULLPTR;
+    return job;
+}
+
+// does not touch the plot, runs in a worker thread for backgroundPreparation
+caCartesianPlot::samplesJob caCartesianPlot::prepareSamples(samplesJob job)
+{
+    const int size = job.x.size();
     double lowX = BIGGEST;
     double lowY = BIGGEST;
     double lowX1 = BIGGEST;
     double lowY1 = BIGGEST;
     bool nanXpresent=false;
     bool nanYpresent=false;
+    double *x = job.x.data();
+    double *y = job.y.data();
 
     // in case of autoscaling and you have infinite values, things will go wrong
-    if(thisXscaling == Auto) {
+    if(job.autoX) {
         for(int i=0; i< size; i++) {
             if(x[i] < SMALLEST || x[i] > BIGGEST) {
-                setXscaling(User); setAxisScale(xBottom, -10.0, 10.0);
                 if(x[i] < SMALLEST) x[i] = SMALLEST;
                 if(x[i] > BIGGEST) x[i] = BIGGEST;
-                emit getAutoScaleXMin(-10.0);
-                emit getAutoScaleXMax(10.0);
-
-                printf("caCartesianPlot::setSamplesData: infinite x value detected, scale set to -10 to 10\n");
-                fflush(stdout);
+                job.infiniteX = true;
                 break;
             }
             if((x[i] < lowX) && (x[i] > 0.0)) lowX = x[i];
@@ -575,16 +619,12 @@ void caCartesianPlot::setSamplesData(int index, double *x, double *y, int size,
     } else {
         lowX = 1.e-20;
     }
-    if(thisYscaling == Auto) {
+    if(job.autoY) {
         for(int i=0; i< size; i++) {
             if(y[i] < SMALLEST || y[i] > BIGGEST) {
-                setYscaling(User); setAxisScale(yLeft, -10.0, 10.0);
                 if(y[i] < SMALLEST) y[i] = SMALLEST;
                 if(y[i] > BIGGEST) y[i] = BIGGEST;
-                emit getAutoScaleYMin(-10.0);
-                emit getAutoScaleYMax(10.0);
-                printf("caCartesianPlot::setSamplesData: ininite y value detected, scale set to -10 to 10\n");
-                fflush(stdout);
+                job.infiniteY = true;
                 break;
             }
             // for logarithmic scale
@@ -601,39 +641,210 @@ void caCartesianPlot::setSamplesData(int index, double *x, double *y, int size,
     }
 
     // saving the data allows to switch between log and lin when no new monitor is coming
-    if(saveFlag) {
-        XSAVE[index].resize(size);
-        YSAVE[index].resize(size);
-        memcpy(XSAVE[index].data(), x, size*sizeof(double));
-        memcpy(YSAVE[index].data(), y, size*sizeof(double));
+    if(job.saveFlag) {
+        job.xsave = job.x;
+        job.ysave = job.y;
+        x = job.x.data();
+        y = job.y.data();
     }
 
-    // use auxiliary arrays, in order not to overwrite the original data
-    if((thisXtype == log10) || (thisYtype == log10)) {
-        XAUX[index].resize(size);
-        YAUX[index].resize(size);
-        memcpy(XAUX[index].data(), x, size*sizeof(double));
-        memcpy(YAUX[index].data(), y, size*sizeof(double));
-
-        if(thisXtype == log10) {
+    if(job.logX || job.logY) {
+        if(job.logX) {
             for(int i=0; i< size; i++) {
-                if(x[i] <= lowX)  XAUX[index][i] = lowX;
-                if(qIsNaN(x[i]))  XAUX[index][i] = lowX;
+                if(x[i] <= lowX || qIsNaN(x[i])) x[i] = lowX;
             }
         }
-        if(thisYtype == log10) {
+        if(job.logY) {
             for(int i=0; i< size; i++) {
-                if(y[i] < lowY)   YAUX[index][i] = lowY;
-                 if(qIsNaN(y[i])) YAUX[index][i] = lowY;
+                if(y[i] < lowY || qIsNaN(y[i])) y[i] = lowY;
             }
         }
-        curve[index].setRawSamples(XAUX[index].data(), YAUX[index].data(), size);
     }
     else {
         if(nanYpresent) for(int i=0; i< size; i++) if(qIsNaN(y[i])) y[i] = lowY1;
         if(nanXpresent) for(int i=0; i< size; i++) if(qIsNaN(x[i])) x[i] = lowX1;
-        curve[index].setRawSamples(x, y, size);
     }
+
+    // the extremes and the decimated points are calculated here, so that drawing finds them ready
+    job.series = new CartesianSeriesData(job.x.constData(), job.y.constData(), size);
+    job.series->boundingRect();
+    if(job.decimate) job.series->decimate(job.xMap);
+    return job;
+}
+
+void caCartesianPlot::applySamples(samplesJob &job)
+{
+    const int index = job.index;
+
+    if(job.infiniteX) {
+        setXscaling(User); setAxisScale(xBottom, -10.0, 10.0);
+        emit getAutoScaleXMin(-10.0);
+        emit getAutoScaleXMax(10.0);
+        printf("caCartesianPlot::setSamplesData: infinite x value detected, scale set to -10 to 10\n");
+        fflush(stdout);
+    }
+    if(job.infiniteY) {
+        setYscaling(User); setAxisScale(yLeft, -10.0, 10.0);
+        emit getAutoScaleYMin(-10.0);
+        emit getAutoScaleYMax(10.0);
+        printf("caCartesianPlot::setSamplesData: ininite y value detected, scale set to -10 to 10\n");
+        fflush(stdout);
+    }
+
+    if(job.saveFlag) {
+        const int size = job.xsave.size();
+        accumul[index].clear();
+        XSAVE[index].resize(size);
+        YSAVE[index].resize(size);
+        if(size > 0) {
+            memcpy(XSAVE[index].data(), job.xsave.constData(), size*sizeof(double));
+            memcpy(YSAVE[index].data(), job.ysave.constData(), size*sizeof(double));
+        }
+    }
+
+    // the series reads the arrays of the job, these are kept until the next series replaces it
+    curve[index].setData(job.series);
+    job.series = Q_NULLPTR;
+    XAUX[index] = job.x;
+    YAUX[index] = job.y;
+    curve[index].setDecimation(decimationEnabled());
+}
+
+// waveforms can be prepared in a worker thread, only the new series is handed to the curve in the gui thread
+// on by default for long waveforms, Never or Always in the property or the environment variable (0 or 1) decide for all sizes
+bool caCartesianPlot::prepareInBackground(int size) const
+{
+    if(thisPreparation != LongWaveforms) return (thisPreparation == Always);
+    QByteArray env = qgetenv("CAQTDM_CARTESIANPLOT_BACKGROUNDPREPARATION");
+    if(!env.isEmpty()) return env != "0";
+    return size >= BACKGROUND_PREPARATION_SIZE;
+}
+
+// a waveform coming while the worker is busy replaces the one still waiting for the same curve
+bool caCartesianPlot::setSamplesDataLater(int index, const double *x, const double *y, int size)
+{
+#ifndef QT_NO_CONCURRENT
+    // while the worker is busy short ones queue too, otherwise they could be overtaken by an older long one
+    if(!prepareInBackground(size) && !samplesRunning) return false;
+    pendingSamples[index] = samplesJobFor(index, x, y, size, true);
+    if(!samplesRunning) startPreparation();
+    return true;
+#else
+    Q_UNUSED(index); Q_UNUSED(x); Q_UNUSED(y); Q_UNUSED(size);
+    return false;
+#endif
+}
+
+void caCartesianPlot::startPreparation()
+{
+#ifndef QT_NO_CONCURRENT
+    for(int i=0; i < curveCount; i++) {
+        if(pendingSamples[i].index < 0) continue;
+        samplesJob job = pendingSamples[i];
+        pendingSamples[i].index = -1;
+        pendingSamples[i].x.clear();
+        pendingSamples[i].y.clear();
+        samplesRunning = true;
+        samplesWatcher->setFuture(QtConcurrent::run(&caCartesianPlot::prepareSamples, job));
+        return;
+    }
+#endif
+}
+
+void caCartesianPlot::samplesPrepared()
+{
+#ifndef QT_NO_CONCURRENT
+    samplesRunning = false;
+    samplesJob job = samplesWatcher->result();
+
+    if(job.generation != samplesGeneration[job.index]) {
+        // the plot was erased in the meantime
+        delete job.series;
+    } else {
+        // the scales were changed in the meantime, prepare again from the saved values
+        if(job.autoX != (thisXscaling == Auto) || job.autoY != (thisYscaling == Auto) ||
+                job.logX != (thisXtype == log10) || job.logY != (thisYtype == log10)) {
+            delete job.series;
+            job = prepareSamples(samplesJobFor(job.index, job.xsave.constData(), job.ysave.constData(), job.xsave.size(), true));
+        }
+        applySamples(job);
+        refreshPlot();
+    }
+
+    startPreparation();
+#endif
+}
+
+// reduce long waveforms with increasing x to the extremes of every pixel column, done when drawing for the actual zoom
+// the environment variable CAQTDM_CARTESIANPLOT_DECIMATION turns it on for all plots
+bool caCartesianPlot::decimationEnabled() const
+{
+    return thisDecimation || !qgetenv("CAQTDM_CARTESIANPLOT_DECIMATION").isEmpty();
+}
+
+// range of the values read through CartesianSeriesData::setLimits
+static void limitedRange(double min, double max, bool nanPresent, double nanValue, double floor, double &low, double &high)
+{
+    low = qMax(min, floor);
+    high = qMax(max, floor);
+    if(nanPresent && !qIsNaN(nanValue)) {
+        low = qMin(low, nanValue);
+        high = qMax(high, nanValue);
+    }
+}
+
+// the accumulated points are handed to the curve without copying, the same limits as in setSamplesData
+// are taken from the extremes kept by the ring instead of looking at all points
+void caCartesianPlot::setAccumulatedData(int index)
+{
+    const CartesianRing &ring = accumul[index];
+    const int size = ring.size();
+    const bool indexX = (accumulType[index] == Y_only);
+    const bool indexY = (accumulType[index] == X_only);
+
+    if(accumulIndex.size() < ring.capacity()) {
+        const int first = accumulIndex.size();
+        accumulIndex.resize(ring.capacity());
+        for(int i = first; i < ring.capacity(); i++) accumulIndex[i] = i;
+    }
+
+    const double *x = indexX ? accumulIndex.constData() : ring.xData();
+    const double *y = indexY ? accumulIndex.constData() : ring.yData();
+    const double minX = indexX ? 0.0 : ring.minX();
+    const double maxX = indexX ? (double) (size - 1) : ring.maxX();
+    const double minPositiveX = indexX ? ((size > 1) ? 1.0 : qQNaN()) : ring.minPositiveX();
+    const bool nanX = indexX ? false : (ring.nanCountX() > 0);
+    const double minY = indexY ? 0.0 : ring.minY();
+    const double maxY = indexY ? (double) (size - 1) : ring.maxY();
+    const double minPositiveY = indexY ? ((size > 1) ? 1.0 : qQNaN()) : ring.minPositiveY();
+    const bool nanY = indexY ? false : (ring.nanCountY() > 0);
+
+    // for logarithmic scales values below the smallest positive value are raised to it, otherwise nan is replaced by the minimum
+    double lowX = 1.e-20;
+    double lowY = 1.e-20;
+    if(thisXscaling == Auto) lowX = qIsNaN(minPositiveX) ? 1.0 : minPositiveX;
+    if(thisYscaling == Auto) lowY = qIsNaN(minPositiveY) ? 1.0 : minPositiveY;
+
+    double nanValueX = qQNaN(), floorX = -qInf();
+    double nanValueY = qQNaN(), floorY = -qInf();
+    if((thisXtype == log10) || (thisYtype == log10)) {
+        if(thisXtype == log10) nanValueX = floorX = lowX;
+        if(thisYtype == log10) nanValueY = floorY = lowY;
+    } else {
+        if(thisXscaling == Auto && nanX) nanValueX = minX;
+        if(thisYscaling == Auto && nanY) nanValueY = minY;
+    }
+
+    CartesianSeriesData *series = new CartesianSeriesData(x, y, size);
+    series->setLimits(nanValueX, floorX, nanValueY, floorY);
+    if(size > 0 && !qIsNaN(minX) && !qIsNaN(minY)) {
+        double x1, x2, y1, y2;
+        limitedRange(minX, maxX, nanX, nanValueX, floorX, x1, x2);
+        limitedRange(minY, maxY, nanY, nanValueY, floorY, y1, y2);
+        series->setBoundingRect(QRectF(x1, y1, x2 - x1, y2 - y1));
+    }
+    curve[index].setData(series);
+    curve[index].setDecimation(decimationEnabled());
 }
 
 void caCartesianPlot::setTitlePlot(QString const &titel)
@@ -1095,7 +1306,8 @@ void caCartesianPlot::setXaxisType(axisType s)
     setXaxisLimits(getXaxisLimits());
 
     for(int i=0; i < curveCount; i++) {
-        if(XSAVE[i].size() > 0) setSamplesData(i, XSAVE[i].data(), YSAVE[i].data(), XSAVE[i].size(), false);
+        if(accumul[i].size() > 0) setAccumulatedData(i);
+        else if(XSAVE[i].size() > 0) setSamplesData(i, XSAVE[i].data(), YSAVE[i].data(), XSAVE[i].size(), false);
     }
     replot();
 }
@@ -1119,7 +1331,8 @@ void caCartesianPlot::setYaxisType(axisType s)
     setYaxisLimits(getYaxisLimits());
 
     for(int i=0; i < curveCount; i++) {
-        if(XSAVE[i].size() > 0) setSamplesData(i, XSAVE[i].data(), YSAVE[i].data(), XSAVE[i].size(), false);
+        if(accumul[i].size() > 0) setAccumulatedData(i);
+        else if(XSAVE[i].size() > 0) setSamplesData(i, XSAVE[i].data(), YSAVE[i].data(), XSAVE[i].size(), false);
     }
 
     replot();
@@ -59,6 +59,10 @@
 #include <stdint.h>
 #include <limits>
 #include "caPropHandleDefs.h"
+#include "qwtplotcurvedecimated.h"
+#ifndef QT_NO_CONCURRENT
+#include <QFutureWatcher>
+#endif
 
 class QTCON_EXPORT caCartesianPlot : public QwtPlot
 {
@@ -76,6 +80,7 @@ class QTCON_EXPORT caCartesianPlot : public QwtPlot
     Q_ENUMS(plMode)
     Q_ENUMS(eraMode)
     Q_ENUMS(axisType)
+    Q_ENUMS(preparation)
 
     Q_PROPERTY(QString Title READ getTitlePlot WRITE setTitlePlot)
     Q_PROPERTY(QString TitleX READ getTitleX WRITE setTitleX)
@@ -156,6 +161,9 @@ class QTCON_EXPORT caCartesianPlot : public QwtPlot
 
     Q_PROPERTY(int XaxisSyncGroup READ getXaxisSyncGroup WRITE setXaxisSyncGroup)
 
+    Q_PROPERTY(bool decimation READ getDecimation WRITE setDecimation)
+    Q_PROPERTY(preparation backgroundPreparation READ getBackgroundPreparation WRITE setBackgroundPreparation)
+
     // this will prevent user interference
     Q_PROPERTY(QString styleSheet READ styleSheet WRITE noStyle DESIGNABLE false)
 
@@ -210,6 +218,9 @@ public:
 
     enum axisType { linear=0, log10, time};
 
+    // where waveforms are prepared for the curves, Never and Always keep the values of the former boolean property
+    enum preparation { Never = 0, Always, LongWaveforms};
+
     enum plMode {
         PlotNPointsAndStop = 0,
         PlotLastNPoints
@@ -372,6 +383,14 @@ public:
     void setXaxisSyncGroup( int group ) {thisXaxisSyncGroup = group;}
     int getXaxisSyncGroup() {return thisXaxisSyncGroup;}
 
+    // long waveforms with increasing x are drawn reduced to the extremes of every pixel column
+    void setDecimation(bool decimation) {thisDecimation = decimation;}
+    bool getDecimation() const {return thisDecimation;}
+
+    // waveforms prepared in a worker thread, by default only the long ones
+    void setBackgroundPreparation(preparation p) {thisPreparation = p;}
+    preparation getBackgroundPreparation() const {return thisPreparation;}
+
     caCartesianPlot(QWidget *parent);
     ~caCartesianPlot();
 
@@ -435,6 +454,8 @@ public slots:
 
 private slots:
     void handleZoomedRect(const QRectF& zoomedRect);
+    void samplesPrepared();
+    void scheduledReplot() {replot();}
 
 signals:
     void ShowContextMenu(const QPoint&);
@@ -471,14 +492,46 @@ private:
     axisScaling thisXscaling, thisYscaling;
     axisType thisXtype, thisYtype;
 
-    QwtPlotCurve curve[curveCount];
+    QwtPlotCurveDecimated curve[curveCount];
 
     QVarLengthArray<double> X[curveCount], XSAVE[curveCount];
     QVarLengthArray<double> Y[curveCount], YSAVE[curveCount];
-    QVarLengthArray<double> XAUX[curveCount], YAUX[curveCount];
+    // values read by the curves
+    QVector<double> XAUX[curveCount], YAUX[curveCount];
+
+    // waveform prepared for a curve, in a worker thread as backgroundPreparation says, otherwise directly
+    typedef struct samplesJob {
+        int index;
+        int generation;
+        bool saveFlag;
+        bool autoX, autoY, logX, logY;
+        bool decimate;
+        QwtScaleMap xMap;
+        QVector<double> x, y;           // on return the values read by the curve
+        QVector<double> xsave, ysave;   // on return the values kept for switching between log and lin
+        bool infiniteX, infiniteY;
+        CartesianSeriesData *series;
+    } samplesJob;
+    static samplesJob prepareSamples(samplesJob job);
+    samplesJob samplesJobFor(int index, const double *x, const double *y, int size, bool saveFlag);
+    void applySamples(samplesJob &job);
+    bool setSamplesDataLater(int index, const double *x, const double *y, int size);
+    void startPreparation();
+    bool prepareInBackground(int size) const;
+    void refreshPlot();
+
+    // the newest waveform of every curve waiting for the worker, only one preparation runs at a time for a plot
+    samplesJob pendingSamples[curveCount];
+    int samplesGeneration[curveCount];
+    bool samplesRunning;
+#ifndef QT_NO_CONCURRENT
+    QFutureWatcher<samplesJob> *samplesWatcher;
+#endif
 
-    QVarLengthArray<double> accumulX[curveCount];
-    QVarLengthArray<double> accumulY[curveCount];
+    // accumulated points for a count bigger than one with scalar channels, the index is used for a missing channel
+    CartesianRing accumul[curveCount];
+    int accumulType[curveCount];
+    QVector<double> accumulIndex;
 
     QwtPlotGrid *plotGrid;
     QPen penGrid;
@@ -490,6 +543,8 @@ private:
     void setScalesColor(QColor c);
     void setGridsColor(QColor c);
     void setSamplesData(int index, double *x, double *y, int size, bool saveFlag);
+    void setAccumulatedData(int index);
+    bool decimationEnabled() const;
     bool eventFilter(QObject *obj, QEvent *event);
 
     QwtPlotZoomer* zoomer;
@@ -498,6 +553,8 @@ private:
     bool thisTriggerNow;
 
     int thisXaxisSyncGroup;
+    bool thisDecimation;
+    preparation thisPreparation;
 
     QwtLegend *lgd;
 
@@ -26,6 +26,7 @@
 #include "caimage.h"
 #include "searchfile.h"
 #include "fileFunctions.h"
+#include "imageframecache.h"
 #include <QPainter>
 //#include <QElapsedTimer>
 
@@ -35,7 +36,8 @@ caImage::caImage(QWidget* parent) : QWidget(parent)
     _container = new QLabel();
     _layout = new QVBoxLayout(this);
     thisAngle = 0;
-    thisFrame = prevFrame = 0;
+    thisFrame = prevFrame = currentFrame = 0;
+    thisInvalid = false;
     setVisibility(StaticV);
     timerId = 0;
     thisDelay = 500;
@@ -43,7 +45,10 @@ caImage::caImage(QWidget* parent) : QWidget(parent)
 
 caImage::~caImage() {
 
-   delete _animation;
+   if(!cachedFile.isEmpty()) {
+       ImageFrameCache::instance()->releaseSize(cachedFile, cachedSize);
+       ImageFrameCache::instance()->release(cachedFile);
+   }
    delete messagequeue;
 }
 
@@ -81,20 +86,27 @@ void caImage::init(const QString& filename) {
         return;
     }
 
-    _animation = new QMovie(fileNameFound, 0, this);
-    _animation->setCacheMode(QMovie::CacheAll);
-    _animation->jumpToFrame(0);
-    connect(_animation, SIGNAL(frameChanged(int)), this, SLOT(OnFrameChanged(int)));
     delete s;
-    if( _animation.isNull()) return;
-    // display the movie
-    _container->setScaledContents(true);
-    _container->setMovie(_animation);
 
-    pixmap = _animation->currentPixmap();
-    pix    = _animation->currentPixmap();
+    // the frames are decoded once for all widgets showing this file, the file shown up to now is released afterwards
+    QString previousFile = cachedFile;
+    QSize previousSize = cachedSize;
+    cachedFile = QString();
+    cachedSize = QSize();
+    if(ImageFrameCache::instance()->acquire(fileNameFound)) {
+        cachedFile = fileNameFound;
+    } else {
+        qDebug() << "file" << fileNameFound << "could not be read";
+    }
+    if(!previousFile.isEmpty()) {
+        ImageFrameCache::instance()->releaseSize(previousFile, previousSize);
+        ImageFrameCache::instance()->release(previousFile);
+    }
 
-    if(thisAngle != 0) OnFrameChanged(0);
+    // display the first frame, the cache gives it already scaled to the size of the widget
+    _container->setScaledContents(false);
+    currentFrame = 0;
+    OnFrameChanged(0);
 
     _layout->setSpacing(0);
     SETMARGIN_QT456(_layout,0);
@@ -106,24 +118,30 @@ void caImage::init(const QString& filename) {
 
 int caImage::getFrameCount()
 {
-    if( _animation.isNull()) return 0;
-    return _animation->frameCount();
+    if(cachedFile.isEmpty()) return 0;
+    return ImageFrameCache::instance()->frameCount(cachedFile);
 }
 
 void caImage::timerEvent(QTimerEvent *)
 {
-    if( _animation.isNull()) return;
-    if(thisFrame > (_animation->frameCount()-1)) {
+    if(cachedFile.isEmpty()) return;
+    if(thisFrame > (getFrameCount()-1)) {
         thisFrame=0;
     }
     // display only when frame changed
     if(thisFrame != prevFrame) {
-      (void)_animation->jumpToFrame(thisFrame);
+      OnFrameChanged(thisFrame);
       prevFrame = thisFrame;
     }
     thisFrame++;
 }
 
+void caImage::resizeEvent(QResizeEvent *e)
+{
+    QWidget::resizeEvent(e);
+    OnFrameChanged(currentFrame);
+}
+
 void caImage::startMovie()
 {
     // kill default timer
@@ -138,7 +156,8 @@ void caImage::setInvalid(QColor c)
       QString style = "color: rgb(%1, %2, %3); background-color: rgb(%4, %5, %6);";
       style = style.arg(c.red()).arg(c.green()).arg(c.blue()).arg(c.red()).arg(c.green()).arg(c.blue());
       _container->setStyleSheet(style);
-      _container->setMovie(NULL);
+      _container->clear();
+      thisInvalid = true;
       oldColor = c;
     }
 }
@@ -147,7 +166,8 @@ void caImage::setValid()
 {
     QColor c;
     if(oldColor == Qt::gray) return;
-    _container->setMovie(_animation);
+    thisInvalid = false;
+    OnFrameChanged(currentFrame);
     c = oldColor = Qt::gray;
     QString style = "color: rgb(%1, %2, %3); background-color: rgba(%4, %5, %6, %7);";
     style = style.arg(c.red()).arg(c.green()).arg(c.blue()).arg(c.red()).arg(c.green()).arg(c.blue()).arg(0);
@@ -163,8 +183,8 @@ void caImage::setFileName(QString filename)
 void caImage::setFrame(int frame)
 {
     thisFrame = frame;
-    if( _animation.isNull()) return;
-    (void)_animation->jumpToFrame(frame);
+    if(cachedFile.isEmpty()) return;
+    OnFrameChanged(frame);
     prevFrame= thisFrame;
 }
 
@@ -172,7 +192,7 @@ void caImage::setAngle( int angle)
 {
     if (angle >= 0 && angle <= 360) {
         thisAngle = angle;
-        OnFrameChanged(thisFrame);
+        OnFrameChanged(currentFrame);
     }
 }
 
@@ -188,10 +208,19 @@ void caImage::slotTiltAngle(double angle)
 
 void caImage::OnFrameChanged(int frame)
 {
-    Q_UNUSED(frame)
-    if( _animation.isNull()) return;
-    pixmap = pixmap.scaled(width(), height());
-    pixmap = _animation->currentPixmap();
+    if(cachedFile.isEmpty()) return;
+    // the scaled frames of the size used up to now are not needed by this widget any more
+    if(size() != cachedSize) {
+        ImageFrameCache::instance()->acquireSize(cachedFile, size());
+        ImageFrameCache::instance()->releaseSize(cachedFile, cachedSize);
+        cachedSize = size();
+    }
+    // a frame that does not exist keeps the one shown, like QMovie::jumpToFrame did
+    QPixmap scaled = ImageFrameCache::instance()->frame(cachedFile, frame, size());
+    if(scaled.isNull()) return;
+    pixmap = scaled;
+    currentFrame = frame;
+    if(thisInvalid) return;
     if(thisAngle == 0) {
         _container->setPixmap (pixmap);
         return;
@@ -204,7 +233,7 @@ void caImage::OnFrameChanged(int frame)
 #endif
 
 
-    pix.scaled(width(), height());
+    if(pix.size() != pixmap.size()) pix = QPixmap(pixmap.size());
     pix.fill(QColor::fromRgb(0, 0, 0, 0)); //pixmap transparent.
     QPainter* p = new QPainter(&pix);
     QSize size = pixmap.size();
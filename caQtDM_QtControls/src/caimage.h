@@ -28,7 +28,7 @@
 
 #include <QVBoxLayout>
 #include <QLabel>
-#include <QMovie>
+#include <QPointer>
 #include <QMenu>
 #include <QMouseEvent>
 #include <qtcontrols_global.h>
@@ -96,18 +96,21 @@ private slots:
 
 protected:
     virtual void timerEvent(QTimerEvent *e);
+    virtual void resizeEvent(QResizeEvent *e);
 
 private:
     void init(const QString& filename);
 
     messageQueue *messagequeue;
     QPointer<QLabel> _container;
-    QPointer<QMovie> _animation;
     QVBoxLayout* _layout;
     QString thisFileName;
+    QString cachedFile;     // file found for thisFileName, its frames are shared through ImageFrameCache
+    QSize cachedSize;       // size of the frames of cachedFile this widget uses from the cache
     QPixmap pixmap, pix;
     int thisFrame, thisDelay;
-    int prevFrame;
+    int prevFrame, currentFrame;
+    bool thisInvalid;
     QString thisImageCalc;
     int timerId;
     QColor oldColor;
@@ -0,0 +1,162 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#include "cameracodecs.h"
+#include <string.h>
+
+static inline quint64 readBigEndian(const uchar *p, int bytes)
+{
+    quint64 value = 0;
+    for(int k = 0; k < bytes; k++) value = (value << 8) | p[k];
+    return value;
+}
+
+long CameraCodecs::blocks(const uchar *frame, long size, int elementSize, QVector<block> &list)
+{
+    list.resize(0);
+    if(frame == (const uchar *) Q_NULLPTR || size < 12 || elementSize < 1) return -1;
+
+    const quint64 total = readBigEndian(frame, 8);
+    const long blockBytes = (long) readBigEndian(frame + 8, 4);
+    const long multiple = 8 * elementSize;
+    // the frames end up in a QByteArray
+    if(total > 0x7FFFFFFF || total % elementSize != 0) return -1;
+    if(blockBytes < multiple || blockBytes % multiple != 0) return -1;
+
+    long pos = 12;
+    long target = 0;
+    while((long) total - target >= multiple) {
+        long targetSize = qMin(blockBytes, (long) total - target);
+        targetSize -= targetSize % multiple;
+        if(size - pos < 4) return -1;
+        const long sourceSize = (long) readBigEndian(frame + pos, 4);
+        pos += 4;
+        if(sourceSize > size - pos) return -1;
+        block b = {pos, sourceSize, target, targetSize, false};
+        list.append(b);
+        pos += sourceSize;
+        target += targetSize;
+    }
+    if(target < (long) total) {
+        const long rest = (long) total - target;
+        if(rest > size - pos) return -1;
+        block b = {pos, rest, target, rest, true};
+        list.append(b);
+    }
+    return (long) total;
+}
+
+bool CameraCodecs::decompressBlock(const uchar *frame, uchar *dst, const block &b, int elementSize, bool shuffled, uchar *scratch)
+{
+    if(b.raw) {
+        memcpy(dst + b.target, frame + b.source, b.targetSize);
+        return true;
+    }
+    uchar *out = shuffled ? scratch : dst + b.target;
+    if(lz4Block(frame + b.source, b.sourceSize, out, b.targetSize) != b.targetSize) return false;
+    if(shuffled) bitUnshuffle(scratch, dst + b.target, b.targetSize / elementSize, elementSize);
+    return true;
+}
+
+long CameraCodecs::lz4Block(const uchar *src, long size, uchar *dst, long capacity)
+{
+    const uchar *ip = src;
+    const uchar *iend = src + size;
+    uchar *op = dst;
+    uchar *oend = dst + capacity;
+
+    while(ip < iend) {
+        const uint token = *ip++;
+
+        // literals
+        long length = token >> 4;
+        if(length == 15) {
+            uint add;
+            do {
+                if(ip >= iend) return -1;
+                add = *ip++;
+                length += add;
+            } while(add == 255);
+        }
+        if(length > iend - ip || length > oend - op) return -1;
+        memcpy(op, ip, length);
+        ip += length;
+        op += length;
+
+        // the last sequence has only literals
+        if(ip >= iend) break;
+
+        // match, copied from the data written already
+        if(iend - ip < 2) return -1;
+        const long offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if(offset == 0 || offset > op - dst) return -1;
+        length = token & 15;
+        if(length == 15) {
+            uint add;
+            do {
+                if(ip >= iend) return -1;
+                add = *ip++;
+                length += add;
+            } while(add == 255);
+        }
+        length += 4;
+        if(length > oend - op) return -1;
+
+        // a match closer than its length repeats itself, the part that does not overlap doubles with every copy
+        const uchar *match = op - offset;
+        while(length > 0) {
+            const long count = qMin(length, (long) (op - match));
+            memcpy(op, match, count);
+            op += count;
+            length -= count;
+        }
+    }
+    return (long) (op - dst);
+}
+
+// transposes the 8x8 bit matrix held in the bytes of x, byte k bit j goes to byte j bit k
+static inline quint64 transpose8(quint64 x)
+{
+    quint64 t;
+    t = (x ^ (x >> 7)) & Q_UINT64_C(0x00AA00AA00AA00AA);
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & Q_UINT64_C(0x0000CCCC0000CCCC);
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & Q_UINT64_C(0x00000000F0F0F0F0);
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+void CameraCodecs::bitUnshuffle(const uchar *src, uchar *dst, long count, int elementSize)
+{
+    // bit k of byte b of all elements is in row 8 * b + k, element e at bit e % 8 of byte e / 8
+    const long rowBytes = count / 8;
+    for(int b = 0; b < elementSize; b++) {
+        const uchar *rows = src + (long) b * 8 * rowBytes;
+        for(long g = 0; g < rowBytes; g++) {
+            quint64 x = 0;
+            for(int k = 0; k < 8; k++) x |= (quint64) rows[k * rowBytes + g] << (8 * k);
+            x = transpose8(x);
+            uchar *out = dst + g * 8 * elementSize + b;
+            for(int e = 0; e < 8; e++) out[e * elementSize] = (uchar) (x >> (8 * e));
+        }
+    }
+}
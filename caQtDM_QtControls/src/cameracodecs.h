@@ -0,0 +1,65 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#ifndef CAMERACODECS_H
+#define CAMERACODECS_H
+
+#include <QtGlobal>
+#include <QVector>
+
+// decompression of the LZ4 and BSLZ4 frames of caCamera
+// the frames consist of blocks, so that caCamera can decompress them in its threads straight into the data it converts
+//
+// both use the layout of the bitshuffle lz4 filter known from HDF5 and areaDetector, the numbers are big endian
+//   offset  0  quint64  size of the uncompressed data in bytes
+//   offset  8  quint32  size of a block in bytes, a multiple of 8 elements
+//   offset 12  the blocks, each one a quint32 with the size of its lz4 data followed by the lz4 data
+// the last block can be smaller, but still holds a multiple of 8 elements; the remaining bytes follow it uncompressed
+// in BSLZ4 the bits of a block are shuffled before compression, first bit 0 of all its elements, then bit 1 and so on
+// LZ4 is the same without the shuffling and with 1 byte elements
+
+class CameraCodecs
+{
+
+public:
+
+    typedef struct {
+        long source;        // offset of the compressed data in the frame
+        long sourceSize;
+        long target;        // offset in the uncompressed data
+        long targetSize;
+        bool raw;           // the uncompressed bytes at the end
+    } block;
+
+    // checks a frame and fills list with its blocks, returns the size of the uncompressed data or -1 for an invalid frame
+    static long blocks(const uchar *frame, long size, int elementSize, QVector<block> &list);
+
+    // one block of the frame into dst, which holds the whole uncompressed data
+    // for shuffled blocks scratch must hold targetSize bytes, false when the block is not valid
+    static bool decompressBlock(const uchar *frame, uchar *dst, const block &b, int elementSize, bool shuffled, uchar *scratch);
+
+    // lz4 block format, returns the number of bytes written or -1 when the data is not valid or does not fit into capacity
+    static long lz4Block(const uchar *src, long size, uchar *dst, long capacity);
+
+    // reverses the bit shuffling of count elements, count is a multiple of 8
+    static void bitUnshuffle(const uchar *src, uchar *dst, long count, int elementSize);
+};
+
+#endif // CAMERACODECS_H
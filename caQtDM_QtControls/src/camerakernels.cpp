@@ -0,0 +1,1085 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+
+#include "camerakernels.h"
+#include <QColor>
+#include <QByteArray>
+#include <climits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define CAMERA_SSE2
+#include <emmintrin.h>
+#endif
+
+// ssse3 and avx2 code is compiled for its functions only, so the library still runs on processors without them
+#if defined(CAMERA_SSE2) && (defined(__clang__) || defined(_MSC_VER) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define CAMERA_SSSE3
+#define CAMERA_AVX2
+#include <tmmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SSSE3_FUNCTION
+#define AVX2_FUNCTION
+#else
+#define SSSE3_FUNCTION __attribute__((target("ssse3")))
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#endif
+
+// ------------------------------------------------------------------------------------------------------------------
+// plain c++, used for the processors without sse2 and for the remainder of a block
+
+// a plain cast of a float out of the range of the integer is undefined, these give what the vector conversions give
+
+// truncated, INT_MIN for NaN and values out of range like cvttps
+static inline int truncatedIndex(float value)
+{
+    if(!(value > -2147483904.0f && value < 2147483648.0f)) return INT_MIN;
+    return (int) value;
+}
+
+// extremes are kept as uint, negative values count as 0 and too large ones as the largest uint
+static inline uint extremeValue(float value)
+{
+    if(!(value > 0.0f)) return 0;
+    if(value >= 4294967296.0f) return UINT_MAX;
+    return (uint) value;
+}
+
+static inline uint extremeValue(uint value)
+{
+    return value;
+}
+
+template <typename T> static void monoTableScalar(const T *src, uint *dst, long count, const uint *table, uint &Max, uint &Min)
+{
+    uint max = Max;
+    uint min = Min;
+    for(long k = 0; k < count; k++) {
+        const uint value = src[k];
+        if(value > max) max = value;
+        if(value < min) min = value;
+        dst[k] = table[value];
+    }
+    Max = max;
+    Min = min;
+}
+
+template <typename T> static void monoScaleScalar(const T *src, uint *dst, long count, float correction, uint minvalue,
+                                                  const uint *colormap, int colors, uint &Max, uint &Min)
+{
+    for(long k = 0; k < count; k++) {
+        const T value = src[k];
+        // a NaN is neither
+        if(value > Max) Max = extremeValue(value);
+        if(value < Min) Min = extremeValue(value);
+        if(colormap == (const uint *) Q_NULLPTR) {
+            int indx1 = truncatedIndex(value * correction);
+            if(indx1 > 255) indx1 = 255;
+            dst[k] = qRgb(indx1, indx1, indx1);
+        } else {
+            int indx1 = truncatedIndex((value - minvalue) * correction);
+            if(indx1 < 0) indx1 = 0;
+            if(indx1 >= colors) indx1 = colors - 1;
+            dst[k] = colormap[indx1];
+        }
+    }
+}
+
+static void rgbScaleScalar(const uint *src, uint *dst, long count, float red, float green, float blue, uint &Max, uint &Min)
+{
+    uint max = Max;
+    uint min = Min;
+    for(long k = 0; k < count; k++) {
+        const uint intensity = qMax(qMax(src[0], src[1]), src[2]);
+        dst[k] = qRgb((int) (src[0] * red), (int) (src[1] * green), (int) (src[2] * blue));
+        if(intensity > max) max = intensity;
+        if(intensity < min) min = intensity;
+        src += 3;
+    }
+    Max = max;
+    Min = min;
+}
+
+static void rgbPlanarScaleScalar(const ushort *red, const ushort *green, const ushort *blue, uint *dst, long count,
+                                 float redcoeff, float greencoeff, float bluecoeff, uint &Max, uint &Min)
+{
+    uint max = Max;
+    uint min = Min;
+    for(long k = 0; k < count; k++) {
+        const uint intensity = qMax(qMax(red[k], green[k]), blue[k]);
+        dst[k] = qRgb((int) (red[k] * redcoeff), (int) (green[k] * greencoeff), (int) (blue[k] * bluecoeff));
+        if(intensity > max) max = intensity;
+        if(intensity < min) min = intensity;
+    }
+    Max = max;
+    Min = min;
+}
+
+/*
+ * the simple bayer interpolation of
+ * 1394-Based Digital Camera Control Library
+ *
+ * Bayer pattern decoding functions
+ *
+ * Written by Damien Douxchamps and Frederic Devernay
+ * The original VNG and AHD Bayer decoding are from Dave Coffin's DCR
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ */
+static void demosaicRowScalar(const ushort *top, const ushort *bottom, int from, int width, bool greenFirst,
+                              ushort *topColor, ushort *green, ushort *bottomColor)
+{
+    for(int x = from; x < width - 1; x++) {
+        // green pixel, its red and blue are beside and below it
+        if(((x & 1) == 0) == greenFirst) {
+            topColor[x] = top[x + 1];
+            green[x] = bottom[x + 1];
+            bottomColor[x] = bottom[x];
+        } else {
+            topColor[x] = top[x];
+            green[x] = top[x + 1];
+            bottomColor[x] = bottom[x + 1];
+        }
+    }
+    if(width > 0) topColor[width - 1] = green[width - 1] = bottomColor[width - 1] = 0;
+}
+
+// the bits of the groups of packed data, as caCamera unpacked them before
+template <int format> static inline void unpackGroup(const uchar *b, ushort *v)
+{
+    switch(format) {
+    case CameraKernels::packed12lsb:
+        v[0] = ((b[1] & 0x0F) << 8) + b[0];
+        v[1] = ((b[1] & 0xF0) >> 4) + (b[2] << 4);
+        break;
+    case CameraKernels::packed12msb:
+        v[0] = (b[1] & 0x0F) + (b[0] << 4);
+        v[1] = ((b[1] & 0xF0) >> 4) + (b[2] << 4);
+        break;
+    case CameraKernels::packed10:
+        v[0] = ((b[1] & 0x30) >> 4) + (b[0] << 2);
+        v[1] = (b[1] & 0x03) + (b[2] << 2);
+        break;
+    default:
+        v[0] = (b[1] & 0x03) + b[0];
+        v[1] = ((b[1] & 0xFC) >> 2) + ((b[2] & 0x0F) << 6);
+        v[2] = ((b[2] & 0xF0) >> 4) + ((b[3] & 0x1F) << 4);
+        v[3] = ((b[3] & 0xC0) >> 6) + (b[4] << 2);
+        break;
+    }
+}
+
+template <int format> static long unpackScalar(const uchar *src, long size, long first, long count, ushort *dst)
+{
+    const int groupBytes = (format == CameraKernels::packed10p) ? 5 : 3;
+    const int groupValues = (format == CameraKernels::packed10p) ? 4 : 2;
+    long offset = (first / groupValues) * groupBytes;
+    int k = (int) (first % groupValues);
+    long n = 0;
+    ushort values[4];
+
+    // a group cut by the start of the block
+    if(k > 0) {
+        if(offset + groupBytes > size) return 0;
+        unpackGroup<format>(src + offset, values);
+        for(; k < groupValues && n < count; k++) dst[n++] = values[k];
+        offset += groupBytes;
+    }
+    // whole groups straight into the destination
+    for(; n + groupValues <= count && offset + groupBytes <= size; n += groupValues, offset += groupBytes) {
+        unpackGroup<format>(src + offset, dst + n);
+    }
+    // a group cut by the end of the block
+    if(n < count && offset + groupBytes <= size) {
+        unpackGroup<format>(src + offset, values);
+        for(k = 0; n < count; k++) dst[n++] = values[k];
+    }
+    return n;
+}
+
+// the bytes of eight values shuffled into 16 bit lanes, every value is then
+// (lane >> shift1 & mask1) + (lane >> shift2 & mask2) + (lane & mask0), the right shifts done as high half of lane * 2^(16 - shift)
+typedef struct {
+    int bytes;              // bytes of eight values
+    char shuffle[16];
+    ushort shift1[8], mask1[8], shift2[8], mask2[8], mask0[8];
+} unpackLayout;
+
+static const unpackLayout unpackLayouts[] = {
+    // packed12lsb, lanes of bytes 0 1 and 1 2 of every group
+    {12, {0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11},
+     {4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096}, {0, 0xFFF, 0, 0xFFF, 0, 0xFFF, 0, 0xFFF},
+     {1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 0, 0, 0, 0, 0, 0},
+     {0xFFF, 0, 0xFFF, 0, 0xFFF, 0, 0xFFF, 0}},
+    // packed12msb, lanes of bytes 1 0 and 1 2
+    {12, {1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11},
+     {4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096}, {0xFF0, 0xFFF, 0xFF0, 0xFFF, 0xFF0, 0xFFF, 0xFF0, 0xFFF},
+     {1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 0, 0, 0, 0, 0, 0},
+     {0x00F, 0, 0x00F, 0, 0x00F, 0, 0x00F, 0}},
+    // packed10, lanes of bytes 1 0 and 1 2
+    {12, {1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11},
+     {1024, 1024, 1024, 1024, 1024, 1024, 1024, 1024}, {0x3FC, 0x3FC, 0x3FC, 0x3FC, 0x3FC, 0x3FC, 0x3FC, 0x3FC},
+     {4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096}, {3, 0, 3, 0, 3, 0, 3, 0},
+     {0, 3, 0, 3, 0, 3, 0, 3}},
+    // packed10p, lanes of bytes 0 1, 1 2, 2 3 and 3 4 of every group
+    {10, {0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9},
+     {256, 16384, 4096, 1024, 256, 16384, 4096, 1024}, {3, 0x3FF, 0x1FF, 0x3FF, 3, 0x3FF, 0x1FF, 0x3FF},
+     {1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 0, 0, 0, 0, 0, 0},
+     {0xFF, 0, 0, 0, 0xFF, 0, 0, 0}}
+};
+
+// the layout of a group of bytes and the conversion of the former caCamera yuv functions, computed in double and truncated
+typedef struct {
+    int bytes;      // bytes of a group
+    int pixels;     // pixels of a group
+    int y[4];       // luma of every pixel, for rgb the red, green and blue bytes
+    int u;
+    int v;
+} colorLayout;
+
+static const colorLayout colorLayouts[] = {
+    {4, 2, {0, 2, 0, 0}, 1, 3},     // yuyv422
+    {4, 2, {1, 3, 0, 0}, 0, 2},     // uyvy422
+    {6, 4, {0, 1, 3, 4}, 2, 5},     // yyuyyv411
+    {6, 4, {1, 2, 4, 5}, 0, 3},     // uyyvyy411
+    {3, 1, {0, 0, 0, 0}, 1, 2},     // yuv444
+    {3, 1, {1, 0, 0, 0}, 0, 2},     // uvy444
+    {3, 1, {0, 1, 2, 0}, 0, 0},     // rgb8
+    {3, 1, {2, 1, 0, 0}, 0, 0},     // bgr8
+    {4, 1, {0, 1, 2, 0}, 0, 0},     // rgba8
+    {4, 1, {2, 1, 0, 0}, 0, 0}      // bgra8
+};
+
+// https://en.wikipedia.org/wiki/YCbCr, negative values are clipped to 0
+static inline void yuvPixel(int y, int cb, int cr, ushort &red, ushort &green, ushort &blue)
+{
+    const long r = 298.082*y/256 +                      408.583 * cr / 256 - 222.291;
+    const long g = 298.082*y/256 - 100.291 * cb / 256 - 208.120 * cr / 256 + 135.576;
+    const long b = 298.082*y/256 + 561.412 * cb / 256                      - 276.836;
+    red = (ushort) qMax(0L, r);
+    green = (ushort) qMax(0L, g);
+    blue = (ushort) qMax(0L, b);
+}
+
+// pixels x up to end - 1 one by one, offset and k are the group and the pixel in it of x; returns the first pixel not done
+static int colorPixelsScalar(const colorLayout &layout, bool yuv, const uchar *src, long size, long &offset, int &k, int x, int end,
+                             ushort *red, ushort *green, ushort *blue)
+{
+    for(; x < end && offset + layout.bytes <= size; x++) {
+        const uchar *b = src + offset;
+        if(yuv) {
+            yuvPixel(b[layout.y[k]], b[layout.u], b[layout.v], red[x], green[x], blue[x]);
+        } else {
+            red[x] = b[layout.y[0]];
+            green[x] = b[layout.y[1]];
+            blue[x] = b[layout.y[2]];
+        }
+        if(++k == layout.pixels) {
+            k = 0;
+            offset += layout.bytes;
+        }
+    }
+    return x;
+}
+
+// the shuffles taking the bytes of four pixels from the start of a group into 32 bit lanes,
+// for yuv into luma, blue and red difference, for rgb into red, green and blue; returns the bytes of the four pixels
+static int colorShuffles(const colorLayout &layout, bool yuv, char first[16], char second[16], char third[16])
+{
+    for(int j = 0; j < 16; j++) first[j] = second[j] = third[j] = (char) 0x80;
+    for(int p = 0; p < 4; p++) {
+        const int base = (p / layout.pixels) * layout.bytes;
+        const int k = p % layout.pixels;
+        first[4 * p] = (char) (base + (yuv ? layout.y[k] : layout.y[0]));
+        second[4 * p] = (char) (base + (yuv ? layout.u : layout.y[1]));
+        third[4 * p] = (char) (base + (yuv ? layout.v : layout.y[2]));
+    }
+    return (4 / layout.pixels) * layout.bytes;
+}
+
+// extremes of a block kept in vector registers, merged with the ones found before
+template <typename T> static void mergeMinMax(const T *maxima, const T *minima, int size, uint &Max, uint &Min)
+{
+    for(int k = 0; k < size; k++) {
+        if(maxima[k] > Max) Max = maxima[k];
+        if(minima[k] < Min) Min = minima[k];
+    }
+}
+
+static void mergeMinMax(const float *maxima, const float *minima, int size, uint &Max, uint &Min)
+{
+    for(int k = 0; k < size; k++) {
+        if(maxima[k] > Max) Max = extremeValue(maxima[k]);
+        if(minima[k] < Min) Min = extremeValue(minima[k]);
+    }
+}
+
+#ifdef CAMERA_SSE2
+
+// ------------------------------------------------------------------------------------------------------------------
+// sse2, 16 bytes per register
+
+// sse2 compares signed 32 bit integers only
+static inline __m128i selectGreater(__m128i a, __m128i b, __m128i greater)
+{
+    return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+}
+
+static inline __m128i maxU32(__m128i a, __m128i b)
+{
+    const __m128i bias = _mm_set1_epi32((int) 0x80000000);
+    return selectGreater(a, b, _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias)));
+}
+
+static inline __m128i minU32(__m128i a, __m128i b)
+{
+    const __m128i bias = _mm_set1_epi32((int) 0x80000000);
+    return selectGreater(b, a, _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias)));
+}
+
+static inline __m128i minS32(__m128i a, int high)
+{
+    const __m128i vhigh = _mm_set1_epi32(high);
+    return selectGreater(vhigh, a, _mm_cmpgt_epi32(a, vhigh));
+}
+
+static inline __m128i maxS32(__m128i a, int low)
+{
+    const __m128i vlow = _mm_set1_epi32(low);
+    return selectGreater(a, vlow, _mm_cmpgt_epi32(a, vlow));
+}
+
+// unsigned to float in two exact halves, the sum is rounded once like the conversion of the compiler
+static inline __m128 u32ToFloat(__m128i a)
+{
+    const __m128 high = _mm_cvtepi32_ps(_mm_srli_epi32(a, 16));
+    const __m128 low = _mm_cvtepi32_ps(_mm_and_si128(a, _mm_set1_epi32(0xFFFF)));
+    return _mm_add_ps(_mm_mul_ps(high, _mm_set1_ps(65536.0f)), low);
+}
+
+// qRgb(i, i, i) of the lowest byte
+static inline __m128i greyPixels(__m128i index)
+{
+    const __m128i grey = _mm_and_si128(index, _mm_set1_epi32(0xFF));
+    return _mm_or_si128(_mm_or_si128(grey, _mm_slli_epi32(grey, 8)),
+                        _mm_or_si128(_mm_slli_epi32(grey, 16), _mm_set1_epi32((int) 0xFF000000)));
+}
+
+// the float to int conversion truncates and gives 0x80000000 out of range, as the compiler does for a scalar
+static inline void storeScaled(__m128 value, __m128 correction, const uint *colormap, int colors, uint *dst)
+{
+    const __m128i index = _mm_cvttps_epi32(_mm_mul_ps(value, correction));
+    if(colormap == (const uint *) Q_NULLPTR) {
+        _mm_storeu_si128((__m128i *) dst, greyPixels(minS32(index, 255)));
+    } else {
+        int indices[4];
+        _mm_storeu_si128((__m128i *) indices, minS32(maxS32(index, 0), colors - 1));
+        for(int j = 0; j < 4; j++) dst[j] = colormap[indices[j]];
+    }
+}
+
+static void monoTableSSE2(const uchar *src, uint *dst, long count, const uint *table, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 16) {
+        __m128i vmax = _mm_setzero_si128();
+        __m128i vmin = _mm_set1_epi8((char) 0xFF);
+        for(; k + 16 <= count; k += 16) {
+            const __m128i value = _mm_loadu_si128((const __m128i *) (src + k));
+            vmax = _mm_max_epu8(vmax, value);
+            vmin = _mm_min_epu8(vmin, value);
+            for(int j = 0; j < 16; j++) dst[k + j] = table[src[k + j]];
+        }
+        uchar maxima[16], minima[16];
+        _mm_storeu_si128((__m128i *) maxima, vmax);
+        _mm_storeu_si128((__m128i *) minima, vmin);
+        mergeMinMax(maxima, minima, 16, Max, Min);
+    }
+    monoTableScalar(src + k, dst + k, count - k, table, Max, Min);
+}
+
+static void monoTableSSE2(const ushort *src, uint *dst, long count, const uint *table, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 8) {
+        // sse2 has only signed 16 bit extremes, the values are moved into the signed range
+        const __m128i bias = _mm_set1_epi16((short) 0x8000);
+        __m128i vmax = _mm_set1_epi16((short) 0x8000);
+        __m128i vmin = _mm_set1_epi16(0x7FFF);
+        for(; k + 8 <= count; k += 8) {
+            const __m128i value = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (src + k)), bias);
+            vmax = _mm_max_epi16(vmax, value);
+            vmin = _mm_min_epi16(vmin, value);
+            for(int j = 0; j < 8; j++) dst[k + j] = table[src[k + j]];
+        }
+        ushort maxima[8], minima[8];
+        _mm_storeu_si128((__m128i *) maxima, _mm_xor_si128(vmax, bias));
+        _mm_storeu_si128((__m128i *) minima, _mm_xor_si128(vmin, bias));
+        mergeMinMax(maxima, minima, 8, Max, Min);
+    }
+    monoTableScalar(src + k, dst + k, count - k, table, Max, Min);
+}
+
+static void monoScaleSSE2(const uint *src, uint *dst, long count, float correction, uint minvalue,
+                          const uint *colormap, int colors, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 4) {
+        const __m128 vcorrection = _mm_set1_ps(correction);
+        const __m128i vminvalue = _mm_set1_epi32((int) (colormap == (const uint *) Q_NULLPTR ? 0 : minvalue));
+        __m128i vmax = _mm_set1_epi32((int) Max);
+        __m128i vmin = _mm_set1_epi32((int) Min);
+        for(; k + 4 <= count; k += 4) {
+            const __m128i value = _mm_loadu_si128((const __m128i *) (src + k));
+            vmax = maxU32(vmax, value);
+            vmin = minU32(vmin, value);
+            // the difference wraps for values below minvalue and ends up in the first color, like in the scalar code
+            storeScaled(u32ToFloat(_mm_sub_epi32(value, vminvalue)), vcorrection, colormap, colors, dst + k);
+        }
+        uint maxima[4], minima[4];
+        _mm_storeu_si128((__m128i *) maxima, vmax);
+        _mm_storeu_si128((__m128i *) minima, vmin);
+        mergeMinMax(maxima, minima, 4, Max, Min);
+    }
+    monoScaleScalar(src + k, dst + k, count - k, correction, minvalue, colormap, colors, Max, Min);
+}
+
+static void monoScaleSSE2(const float *src, uint *dst, long count, float correction, uint minvalue,
+                          const uint *colormap, int colors, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 4) {
+        const __m128 vcorrection = _mm_set1_ps(correction);
+        const __m128 vminvalue = _mm_set1_ps(colormap == (const uint *) Q_NULLPTR ? 0.0f : (float) minvalue);
+        __m128 vmax = _mm_set1_ps((float) Max);
+        __m128 vmin = _mm_set1_ps((float) Min);
+        for(; k + 4 <= count; k += 4) {
+            const __m128 value = _mm_loadu_ps(src + k);
+            // a NaN keeps the extreme found so far
+            vmax = _mm_max_ps(value, vmax);
+            vmin = _mm_min_ps(value, vmin);
+            storeScaled(_mm_sub_ps(value, vminvalue), vcorrection, colormap, colors, dst + k);
+        }
+        float maxima[4], minima[4];
+        _mm_storeu_ps(maxima, vmax);
+        _mm_storeu_ps(minima, vmin);
+        mergeMinMax(maxima, minima, 4, Max, Min);
+    }
+    monoScaleScalar(src + k, dst + k, count - k, correction, minvalue, colormap, colors, Max, Min);
+}
+
+// four pixels of interleaved red, green, blue are split into one register per channel
+static inline void deinterleave(const uint *src, __m128i &red, __m128i &green, __m128i &blue)
+{
+    const __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) src));         // r0 g0 b0 r1
+    const __m128 b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + 4)));   // g1 b1 r2 g2
+    const __m128 c = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + 8)));   // b2 r3 g3 b3
+    red = _mm_castps_si128(_mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0)));
+    green = _mm_castps_si128(_mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                                            _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+    blue = _mm_castps_si128(_mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                                           _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+// qRgb of the scaled channels, truncated and cut to their lowest byte
+static inline void storeRgb(__m128 red, __m128 green, __m128 blue, __m128 vred, __m128 vgreen, __m128 vblue, uint *dst)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i r = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(red, vred)), mask);
+    const __m128i g = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(green, vgreen)), mask);
+    const __m128i b = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(blue, vblue)), mask);
+    const __m128i pixels = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8)),
+                                        _mm_or_si128(b, _mm_set1_epi32((int) 0xFF000000)));
+    _mm_storeu_si128((__m128i *) dst, pixels);
+}
+
+static void rgbScaleSSE2(const uint *src, uint *dst, long count, float red, float green, float blue, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 4) {
+        const __m128 vred = _mm_set1_ps(red);
+        const __m128 vgreen = _mm_set1_ps(green);
+        const __m128 vblue = _mm_set1_ps(blue);
+        __m128i vmax = _mm_set1_epi32((int) Max);
+        __m128i vmin = _mm_set1_epi32((int) Min);
+        for(; k + 4 <= count; k += 4) {
+            __m128i r, g, b;
+            deinterleave(src + 3 * k, r, g, b);
+            const __m128i intensity = maxU32(maxU32(r, g), b);
+            vmax = maxU32(vmax, intensity);
+            vmin = minU32(vmin, intensity);
+            storeRgb(u32ToFloat(r), u32ToFloat(g), u32ToFloat(b), vred, vgreen, vblue, dst + k);
+        }
+        uint maxima[4], minima[4];
+        _mm_storeu_si128((__m128i *) maxima, vmax);
+        _mm_storeu_si128((__m128i *) minima, vmin);
+        mergeMinMax(maxima, minima, 4, Max, Min);
+    }
+    rgbScaleScalar(src + 3 * k, dst + k, count - k, red, green, blue, Max, Min);
+}
+
+static void rgbPlanarScaleSSE2(const ushort *red, const ushort *green, const ushort *blue, uint *dst, long count,
+                               float redcoeff, float greencoeff, float bluecoeff, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 8) {
+        const __m128 vred = _mm_set1_ps(redcoeff);
+        const __m128 vgreen = _mm_set1_ps(greencoeff);
+        const __m128 vblue = _mm_set1_ps(bluecoeff);
+        const __m128i zero = _mm_setzero_si128();
+        // signed 16 bit extremes only, see monoTableSSE2
+        const __m128i bias = _mm_set1_epi16((short) 0x8000);
+        __m128i vmax = _mm_set1_epi16((short) 0x8000);
+        __m128i vmin = _mm_set1_epi16(0x7FFF);
+        for(; k + 8 <= count; k += 8) {
+            const __m128i r = _mm_loadu_si128((const __m128i *) (red + k));
+            const __m128i g = _mm_loadu_si128((const __m128i *) (green + k));
+            const __m128i b = _mm_loadu_si128((const __m128i *) (blue + k));
+            const __m128i intensity = _mm_max_epi16(_mm_max_epi16(_mm_xor_si128(r, bias), _mm_xor_si128(g, bias)), _mm_xor_si128(b, bias));
+            vmax = _mm_max_epi16(vmax, intensity);
+            vmin = _mm_min_epi16(vmin, intensity);
+            storeRgb(_mm_cvtepi32_ps(_mm_unpacklo_epi16(r, zero)), _mm_cvtepi32_ps(_mm_unpacklo_epi16(g, zero)),
+                     _mm_cvtepi32_ps(_mm_unpacklo_epi16(b, zero)), vred, vgreen, vblue, dst + k);
+            storeRgb(_mm_cvtepi32_ps(_mm_unpackhi_epi16(r, zero)), _mm_cvtepi32_ps(_mm_unpackhi_epi16(g, zero)),
+                     _mm_cvtepi32_ps(_mm_unpackhi_epi16(b, zero)), vred, vgreen, vblue, dst + k + 4);
+        }
+        ushort maxima[8], minima[8];
+        _mm_storeu_si128((__m128i *) maxima, _mm_xor_si128(vmax, bias));
+        _mm_storeu_si128((__m128i *) minima, _mm_xor_si128(vmin, bias));
+        mergeMinMax(maxima, minima, 8, Max, Min);
+    }
+    rgbPlanarScaleScalar(red + k, green + k, blue + k, dst + k, count - k, redcoeff, greencoeff, bluecoeff, Max, Min);
+}
+
+// eight pixels at once, the colors alternate between green and red or blue and repeat every two pixels
+static void demosaicRowSSE2(const ushort *top, const ushort *bottom, int width, bool greenFirst,
+                            ushort *topColor, ushort *green, ushort *bottomColor)
+{
+    const __m128i nonGreen = greenFirst ? _mm_set_epi16(-1, 0, -1, 0, -1, 0, -1, 0) : _mm_set_epi16(0, -1, 0, -1, 0, -1, 0, -1);
+    int x = 0;
+    for(; x + 9 <= width; x += 8) {
+        const __m128i top0 = _mm_loadu_si128((const __m128i *) (top + x));
+        const __m128i top1 = _mm_loadu_si128((const __m128i *) (top + x + 1));
+        const __m128i bottom0 = _mm_loadu_si128((const __m128i *) (bottom + x));
+        const __m128i bottom1 = _mm_loadu_si128((const __m128i *) (bottom + x + 1));
+        _mm_storeu_si128((__m128i *) (topColor + x), selectGreater(top0, top1, nonGreen));
+        _mm_storeu_si128((__m128i *) (green + x), selectGreater(top1, bottom1, nonGreen));
+        _mm_storeu_si128((__m128i *) (bottomColor + x), selectGreater(bottom1, bottom0, nonGreen));
+    }
+    demosaicRowScalar(top, bottom, x, width, greenFirst, topColor, green, bottomColor);
+}
+
+#endif // CAMERA_SSE2
+
+#ifdef CAMERA_SSSE3
+
+// ------------------------------------------------------------------------------------------------------------------
+// ssse3, byte shuffles for the packed and the yuv and rgb formats
+
+static bool cpuHasSsse3()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+// eight values of the 16 bytes at src, of which the first layout.bytes belong to them
+SSSE3_FUNCTION static inline __m128i unpackEight(const unpackLayout &layout, const uchar *src)
+{
+    const __m128i lanes = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) src), _mm_loadu_si128((const __m128i *) layout.shuffle));
+    const __m128i part1 = _mm_and_si128(_mm_mulhi_epu16(lanes, _mm_loadu_si128((const __m128i *) layout.shift1)),
+                                        _mm_loadu_si128((const __m128i *) layout.mask1));
+    const __m128i part2 = _mm_and_si128(_mm_mulhi_epu16(lanes, _mm_loadu_si128((const __m128i *) layout.shift2)),
+                                        _mm_loadu_si128((const __m128i *) layout.mask2));
+    const __m128i part0 = _mm_and_si128(lanes, _mm_loadu_si128((const __m128i *) layout.mask0));
+    return _mm_add_epi16(_mm_add_epi16(part1, part2), part0);
+}
+
+// whole blocks of eight values from offset at the start of a group, the 16 bytes read may go beyond the values;
+// returns how many values were done
+SSSE3_FUNCTION static long unpackSSSE3(const unpackLayout &layout, const uchar *src, long size, long offset, long count, ushort *dst)
+{
+    long n = 0;
+    for(; n + 8 <= count && offset + 16 <= size; n += 8, offset += layout.bytes) {
+        _mm_storeu_si128((__m128i *) (dst + n), unpackEight(layout, src + offset));
+    }
+    return n;
+}
+
+// four yuv pixels in double like yuvPixel, truncated and clipped to 0
+SSSE3_FUNCTION static inline __m128i yuvChannelSSSE3(__m128i luma, __m128i first, __m128i second, double lumaFactor,
+                                                     double firstFactor, double secondFactor, double offset)
+{
+    const __m128d scale = _mm_set1_pd(1.0 / 256.0);
+    __m128i halves[2];
+    for(int h = 0; h < 2; h++) {
+        const __m128d y = _mm_cvtepi32_pd(luma);
+        const __m128d a = _mm_cvtepi32_pd(first);
+        const __m128d b = _mm_cvtepi32_pd(second);
+        // the sums in the order of yuvPixel, the terms of the missing differences are 0 and change nothing
+        __m128d value = _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(lumaFactor), y), scale);
+        value = _mm_add_pd(value, _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(firstFactor), a), scale));
+        value = _mm_add_pd(value, _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(secondFactor), b), scale));
+        value = _mm_add_pd(value, _mm_set1_pd(offset));
+        halves[h] = _mm_cvttpd_epi32(value);
+        luma = _mm_srli_si128(luma, 8);
+        first = _mm_srli_si128(first, 8);
+        second = _mm_srli_si128(second, 8);
+    }
+    return maxS32(_mm_unpacklo_epi64(halves[0], halves[1]), 0);
+}
+
+static inline void storeFour(__m128i values, ushort *dst)
+{
+    _mm_storel_epi64((__m128i *) dst, _mm_packs_epi32(values, values));
+}
+
+// four pixels at a time from offset at the start of a group into the rows from x on; returns the first pixel not done
+SSSE3_FUNCTION static int colorPixelsSSSE3(const colorLayout &layout, bool yuv, const uchar *src, long size, long &offset, int x, int count,
+                                           ushort *red, ushort *green, ushort *blue)
+{
+    char first[16], second[16], third[16];
+    const int step = colorShuffles(layout, yuv, first, second, third);
+    const __m128i shuffle1 = _mm_loadu_si128((const __m128i *) first);
+    const __m128i shuffle2 = _mm_loadu_si128((const __m128i *) second);
+    const __m128i shuffle3 = _mm_loadu_si128((const __m128i *) third);
+    for(; x + 4 <= count && offset + 16 <= size; x += 4, offset += step) {
+        const __m128i bytes = _mm_loadu_si128((const __m128i *) (src + offset));
+        const __m128i c1 = _mm_shuffle_epi8(bytes, shuffle1);
+        const __m128i c2 = _mm_shuffle_epi8(bytes, shuffle2);
+        const __m128i c3 = _mm_shuffle_epi8(bytes, shuffle3);
+        if(yuv) {
+            // subtractions as additions of the negative factor give the same doubles
+            storeFour(yuvChannelSSSE3(c1, c2, c3, 298.082, 0.0, 408.583, -222.291), red + x);
+            storeFour(yuvChannelSSSE3(c1, c2, c3, 298.082, -100.291, -208.120, 135.576), green + x);
+            storeFour(yuvChannelSSSE3(c1, c2, c3, 298.082, 561.412, 0.0, -276.836), blue + x);
+        } else {
+            storeFour(c1, red + x);
+            storeFour(c2, green + x);
+            storeFour(c3, blue + x);
+        }
+    }
+    return x;
+}
+
+#endif // CAMERA_SSSE3
+
+#ifdef CAMERA_AVX2
+
+// ------------------------------------------------------------------------------------------------------------------
+// avx2, 32 bytes per register, the colors are gathered from the tables
+
+static bool cpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) return false;
+    __cpuid(info, 1);
+    // avx and its registers saved by the operating system
+    if((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+    if((_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+AVX2_FUNCTION static inline __m256 u32ToFloatAVX2(__m256i a)
+{
+    const __m256 high = _mm256_cvtepi32_ps(_mm256_srli_epi32(a, 16));
+    const __m256 low = _mm256_cvtepi32_ps(_mm256_and_si256(a, _mm256_set1_epi32(0xFFFF)));
+    return _mm256_add_ps(_mm256_mul_ps(high, _mm256_set1_ps(65536.0f)), low);
+}
+
+AVX2_FUNCTION static inline __m256i scaledPixelsAVX2(__m256 value, __m256 correction, const uint *colormap, int colors)
+{
+    const __m256i index = _mm256_cvttps_epi32(_mm256_mul_ps(value, correction));
+    if(colormap == (const uint *) Q_NULLPTR) {
+        const __m256i grey = _mm256_and_si256(_mm256_min_epi32(index, _mm256_set1_epi32(255)), _mm256_set1_epi32(0xFF));
+        return _mm256_or_si256(_mm256_mullo_epi32(grey, _mm256_set1_epi32(0x010101)), _mm256_set1_epi32((int) 0xFF000000));
+    }
+    const __m256i clamped = _mm256_min_epi32(_mm256_max_epi32(index, _mm256_setzero_si256()), _mm256_set1_epi32(colors - 1));
+    return _mm256_i32gather_epi32((const int *) colormap, clamped, 4);
+}
+
+AVX2_FUNCTION static void monoTableAVX2(const uchar *src, uint *dst, long count, const uint *table, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 32) {
+        __m256i vmax = _mm256_setzero_si256();
+        __m256i vmin = _mm256_set1_epi8((char) 0xFF);
+        for(; k + 32 <= count; k += 32) {
+            const __m256i value = _mm256_loadu_si256((const __m256i *) (src + k));
+            vmax = _mm256_max_epu8(vmax, value);
+            vmin = _mm256_min_epu8(vmin, value);
+            for(int j = 0; j < 32; j += 8) {
+                const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + k + j)));
+                _mm256_storeu_si256((__m256i *) (dst + k + j), _mm256_i32gather_epi32((const int *) table, index, 4));
+            }
+        }
+        uchar maxima[32], minima[32];
+        _mm256_storeu_si256((__m256i *) maxima, vmax);
+        _mm256_storeu_si256((__m256i *) minima, vmin);
+        mergeMinMax(maxima, minima, 32, Max, Min);
+    }
+    monoTableScalar(src + k, dst + k, count - k, table, Max, Min);
+}
+
+AVX2_FUNCTION static void monoTableAVX2(const ushort *src, uint *dst, long count, const uint *table, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 16) {
+        __m256i vmax = _mm256_setzero_si256();
+        __m256i vmin = _mm256_set1_epi16((short) 0xFFFF);
+        for(; k + 16 <= count; k += 16) {
+            const __m256i value = _mm256_loadu_si256((const __m256i *) (src + k));
+            vmax = _mm256_max_epu16(vmax, value);
+            vmin = _mm256_min_epu16(vmin, value);
+            for(int j = 0; j < 16; j += 8) {
+                const __m256i index = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (src + k + j)));
+                _mm256_storeu_si256((__m256i *) (dst + k + j), _mm256_i32gather_epi32((const int *) table, index, 4));
+            }
+        }
+        ushort maxima[16], minima[16];
+        _mm256_storeu_si256((__m256i *) maxima, vmax);
+        _mm256_storeu_si256((__m256i *) minima, vmin);
+        mergeMinMax(maxima, minima, 16, Max, Min);
+    }
+    monoTableScalar(src + k, dst + k, count - k, table, Max, Min);
+}
+
+AVX2_FUNCTION static void monoScaleAVX2(const uint *src, uint *dst, long count, float correction, uint minvalue,
+                                        const uint *colormap, int colors, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 8) {
+        const __m256 vcorrection = _mm256_set1_ps(correction);
+        const __m256i vminvalue = _mm256_set1_epi32((int) (colormap == (const uint *) Q_NULLPTR ? 0 : minvalue));
+        __m256i vmax = _mm256_set1_epi32((int) Max);
+        __m256i vmin = _mm256_set1_epi32((int) Min);
+        for(; k + 8 <= count; k += 8) {
+            const __m256i value = _mm256_loadu_si256((const __m256i *) (src + k));
+            vmax = _mm256_max_epu32(vmax, value);
+            vmin = _mm256_min_epu32(vmin, value);
+            const __m256 scaled = u32ToFloatAVX2(_mm256_sub_epi32(value, vminvalue));
+            _mm256_storeu_si256((__m256i *) (dst + k), scaledPixelsAVX2(scaled, vcorrection, colormap, colors));
+        }
+        uint maxima[8], minima[8];
+        _mm256_storeu_si256((__m256i *) maxima, vmax);
+        _mm256_storeu_si256((__m256i *) minima, vmin);
+        mergeMinMax(maxima, minima, 8, Max, Min);
+    }
+    monoScaleScalar(src + k, dst + k, count - k, correction, minvalue, colormap, colors, Max, Min);
+}
+
+AVX2_FUNCTION static void monoScaleAVX2(const float *src, uint *dst, long count, float correction, uint minvalue,
+                                        const uint *colormap, int colors, uint &Max, uint &Min)
+{
+    long k = 0;
+    if(count >= 8) {
+        const __m256 vcorrection = _mm256_set1_ps(correction);
+        const __m256 vminvalue = _mm256_set1_ps(colormap == (const uint *) Q_NULLPTR ? 0.0f : (float) minvalue);
+        __m256 vmax = _mm256_set1_ps((float) Max);
+        __m256 vmin = _mm256_set1_ps((float) Min);
+        for(; k + 8 <= count; k += 8) {
+            const __m256 value = _mm256_loadu_ps(src + k);
+            vmax = _mm256_max_ps(value, vmax);
+            vmin = _mm256_min_ps(value, vmin);
+            _mm256_storeu_si256((__m256i *) (dst + k), scaledPixelsAVX2(_mm256_sub_ps(value, vminvalue), vcorrection, colormap, colors));
+        }
+        float maxima[8], minima[8];
+        _mm256_storeu_ps(maxima, vmax);
+        _mm256_storeu_ps(minima, vmin);
+        mergeMinMax(maxima, minima, 8, Max, Min);
+    }
+    monoScaleScalar(src + k, dst + k, count - k, correction, minvalue, colormap, colors, Max, Min);
+}
+
+// sixteen values, the two halves of the registers take eight of them each
+AVX2_FUNCTION static long unpackAVX2(const unpackLayout &layout, const uchar *src, long size, long offset, long count, ushort *dst)
+{
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) layout.shuffle));
+    const __m256i shift1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) layout.shift1));
+    const __m256i mask1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) layout.mask1));
+    const __m256i shift2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) layout.shift2));
+    const __m256i mask2 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) layout.mask2));
+    const __m256i mask0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) layout.mask0));
+    long n = 0;
+    for(; n + 16 <= count && offset + layout.bytes + 16 <= size; n += 16, offset += 2 * layout.bytes) {
+        const __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (src + offset))),
+                                                      _mm_loadu_si128((const __m128i *) (src + offset + layout.bytes)), 1);
+        const __m256i lanes = _mm256_shuffle_epi8(bytes, shuffle);
+        const __m256i part1 = _mm256_and_si256(_mm256_mulhi_epu16(lanes, shift1), mask1);
+        const __m256i part2 = _mm256_and_si256(_mm256_mulhi_epu16(lanes, shift2), mask2);
+        const __m256i part0 = _mm256_and_si256(lanes, mask0);
+        _mm256_storeu_si256((__m256i *) (dst + n), _mm256_add_epi16(_mm256_add_epi16(part1, part2), part0));
+    }
+    return n;
+}
+
+// four yuv pixels in double like yuvPixel, see yuvChannelSSSE3
+AVX2_FUNCTION static inline __m128i yuvChannelAVX2(__m128i luma, __m128i first, __m128i second, double lumaFactor,
+                                                   double firstFactor, double secondFactor, double offset)
+{
+    const __m256d scale = _mm256_set1_pd(1.0 / 256.0);
+    __m256d value = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(lumaFactor), _mm256_cvtepi32_pd(luma)), scale);
+    value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(firstFactor), _mm256_cvtepi32_pd(first)), scale));
+    value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(secondFactor), _mm256_cvtepi32_pd(second)), scale));
+    value = _mm256_add_pd(value, _mm256_set1_pd(offset));
+    return _mm_max_epi32(_mm256_cvttpd_epi32(value), _mm_setzero_si128());
+}
+
+// four pixels at a time like colorPixelsSSSE3, the colors computed in four doubles at once
+AVX2_FUNCTION static int colorPixelsAVX2(const colorLayout &layout, bool yuv, const uchar *src, long size, long &offset, int x, int count,
+                                         ushort *red, ushort *green, ushort *blue)
+{
+    if(!yuv) return colorPixelsSSSE3(layout, yuv, src, size, offset, x, count, red, green, blue);
+    char first[16], second[16], third[16];
+    const int step = colorShuffles(layout, yuv, first, second, third);
+    const __m128i shuffle1 = _mm_loadu_si128((const __m128i *) first);
+    const __m128i shuffle2 = _mm_loadu_si128((const __m128i *) second);
+    const __m128i shuffle3 = _mm_loadu_si128((const __m128i *) third);
+    for(; x + 4 <= count && offset + 16 <= size; x += 4, offset += step) {
+        const __m128i bytes = _mm_loadu_si128((const __m128i *) (src + offset));
+        const __m128i c1 = _mm_shuffle_epi8(bytes, shuffle1);
+        const __m128i c2 = _mm_shuffle_epi8(bytes, shuffle2);
+        const __m128i c3 = _mm_shuffle_epi8(bytes, shuffle3);
+        storeFour(yuvChannelAVX2(c1, c2, c3, 298.082, 0.0, 408.583, -222.291), red + x);
+        storeFour(yuvChannelAVX2(c1, c2, c3, 298.082, -100.291, -208.120, 135.576), green + x);
+        storeFour(yuvChannelAVX2(c1, c2, c3, 298.082, 561.412, 0.0, -276.836), blue + x);
+    }
+    return x;
+}
+
+#endif // CAMERA_AVX2
+
+// ------------------------------------------------------------------------------------------------------------------
+
+CameraKernels::level CameraKernels::simdLevel()
+{
+    static int detected = -1;
+    if(detected < 0) {
+        int found = levelNone;
+        if(qgetenv("CAQTDM_CAMERA_NOSIMD").isEmpty()) {
+#ifdef CAMERA_SSE2
+            found = levelSSE2;
+#endif
+#ifdef CAMERA_SSSE3
+            if(cpuHasSsse3()) found = levelSSSE3;
+#endif
+#ifdef CAMERA_AVX2
+            if(cpuHasAvx2()) found = levelAVX2;
+#endif
+        }
+        // the conversion threads may get here together, they all find the same
+        detected = found;
+    }
+    return (level) detected;
+}
+
+const char *CameraKernels::instructionSet()
+{
+    switch(simdLevel()) {
+    case levelAVX2: return "avx2";
+    case levelSSSE3: return "ssse3";
+    case levelSSE2: return "sse2";
+    default: return "none";
+    }
+}
+
+bool CameraKernels::monoTable(const uchar *src, uint *dst, long count, const uint *table, uint &Max, uint &Min)
+{
+    switch(simdLevel()) {
+#ifdef CAMERA_AVX2
+    case levelAVX2: monoTableAVX2(src, dst, count, table, Max, Min); break;
+#endif
+#ifdef CAMERA_SSE2
+    case levelSSSE3:
+    case levelSSE2: monoTableSSE2(src, dst, count, table, Max, Min); break;
+#endif
+    default: monoTableScalar(src, dst, count, table, Max, Min); break;
+    }
+    return true;
+}
+
+bool CameraKernels::monoTable(const ushort *src, uint *dst, long count, const uint *table, uint &Max, uint &Min)
+{
+    switch(simdLevel()) {
+#ifdef CAMERA_AVX2
+    case levelAVX2: monoTableAVX2(src, dst, count, table, Max, Min); break;
+#endif
+#ifdef CAMERA_SSE2
+    case levelSSSE3:
+    case levelSSE2: monoTableSSE2(src, dst, count, table, Max, Min); break;
+#endif
+    default: monoTableScalar(src, dst, count, table, Max, Min); break;
+    }
+    return true;
+}
+
+bool CameraKernels::monoScale(const uint *src, uint *dst, long count, float correction, uint minvalue,
+                              const uint *colormap, int colors, uint &Max, uint &Min)
+{
+    switch(simdLevel()) {
+#ifdef CAMERA_AVX2
+    case levelAVX2: monoScaleAVX2(src, dst, count, correction, minvalue, colormap, colors, Max, Min); break;
+#endif
+#ifdef CAMERA_SSE2
+    case levelSSSE3:
+    case levelSSE2: monoScaleSSE2(src, dst, count, correction, minvalue, colormap, colors, Max, Min); break;
+#endif
+    default: monoScaleScalar(src, dst, count, correction, minvalue, colormap, colors, Max, Min); break;
+    }
+    return true;
+}
+
+bool CameraKernels::monoScale(const float *src, uint *dst, long count, float correction, uint minvalue,
+                              const uint *colormap, int colors, uint &Max, uint &Min)
+{
+    switch(simdLevel()) {
+#ifdef CAMERA_AVX2
+    case levelAVX2: monoScaleAVX2(src, dst, count, correction, minvalue, colormap, colors, Max, Min); break;
+#endif
+#ifdef CAMERA_SSE2
+    case levelSSSE3:
+    case levelSSE2: monoScaleSSE2(src, dst, count, correction, minvalue, colormap, colors, Max, Min); break;
+#endif
+    default: monoScaleScalar(src, dst, count, correction, minvalue, colormap, colors, Max, Min); break;
+    }
+    return true;
+}
+
+// avx2 would need shuffles across its two halves to split the channels, the sse2 version is used for it as well
+bool CameraKernels::rgbScale(const uint *src, uint *dst, long count, float red, float green, float blue, uint &Max, uint &Min)
+{
+#ifdef CAMERA_SSE2
+    if(simdLevel() != levelNone) {
+        rgbScaleSSE2(src, dst, count, red, green, blue, Max, Min);
+        return true;
+    }
+#endif
+    rgbScaleScalar(src, dst, count, red, green, blue, Max, Min);
+    return true;
+}
+
+void CameraKernels::rgbPlanarScale(const ushort *red, const ushort *green, const ushort *blue, uint *dst, long count,
+                                   float redcoeff, float greencoeff, float bluecoeff, uint &Max, uint &Min)
+{
+#ifdef CAMERA_SSE2
+    if(simdLevel() != levelNone) {
+        rgbPlanarScaleSSE2(red, green, blue, dst, count, redcoeff, greencoeff, bluecoeff, Max, Min);
+        return;
+    }
+#endif
+    rgbPlanarScaleScalar(red, green, blue, dst, count, redcoeff, greencoeff, bluecoeff, Max, Min);
+}
+
+static long unpackValues(CameraKernels::packing format, const uchar *src, long size, long first, long count, ushort *dst)
+{
+    switch(format) {
+    case CameraKernels::packed12lsb: return unpackScalar<CameraKernels::packed12lsb>(src, size, first, count, dst);
+    case CameraKernels::packed12msb: return unpackScalar<CameraKernels::packed12msb>(src, size, first, count, dst);
+    case CameraKernels::packed10: return unpackScalar<CameraKernels::packed10>(src, size, first, count, dst);
+    default: return unpackScalar<CameraKernels::packed10p>(src, size, first, count, dst);
+    }
+}
+
+// sse2 has no byte shuffles, there the groups are taken apart one by one
+long CameraKernels::unpack(packing format, const uchar *src, long size, long first, long count, ushort *dst)
+{
+    if(src == (const uchar *) Q_NULLPTR || count <= 0) return 0;
+    const level simd = simdLevel();
+    if(simd < levelSSSE3) return unpackValues(format, src, size, first, count, dst);
+
+    // the values up to the first whole group one by one, then whole groups in blocks, the rest again one by one
+    const int groupValues = (format == packed10p) ? 4 : 2;
+    const int groupBytes = (format == packed10p) ? 5 : 3;
+    long n = qMin(count, (long) ((groupValues - first % groupValues) % groupValues));
+    if(n > 0) {
+        const long done = unpackValues(format, src, size, first, n, dst);
+        if(done < n) return done;
+    }
+    long offset = ((first + n) / groupValues) * groupBytes;
+#ifdef CAMERA_AVX2
+    if(simd == levelAVX2) {
+        const long done = unpackAVX2(unpackLayouts[format], src, size, offset, count - n, dst + n);
+        n += done;
+        offset += (done / groupValues) * groupBytes;
+    }
+#endif
+#ifdef CAMERA_SSSE3
+    n += unpackSSSE3(unpackLayouts[format], src, size, offset, count - n, dst + n);
+#endif
+    return n + unpackValues(format, src, size, first + n, count - n, dst + n);
+}
+
+void CameraKernels::demosaicRow(const ushort *top, const ushort *bottom, int width, bool greenFirst,
+                                ushort *topColor, ushort *green, ushort *bottomColor)
+{
+#ifdef CAMERA_SSE2
+    if(simdLevel() != levelNone) {
+        demosaicRowSSE2(top, bottom, width, greenFirst, topColor, green, bottomColor);
+        return;
+    }
+#endif
+    demosaicRowScalar(top, bottom, 0, width, greenFirst, topColor, green, bottomColor);
+}
+
+void CameraKernels::colorRow(colorFormat format, const uchar *src, long size, long first, int count,
+                             ushort *red, ushort *green, ushort *blue)
+{
+    const colorLayout &layout = colorLayouts[format];
+    const bool yuv = (format < rgb8);
+    long offset = (first / layout.pixels) * layout.bytes;
+    int k = (int) (first % layout.pixels);
+    int x = 0;
+
+    if(src != (const uchar *) Q_NULLPTR) {
+        // the pixels up to the first whole group one by one, then four at a time with byte shuffles, the rest again one by one
+        if(k > 0) x = colorPixelsScalar(layout, yuv, src, size, offset, k, x, qMin(count, layout.pixels - k), red, green, blue);
+        if(k == 0) {
+            switch(simdLevel()) {
+#ifdef CAMERA_AVX2
+            case levelAVX2: x = colorPixelsAVX2(layout, yuv, src, size, offset, x, count, red, green, blue); break;
+#endif
+#ifdef CAMERA_SSSE3
+            case levelSSSE3: x = colorPixelsSSSE3(layout, yuv, src, size, offset, x, count, red, green, blue); break;
+#endif
+            default: break;
+            }
+        }
+        x = colorPixelsScalar(layout, yuv, src, size, offset, k, x, count, red, green, blue);
+    }
+    for(; x < count; x++) red[x] = green[x] = blue[x] = 0;
+}
@@ -0,0 +1,88 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+
+#ifndef CAMERAKERNELS_H
+#define CAMERAKERNELS_H
+
+#include <QtGlobal>
+
+// pixel conversions of caCamera for whole blocks of data, with sse2, ssse3 or avx2 when the processor has it
+// the instruction set is chosen at runtime, CAQTDM_CAMERA_NOSIMD forces the plain c++ loops
+// every function gives the same pixels as caCamera::calcImageMono and calcImage, Max and Min are updated with the
+// values of the block; the ones returning bool return false for types they do not handle, the caller then does it itself
+// the row functions for packed, bayer, yuv and 8 bit rgb data let caCamera convert a frame row by row in its threads
+
+class CameraKernels
+{
+
+public:
+
+    // 8 and 16 bit mono, the color of every value is taken from table
+    static bool monoTable(const uchar *src, uint *dst, long count, const uint *table, uint &Max, uint &Min);
+    static bool monoTable(const ushort *src, uint *dst, long count, const uint *table, uint &Max, uint &Min);
+    template <typename T> static bool monoTable(const T *, uint *, long, const uint *, uint &, uint &) {return false;}
+
+    // 32 bit and float mono, grey from value * correction when colormap is null,
+    // otherwise (value - minvalue) * correction is the index into colormap with colors entries
+    // float values below 0 count as 0 for Max and Min, NaN values are left out of them
+    static bool monoScale(const uint *src, uint *dst, long count, float correction, uint minvalue,
+                          const uint *colormap, int colors, uint &Max, uint &Min);
+    static bool monoScale(const float *src, uint *dst, long count, float correction, uint minvalue,
+                          const uint *colormap, int colors, uint &Max, uint &Min);
+    template <typename T> static bool monoScale(const T *, uint *, long, float, uint, const uint *, int, uint &, uint &) {return false;}
+
+    // interleaved red, green, blue of 32 bit values, every channel scaled with its coefficient
+    // Max and Min are taken from the brightest channel of a pixel
+    static bool rgbScale(const uint *src, uint *dst, long count, float red, float green, float blue, uint &Max, uint &Min);
+    template <typename T> static bool rgbScale(const T *, uint *, long, float, float, float, uint &, uint &) {return false;}
+
+    // separate rows of red, green and blue, scaled like rgbScale
+    static void rgbPlanarScale(const ushort *red, const ushort *green, const ushort *blue, uint *dst, long count,
+                               float redcoeff, float greencoeff, float bluecoeff, uint &Max, uint &Min);
+
+    // packed mono and bayer data, 12 bit with the low or high bits first and the 10 bit formats
+    enum packing {packed12lsb = 0, packed12msb, packed10, packed10p};
+    // values first up to first + count - 1 of the frame from the size bytes at src to 16 bit,
+    // returns how many of them were complete in the data
+    static long unpack(packing format, const uchar *src, long size, long first, long count, ushort *dst);
+
+    // one row of the bayer interpolation, a pixel gets the colors of the 2x2 block to its lower right
+    // top is the row of the pixels and bottom the one below, topColor gets the red or blue of the top row and bottomColor the other one
+    // greenFirst when the top row starts with a green pixel, the last pixel of the row is black
+    static void demosaicRow(const ushort *top, const ushort *bottom, int width, bool greenFirst,
+                            ushort *topColor, ushort *green, ushort *bottomColor);
+
+    // 8 bit yuv, rgb and rgba formats, pixels first up to first + count - 1 of the frame into separate red, green and blue rows
+    // pixels not complete in the size bytes at src are black
+    enum colorFormat {yuyv422 = 0, uyvy422, yyuyyv411, uyyvyy411, yuv444, uvy444, rgb8, bgr8, rgba8, bgra8};
+    static void colorRow(colorFormat format, const uchar *src, long size, long first, int count,
+                         ushort *red, ushort *green, ushort *blue);
+
+    // "avx2", "ssse3", "sse2" or "none"
+    static const char *instructionSet();
+
+private:
+
+    enum level {levelNone = 0, levelSSE2, levelSSSE3, levelAVX2};
+    static level simdLevel();
+};
+
+#endif // CAMERAKERNELS_H
@@ -27,10 +27,18 @@
 #include <QtGui>
 #include <QApplication>
 #include "cascan2d.h"
+#include "replotscheduler.h"
 
 caScan2D::caScan2D(QWidget *parent) : QWidget(parent)
 {
     m_init = true;
+    newArrayPending = false;
+    newRowsFirst = newRowsEnd = 0;
+    m_rowsRead = 0;
+
+    minvalue = 0;
+    maxvalue = 65535;
+    shownValid = false;
 
     m_widthDefined = false;
     m_heightDefined = false;
@@ -605,6 +613,7 @@ void caScan2D::setXNEWDATA(int xnewdata)
 void caScan2D::setYNEWDATA(int ynewdata)
 {
     int i, status=0;
+    int firstRow = 0, endRow = -1;
 
     // I get two calls per monitor event for some reason
     if (m_ynewdata == ynewdata) {
@@ -620,15 +629,26 @@ void caScan2D::setYNEWDATA(int ynewdata)
     if (m_ynewdata == 0) {
         for (i=0; i<m_width*m_height; i++) xdata[i] = (float) 0.0;
         for (i=0; i<m_height; i++) haveY[i] = 0;
+        m_rowsRead = 0;
     } else {
-        // Get all data from file
+        // Get the rows completed since the last time from file
         if (m_savedata_pathDefined && m_savedata_subdirDefined && m_savedata_filenameDefined && m_ycptDefined) {
             QString dataFile = m_savedata_path + QString("/") + m_savedata_subdir + QString("/") + m_savedata_filename;
-            status = mdaReader_gimmeYerData(dataFile, thisPV_Data, xdata, m_width, m_height, m_ycpt);
+            if (dataFile != m_rowsFile) {
+                m_rowsFile = dataFile;
+                m_rowsRead = 0;
+            }
+            firstRow = m_rowsRead;
+            endRow = mdaReader_gimmeNewRows(dataFile, thisPV_Data, xdata, m_width, m_height, m_ycpt, m_rowsRead);
+            if (endRow < 0) {
+                status = -1;
+            } else {
+                m_rowsRead = endRow;
+            }
         }
     }
     // Don't call showImage() on m_init, because xdata may not have been initialized from the data file
-    if (status == 0 && !m_init) showImage(m_width, m_height);
+    if (status == 0 && !m_init) showImage(m_width, m_height, firstRow, endRow);
 }
 
 void caScan2D::setSAVEDATA_PATH(const QString &savedata_path)
@@ -655,7 +675,9 @@ void caScan2D::setSAVEDATA_FILENAME(const QString &savedata_filename)
 void caScan2D::attemptInitialPlot() {
     if (m_init && m_widthDefined && m_heightDefined && m_savedata_pathDefined && m_savedata_subdirDefined && m_savedata_filenameDefined && m_ycptDefined) {
         QString dataFile = m_savedata_path + QString("/") + m_savedata_subdir + QString("/") + m_savedata_filename;
-        mdaReader_gimmeYerData(dataFile, thisPV_Data, xdata, m_width, m_height, m_ycpt);
+        for (int i=0; i<m_width*m_height; i++) xdata[i] = (float) 0.0;
+        m_rowsFile = dataFile;
+        m_rowsRead = qMax(0, mdaReader_gimmeNewRows(dataFile, thisPV_Data, xdata, m_width, m_height, m_ycpt, 0));
         showImage(m_width, m_height);
     }
 }
@@ -782,7 +804,8 @@ void caScan2D::dataProcessing(double value, int id)
     readvaluesPresent[id] = true;
     readvalues[id] = value;
 
-    refreshImage();
+    // the four values usually come together, the image is made once for them
+    if(!ReplotScheduler::instance()->schedule(this)) refreshImage();
 }
 
 void caScan2D::newArray(int numDataBytes, float *data) {
@@ -802,20 +825,44 @@ void caScan2D::newArray(int numDataBytes, float *data) {
         xdata[i] = data[j];
     }
     haveY[m_ycpt] = 1;
-    showImage(m_width, m_height);
     savedData = xdata;
+    if(ReplotScheduler::instance()->schedule(this)) {
+        if(newArrayPending) {
+            newRowsFirst = qMin(newRowsFirst, m_ycpt);
+            newRowsEnd = qMax(newRowsEnd, m_ycpt + 1);
+        } else {
+            newRowsFirst = m_ycpt;
+            newRowsEnd = m_ycpt + 1;
+        }
+        newArrayPending = true;
+    } else {
+        showImage(m_width, m_height, m_ycpt, m_ycpt + 1);
+    }
 }
 
-void caScan2D::showImage(int numXDataValues, int numYDataValues)
+// called by the replot scheduler
+void caScan2D::scheduledReplot()
+{
+    if(newArrayPending) {
+        newArrayPending = false;
+        showImage(m_width, m_height, newRowsFirst, newRowsEnd);
+    } else {
+        refreshImage();
+    }
+}
+
+// the rows from firstRow up to endRow changed, all of them when endRow is negative
+void caScan2D::showImage(int numXDataValues, int numYDataValues, int firstRow, int endRow)
 {
     uint indx, indx1;
     long int i;
     QSize resultSize;
     uint Max[2], Min[2];
-    static uint minvalue=0, maxvalue=65535;
+    uint usedMinvalue, usedMaxvalue;
     float dataMin=(float) 1.e9, dataMax= (float) -1.e9;
     float dataFactor;
     int numDataValues = numXDataValues * numYDataValues;
+    bool rowsOnly = false;
 
     if(!m_widthDefined) return;
     if(!m_heightDefined) return;
@@ -833,21 +880,45 @@ void caScan2D::showImage(int numXDataValues, int numYDataValues)
         m_init = false;
         minvalue = 0;
         maxvalue = 65535;
+        shownValid = false;
         ftime(&timeRef);
     }
 
-    Max[1] = 0;
-    Min[1] = 65535;
+    // the other rows keep their colours when the new rows stay within the data range and the levels did not change
+    if(endRow >= 0 && shownValid && numDataValues == m_width * m_height && minvalue == shownMinvalue && maxvalue == shownMaxvalue) {
+        firstRow = qMax(firstRow, 0);
+        endRow = qMax(qMin(endRow, m_height), firstRow);
+        dataMin = shownDataMin;
+        dataMax = shownDataMax;
+        rowsOnly = true;
+        for (i=firstRow*m_width; i<endRow*m_width; i++) {
+            if (xdata[i] < dataMin || xdata[i] > dataMax) {
+                rowsOnly = false;
+                break;
+            }
+        }
+    }
 
-    for (i=0; i<numDataValues; i++) {
-        if (xdata[i] < dataMin) dataMin = xdata[i];
-        if (xdata[i] > dataMax) dataMax = xdata[i];
+    if(rowsOnly) {
+        Max[1] = shownIndexMax;
+        Min[1] = shownIndexMin;
+    } else {
+        firstRow = 0;
+        endRow = resultSize.height();
+        Max[1] = 0;
+        Min[1] = 65535;
+        dataMin=(float) 1.e9;
+        dataMax= (float) -1.e9;
+        for (i=0; i<numDataValues; i++) {
+            if (xdata[i] < dataMin) dataMin = xdata[i];
+            if (xdata[i] > dataMax) dataMax = xdata[i];
+        }
     }
 
     dataFactor = (maxvalue - minvalue)/(dataMax-dataMin);
-    i = 0;
+    i = (long int) firstRow * resultSize.width();
 
-    for (int y = 0; y < resultSize.height(); ++y) {
+    for (int y = firstRow; y < endRow && i < numDataValues; ++y) {
         uint *scanLine = reinterpret_cast<uint *>(image->scanLine(y));
 
         for (int x = 0; x < resultSize.width(); ++x) {
@@ -861,9 +932,10 @@ void caScan2D::showImage(int numXDataValues, int numYDataValues)
             Max[(indx > Max[1])] = indx;
             Min[(indx < Min[1])] = indx;
         }
-        if(i >= numDataValues) break;
     }
 
+    usedMinvalue = minvalue;
+    usedMaxvalue = maxvalue;
     minvalue = Min[1];
     maxvalue= Max[1];
 
@@ -879,6 +951,14 @@ void caScan2D::showImage(int numXDataValues, int numYDataValues)
         }
     }
 
+    shownValid = (numDataValues == m_width * m_height);
+    shownDataMin = dataMin;
+    shownDataMax = dataMax;
+    shownMinvalue = usedMinvalue;
+    shownMaxvalue = usedMaxvalue;
+    shownIndexMin = Min[1];
+    shownIndexMax = Max[1];
+
     if(image != (QImage *) Q_NULLPTR)  updateImage(*image, readvaluesPresent, readvalues, scaleFactor);
 }
 
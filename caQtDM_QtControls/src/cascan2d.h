@@ -138,7 +138,7 @@ public:
 
     void updateImage(const QImage &image, bool valuesPresent[], double values[], double scaleFactor);
     void getROI(QPointF &P1, QPointF &P2);
-    void showImage(int numXDataValues, int numYDataValues);
+    void showImage(int numXDataValues, int numYDataValues, int firstRow = 0, int endRow = -1);
 
     void refreshImage();
     void newArray(int numDataBytes, float *data);
@@ -258,6 +258,7 @@ private slots:
     void zoomOut(int level = 1);
     void zoomNow();
     void updateChannels(); 
+    void scheduledReplot();
 
 protected:
     void resizeEvent(QResizeEvent *event);
@@ -285,6 +286,7 @@ private:
     int Xpos, Ypos;
     float Zvalue;
     bool m_init;
+    bool newArrayPending;
     enum { ColormapSize = 256 };
     uint ColorMap[ColormapSize];
 
@@ -300,6 +302,17 @@ private:
 
     uint minvalue, maxvalue;
 
+    // mapping of the image shown, rows can be coloured alone as long as it stays the same
+    bool shownValid;
+    float shownDataMin, shownDataMax;
+    uint shownMinvalue, shownMaxvalue;
+    uint shownIndexMin, shownIndexMax;
+
+    // rows taken from the data file up to now, rows from newArray waiting for the replot scheduler
+    QString m_rowsFile;
+    int m_rowsRead;
+    int newRowsFirst, newRowsEnd;
+
     // sscanRecord
     bool m_xcptDefined, m_ycptDefined, m_xnewdataDefined, m_ynewdataDefined;
     bool m_savedata_pathDefined, m_savedata_subdirDefined, m_savedata_filenameDefined;
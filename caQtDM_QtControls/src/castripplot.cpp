@@ -37,9 +37,14 @@
 #include <QMetaProperty>
 #include "castripplot.h"
 #include <cmath>
+#include <cstring>
 #include <qwt_picker_machine.h>
 #include <qelapsedtimer.h>
 #include <plotHelperClasses.h>
+#include "replotscheduler.h"
+#ifndef QT_NO_CONCURRENT
+#include <qtconcurrentmap.h>
+#endif
 
 #if QT_VERSION > QT_VERSION_CHECK(5, 12, 0)
 #if !defined(NAN)
@@ -59,15 +64,21 @@
 // increase the array size given by the canvas width to be sure that the whole range is covered
 #define MAXIMUMSIZE 5000
 #define SOMEMORE 500
+// columns drawn in addition to the scrolled pixels, covers the line width and antialiasing at the border of the strip
+#define SCROLLPAD 4
 
 caStripPlot::~caStripPlot() {
 
+    remapWatcher->waitForFinished();
     emit timerThreadStop();
     timerThread->wait(200);
     timerThread->deleteLater();
 }
 
 caStripPlot::caStripPlot(QWidget *parent): QwtPlot(parent)
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+  , mutex(QMutex::Recursive)
+#endif
 {
     // initialisations
     initCurves = true;
@@ -90,10 +101,22 @@ caStripPlot::caStripPlot(QWidget *parent): QwtPlot(parent)
     thisYaxisType = linear;
     YAxisIndex = 0;
     plotIsPaused = false;
+    historyView = false;
+    advanceCount = remapAdvance = 0;
+    dataGeneration = remapGeneration = 0;
+    remapPending = remapPendingLog = false;
+    remapWatcher = new QFutureWatcher<void>(this);
+    connect(remapWatcher, SIGNAL(finished()), this, SLOT(remapFinished()));
+    viewStart = viewEnd = viewBase = pauseTime = 0.0;
     setProperty("xAxisToleranceFactor", 0.01);
+    thisRawHistoryDuration = HISTORY_RAW_SECONDS;
     thisIterableCurves = thisSelectableCurves = false;
     thisPlotPicker = off;
     autoscaleMinYOverride = false;
+    xOffset = 0.0;
+    scrollRendering = thisScrollRendering = false;
+    layerDirty = true;
+    layerOrigin = layerXSpan = 0.0;
 
 #ifdef QWT_USE_OPENGL
     printf("caStripplot uses opengl ?\n");
@@ -205,13 +228,13 @@ caStripPlot::caStripPlot(QWidget *parent): QwtPlot(parent)
  * Can be used to analyze the curves.
  * */
 void caStripPlot::stopPlot(){
-    plotIsPaused = true;
+    setPaused(true);
 }
 
 /* Slot to resume the plot after stopping, e.g by a Button or Checkbox.
  * */
 void caStripPlot::resumePlot(){
-    plotIsPaused = false;
+    setPaused(false);
 }
 
 /* Slot to restart  the plot, e.g by a Button or Checkbox.
@@ -219,42 +242,15 @@ void caStripPlot::resumePlot(){
  * */
 void caStripPlot::restartPlot()
 {
-    plotIsPaused = false;
-    for(int i=0; i < MAXCURVES; i++) {
-        // reset interval data for error and fill curves
-        rangeData[i].clear();
-        rangeData[i].reserve(MAXIMUMSIZE+5);
-        fillData[i].clear();
-        fillData[i].reserve(MAXIMUMSIZE+5);
-
-        //reset interval data for raw data curves
-        rangeDataRaw[i].clear();
-        rangeDataRaw[i].reserve(MAXIMUMSIZE+5);
-        fillDataRaw[i].clear();
-        fillDataRaw[i].reserve(MAXIMUMSIZE+5);
-
-        if(i==0)  {
-            base.clear();
-            base.reserve(MAXIMUMSIZE+5);
-        }
-        for ( int j = 0; j <  MAXIMUMSIZE; j++ ) {
-            rangeData[i].append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-            fillData[i].append(QPointF(NAN,NAN));
-            if(i==0) base.append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-
-            rangeDataRaw[i].append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-            fillDataRaw[i].append(QPointF(NAN,NAN));
-        }
-    }
+    setPaused(false);
+    mutex.lock();
+    resetCurveData();
+    for(int i=0; i < MAXCURVES; i++) history[i].clear();
     // set the data to the curves
     for(int i=0; i < NumberOfCurves; i++) {
-        if(thisStyle[i] == FillUnder) {
-            fillcurve[i]->setSamplesList(fillData[i]);
-            fillcurve[i]->setSamples(fillData[i]);
-        }
-        errorcurve[i]->setSamplesList(rangeData[i]);
-        errorcurve[i]->setSamples(rangeData[i]);
+        setCurveData(i);
     }
+    mutex.unlock();
     replot();
 }
 
@@ -264,7 +260,26 @@ void caStripPlot::restartPlot()
  * */
 void caStripPlot::pausePlot(bool pausePlot)
 {
-    pausePlot ? plotIsPaused = true : plotIsPaused = false;
+    setPaused(pausePlot);
+}
+
+// the data collection goes on while paused, so the curves get a copy of what is displayed and the rings again when resumed
+void caStripPlot::setPaused(bool paused)
+{
+    if(paused == plotIsPaused) return;
+    if(!paused) leaveHistory();
+    plotIsPaused = paused;
+    mutex.lock();
+    if(paused) {
+        struct timeb now;
+        ftime(&now);
+        pauseTime = (double) now.time + (double) now.millitm / (double)1000;
+    }
+    for(int i=0; i < NumberOfCurves; i++) {
+        if(paused) freezeCurveData(i); else setCurveData(i);
+    }
+    layerDirty = true;
+    mutex.unlock();
 }
 
 /* Slot to select a curve whose Y Axis is to be displayed.
@@ -307,11 +322,12 @@ void caStripPlot::onSelected(const QPointF& point)
         double lCurveDist = 100000000000;
         double lTmpDist;
         // loop over all samples that are somewhere around the selected point
-        for (quint32 j = 0; rangeData[curvIndex][j].value > (rangeData[curvIndex][0].value - thisPeriod) && rangeData[curvIndex][j].interval.isValid() && rangeData[curvIndex][j].value != 0; j++) {
-            if (rangeData[curvIndex][j].value > (point.x() + xAxisTolerance) || rangeData[curvIndex][j].value < (point.x() - xAxisTolerance)) {
+        for (int j = 0; j < rangeData[curvIndex].size() && rangeData[curvIndex].at(j).value > (rangeData[curvIndex].at(0).value - thisPeriod) && rangeData[curvIndex].at(j).interval.isValid() && rangeData[curvIndex].at(j).value != 0; j++) {
+            const double x = rangeData[curvIndex].at(j).value - xOffset;
+            if (x > (point.x() + xAxisTolerance) || x < (point.x() - xAxisTolerance)) {
                 continue;
             }
-            double yAverage = (rangeData[curvIndex][j].interval.maxValue() + rangeData[curvIndex][j].interval.minValue()) / 2;
+            double yAverage = (rangeData[curvIndex].at(j).interval.maxValue() + rangeData[curvIndex].at(j).interval.minValue()) / 2;
 
             lTmpDist = std::abs(yAverage - point.y()); // simpler and as good as hypothenuse
             lCurveDist = std::min(lTmpDist, lCurveDist);
@@ -443,6 +459,7 @@ void caStripPlot::setYaxisType(yAxisType s)
         setAxisScaleDraw(QwtPlot::yLeft, new PlotScaleDraw());
         setAxisScaleEngine(QwtPlot::yLeft, new QwtLinearScaleEngine());
     }
+    layerDirty = true;
 
     replot();
 }
@@ -450,18 +467,22 @@ void caStripPlot::setYaxisType(yAxisType s)
 /* Function to remap a curve to a new Scale.
  * Is used to correct data already on the plot if axis scaling or type is changed.
  * Always calculates values from raw data.
+ * Works on the copies of the job only, the curves are independent and are remapped in parallel by remapCurves.
  * */
-void caStripPlot::remapCurve(double newMin, double newMax,  quint8 curvIndex, bool isNewLog = false)
+void caStripPlot::remapCurveData(remapJob &job)
 {
-    //qDebug() << "remapping Curve: " << curvIndex << "min/max:" << newMin << newMax << "isNewLog:"<< isNewLog;
+    //qDebug() << "remapping Curve: " << job.curvIndex << "min/max:" << job.newMin << job.newMax << "isNewLog:"<< job.isNewLog;
     // Start timer to measure performance:
     //QElapsedTimer timer;
     //timer.start();
 
     // Variables
     // Because the values are calculated from the raw data, old min and old max are always given.
-    double oldMin = thisYaxisLimitsMin[curvIndex];
-    double oldMax = thisYaxisLimitsMax[curvIndex];
+    double oldMin = job.oldMin;
+    double oldMax = job.oldMax;
+    double newMin = job.newMin;
+    double newMax = job.newMax;
+    const bool isNewLog = job.isNewLog;
 
     // Make sure no bad values are used for logarithmic conversions.
     if (isNewLog) {
@@ -485,63 +506,135 @@ void caStripPlot::remapCurve(double newMin, double newMax,  quint8 curvIndex, bo
     // efficiently do default conversion to original values
     if (oldMin == newMin && oldMax == newMax) {
         if (isNewLog){ // treat incorrect values
-           mutex.lock();
-           for (quint32 j = 0; rangeDataRaw[curvIndex][j].value > (rangeDataRaw[curvIndex][0].value - thisPeriod) && rangeDataRaw[curvIndex][j].interval.isValid() && rangeDataRaw[curvIndex][j].value != 0; j++){
-                rangeData[curvIndex][j].interval.setMinValue(qMax(rangeDataRaw[curvIndex][j].interval.minValue(), 1e-20));
-                rangeData[curvIndex][j].interval.setMaxValue(qMax(rangeDataRaw[curvIndex][j].interval.maxValue(), 1e-20));
-                fillData[curvIndex][j].setY(qMax(fillDataRaw[curvIndex][j].y(), 1e-20));
+           for (int j = 0; j < job.rangeRaw.size() && job.rangeRaw.at(j).value > (job.rangeRaw.at(0).value - job.period) && job.rangeRaw.at(j).interval.isValid() && job.rangeRaw.at(j).value != 0; j++){
+                job.range[j].interval.setMinValue(qMax(job.rangeRaw.at(j).interval.minValue(), 1e-20));
+                job.range[j].interval.setMaxValue(qMax(job.rangeRaw.at(j).interval.maxValue(), 1e-20));
+                job.fill[j].setY(qMax(job.fillRaw.at(j).y(), 1e-20));
            }
-           mutex.unlock();
         } else {
-           mutex.lock();
-           rangeData[curvIndex] = rangeDataRaw[curvIndex];
-           fillData[curvIndex] = fillDataRaw[curvIndex];
-           mutex.unlock();
+           job.range = job.rangeRaw;
+           job.fill = job.fillRaw;
         }
     } else { // remap the curves for any arbitrary conversion
         // Different equations are used because the logarithmic conversion is most performant the way it is (least amount of log10() calls)
         // but the linear conversion needs to be different due to division by zero errors which can't happen on a log scale (are prevented by setting minimum values to 1e-20).
         if (isNewLog) {
-           mutex.lock();
-           for (quint32 j = 0; rangeDataRaw[curvIndex][j].value > (rangeDataRaw[curvIndex][0].value - thisPeriod) && rangeDataRaw[curvIndex][j].interval.isValid() && rangeDataRaw[curvIndex][j].value != 0; j++){
-                double minPositive = qMax(rangeDataRaw[curvIndex][j].interval.minValue(), 1e-20);
-                double maxPositive = qMax(rangeDataRaw[curvIndex][j].interval.maxValue(), 1e-20);
-                double fillYPositive = qMax(fillDataRaw[curvIndex][j].y(), 1e-20);
+           for (int j = 0; j < job.rangeRaw.size() && job.rangeRaw.at(j).value > (job.rangeRaw.at(0).value - job.period) && job.rangeRaw.at(j).interval.isValid() && job.rangeRaw.at(j).value != 0; j++){
+                double minPositive = qMax(job.rangeRaw.at(j).interval.minValue(), 1e-20);
+                double maxPositive = qMax(job.rangeRaw.at(j).interval.maxValue(), 1e-20);
+                double fillYPositive = qMax(job.fillRaw.at(j).y(), 1e-20);
 
                 percentMin = (std::log10(minPositive) - log10OldMin)/oldLogMaxMinDiv;
                 percentMax = (std::log10(maxPositive) - log10OldMin)/oldLogMaxMinDiv;
                 percentFillY = (std::log10(fillYPositive) - log10OldMin)/oldLogMaxMinDiv;
-                rangeData[curvIndex][j].interval.setMinValue(pow(10, ((percentMin * newLogMaxMinDiv) + log10NewMin)));
-                rangeData[curvIndex][j].interval.setMaxValue(pow(10, ((percentMax * newLogMaxMinDiv) + log10NewMin)));
-                fillData[curvIndex][j].setY(pow(10, ((percentFillY * newLogMaxMinDiv) + log10NewMin)));
+                job.range[j].interval.setMinValue(pow(10, ((percentMin * newLogMaxMinDiv) + log10NewMin)));
+                job.range[j].interval.setMaxValue(pow(10, ((percentMax * newLogMaxMinDiv) + log10NewMin)));
+                job.fill[j].setY(pow(10, ((percentFillY * newLogMaxMinDiv) + log10NewMin)));
            }
-           mutex.unlock();
         } else {
-           mutex.lock();
-           for (quint32 j = 0; rangeDataRaw[curvIndex][j].value > (rangeDataRaw[curvIndex][0].value - thisPeriod) && rangeDataRaw[curvIndex][j].interval.isValid() && rangeDataRaw[curvIndex][j].value != 0; j++){
-                percentMin = (rangeDataRaw[curvIndex][j].interval.minValue() - oldMin)/(oldMaxMinDiff);
-                percentMax = (rangeDataRaw[curvIndex][j].interval.maxValue() - oldMin)/(oldMaxMinDiff);
-                percentFillY = (fillDataRaw[curvIndex][j].y() - oldMin)/(oldMaxMinDiff);
-                rangeData[curvIndex][j].interval.setMinValue((percentMin * newMaxMinDiff) + newMin);
-                rangeData[curvIndex][j].interval.setMaxValue((percentMax * newMaxMinDiff) + newMin);
-                fillData[curvIndex][j].setY((percentFillY * newMaxMinDiff) + newMin);
+           for (int j = 0; j < job.rangeRaw.size() && job.rangeRaw.at(j).value > (job.rangeRaw.at(0).value - job.period) && job.rangeRaw.at(j).interval.isValid() && job.rangeRaw.at(j).value != 0; j++){
+                percentMin = (job.rangeRaw.at(j).interval.minValue() - oldMin)/(oldMaxMinDiff);
+                percentMax = (job.rangeRaw.at(j).interval.maxValue() - oldMin)/(oldMaxMinDiff);
+                percentFillY = (job.fillRaw.at(j).y() - oldMin)/(oldMaxMinDiff);
+                job.range[j].interval.setMinValue((percentMin * newMaxMinDiff) + newMin);
+                job.range[j].interval.setMaxValue((percentMax * newMaxMinDiff) + newMin);
+                job.fill[j].setY((percentFillY * newMaxMinDiff) + newMin);
            }
-           mutex.unlock();
         }
     }
 
-    // Set the data to the curves
-    if(thisStyle[curvIndex] == FillUnder) {
-        fillcurve[curvIndex]->setSamplesList(fillData[curvIndex]);
-        fillcurve[curvIndex]->setSamples(fillData[curvIndex]);
+    // Print time it took to do conversions
+    //qDebug() << "Conversion took ms: " << timer.nsecsElapsed()/1000000.0;
+}
+
+// remaps all curves to their limits, the conversion is done in worker threads on copies of the rings and swapped in
+// by remapFinished, so the gui does not wait for it; a remap asked for while one is running is done after it
+void caStripPlot::remapCurves(bool isNewLog)
+{
+    if(remapWatcher->isRunning()) {
+        remapPending = true;
+        remapPendingLog = isNewLog;
+        return;
     }
-    errorcurve[curvIndex]->setSamplesList(rangeData[curvIndex]);
-    errorcurve[curvIndex]->setSamples(rangeData[curvIndex]);
 
-    replot();
+    mutex.lock();
+    remapJobs.resize(NumberOfCurves);
+    for (int curvIndex = 0 ; curvIndex < NumberOfCurves ; curvIndex++) {
+        const int limits = (thisYaxisScaling == fixedScale) ? 0 : curvIndex;
+        remapJob &job = remapJobs[curvIndex];
+        job.curvIndex = curvIndex;
+        job.isNewLog = isNewLog;
+        job.fillUnder = (thisStyle[curvIndex] == FillUnder);
+        job.oldMin = thisYaxisLimitsMin[curvIndex];
+        job.oldMax = thisYaxisLimitsMax[curvIndex];
+        job.newMin = thisYaxisLimitsMin[limits];
+        job.newMax = thisYaxisLimitsMax[limits];
+        job.period = thisPeriod;
+        job.rangeRaw = rangeDataRaw[curvIndex];
+        job.range = rangeData[curvIndex];
+        job.fillRaw = fillDataRaw[curvIndex];
+        job.fill = fillData[curvIndex];
+    }
+    remapAdvance = advanceCount;
+    remapGeneration = dataGeneration;
+    mutex.unlock();
 
-    // Print time it took to do conversions
-    //qDebug() << "Conversion took ms: " << timer.nsecsElapsed()/1000000.0;
+#ifndef QT_NO_CONCURRENT
+    remapWatcher->setFuture(QtConcurrent::map(remapJobs, &caStripPlot::remapCurveData));
+#else
+    for (int curvIndex = 0 ; curvIndex < remapJobs.size() ; curvIndex++) remapCurveData(remapJobs[curvIndex]);
+    remapFinished();
+#endif
+}
+
+void caStripPlot::remapFinished()
+{
+    // newer limits came in the meantime, this result is already outdated
+    if(remapPending) {
+        remapPending = false;
+        remapJobs.clear();
+        remapCurves(remapPendingLog);
+        return;
+    }
+
+    mutex.lock();
+
+    // the rings were reset in the meantime or moved further than they are long
+    const quint64 newer = advanceCount - remapAdvance;
+    if(remapGeneration != dataGeneration || remapJobs.size() != NumberOfCurves || newer >= (quint64) MAXIMUMSIZE) {
+        mutex.unlock();
+        remapJobs.clear();
+        if(remapGeneration == dataGeneration) remapCurves(thisYaxisType == log10);
+        return;
+    }
+
+    // the samples that came after the copy were already stored with the new limits
+    for (int curvIndex = 0 ; curvIndex < NumberOfCurves ; curvIndex++) {
+        remapJob &job = remapJobs[curvIndex];
+        QwtIntervalSample tmp;
+        QPointF tmpP;
+        for(quint64 j = 0; j < newer; j++) job.range.advance(tmp);
+        for(int j = 0; j < (int) newer; j++) job.range[j] = rangeData[curvIndex].at(j);
+        rangeData[curvIndex] = job.range;
+
+        if(thisStyle[curvIndex] == FillUnder) {
+            if(job.fillUnder) {
+                for(quint64 j = 0; j < newer; j++) job.fill.advance(tmpP);
+                for(int j = 0; j < (int) newer; j++) job.fill[j] = fillData[curvIndex].at(j);
+                fillData[curvIndex] = job.fill;
+            } else {
+                rebuildFillData(curvIndex);
+            }
+        }
+
+        if(plotIsPaused) freezeCurveData(curvIndex); else setCurveData(curvIndex);
+        extremes[curvIndex].rebuild(rangeData[curvIndex], dataCount);
+    }
+    layerDirty = true;
+    mutex.unlock();
+    remapJobs.clear();
+
+    replot();
 }
 
 void caStripPlot::RescaleCurves(int width, units unit, double period)
@@ -549,6 +642,8 @@ void caStripPlot::RescaleCurves(int width, units unit, double period)
 
     //printf("canvas width=%d\n",width);
 
+    const double oldTimeInterval = timeInterval;
+
     HISTORY = width; // equals canvas width
 
     // set the right interval
@@ -581,52 +676,25 @@ void caStripPlot::RescaleCurves(int width, units unit, double period)
         }
     }
 
-    if(!initCurves) return;
+    // same column width, the data can be kept
+    if(!initCurves && timeInterval == oldTimeInterval) return;
     initCurves = false;
 
     mutex.lock();
 
-    // initialize the arrays, with nan data
-    for(int i=0; i < MAXCURVES; i++) {
-        // define interval data for error and fill curves
-        rangeData[i].clear();
-        rangeData[i].reserve(MAXIMUMSIZE+5);
-        fillData[i].clear();
-        fillData[i].reserve(MAXIMUMSIZE+5);
-
-        //reset interval data for raw data curves
-        rangeDataRaw[i].clear();
-        rangeDataRaw[i].reserve(MAXIMUMSIZE+5);
-        fillDataRaw[i].clear();
-        fillDataRaw[i].reserve(MAXIMUMSIZE+5);
-        if(i==0)  {
-            base.clear();
-            base.reserve(MAXIMUMSIZE+5);
-        }
-        for ( int j = 0; j <  MAXIMUMSIZE; j++ ) {
-            rangeData[i].append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-            fillData[i].append(QPointF(NAN,NAN));
-            rangeDataRaw[i].append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-            fillDataRaw[i].append(QPointF(NAN,NAN));
-            if(i==0) base.append(QwtIntervalSample(0, QwtInterval(NAN, NAN)));
-        }
-    }
+    // initialize the arrays, with nan data and rebuild the columns from the history
+    resetCurveData();
+    dataCount = fillFromHistory();
+    for(int i=0; i < NumberOfCurves; i++) extremes[i].rebuild(rangeData[i], dataCount);
 
     // set the data to the curves
     for(int i=0; i < NumberOfCurves; i++) {
-        if(thisStyle[i] == FillUnder) {
-            fillcurve[i]->setSamplesList(fillData[i]);
-            fillcurve[i]->setSamples(fillData[i]);
-        }
-        errorcurve[i]->setSamplesList(rangeData[i]);
-        errorcurve[i]->setSamples(rangeData[i]);
+        if(plotIsPaused) freezeCurveData(i); else setCurveData(i);
     }
 
     mutex.unlock();
 
     // define update rate
-    dataCount = 0;
-
     if(timerID) {
         TimersStart();
     }
@@ -637,6 +705,408 @@ void caStripPlot::RescaleCurves(int width, units unit, double period)
     replot();
 }
 
+// initialize the circular buffers with nan data
+void caStripPlot::resetCurveData()
+{
+    for(int i=0; i < MAXCURVES; i++) {
+        rangeData[i].reset(MAXIMUMSIZE, QwtIntervalSample(0, QwtInterval(NAN, NAN)));
+        fillData[i].reset(MAXIMUMSIZE, QPointF(NAN,NAN));
+        rangeDataRaw[i].reset(MAXIMUMSIZE, QwtIntervalSample(0, QwtInterval(NAN, NAN)));
+        fillDataRaw[i].reset(MAXIMUMSIZE, QPointF(NAN,NAN));
+        extremes[i].clear();
+    }
+    dataGeneration++;
+    xOffset = 0.0;
+    layerDirty = true;
+}
+
+// fill the columns of the actual period and canvas width with the envelope of the history, returns the number of columns
+// the newest column gets the x value the next tick will start with, the time base is reset by the restart of the plot
+int caStripPlot::fillFromHistory()
+{
+    struct timeb now;
+    QVector<double> minY, maxY;
+    bool known = false;
+    const double dt = timeInterval / 1000.0;
+    const int columns = qMin(HISTORY, MAXIMUMSIZE - 1);
+
+    const double factor = xUnitFactor();
+
+    ftime(&now);
+    const double end = (double) now.time + (double) now.millitm / (double)1000;
+
+    for(int c = 0; c < NumberOfCurves; c++) {
+        if(history[c].envelope(end - columns * dt, end, columns, minY, maxY)) known = true;
+
+        for(int j = 0; j < columns; j++) {
+            // the envelope starts with the oldest column
+            const double valueMinRaw = minY.at(columns - 1 - j);
+            const double valueMaxRaw = maxY.at(columns - 1 - j);
+            double valueMin = valueMinRaw;
+            double valueMax = valueMaxRaw;
+            if(thisYaxisScaling == fixedScale) {
+                valueMin = mapValue(c, valueMinRaw);
+                valueMax = mapValue(c, valueMaxRaw);
+            }
+            if(thisYaxisType == log10) {
+                if(valueMin < 1e-20) valueMin=1e-20;
+                if(valueMax < 1e-20) valueMax=1e-20;
+            }
+
+            const double x = (INTERVAL - j * dt) * factor;
+            rangeData[c][j] = QwtIntervalSample(x, QwtInterval(valueMin, valueMax));
+            rangeDataRaw[c][j] = QwtIntervalSample(x, QwtInterval(valueMinRaw, valueMaxRaw));
+            fillData[c][j] = QPointF(x, (valueMax+valueMin)/2);
+            fillDataRaw[c][j] = QPointF(x, (valueMaxRaw+valueMinRaw)/2);
+        }
+    }
+
+    return known ? columns : 0;
+}
+
+// hand the buffers to the curves, the curves read them in place, so this is only needed when the curves or their data were replaced
+void caStripPlot::setCurveData(int curvIndex)
+{
+    if(thisStyle[curvIndex] == FillUnder) {
+        fillcurve[curvIndex]->setData(new StripPlotSeriesData(&fillData[curvIndex], &xOffset));
+    } else {
+        fillcurve[curvIndex]->setSamples(QVector<QPointF>());
+    }
+    errorcurve[curvIndex]->setData(new StripPlotIntervalSeriesData(&rangeData[curvIndex], &xOffset));
+}
+
+// while paused the rings go on, the curves get a copy of their actual state
+void caStripPlot::freezeCurveData(int curvIndex)
+{
+    if(historyView) {
+        historyCurveData(curvIndex);
+        return;
+    }
+    if(thisStyle[curvIndex] == FillUnder) {
+        QVector<QPointF> fill(fillData[curvIndex].size());
+        for(int j = 0; j < fill.size(); j++) {
+            const QPointF &P = fillData[curvIndex].at(j);
+            fill[j] = QPointF(P.x() - xOffset, P.y());
+        }
+        fillcurve[curvIndex]->setSamples(fill);
+    } else {
+        fillcurve[curvIndex]->setSamples(QVector<QPointF>());
+    }
+    QVector<QwtIntervalSample> range(rangeData[curvIndex].size());
+    for(int j = 0; j < range.size(); j++) {
+        const QwtIntervalSample &P = rangeData[curvIndex].at(j);
+        range[j] = QwtIntervalSample(P.value - xOffset, P.interval);
+    }
+    errorcurve[curvIndex]->setSamples(range);
+}
+
+// units of the x axis per second, same as in TimeOutThread
+double caStripPlot::xUnitFactor() const
+{
+    if(thisXaxisType == ValueScale) {
+        if(thisUnits == Millisecond) return 1000.0;
+        if(thisUnits == Minute) return 1.0 / 60.0;
+    }
+    return 1.0;
+}
+
+// the value scale counts back from the moment of the pause, the time scales go on from the base of their labels
+double caStripPlot::historyToX(double t) const
+{
+    if(thisXaxisType == ValueScale) return (t - pauseTime) * xUnitFactor();
+    return t - viewBase;
+}
+
+double caStripPlot::xToHistory(double x) const
+{
+    if(thisXaxisType == ValueScale) return pauseTime + x / xUnitFactor();
+    return viewBase + x;
+}
+
+// one column per pixel of the viewed time range, newest first as the curves expect it
+void caStripPlot::historyCurveData(int curvIndex)
+{
+    QVector<double> minY, maxY;
+    const int columns = qMax(canvas()->contentsRect().width(), 2);
+    const double dt = (viewEnd - viewStart) / columns;
+    history[curvIndex].envelope(viewStart, viewEnd, columns, minY, maxY);
+
+    QVector<QwtIntervalSample> range(columns);
+    QVector<QPointF> fill;
+    if(thisStyle[curvIndex] == FillUnder) fill.resize(columns);
+
+    for(int j = 0; j < columns; j++) {
+        double valueMin = minY.at(columns - 1 - j);
+        double valueMax = maxY.at(columns - 1 - j);
+        if(thisYaxisScaling == fixedScale) {
+            valueMin = mapValue(curvIndex, valueMin);
+            valueMax = mapValue(curvIndex, valueMax);
+        }
+        if(thisYaxisType == log10) {
+            if(valueMin < 1e-20) valueMin=1e-20;
+            if(valueMax < 1e-20) valueMax=1e-20;
+        }
+        const double x = historyToX(viewEnd - (j + 0.5) * dt);
+        range[j] = QwtIntervalSample(x, QwtInterval(valueMin, valueMax));
+        if(!fill.isEmpty()) fill[j] = QPointF(x, (valueMax+valueMin)/2);
+    }
+
+    // the curves stop at the interval, here it has to cover the whole view
+    const double interval = qAbs(historyToX(viewStart)) + qAbs(historyToX(viewEnd));
+    const curvType type = (thisXaxisType == ValueScale) ? ValueCurv : TimeCurv;
+    fillcurve[curvIndex]->setInterval(type, interval);
+    errorcurve[curvIndex]->setInterval(type, interval);
+
+    fillcurve[curvIndex]->setSamples(fill);
+    errorcurve[curvIndex]->setSamples(range);
+}
+
+// show the given time range of the history, only used while paused
+void caStripPlot::showHistory(double start, double end)
+{
+    int nbTicks;
+    if(thisXticks < 1) nbTicks = 1; else nbTicks = thisXticks;
+
+    // the envelope does not go further back than the coarsest level of the history, and not below a millisecond per pixel
+    const double maxSpan = HISTORY_BASE_WIDTH * HISTORY_BUCKETS * pow((double) HISTORY_LEVEL_FACTOR, HISTORY_LEVELS - 1);
+    const double minSpan = 0.001 * qMax(canvas()->contentsRect().width(), 2);
+    double span = qBound(minSpan, end - start, maxSpan);
+    if(end > pauseTime) end = pauseTime;
+    start = end - span;
+
+    mutex.lock();
+    historyView = true;
+    viewStart = start;
+    viewEnd = end;
+    for(int i=0; i < NumberOfCurves; i++) historyCurveData(i);
+    layerDirty = true;
+
+    // in case of autoscale the vertical scale follows the viewed range
+    if(thisYaxisScaling == autoScale || thisYaxisScaling == selectiveAutoScale) {
+        double minY = qInf(), maxY = -qInf();
+        for(int i=0; i < NumberOfCurves; i++) {
+            if(thisYaxisScaling == selectiveAutoScale && !sAutoScaleCurves[i]) continue;
+            const QwtSeriesData<QwtIntervalSample> *data = errorcurve[i]->data();
+            for(size_t j = 0; j < data->size(); j++) {
+                const QwtInterval &I = data->sample(j).interval;
+                if(qIsNaN(I.minValue()) || qIsNaN(I.maxValue())) continue;
+                minY = qMin(minY, I.minValue());
+                maxY = qMax(maxY, I.maxValue());
+            }
+        }
+        if(!qIsInf(minY) && !qIsInf(maxY)) {
+            if(minY == maxY) {minY -= 0.5; maxY += 0.5;}
+            setAxisScale(QwtPlot::yLeft, minY, maxY);
+        }
+    }
+    mutex.unlock();
+
+    const double x1 = historyToX(start);
+    const double x2 = historyToX(end);
+    setAxisScale(QwtPlot::xBottom, x1, x2, (x2 - x1)/nbTicks);
+    replot();
+}
+
+// back to the state of the paused plot, the running plot sets its scales itself again with every tick
+void caStripPlot::leaveHistory()
+{
+    if(!historyView) return;
+    mutex.lock();
+    historyView = false;
+    layerDirty = true;
+    mutex.unlock();
+
+    int nbTicks;
+    if(thisXticks < 1) nbTicks = 1; else nbTicks = thisXticks;
+    if(thisXaxisType == ValueScale) {
+        const double period = INTERVAL * xUnitFactor();
+        setAxisScale(QwtPlot::xBottom, -period, 0, period/nbTicks);
+    }
+}
+
+// wheel zooms the time axis around the mouse position, with shift it pans by a tenth of the view
+bool caStripPlot::historyWheel(QWheelEvent *event)
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    const int delta = event->delta();
+    const QPoint pos = event->pos();
+#else
+    const int delta = event->angleDelta().y();
+    const QPoint pos = event->position().toPoint();
+#endif
+    if(delta == 0 || NumberOfCurves < 1) return false;
+
+    double start, end;
+    if(historyView) {
+        start = viewStart;
+        end = viewEnd;
+    } else {
+        // same base as the labels of the running plot
+        if(thisXaxisType != ValueScale) {
+            viewBase = (double) plotStart.time + (double) plotStart.millitm / (double)1000 - INTERVAL;
+        }
+        start = xToHistory(axisScaleDiv(QwtPlot::xBottom).lowerBound());
+        end = xToHistory(axisScaleDiv(QwtPlot::xBottom).upperBound());
+    }
+    const double span = end - start;
+
+    if(event->modifiers() & Qt::ShiftModifier) {
+        const double shift = (delta > 0) ? -0.1 * span : 0.1 * span;
+        showHistory(start + shift, end + shift);
+    } else {
+        const QPoint canvasPos = canvas()->mapFrom(this, pos);
+        const double t = qBound(start, xToHistory(invTransform(QwtPlot::xBottom, canvasPos.x())), end);
+        const double factor = (delta > 0) ? 1.0 / 1.25 : 1.25;
+        showHistory(t - (t - start) * factor, t + (end - t) * factor);
+    }
+    return true;
+}
+
+// the fill rings only move for curves drawn with FillUnder, when a curve gets this style they are derived from the range rings
+// the same way the ticks do it, with the middle of the interval
+void caStripPlot::rebuildFillData(int curvIndex)
+{
+    for(int j = 0; j < rangeData[curvIndex].size(); j++) {
+        const QwtIntervalSample &P = rangeData[curvIndex].at(j);
+        const QwtIntervalSample &R = rangeDataRaw[curvIndex].at(j);
+        fillData[curvIndex][j] = QPointF(P.value, (P.interval.maxValue() + P.interval.minValue())/2);
+        fillDataRaw[curvIndex][j] = QPointF(R.value, (R.interval.maxValue() + R.interval.minValue())/2);
+    }
+}
+
+// scroll rendering: move the image of the curves by the pixels elapsed since the last tick and draw only the new columns
+// everything is drawn again when the vertical scale, the period, the size or the style changed
+void caStripPlot::updateCurveLayer()
+{
+    const QRect rect = canvas()->contentsRect();
+    if(rect.width() < 1 || rect.height() < 1) {
+        curveLayer = QImage();
+        return;
+    }
+
+    updateAxes();
+    const QwtScaleMap xMap = canvasMap(QwtPlot::xBottom);
+    const QwtScaleMap yMap = canvasMap(QwtPlot::yLeft);
+    const double span = xMap.s2() - xMap.s1();
+    const double origin = xMap.s1() + xOffset;
+    const double pixelsPerUnit = (xMap.p2() - xMap.p1()) / span;
+
+    bool full = layerDirty || curveLayer.size() != rect.size() || !(span > 0.0) || span != layerXSpan ||
+                yMap.s1() != layerYMap.s1() || yMap.s2() != layerYMap.s2() ||
+                yMap.p1() != layerYMap.p1() || yMap.p2() != layerYMap.p2();
+
+    // whole pixels only, the rest is kept for the next tick; going backwards means the time base was reset
+    int shift = 0;
+    if(!full) {
+        const double pixels = (origin - layerOrigin) * pixelsPerUnit;
+        if(pixels < 0.0 || pixels >= (double) rect.width()) full = true; else shift = (int) pixels;
+    }
+
+    if(full) {
+        if(curveLayer.size() != rect.size()) curveLayer = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+        layerOrigin = origin;
+        layerXSpan = span;
+        layerYMap = yMap;
+        layerDirty = false;
+        drawCurveLayer(QRect(QPoint(0, 0), rect.size()), xMap, yMap, -INFINITY);
+        return;
+    }
+
+    const int width = curveLayer.width();
+    if(shift > 0) {
+        const int bytes = curveLayer.depth() / 8;
+        for(int row = 0; row < curveLayer.height(); row++) {
+            uchar *line = curveLayer.scanLine(row);
+            memmove(line, line + shift * bytes, (size_t) ((width - shift) * bytes));
+        }
+        layerOrigin += (double) shift / pixelsPerUnit;
+    }
+
+    // the curves are drawn into the image with a map starting at the image origin, the newest segment changes with every tick
+    QwtScaleMap layerXMap = xMap;
+    layerXMap.setScaleInterval(layerOrigin - xOffset, layerOrigin - xOffset + span);
+    const int stripWidth = qMin(width, shift + SCROLLPAD);
+    const QRect strip(width - stripWidth, 0, stripWidth, curveLayer.height());
+    drawCurveLayer(strip, layerXMap, yMap, layerXMap.invTransform(rect.left() + strip.left()));
+}
+
+void caStripPlot::drawCurveLayer(const QRect &strip, const QwtScaleMap &xMap, const QwtScaleMap &yMap, double minimumX)
+{
+    const QRect rect = canvas()->contentsRect();
+    QPainter painter(&curveLayer);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(strip, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setClipRect(strip);
+    // the maps are in canvas coordinates
+    painter.translate(-rect.left(), -rect.top());
+
+    // same order as given by the z values: fill curves below the error curves
+    for(int pass = 0; pass < 2; pass++) {
+        for(int c = 0; c < NumberOfCurves; c++) {
+            if(pass == 0 && fillcurve[c]->isVisible()) {
+                painter.save();
+                painter.setRenderHint(QPainter::Antialiasing, fillcurve[c]->testRenderHint(QwtPlotItem::RenderAntialiased));
+                fillcurve[c]->setMinimumX(minimumX);
+                fillcurve[c]->draw(&painter, xMap, yMap, QRectF(rect));
+                fillcurve[c]->setMinimumX(-INFINITY);
+                painter.restore();
+            } else if(pass == 1 && errorcurve[c]->isVisible()) {
+                painter.save();
+                painter.setRenderHint(QPainter::Antialiasing, errorcurve[c]->testRenderHint(QwtPlotItem::RenderAntialiased));
+                errorcurve[c]->setMinimumX(minimumX);
+                errorcurve[c]->draw(&painter, xMap, yMap, QRectF(rect));
+                errorcurve[c]->setMinimumX(-INFINITY);
+                painter.restore();
+            }
+        }
+    }
+}
+
+bool caStripPlot::isLayerItem(const QwtPlotItem *item) const
+{
+    for(int c = 0; c < NumberOfCurves; c++) {
+        if(item == fillcurve[c] || item == errorcurve[c]) return true;
+    }
+    return false;
+}
+
+// with scroll rendering the curves come from the image, the other items (grid, markers) are drawn as usual
+// when printing or when the scales changed since the last tick everything is drawn the normal way
+void caStripPlot::drawItems(QPainter *painter, const QRectF &canvasRect, const QwtScaleMap *maps) const
+{
+    const QwtScaleMap &xMap = maps[QwtPlot::xBottom];
+    const QwtScaleMap &yMap = maps[QwtPlot::yLeft];
+
+    // the curves read the rings in place, which the data collection thread writes with the mutex held
+    mutex.lock();
+    if(!scrollRendering || layerDirty || curveLayer.isNull() || canvasRect.toRect() != canvas()->contentsRect() ||
+            xMap.s2() - xMap.s1() != layerXSpan || yMap.s1() != layerYMap.s1() || yMap.s2() != layerYMap.s2() ||
+            yMap.p1() != layerYMap.p1() || yMap.p2() != layerYMap.p2()) {
+        QwtPlot::drawItems(painter, canvasRect, maps);
+        mutex.unlock();
+        return;
+    }
+
+    // the image is put at the place of the lowest curve
+    bool layerDrawn = false;
+    const QwtPlotItemList &items = itemList();
+    for(QwtPlotItemIterator it = items.begin(); it != items.end(); ++it) {
+        QwtPlotItem *item = *it;
+        if(item == Q_NULLPTR || !item->isVisible()) continue;
+        if(isLayerItem(item)) {
+            if(!layerDrawn) painter->drawImage(canvasRect.topLeft(), curveLayer);
+            layerDrawn = true;
+            continue;
+        }
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing, item->testRenderHint(QwtPlotItem::RenderAntialiased));
+        item->draw(painter, maps[item->xAxis()], maps[item->yAxis()], canvasRect);
+        painter->restore();
+    }
+    mutex.unlock();
+}
+
 void caStripPlot::TimersStart()
 {
     // change display timer interval, limit to 10 Hz
@@ -670,6 +1140,7 @@ void caStripPlot::resizeEvent ( QResizeEvent * event )
 {
     QwtPlot::resizeEvent(event);
     RescaleCurves(canvas()->size().width(), thisUnits, thisPeriod);
+    if(historyView) showHistory(viewStart, viewEnd);
     replot();
     if(timerID) RescaleAxis();
 }
@@ -696,15 +1167,7 @@ void caStripPlot::UpdateScaling()
             curve[i]->setTitle(legendText(i));
         }
     }
-    if (thisYaxisScaling == fixedScale){
-        for (quint8 curvIndex = 0 ; curvIndex < NumberOfCurves ; curvIndex++) {
-            remapCurve(thisYaxisLimitsMin[0], thisYaxisLimitsMax[0], curvIndex, thisYaxisType == log10);
-        }
-    } else {
-        for (quint8 curvIndex = 0 ; curvIndex < NumberOfCurves ; curvIndex++) {
-            remapCurve(thisYaxisLimitsMin[curvIndex], thisYaxisLimitsMax[curvIndex], curvIndex, thisYaxisType == log10);
-        }
-    }
+    remapCurves(thisYaxisType == log10);
     selectYAxis(YAxisIndex);
 
     replot();
@@ -813,6 +1276,20 @@ void caStripPlot::defineCurves(QStringList titles, units unit, double period, in
         qDebug() << "The Dynamic Property xAxisToleranceFactor is either not set or set incorrectly (not between 0 and 1) and will be replaced by default value 0.01 for Object:" << this->objectName();
         xAxisToleranceFactor = 0.01f;
     }
+    double rawHistoryDuration = thisRawHistoryDuration;
+    if (rawHistoryDuration < 0){
+        qDebug() << "The Property rawHistoryDuration is set incorrectly (seconds, not negative) and will be replaced by default value" << HISTORY_RAW_SECONDS << "for Object:" << this->objectName();
+        rawHistoryDuration = HISTORY_RAW_SECONDS;
+    }
+    // scroll rendering, for all plots left at the default with the environment variable CAQTDM_STRIPPLOT_SCROLLRENDERING
+    scrollRendering = thisScrollRendering || !qgetenv("CAQTDM_STRIPPLOT_SCROLLRENDERING").isEmpty();
+    mutex.lock();
+    layerDirty = true;
+    for(int i=0; i < MAXCURVES; i++) {
+        history[i].setRawDuration(rawHistoryDuration);
+        history[i].clear();
+    }
+    mutex.unlock();
     // set plotpicker, same reason as xAxisToleranceFactor;
     if (thisPlotPicker == on) plotPicker->setTrackerMode(QwtPicker::AlwaysOn);
 }
@@ -842,11 +1319,10 @@ void caStripPlot::addText(double x, double y, char* text, QColor c, int fontsize
 // data collection done by timerthread
 void caStripPlot::TimeOutThread()
 {
-    int c, i;
+    int c;
     double elapsedTime = 0.0;
     QwtIntervalSample tmp;
     QPointF tmpP;
-    double value = 0.0;
     double interval=0.0;
 
     if(!timerID) return;
@@ -886,8 +1362,8 @@ void caStripPlot::TimeOutThread()
         }
     }
 
-    // tell interval to base class nan
-    for (c = 0; c < NumberOfCurves; c++ ) {
+    // tell interval to base class nan, the history view sets its own
+    for (c = 0; c < NumberOfCurves && !historyView; c++ ) {
         if(thisXaxisType == ValueScale) {
             fillcurve[c]->setInterval(ValueCurv, interval);
             errorcurve[c]->setInterval(ValueCurv, interval);
@@ -897,57 +1373,23 @@ void caStripPlot::TimeOutThread()
         }
     }
 
-    // shift data back
-    if(dataCount > 1) {
-        // shift data and our timebase for the fixed scale
-        if(thisXaxisType == ValueScale) {
-            for (c = 0; c < NumberOfCurves; c++ ) {
-                // shift left and cur last
-                rangeData[c].prepend(tmp);
-                rangeData[c].erase(rangeData[c].end() - 1);
-                rangeDataRaw[c].prepend(tmp);
-                rangeDataRaw[c].erase(rangeDataRaw[c].end() - 1);
-                if(thisStyle[c] == FillUnder) {
-                    fillData[c].prepend(tmpP);
-                    fillData[c].erase(fillData[c].end() - 1);
-                    fillDataRaw[c].prepend(tmpP);
-                    fillDataRaw[c].erase(fillDataRaw[c].end() - 1);
-                }
-            }
-
-            base.prepend(tmp);
-            base.erase(base.end() - 1);
-
-            for (i = dataCount; i > 0; i-- ) {
-                value = base[i].value - timeData;
-                for (c = 0; c < NumberOfCurves; c++ ) {
-                    rangeData[c][i].value = value;
-                    fillData[c][i].setX(value);
-                    rangeDataRaw[c][i].value = value;
-                    fillDataRaw[c][i].setX(value);
-                }
-            }
-
-            // shift data
-        } else {
-            for (c = 0; c < NumberOfCurves; c++ ) {
-                rangeData[c].prepend(tmp);
-                rangeDataRaw[c].prepend(tmp);
-                if(thisStyle[c] == FillUnder) {
-                    fillData[c].prepend(tmpP);
-                    fillDataRaw[c].prepend(tmpP);
-                }
-                rangeData[c].erase(rangeData[c].end() - 1);
-                rangeDataRaw[c].erase(rangeDataRaw[c].end() - 1);
-                if(thisStyle[c] == FillUnder) {
-                    fillData[c].erase(fillData[c].end() - 1);
-                    fillDataRaw[c].erase(fillDataRaw[c].end() - 1);
-                }
+    // shift data back, only the head of the circular buffers moves; the fill buffers are only used with FillUnder
+    const bool advanced = (dataCount > 1);
+    if(advanced) {
+        advanceCount++;
+        for (c = 0; c < NumberOfCurves; c++ ) {
+            rangeData[c].advance(tmp);
+            rangeDataRaw[c].advance(tmp);
+            if(thisStyle[c] == FillUnder) {
+                fillData[c].advance(tmpP);
+                fillDataRaw[c].advance(tmpP);
             }
         }
-
     }
 
+    // for the fixed scale the x values are relative to the newest point, the stored absolute time is corrected on read
+    xOffset = (thisXaxisType == ValueScale) ? timeData : 0.0;
+
     // update last point
     for (c = 0; c < NumberOfCurves; c++ ) {
         double valueMin = minVal[c];
@@ -970,9 +1412,6 @@ void caStripPlot::TimeOutThread()
 
         rangeData[c][0] = QwtIntervalSample( timeData, newInterval);
         rangeDataRaw[c][0] = QwtIntervalSample( timeData, newIntervalRaw);
-        if(thisXaxisType == ValueScale) {
-            base[0] = QwtIntervalSample(timeData, newInterval);
-        }
         if(thisStyle[c] == FillUnder) {
             fillData[c][0] = QPointF(timeData, (valueMax+valueMin)/2);
             fillDataRaw[c][0] = QPointF(timeData, (valueMaxRaw+valueMinRaw)/2);
@@ -983,7 +1422,7 @@ void caStripPlot::TimeOutThread()
     if (dataCount < 2 && dataCount < dataCountLimit) dataCount++;
     else if(dataCount < dataCountLimit) {
         if(thisXaxisType == ValueScale) {
-            if(fillData[0][dataCount-1].x() > -interval) dataCount++;
+            if(rangeData[0].at(dataCount-1).value - xOffset > -interval) dataCount++;
         } else {
             if(elapsedTime < interval) dataCount++;
         }
@@ -995,17 +1434,25 @@ void caStripPlot::TimeOutThread()
         realMax[c] = realMin[c] = realVal[c];
     }
 
+    // the extremes of the displayed samples follow the ring, only the new sample is added
+    for (c = 0; c < NumberOfCurves; c++ ) {
+        if(advanced) {
+            extremes[c].push(rangeData[c].at(0).interval.minValue(), rangeData[c].at(0).interval.maxValue());
+            extremes[c].limit(dataCount);
+        } else {
+            extremes[c].rebuild(rangeData[c], dataCount);
+        }
+    }
+
     // in case of automatic y scale we need the minimum and maximum of our curves
     if(thisYaxisScaling == autoScale) {
         AutoscaleMaxY = -INFINITY;
         AutoscaleMinY = INFINITY;
 
         for (c = 0; c < NumberOfCurves; c++ ) {
-            for (int counter = 0; counter < dataCount; counter++) {
-                QwtIntervalSample P = rangeData[c].at(counter);
-                if(!qIsNaN(P.interval.maxValue()) && P.interval.maxValue() > AutoscaleMaxY) AutoscaleMaxY = P.interval.maxValue();
-                if(!qIsNaN(P.interval.minValue()) && P.interval.minValue() < AutoscaleMinY) AutoscaleMinY = P.interval.minValue();
-            }
+            if(extremes[c].isEmpty()) continue;
+            if(extremes[c].maximum() > AutoscaleMaxY) AutoscaleMaxY = extremes[c].maximum();
+            if(extremes[c].minimum() < AutoscaleMinY) AutoscaleMinY = extremes[c].minimum();
         }
 
         if(AutoscaleMaxY == AutoscaleMinY) {
@@ -1028,12 +1475,9 @@ void caStripPlot::TimeOutThread()
         AutoscaleMinY = INFINITY;
 
         for (c = 0; c < NumberOfCurves; c++ ) {
-            if (!sAutoScaleCurves[c]) continue;
-            for (int counter = 0; counter < dataCount; counter++) {
-                QwtIntervalSample P = rangeData[c].at(counter);
-                if(!qIsNaN(P.interval.maxValue()) && P.interval.maxValue() > AutoscaleMaxY) AutoscaleMaxY = P.interval.maxValue();
-                if(!qIsNaN(P.interval.minValue()) && P.interval.minValue() < AutoscaleMinY) AutoscaleMinY = P.interval.minValue();
-            }
+            if (!sAutoScaleCurves[c] || extremes[c].isEmpty()) continue;
+            if(extremes[c].maximum() > AutoscaleMaxY) AutoscaleMaxY = extremes[c].maximum();
+            if(extremes[c].minimum() < AutoscaleMinY) AutoscaleMinY = extremes[c].minimum();
         }
 
         if(AutoscaleMaxY == AutoscaleMinY) {
@@ -1116,24 +1560,7 @@ void caStripPlot::TimeOut()
         setAxisScale(QwtPlot::xBottom, timeData - INTERVAL, timeData, INTERVAL/nbTicks);
     }
 
-    // set data into the curves
-    for (int c = 0; c < NumberOfCurves; c++ ) {
-        if(thisStyle[c] == FillUnder) {
-            fillcurve[c]->setSamplesList(fillData[c]);
-            fillcurve[c]->setSamples(fillData[c]);
-        }
-        errorcurve[c]->setSamplesList(rangeData[c]);
-        errorcurve[c]->setSamples(rangeData[c]);
-        /*
-        if(c==0) {
-            printf("-----------------------\n");
-            for(int j=0; j!=rangeData[c].size();j++) {
-                printf("%d %f %f\n", j, rangeData[c][j].value, rangeData[c][j].interval.maxValue());
-                if(qIsNaN(rangeData[c][j].interval.maxValue())) break;
-            }
-        }
-*/
-    }
+    // the curves read the rings in place, nothing has to be handed over
 
     // in case of autoscale adjust the vertical scale
     if(thisYaxisScaling == autoScale || thisYaxisScaling == selectiveAutoScale) {
@@ -1153,12 +1580,22 @@ void caStripPlot::TimeOut()
         oldResizeFactorY = ResizeFactorY;
     }
 
-    // replot
-    replot();
+    if(scrollRendering) updateCurveLayer();
+
+    // replot, at most once per frame when the replot scheduler is used
+    if(!ReplotScheduler::instance()->schedule(this)) replot();
 
     mutex.unlock();
 }
 
+// called by the replot scheduler
+void caStripPlot::scheduledReplot()
+{
+    mutex.lock();
+    replot();
+    mutex.unlock();
+}
+
 void caStripPlot::setYscale(double ymin, double ymax) {
     setAxisScale(QwtPlot::yLeft, ymin, ymax);
     replot();
@@ -1288,6 +1725,7 @@ void caStripPlot::setData(struct timeb now, double Y, int curvIndex)
 
     realVal[curvIndex] = Y;
     realTim[curvIndex] = now;
+    history[curvIndex].append((double) now.time + (double) now.millitm / (double)1000, Y);
     if(Y> realMax[curvIndex]) realMax[curvIndex]  = Y;
     if(Y< realMin[curvIndex]) realMin[curvIndex]  = Y;
 
@@ -1295,29 +1733,18 @@ void caStripPlot::setData(struct timeb now, double Y, int curvIndex)
     if(thisYaxisScaling == fixedScale) {
         // We need a different Algorithm for remapping linear vs logarithmic data
         if (thisYaxisType == linear) {
-            double y0min = thisYaxisLimitsMin[0];
-            double y0max = thisYaxisLimitsMax[0];
-            double ymin =  thisYaxisLimitsMin[curvIndex];
-            double ymax =  thisYaxisLimitsMax[curvIndex];
-            actVal[curvIndex] = (y0max - y0min) / (ymax -ymin) * (realVal[curvIndex] - ymin) + y0min;
-            minVal[curvIndex] = (y0max - y0min) / (ymax -ymin) * (realMin[curvIndex] - ymin) + y0min;
-            maxVal[curvIndex] = (y0max - y0min) / (ymax -ymin) * (realMax[curvIndex] - ymin) + y0min;
+            actVal[curvIndex] = mapValue(curvIndex, realVal[curvIndex]);
+            minVal[curvIndex] = mapValue(curvIndex, realMin[curvIndex]);
+            maxVal[curvIndex] = mapValue(curvIndex, realMax[curvIndex]);
         } else {
-            double ymin =  thisYaxisLimitsMin[curvIndex];
-            double ymax =  thisYaxisLimitsMax[curvIndex];
-            if (ymin < 1e-20) setYaxisLimitsMin(curvIndex, 1e-20);
-            if (ymax < 1e-19) setYaxisLimitsMax(curvIndex, 1e-19);
-            double y0min = thisYaxisLimitsMin[0];
-            double y0max = thisYaxisLimitsMax[0];
-            if (y0min < 1e-20) setYaxisLimitsMin(0, 1e-20);
-            if (y0max < 1e-19) setYaxisLimitsMax(0, 1e-19);
-
-            double realValPositive = qMax(realVal[curvIndex], 1e-20);
-            double realMinPositive = qMax(realMin[curvIndex], 1e-20);
-            double realMaxPositive = qMax(realMax[curvIndex], 1e-20);
-            actVal[curvIndex] = y0min*(pow((y0max/y0min),(std::log10(realValPositive/ymin)/std::log10(ymax/ymin))));
-            minVal[curvIndex] = y0min*(pow((y0max/y0min),(std::log10(realMinPositive/ymin)/std::log10(ymax/ymin))));
-            maxVal[curvIndex] = y0min*(pow((y0max/y0min),(std::log10(realMaxPositive/ymin)/std::log10(ymax/ymin))));
+            if (thisYaxisLimitsMin[curvIndex] < 1e-20) setYaxisLimitsMin(curvIndex, 1e-20);
+            if (thisYaxisLimitsMax[curvIndex] < 1e-19) setYaxisLimitsMax(curvIndex, 1e-19);
+            if (thisYaxisLimitsMin[0] < 1e-20) setYaxisLimitsMin(0, 1e-20);
+            if (thisYaxisLimitsMax[0] < 1e-19) setYaxisLimitsMax(0, 1e-19);
+
+            actVal[curvIndex] = mapValue(curvIndex, realVal[curvIndex]);
+            minVal[curvIndex] = mapValue(curvIndex, realMin[curvIndex]);
+            maxVal[curvIndex] = mapValue(curvIndex, realMax[curvIndex]);
             /*qDebug() << "start";
             QElapsedTimer timer;
             timer.start();
@@ -1346,12 +1773,33 @@ void caStripPlot::setData(struct timeb now, double Y, int curvIndex)
     mutex.unlock();
 }
 
+// in case of fixed scales, the values of every curve are remapped to the scale of the first curve
+double caStripPlot::mapValue(int curvIndex, double y) const
+{
+    double y0min = thisYaxisLimitsMin[0];
+    double y0max = thisYaxisLimitsMax[0];
+    double ymin =  thisYaxisLimitsMin[curvIndex];
+    double ymax =  thisYaxisLimitsMax[curvIndex];
+
+    if (thisYaxisType == linear) {
+        return (y0max - y0min) / (ymax -ymin) * (y - ymin) + y0min;
+    }
+
+    y0min = qMax(y0min, 1e-20);
+    y0max = qMax(y0max, 1e-19);
+    ymin = qMax(ymin, 1e-20);
+    ymax = qMax(ymax, 1e-19);
+    double yPositive = qMax(y, 1e-20);
+    return y0min*(pow((y0max/y0min),(std::log10(yPositive/ymin)/std::log10(ymax/ymin))));
+}
+
 void caStripPlot::showCurve(int number, bool on)
 {
     if(number < 0 || number > (MAXCURVES-1)) return;
     curve[number]->setVisible(on);
     fillcurve[number]->setVisible(on);
     errorcurve[number]->setVisible(on);
+    layerDirty = true;
     replot();
 }
 
@@ -1506,12 +1954,19 @@ void caStripPlot::setColor(QColor c, int number)
         }
         errorcurve[number]->setRenderHint( QwtPlotItem::RenderAntialiased, true);
     }
+    layerDirty = true;
 }
 
 void caStripPlot::setStyle(curvStyle s, int number)
 {
     if(number < 0 || number > (MAXCURVES-1)) return;
+    mutex.lock();
+    if(s == FillUnder && thisStyle[number] != FillUnder) rebuildFillData(number);
     thisStyle[number] = s;
+    if(fillcurve[number] != (QwtPlotCurveNaN *) Q_NULLPTR) {
+        if(plotIsPaused) freezeCurveData(number); else setCurveData(number);
+    }
+    mutex.unlock();
     setColor(thisLineColor[number], number);
 }
 
@@ -1563,6 +2018,8 @@ bool caStripPlot::eventFilter(QObject *obj, QEvent *event)
             emit ShowContextMenu(p);
             return true;
         }
+    } else if(event->type() == QEvent::Wheel && plotIsPaused) {
+        if(historyWheel(static_cast<QWheelEvent*>(event))) return true;
     } else if(event->type() == QEvent::Show) {
         //hoi
     }
@@ -37,6 +37,8 @@
 #include <QTimer>
 #include <QThread>
 #include <QMutex>
+#include <QImage>
+#include <QFutureWatcher>
 #include <qwt_plot.h>
 #include <qwt_plot_curve.h>
 #include <qwt_plot_intervalcurve.h>
@@ -69,6 +71,7 @@
 class QwtPlotCurve;
 
 #include "qwtplotcurvenan.h"
+#include "stripplothistory.h"
 
 #ifdef QWT_USE_OPENGL
 #include <qevent.h>
@@ -189,6 +192,9 @@ class QTCON_EXPORT caStripPlot : public QwtPlot
 
     Q_PROPERTY(int XaxisSyncGroup READ getXaxisSyncGroup WRITE setXaxisSyncGroup)
 
+    Q_PROPERTY(double rawHistoryDuration READ getRawHistoryDuration WRITE setRawHistoryDuration)
+    Q_PROPERTY(bool scrollRendering READ getScrollRendering WRITE setScrollRendering)
+
     // this will prevent user interference
     Q_PROPERTY(QString styleSheet READ styleSheet WRITE noStyle DESIGNABLE false)
 
@@ -227,6 +233,14 @@ public:
     bool getSelectableCurves() const {return thisSelectableCurves;}
     // setter defined as public slot
 
+    // seconds of raw samples kept for every curve, at most HISTORY_RAW_MAXSAMPLES of them
+    double getRawHistoryDuration() const {return thisRawHistoryDuration;}
+    void setRawHistoryDuration(double seconds) {thisRawHistoryDuration = seconds;}
+
+    // when false the environment variable CAQTDM_STRIPPLOT_SCROLLRENDERING switches scroll rendering on
+    bool getScrollRendering() const {return thisScrollRendering;}
+    void setScrollRendering(bool scroll) {thisScrollRendering = scroll;}
+
     caStripPlot(QWidget * = 0);
     ~caStripPlot();
 
@@ -494,6 +508,7 @@ public slots:
 
 protected:
     void resizeEvent ( QResizeEvent * event);
+    virtual void drawItems(QPainter *painter, const QRectF &canvasRect, const QwtScaleMap *maps) const;
 
 signals:
     void ShowContextMenu(const QPoint&);
@@ -503,7 +518,9 @@ signals:
 private slots:
      void TimeOut();
      void TimeOutThread();
+     void scheduledReplot();
      void onSelected(const QPointF& point);
+     void remapFinished();
 
 private:
     int HISTORY;
@@ -524,7 +541,33 @@ private:
     void RescaleAxis();
     void TimersStart();
     void selectYAxis(quint8 newYAxisIndex);
-    void remapCurve(double newMin, double newMax, quint8 curvIndex, bool isNewLog);
+    // conversion of the raw rings of one curve to other limits, done on copies so that it can run in a worker thread
+    struct remapJob {
+        int curvIndex;
+        bool isNewLog, fillUnder;
+        double oldMin, oldMax, newMin, newMax, period;
+        StripPlotRing<QwtIntervalSample> rangeRaw, range;
+        StripPlotRing<QPointF> fillRaw, fill;
+    };
+    static void remapCurveData(remapJob &job);
+    void remapCurves(bool isNewLog);
+    void resetCurveData();
+    void setCurveData(int curvIndex);
+    void freezeCurveData(int curvIndex);
+    void setPaused(bool paused);
+    void rebuildFillData(int curvIndex);
+    int fillFromHistory();
+    double xUnitFactor() const;
+    double historyToX(double t) const;
+    double xToHistory(double x) const;
+    void historyCurveData(int curvIndex);
+    void showHistory(double start, double end);
+    void leaveHistory();
+    bool historyWheel(QWheelEvent *event);
+    double mapValue(int curvIndex, double y) const;
+    void updateCurveLayer();
+    void drawCurveLayer(const QRect &strip, const QwtScaleMap &xMap, const QwtScaleMap &yMap, double minimumX);
+    bool isLayerItem(const QwtPlotItem *item) const;
 
     // curve only used to define nicely the legend
     QwtPlotCurve *curve[MAXCURVES];
@@ -532,14 +575,43 @@ private:
     QwtPlotIntervalCurveNaN *errorcurve[MAXCURVES];
     QwtPlotCurveNaN *fillcurve[MAXCURVES];
 
-    // y data for error curve
-    QVector<QwtIntervalSample> base;
-    QVector<QwtIntervalSample> rangeData[MAXCURVES];
-    QVector<QPointF> fillData[MAXCURVES];
+    // y data for error curve, circular buffers with the newest sample at index 0
+    StripPlotRing<QwtIntervalSample> rangeData[MAXCURVES];
+    StripPlotRing<QPointF> fillData[MAXCURVES];
 
     // original, raw y data for conversions
-    QVector<QwtIntervalSample> rangeDataRaw[MAXCURVES];
-    QVector<QPointF> fillDataRaw[MAXCURVES];
+    StripPlotRing<QwtIntervalSample> rangeDataRaw[MAXCURVES];
+    StripPlotRing<QPointF> fillDataRaw[MAXCURVES];
+
+    // minimum and maximum of the displayed part of rangeData, for the autoscale
+    StripPlotExtremes extremes[MAXCURVES];
+
+    // the remap runs while the rings go on, the samples added meanwhile are taken over when the result is swapped in
+    QFutureWatcher<void> *remapWatcher;
+    QVector<remapJob> remapJobs;
+    quint64 advanceCount, remapAdvance;
+    quint64 dataGeneration, remapGeneration;
+    bool remapPending, remapPendingLog;
+
+    // stored x values are absolute, for the value scale this offset is subtracted when reading them
+    double xOffset;
+
+    // history of the raw data independent of the canvas width, used to rebuild the curves when the period or the width changes
+    StripPlotHistory history[MAXCURVES];
+
+    // while paused the wheel zooms (shift pans) the time axis over the history, the curves then show its envelope
+    bool historyView;
+    double viewStart, viewEnd;   // seconds since epoch
+    double viewBase;             // time of x = 0 for the time scales
+    double pauseTime;            // time of x = 0 for the value scale
+
+    // scroll rendering: the curves are kept in an image that is moved by the elapsed pixels, only the newest columns get drawn
+    bool scrollRendering;
+    bool layerDirty;
+    QImage curveLayer;
+    double layerOrigin;   // stored x value at the left edge of the image
+    double layerXSpan;
+    QwtScaleMap layerYMap;
 
     DynamicPlotPicker * plotPicker;
 
@@ -550,6 +622,8 @@ private:
 
     bool thisXshow, thisYshow, thisLegendshow, thisGrid;
     bool thisIterableCurves, thisSelectableCurves;
+    double thisRawHistoryDuration;
+    bool thisScrollRendering;
     xAxisType thisXaxisType;
     yAxisType thisYaxisType;
     yAxisScaling thisYaxisScaling;
@@ -594,7 +668,12 @@ private:
 
     stripplotthread *timerThread;
 
-    QMutex mutex;
+    // recursive, as painting takes it too and replot() is also called with it held
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    mutable QRecursiveMutex mutex;
+#else
+    mutable QMutex mutex;
+#endif
 
     bool initCurves;
 
@@ -28,12 +28,112 @@
 #endif
 
 #include "cawaterfallplot.h"
+#include "replotscheduler.h"
 
 __inline double gauss(double x)
 {
     return exp(-0.5*x*x);
 }
 
+WaterfallSpectrogram::WaterfallSpectrogram() : QwtPlotSpectrogram()
+{
+    imageColorMap = Q_NULLPTR;
+    imageLayout = -1;
+    imageRowsWritten = 0;
+    imageTableScale = 0.0;
+}
+
+void WaterfallSpectrogram::colorizeRow(const SpectrogramData *spectrogram, int ringIndex) const
+{
+    const double *values = spectrogram->ringRow(ringIndex);
+    const QRgb *table = imageTable.constData();
+    const int last = imageTable.size() - 1;
+    const double min = imageRange.minValue();
+    QRgb *line = (QRgb *) image.scanLine(ringIndex);
+    for(int col = 0; col < image.width(); col++) {
+        // nothing is drawn for a NaN, like the colormap does
+        if(qIsNaN(values[col])) {
+            line[col] = 0u;
+            continue;
+        }
+        const double pos = (values[col] - min) * imageTableScale;
+        line[col] = table[pos <= 0.0 ? 0 : (pos >= last ? last : (int) (pos + 0.5))];
+    }
+}
+
+// colorize the rows written since the last drawing
+bool WaterfallSpectrogram::updateImage(const SpectrogramData *spectrogram) const
+{
+    if(!spectrogram->isValid() || colorMap() == Q_NULLPTR || colorMap()->format() != QwtColorMap::RGB) return false;
+
+    const int rows = spectrogram->rows();
+    const int cols = spectrogram->columns();
+    const QwtInterval range = spectrogram->interval(Qt::ZAxis);
+    qint64 newRows = spectrogram->writtenRows() - imageRowsWritten;
+
+    if(image.width() != cols || image.height() != rows || imageLayout != spectrogram->layout() ||
+            imageColorMap != colorMap() || imageRange != range) {
+        image = QImage(cols, rows, QImage::Format_ARGB32);
+        imageLayout = spectrogram->layout();
+        imageColorMap = colorMap();
+        imageRange = range;
+        newRows = rows;
+
+        // the colors come from a table built once for this colormap and range
+        imageTable = colorMaps::colorTable(colorMap(), range, WATERFALL_COLORTABLE);
+        imageTableScale = range.width() > 0.0 ? (double) (WATERFALL_COLORTABLE - 1) / range.width() : 0.0;
+    }
+    if(imageTable.isEmpty()) return false;
+
+    // the newest rows are the ones before the last written in the ring
+    newRows = qMin(newRows, (qint64) rows);
+    for(int j = 0; j < (int) newRows; j++) {
+        colorizeRow(spectrogram, (spectrogram->lastWrittenRow() - j + rows) % rows);
+    }
+    imageRowsWritten = spectrogram->writtenRows();
+    return true;
+}
+
+void WaterfallSpectrogram::draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const
+{
+    const SpectrogramData *spectrogram = dynamic_cast<const SpectrogramData *>(data());
+    if(spectrogram == Q_NULLPTR || !testDisplayMode(QwtPlotSpectrogram::ImageMode) || testDisplayMode(QwtPlotSpectrogram::ContourMode)) {
+        QwtPlotSpectrogram::draw(painter, xMap, yMap, canvasRect);
+        return;
+    }
+
+    const QwtInterval xInterval = spectrogram->interval(Qt::XAxis);
+    const QwtInterval yInterval = spectrogram->interval(Qt::YAxis);
+
+    // the top row of the data has to be on top of the canvas, like the waterfall is set up
+    if(!xInterval.isValid() || !yInterval.isValid() ||
+            xMap.transform(xInterval.minValue()) > xMap.transform(xInterval.maxValue()) ||
+            yMap.transform(yInterval.minValue()) > yMap.transform(yInterval.maxValue()) || !updateImage(spectrogram)) {
+        QwtPlotSpectrogram::draw(painter, xMap, yMap, canvasRect);
+        return;
+    }
+
+    const int rows = image.height();
+    const int top = spectrogram->topRow();
+    const double dy = yInterval.width() / rows;
+    const double x1 = xMap.transform(xInterval.minValue());
+    const double x2 = xMap.transform(xInterval.maxValue());
+
+    painter->save();
+    painter->setClipRect(canvasRect, Qt::IntersectClip);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+    // ring rows from the top row to the end of the image, then the rows from the start of the image
+    const double split = yMap.transform(yInterval.minValue() + (rows - top) * dy);
+    painter->drawImage(QRectF(QPointF(x1, yMap.transform(yInterval.minValue())), QPointF(x2, split)),
+                       image, QRectF(0, top, image.width(), rows - top));
+    if(top > 0) {
+        painter->drawImage(QRectF(QPointF(x1, split), QPointF(x2, yMap.transform(yInterval.maxValue()))),
+                           image, QRectF(0, 0, image.width(), top));
+    }
+    painter->restore();
+}
+
 caWaterfallPlot::caWaterfallPlot(QWidget *parent): QWidget(parent)
 {
 
@@ -52,7 +152,7 @@ caWaterfallPlot::caWaterfallPlot(QWidget *parent): QWidget(parent)
     hboxLayout->addWidget(plot);
 
     // define spectrogram
-    d_spectrogram = new QwtPlotSpectrogram();
+    d_spectrogram = new WaterfallSpectrogram();
     d_spectrogram->setRenderThreadCount(0); // use system specific thread count
 
     d_spectrogram->setColorMap(new ColorMap_Wavelength());
@@ -64,8 +164,7 @@ caWaterfallPlot::caWaterfallPlot(QWidget *parent): QWidget(parent)
     setRows(nbRows);
     setCols(nbCols);
     ActualNumberOfColumns = NumberOfColumns = nbCols;
-    reducedArray = (double*) malloc(ActualNumberOfColumns * sizeof(double));
-    memset(reducedArray, 0, ActualNumberOfColumns *sizeof(double));
+    reducedArray.fill(0.0, ActualNumberOfColumns);
 
     // initialize data
     m_data->initData(NumberOfColumns, getRows());
@@ -117,10 +216,6 @@ caWaterfallPlot::caWaterfallPlot(QWidget *parent): QWidget(parent)
 
 caWaterfallPlot::~caWaterfallPlot()
 {
-    if(reducedArray != (double *) Q_NULLPTR) {
-        free(reducedArray);
-        reducedArray = (double *) Q_NULLPTR;
-    }
 }
 
 bool caWaterfallPlot::isPropertyVisible(Properties property)
@@ -188,10 +283,7 @@ void caWaterfallPlot::setCountNumber(int number) {
 void caWaterfallPlot::InitData(int numCols)
 {
     disableDemo = true;
-    if(reducedArray != (double *) Q_NULLPTR) {
-        free(reducedArray);
-        reducedArray = (double *) Q_NULLPTR;
-    }
+    reducedArray.clear();
 
     countRows = 0;
     setCols(numCols);
@@ -202,7 +294,13 @@ void caWaterfallPlot::InitData(int numCols)
     setCols(ActualNumberOfColumns);
 }
 
+// at most once per frame when the replot scheduler is used
 void caWaterfallPlot::myReplot()
+{
+    if(!ReplotScheduler::instance()->schedule(this)) scheduledReplot();
+}
+
+void caWaterfallPlot::scheduledReplot()
 {
 #if QWT_VERSION >= 0x060100
     QwtPlotCanvas *canvas =  (QwtPlotCanvas *) plot->canvas();
@@ -232,13 +330,10 @@ template <typename pureData> void caWaterfallPlot::CompressAndkeepArray(pureData
 {
     datamutex->lock();
     int ratio = m_data->getRatio(NumberOfColumns, ActualNumberOfColumns);
-    if(reducedArray != (double *) Q_NULLPTR) {
-        free(reducedArray);
-        reducedArray = (double *) Q_NULLPTR;
-    }
-    reducedArray = (double*) malloc(ActualNumberOfColumns * sizeof(double));
-    memset(reducedArray, 0, ActualNumberOfColumns *sizeof(double));
-    AverageArray(vec, size, arraySize, reducedArray, ratio);
+    // the buffer is only reallocated when the number of columns changes
+    reducedArray.resize(ActualNumberOfColumns);
+    reducedArray.fill(0.0);
+    AverageArray(vec, size, arraySize, reducedArray.data(), ratio);
     datamutex->unlock();
 }
 
@@ -372,7 +467,7 @@ void caWaterfallPlot::TimeOut()
         if(!disableDemo) {
             datamutex->lock();
             GausCurv(position);
-            m_data->setData(reducedArray, countRows, ActualNumberOfColumns, getRows(), ActualNumberOfColumns);
+            m_data->setData(reducedArray.data(), countRows, ActualNumberOfColumns, getRows(), reducedArray.size());
             setCols(ActualNumberOfColumns);
 
             if(firstDemoPlot) {
@@ -386,9 +481,9 @@ void caWaterfallPlot::TimeOut()
             if(drift < 0 && position <= 0)  drift = 1;
             position += drift;
         } else {
-            if(reducedArray != (double*) Q_NULLPTR) {
+            if(!reducedArray.isEmpty()) {
                 datamutex->lock();
-                m_data->setData(reducedArray, countRows, ActualNumberOfColumns, getRows(),  ActualNumberOfColumns);
+                m_data->setData(reducedArray.data(), countRows, ActualNumberOfColumns, getRows(), reducedArray.size());
                 if(firstTimerPlot) {
                     updatePlot();
                     m_data->setLimits(0., getCols(), 0., getRows(), thisIntensityMin, thisIntensityMax);
@@ -490,7 +585,7 @@ void caWaterfallPlot::GausCurv(double middle) {
     double max = 1000.0;
     double range = max - min;
     double sigma = 100.0;
-    for (int i=0; i<nbCols; i++) {
+    for (int i=0; i<qMin((int) nbCols, (int) reducedArray.size()); i++) {
         reducedArray[i] =  min + range * gauss((i-middle)/sigma);
     }
 }
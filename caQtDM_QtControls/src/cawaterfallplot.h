@@ -65,6 +65,8 @@
 
 #define MAXCOLUMNS 500
 
+// the rows are kept in a ring, a new row overwrites the oldest one and only the row offset moves
+// value() maps the y coordinate through this offset, so the matrix never has to be shifted or handed to qwt again
 class SpectrogramData: public QwtMatrixRasterData
 {
 private:
@@ -75,16 +77,26 @@ private:
     int NumberOfRows;
     int ActualNumberOfColumns;
     int ratio;
+    int firstRow;    // ring index of the top row
+    int lastRow;     // ring index of the row written last
+    qint64 rowsWritten;
+    int geometry;    // changed whenever the rows are laid out again
 
 public:
     SpectrogramData() {
+        NumberOfColumns = NumberOfRows = ActualNumberOfColumns = 0;
+        ratio = 1;
+        firstRow = lastRow = 0;
+        rowsWritten = 0;
+        geometry = 0;
     }
 
     template <typename pureData>
     void AverageVector(pureData *vec, int size, QVector<double> &avg, int arraySize)
     {
-        avg.clear();
-        for (int i=0; i< size-ratio; i+=ratio) {
+        // written in place, the vector keeps its size
+        int counter = 0;
+        for (int i=0; i< size-ratio && counter < avg.size(); i+=ratio) {
             double mean = 0;
             for(int j=0; j< ratio; j++) {
                 if((i+j) >= arraySize) {
@@ -93,7 +105,7 @@ public:
                    mean += vec[i+j];
                 }
             }
-            avg += mean / (double) ratio;
+            avg[counter++] = mean / (double) ratio;
         }
     }
 
@@ -120,6 +132,8 @@ public:
         }
         values.clear();
         valuesAveraged.clear();
+        firstRow = 0;
+        geometry++;
 
         return ActualNumberOfColumns;
     }
@@ -137,7 +151,14 @@ public:
         if(ratio != 1) {
             valuesAveraged.resize(ActualNumberOfColumns);
         }
-        values.resize(ActualNumberOfColumns * NumberOfRows);
+
+        // a new geometry starts again with the top row
+        if(values.size() != ActualNumberOfColumns * NumberOfRows) {
+            values.resize(ActualNumberOfColumns * NumberOfRows);
+            firstRow = 0;
+            geometry++;
+        }
+        if(NumberOfRows < 1 || ActualNumberOfColumns < 1) return ActualNumberOfColumns;
 
         // calculate reduced data vector
         if(ratio != 1) {
@@ -145,59 +166,77 @@ public:
         }
 
         // in case of a plot down to the bottom, start from the top and go to bottom
+        int row;
         if(count <  NumberOfRows) {
-            int start = ActualNumberOfColumns * count;
-            int stop = start + ActualNumberOfColumns;
-            if(ratio != 1) {
-                for ( int i = start; i < stop; i++ ) {
-                    values[i] = valuesAveraged[i-start];
-                }
-            } else {
-                for ( int i = start; i < stop; i++ ) {
-                    if((i-start) >= arraySize) {
-                        break;
-                    } else {
-                       values[i] = Array[i-start];
-                    }
-                }
-            }
+            row = (firstRow + count) % NumberOfRows;
             count++;
-            // otherwise shift plot and add to the end
+            // otherwise the oldest row is overwritten and the next one becomes the top row
         } else {
-            // delete first row
-            values.remove(0, ActualNumberOfColumns);
-            // resize to full size
-            values.resize(ActualNumberOfColumns * NumberOfRows);
+            row = firstRow;
+            firstRow = (firstRow + 1) % NumberOfRows;
+        }
 
-            // copy array to the end of the array data
-            int start = ActualNumberOfColumns * NumberOfRows - ActualNumberOfColumns;
-            int stop = ActualNumberOfColumns * NumberOfRows;
-            if(ratio != 1) {
-                for ( int i = start; i < stop; i++ ) {
-                    values[i] = valuesAveraged[i-start];
-                }
-            } else {
-                for ( int i = start; i < stop; i++ ) {
-                    if((i-start) >= arraySize) {
-                        break;
-                    } else {
-                       values[i] = Array[i-start];
-                    }
-                }
-            }
+        double *data = values.data() + row * ActualNumberOfColumns;
+        if(ratio != 1) {
+            for ( int i = 0; i < ActualNumberOfColumns; i++ ) data[i] = valuesAveraged.at(i);
+        } else {
+            const int stop = qMin(ActualNumberOfColumns, arraySize);
+            for ( int i = 0; i < stop; i++ ) data[i] = Array[i];
         }
+        lastRow = row;
+        rowsWritten++;
 
         //ftime(&now);
         //double diff = ((double) now.time + (double) now.millitm / (double)1000) -
         //        ((double) last.time + (double) last.millitm / (double)1000);
         //printf("%f\n", diff);
 
-        // update the matrix
-        setValueMatrix(values, ActualNumberOfColumns);
-
         return ActualNumberOfColumns;
     }
 
+    int rows() const {return NumberOfRows;}
+    int columns() const {return ActualNumberOfColumns;}
+
+    bool isValid() const {return NumberOfRows > 0 && ActualNumberOfColumns > 0 && values.size() == ActualNumberOfColumns * NumberOfRows;}
+
+    // row counted from the top of the plot
+    const double *rowData(int row) const {
+        return values.constData() + ((firstRow + row) % NumberOfRows) * ActualNumberOfColumns;
+    }
+
+    // access to the ring itself, used to colorize only the rows that changed
+    const double *ringRow(int ringIndex) const {return values.constData() + ringIndex * ActualNumberOfColumns;}
+    int topRow() const {return firstRow;}
+    int lastWrittenRow() const {return lastRow;}
+    qint64 writtenRows() const {return rowsWritten;}
+    int layout() const {return geometry;}
+
+    // nearest neighbour like QwtMatrixRasterData, through the ring
+    virtual double value(double x, double y) const
+    {
+        if(!isValid()) return qQNaN();
+        const QwtInterval xInterval = interval(Qt::XAxis);
+        const QwtInterval yInterval = interval(Qt::YAxis);
+        if (!(xInterval.contains(x) && yInterval.contains(y))) return qQNaN();
+
+        int row = int((y - yInterval.minValue()) / (yInterval.width() / NumberOfRows));
+        int col = int((x - xInterval.minValue()) / (xInterval.width() / ActualNumberOfColumns));
+        // the maximum of the interval is included
+        if(row >= NumberOfRows) row = NumberOfRows - 1;
+        if(col >= ActualNumberOfColumns) col = ActualNumberOfColumns - 1;
+        return rowData(row)[col];
+    }
+
+    // size of one cell, as QwtMatrixRasterData gives it for a matrix
+    virtual QRectF pixelHint(const QRectF &area) const
+    {
+        Q_UNUSED(area);
+        const QwtInterval xInterval = interval(Qt::XAxis);
+        const QwtInterval yInterval = interval(Qt::YAxis);
+        if(NumberOfRows < 1 || ActualNumberOfColumns < 1 || !xInterval.isValid() || !yInterval.isValid()) return QRectF();
+        return QRectF(xInterval.minValue(), yInterval.minValue(), xInterval.width() / ActualNumberOfColumns, yInterval.width() / NumberOfRows);
+    }
+
     void setLimits(double xmin, double xmax, double ymin, double ymax, double zmin, double zmax)
     {
         setInterval( Qt::XAxis, QwtInterval( xmin, xmax ) );
@@ -207,6 +246,31 @@ public:
 
 };
 
+// spectrogram keeping the colored rows in an image laid out like the ring of SpectrogramData
+// a new row is colorized alone, the image is drawn in two parts starting with the top row
+// all rows are colorized again only when the colormap, the intensity range or the geometry changed
+// number of colors in the lookup table used for colorizing the rows
+#define WATERFALL_COLORTABLE 4096
+
+class WaterfallSpectrogram: public QwtPlotSpectrogram
+{
+public:
+    WaterfallSpectrogram();
+    virtual void draw(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvasRect) const;
+
+private:
+    bool updateImage(const SpectrogramData *spectrogram) const;
+    void colorizeRow(const SpectrogramData *spectrogram, int ringIndex) const;
+
+    mutable QImage image;
+    mutable const QwtColorMap *imageColorMap;
+    mutable QwtInterval imageRange;
+    mutable int imageLayout;
+    mutable qint64 imageRowsWritten;
+    mutable QVector<QRgb> imageTable;
+    mutable double imageTableScale;
+};
+
 
 class QTCON_EXPORT caWaterfallPlot: public QWidget
 {
@@ -364,12 +428,13 @@ private:
     QMutex *datamutex;
 
     QwtPlot *plot;
-    QwtPlotSpectrogram *d_spectrogram;
+    WaterfallSpectrogram *d_spectrogram;
     QwtPlotGrid * plotGrid;
     QTimer *Timer;
     double position, drift;
 
-    double *reducedArray;
+    // reduced row, kept between the updates
+    QVector<double> reducedArray;
 
     SpectrogramData *m_data;
 
@@ -398,4 +463,7 @@ private:
 
 public  Q_SLOTS:
     void TimeOut();
+
+private  Q_SLOTS:
+    void scheduledReplot();
 };
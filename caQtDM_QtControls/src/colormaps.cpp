@@ -42,6 +42,18 @@ void colorMaps::showColorMap(QwtScaleWidget *colormapWidget, bool hide, QwtLinea
     }
 }
 
+QVector<QRgb> colorMaps::colorTable(const QwtColorMap *colormap, const QwtInterval &range, int size)
+{
+    QVector<QRgb> table;
+    if(colormap == (QwtColorMap *) Q_NULLPTR || size < 2 || !range.isValid()) return table;
+
+    table.resize(size);
+    const double step = range.width() / (double) (size - 1);
+    for(int i = 0; i < size - 1; i++) table[i] = colormap->rgb(range, range.minValue() + i * step);
+    table[size - 1] = colormap->rgb(range, range.maxValue());
+    return table;
+}
+
 void colorMaps::getColormap(colormaps map, bool discrete, QStringList CustomMap, int ColormapSize, uint colorMap[], QwtScaleWidget *colormapWidget)
 {
 
@@ -177,6 +177,10 @@ public:
 
   void getColormap(colormaps map, bool discrete, QStringList CustomMap, int ColorMapSize, uint colorMap[], QwtScaleWidget *colormapWidget);
 
+  // dense lookup table with the colors of size values equally spaced over the range, the first entry for the minimum,
+  // the last one for the maximum; a value v is then colored with table[(v - min) * (size - 1) / width]
+  static QVector<QRgb> colorTable(const QwtColorMap *colormap, const QwtInterval &range, int size);
+
 private:
 
     void showColorMap(QwtScaleWidget *colormapWidget, bool hide, QwtLinearColorMap *colormap);
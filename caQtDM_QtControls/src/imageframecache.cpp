@@ -0,0 +1,108 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#include "imageframecache.h"
+#include <QImageReader>
+#include <QImage>
+
+ImageFrameCache *ImageFrameCache::instance()
+{
+    static ImageFrameCache *cache = Q_NULLPTR;
+    if(cache == (ImageFrameCache *) Q_NULLPTR) cache = new ImageFrameCache();
+    return cache;
+}
+
+bool ImageFrameCache::acquire(const QString &fileName)
+{
+    QHash<QString, entry>::iterator it = Entries.find(fileName);
+    if(it != Entries.end()) {
+        it.value().users++;
+        return true;
+    }
+
+    // all frames at once, the same way QMovie reads them one after the other
+    entry e;
+    e.users = 1;
+    QImageReader reader(fileName);
+    while(reader.canRead()) {
+        QImage image = reader.read();
+        if(image.isNull()) break;
+        e.frames.append(QPixmap::fromImage(image));
+    }
+    if(e.frames.isEmpty()) return false;
+
+    Entries.insert(fileName, e);
+    return true;
+}
+
+void ImageFrameCache::release(const QString &fileName)
+{
+    QHash<QString, entry>::iterator it = Entries.find(fileName);
+    if(it == Entries.end()) return;
+    if(--it.value().users <= 0) Entries.erase(it);
+}
+
+void ImageFrameCache::acquireSize(const QString &fileName, const QSize &size)
+{
+    QHash<QString, entry>::const_iterator file = Entries.constFind(fileName);
+    if(file == Entries.constEnd() || size.isEmpty()) return;
+
+    QHash<sizeKey, scaledEntry>::iterator it = Scaled.find(key(fileName, size));
+    if(it != Scaled.end()) {
+        it.value().users++;
+        return;
+    }
+    scaledEntry e;
+    e.users = 1;
+    e.frames.resize(file.value().frames.size());
+    Scaled.insert(key(fileName, size), e);
+}
+
+void ImageFrameCache::releaseSize(const QString &fileName, const QSize &size)
+{
+    QHash<sizeKey, scaledEntry>::iterator it = Scaled.find(key(fileName, size));
+    if(it == Scaled.end()) return;
+    if(--it.value().users <= 0) Scaled.erase(it);
+}
+
+int ImageFrameCache::frameCount(const QString &fileName) const
+{
+    QHash<QString, entry>::const_iterator it = Entries.constFind(fileName);
+    if(it == Entries.constEnd()) return 0;
+    return (int) it.value().frames.size();
+}
+
+QPixmap ImageFrameCache::frame(const QString &fileName, int index, const QSize &size)
+{
+    QHash<QString, entry>::iterator it = Entries.find(fileName);
+    if(it == Entries.end()) return QPixmap();
+    entry &e = it.value();
+    if(index < 0 || index >= e.frames.size()) return QPixmap();
+
+    const QPixmap &original = e.frames.at(index);
+    if(size.isEmpty() || size == original.size()) return original;
+
+    QHash<sizeKey, scaledEntry>::iterator sized = Scaled.find(key(fileName, size));
+    if(sized == Scaled.end()) return original.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    QPixmap &scaled = sized.value().frames[index];
+    if(scaled.isNull()) scaled = original.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    return scaled;
+}
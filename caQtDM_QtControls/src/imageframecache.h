@@ -0,0 +1,79 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#ifndef IMAGEFRAMECACHE_H
+#define IMAGEFRAMECACHE_H
+
+#include <qtcontrols_global.h>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QPixmap>
+#include <QString>
+#include <QSize>
+
+// decoded frames of the image files shown by caImage, shared by all widgets of the application
+// every file is decoded once however many widgets show it, and every frame is scaled once per size
+// the frames of a file are kept as long as a widget uses the file, the scaled ones as long as a widget uses that size
+
+class QTCON_EXPORT ImageFrameCache
+{
+
+public:
+
+    static ImageFrameCache *instance();
+
+    // decodes the frames of the file when no other widget uses it yet, returns false when nothing could be read
+    bool acquire(const QString &fileName);
+    void release(const QString &fileName);
+
+    // a widget shows the frames of an acquired file in this size, the scaled frames are kept until it releases the size
+    void acquireSize(const QString &fileName, const QSize &size);
+    void releaseSize(const QString &fileName, const QSize &size);
+
+    int frameCount(const QString &fileName) const;
+
+    // the frame scaled to the given size, the frame as read for an empty size; a null pixmap when there is no such frame
+    // the scaled frame is only kept when the size was acquired
+    QPixmap frame(const QString &fileName, int index, const QSize &size);
+
+private:
+
+    ImageFrameCache() {}
+
+    typedef struct {
+        int users;
+        QVector<QPixmap> frames;
+    } entry;
+
+    // file, width and height
+    typedef QPair<QString, QPair<int, int> > sizeKey;
+    static sizeKey key(const QString &fileName, const QSize &size) {return sizeKey(fileName, QPair<int, int>(size.width(), size.height()));}
+
+    typedef struct {
+        int users;
+        QVector<QPixmap> frames;    // null until the frame is needed in this size
+    } scaledEntry;
+
+    QHash<QString, entry> Entries;
+    QHash<sizeKey, scaledEntry> Scaled;
+};
+
+#endif // IMAGEFRAMECACHE_H
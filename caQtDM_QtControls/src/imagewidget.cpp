@@ -42,6 +42,7 @@ ImageWidget::ImageWidget(QWidget *parent) : QWidget(parent)
     }
     firstImage = true;
     scaleFactorL = 1.0;
+    binningL = 1;
     firstSelection = true;
     selectionInProgress = false;
 }
@@ -49,8 +50,30 @@ ImageWidget::ImageWidget(QWidget *parent) : QWidget(parent)
 void ImageWidget::getImageDimensions(int &width, int &height)
 {
     double correction = scaleFactorL;
-    width = qRound(imageNew.size().width() * correction);
-    height = qRound(imageNew.size().height() * correction);
+    width = qRound(imageFrameSize().width() * correction);
+    height = qRound(imageFrameSize().height() * correction);
+}
+
+void ImageWidget::setBinning(int binning, const QSize &frameSize)
+{
+    binningL = qMax(binning, 1);
+    frameSizeL = frameSize;
+}
+
+QSize ImageWidget::imageFrameSize() const
+{
+    return imageFrameSize(imageNew);
+}
+
+QSize ImageWidget::imageFrameSize(const QImage &image) const
+{
+    // a binned image holds every binning'th pixel of the frame, everything is drawn in frame coordinates
+    // the binned size is rounded up, so the frame size given with the binning is used when the image belongs to it
+    if(binningL > 1) {
+        const QSize binned((frameSizeL.width() + binningL - 1) / binningL, (frameSizeL.height() + binningL - 1) / binningL);
+        if(binned == image.size()) return frameSizeL;
+    }
+    return image.size() * binningL;
 }
 
 void ImageWidget::updateDisconnected()
@@ -124,7 +147,15 @@ void ImageWidget::paintEvent(QPaintEvent * event)
 #endif
     // and draw
 
-    painter.drawImage(exposedRect, imageNew, exposedRect);
+    if(binningL > 1) {
+        // the last binned pixels also cover the columns and rows beyond the frame
+        exposedRect &= QRect(QPoint(0, 0), imageFrameSize());
+        const double b = (double) binningL;
+        painter.drawImage(QRectF(exposedRect), imageNew,
+                          QRectF(exposedRect.x() / b, exposedRect.y() / b, exposedRect.width() / b, exposedRect.height() / b));
+    } else {
+        painter.drawImage(exposedRect, imageNew, exposedRect);
+    }
 
     if(selectSimpleViewL) {
         painter.restore();
@@ -132,8 +163,8 @@ void ImageWidget::paintEvent(QPaintEvent * event)
     }
 
     // draw a rounded rectangle around the image
-    width = imageNew.size().width();
-    height = imageNew.size().height();
+    width = imageFrameSize().width();
+    height = imageFrameSize().height();
     painter.setPen(Qt::blue);
     painter.drawRoundedRect(0, 0, width, height, 2.0, 2.0);
 
@@ -303,8 +334,8 @@ void ImageWidget::paintEvent(QPaintEvent * event)
         case xy_only:
             if(!present[0] || !present[1]) break;
             // vertical and horizontal
-            painter.drawLine(values[0], 0, values[0], qRound(imageNew.size().height()*scaleFactorL));
-            painter.drawLine(0, values[1], qRound(imageNew.size().width()*scaleFactorL), values[1]);
+            painter.drawLine(values[0], 0, values[0], qRound(imageFrameSize().height()*scaleFactorL));
+            painter.drawLine(0, values[1], qRound(imageFrameSize().width()*scaleFactorL), values[1]);
 
             switch (markerTypeL) {
             case box:
@@ -329,8 +360,8 @@ void ImageWidget::paintEvent(QPaintEvent * event)
             switch (markerTypeL) {
             case box_crosshairs:
                 // vertical and horizontal
-                painter.drawLine(xnew, 0, xnew, qRound(imageNew.size().height()*scaleFactorL));
-                painter.drawLine(0, ynew, qRound(imageNew.size().width()*scaleFactorL), ynew);
+                painter.drawLine(xnew, 0, xnew, qRound(imageFrameSize().height()*scaleFactorL));
+                painter.drawLine(0, ynew, qRound(imageFrameSize().width()*scaleFactorL), ynew);
             case box:
                 selectionRect.setCoords(values[0], values[1], values[2], values[3]);
                 painter.drawRect(selectionRect);
@@ -377,8 +408,8 @@ void ImageWidget::paintEvent(QPaintEvent * event)
             switch (markerTypeL) {
             case box_crosshairs:
                 // vertical and horizontal
-                painter.drawLine(xnew, 0, xnew, qRound(imageNew.size().height()*scaleFactorL));
-                painter.drawLine(0, ynew, qRound(imageNew.size().width()*scaleFactorL), ynew);
+                painter.drawLine(xnew, 0, xnew, qRound(imageFrameSize().height()*scaleFactorL));
+                painter.drawLine(0, ynew, qRound(imageFrameSize().width()*scaleFactorL), ynew);
             case box:
                 if(width <= 1) break;
                 if((height) <= 1) break;
@@ -417,8 +448,8 @@ void ImageWidget::paintEvent(QPaintEvent * event)
             case box_crosshairs:
                 if(!present[0] || !present[1]) break;
                 // vertical and horizontal
-                painter.drawLine(values[0], 0, values[0], qRound(imageNew.size().height()*scaleFactorL));
-                painter.drawLine(0, values[1], qRound(imageNew.size().width()*scaleFactorL), values[1]);
+                painter.drawLine(values[0], 0, values[0], qRound(imageFrameSize().height()*scaleFactorL));
+                painter.drawLine(0, values[1], qRound(imageFrameSize().width()*scaleFactorL), values[1]);
             case box:
                 if(!present[0] || !present[1] || !present[2] || !present[3]) break;
                 if((values[0] - values[2]/2) <= 1) break;
@@ -473,8 +504,8 @@ void ImageWidget::rescaleReadValues(const bool &fitToSize, const QImage &image,
                                     bool readvaluesPresent[], double readvalues[],
                                     QVarLengthArray<double> X,  QVarLengthArray<double> Y)
 {
-    double factorX = (double) this->size().width() / (double) image.size().width();
-    double factorY = (double) this->size().height() /(double) image.size().height();
+    double factorX = (double) this->size().width() / (double) imageFrameSize(image).width();
+    double factorY = (double) this->size().height() /(double) imageFrameSize(image).height();
     double factor = qMin(factorX, factorY);
     for(int i=0; i<4; i++) {
         readValuesPresentL[i] = readvaluesPresent[i];
@@ -522,8 +553,8 @@ void  ImageWidget::updateImage(bool FitToSize, const QImage &image, bool readval
     readTypeL = (ROI_type) readType;
     writeTypeL = (ROI_type) writeType;
     if(FitToSize) {
-        double factorX = (double) this->size().width() / (double) image.size().width();
-        double factorY = (double) this->size().height() /(double) image.size().height();
+        double factorX = (double) this->size().width() / (double) imageFrameSize(image).width();
+        double factorY = (double) this->size().height() /(double) imageFrameSize(image).height();
         scaleFactorL = qMin(factorX, factorY);
     } else {
         scaleFactorL = scaleFactor;
@@ -51,6 +51,8 @@ public:
     void rescaleSelectionBox(const double &scaleFactor);
     void updateSelectionBox(QPoint selectionPoints[], const bool &selectInProgress);
     void getImageDimensions(int &width, int &height);
+    // the next images hold only every binning'th pixel of a frame of frameSize in both directions
+    void setBinning(int binning, const QSize &frameSize);
     void updateDisconnected();
 
     // must match definitions in cacamera and cascan2d
@@ -69,6 +71,8 @@ private:
                            QVarLengthArray<double> X,  QVarLengthArray<double> Y);
 
     QPolygonF getHead( QPointF p1, QPointF p2, int arrowSize);
+    QSize imageFrameSize() const;
+    QSize imageFrameSize(const QImage &image) const;
     QImage imageNew;
     QPoint imageOffset;
     bool m_zoom;
@@ -91,6 +95,8 @@ private:
     ROI_type readTypeL;
     ROI_type writeTypeL;
     double selectionFirstFactor, scaleFactorL, imageFirstFactor;
+    int binningL;
+    QSize frameSizeL;
     bool firstSelection;
     bool firstImage;
     bool selectionInProgress;
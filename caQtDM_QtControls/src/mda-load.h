@@ -172,6 +172,7 @@ struct mda_header *mda_header_load( FILE *fptr);
 struct mda_scan *mda_scan_load( FILE *fptr);
 struct mda_scan *mda_subscan_load( FILE *fptr, int depth, int *indices, 
 				      int recursive);
+struct mda_scan *mda_scan_load_at( FILE *fptr, long offset, int recursive);
 struct mda_extra *mda_extra_load( FILE *fptr);
 
 
@@ -5,14 +5,28 @@
 * found in file mdaLICENSE that is included with this distribution. 
 \*************************************************************************/
 #include <stdlib.h>
+#include <QHash>
 #include "mda-load.h"
 #include "mdaReader.h"
 #include "qtdefinitions.h"
 
 #define PRINT(x)
 
-void mdaReaderThread(const char *dataFile, int y_cpy);
-struct mda_file *mdaData = NULL;
+#define NAMELEN 100
+#define MAXFILES 8
+
+// a scan file: its outer scan, read again for every new row, and the rows read so far in its sub_scans
+// rows are only read once, as soon as the outer scan counts them as complete
+typedef struct {
+	struct mda_scan *outerScan;
+	int rowsRead;
+	quint64 lastUse;
+} mdaScanFile;
+
+// every file shown by a caScan2D is kept on its own, so widgets showing different files do not throw away each other's rows
+// beyond MAXFILES the file used least recently is dropped
+static QHash<QString, mdaScanFile> scanFiles;
+static quint64 scanFileUse = 0;
 
 void mdaReader_RegisterPV(QString pvName) {
     Q_UNUSED(pvName); // not clean but not well solvable with preprocessor
@@ -20,112 +34,167 @@ void mdaReader_RegisterPV(QString pvName) {
 	return;
 }
 
-int mdaReader_gimmeYerData(QString QS_dataFile, QString QS_pvName, float *data, int nx, int ny, int y_cpt) {
-	int i, j, index, detNum=0, ycpt, xcpt;
-	char pvName[60] = "";
-	struct mda_scan *thisScan = NULL;
+static void mdaReader_clear(mdaScanFile &file) {
+	if (file.outerScan) mda_scan_unload(file.outerScan);
+	file.outerScan = NULL;
+	file.rowsRead = 0;
+}
+
+// the state of dataFile, a new one when the file was not read before
+static mdaScanFile &mdaReader_file(const QString &dataFile) {
+	QHash<QString, mdaScanFile>::iterator it = scanFiles.find(dataFile);
+	if (it == scanFiles.end()) {
+		if (scanFiles.size() >= MAXFILES) {
+			QHash<QString, mdaScanFile>::iterator oldest = scanFiles.begin();
+			for (QHash<QString, mdaScanFile>::iterator f = scanFiles.begin(); f != scanFiles.end(); ++f) {
+				if (f.value().lastUse < oldest.value().lastUse) oldest = f;
+			}
+			mdaReader_clear(oldest.value());
+			scanFiles.erase(oldest);
+		}
+		mdaScanFile file;
+		file.outerScan = NULL;
+		file.rowsRead = 0;
+		it = scanFiles.insert(dataFile, file);
+	}
+	it.value().lastUse = ++scanFileUse;
+	return it.value();
+}
+
+static FILE *mdaReader_open(const char *dataFile) {
+	char fname[NAMELEN] = "";
+
+	if (strncmp(dataFile, "//", strlen("//")) == 0) {
+		// a vxWorks IOC has a filepath specification that's different from that of
+		// a linux soft ioc.  The form is "//server/dir1/dir2/file", and I assume
+		// a valid path to file is "/net/server/dir1/dir2/file".  I don't know how
+		// portable this is, but sysadmins here suggest it's common for an automounter.
+		// I'm out of my league here.
+        qstrncpy(fname, "/net",NAMELEN);
+        strncat(fname, dataFile,NAMELEN-5);
+	} else {
+        strncat(fname, dataFile,NAMELEN-1);
+	}
+	PRINT(printf("mdaReader_open: '%s'\n", fname));
+	return fopen(fname, "rb");
+}
+
+// Should have a thread to read the data file.  For now, just do it in the GUI thread.
+// reads the rows completed since the last call, returns -1 when nothing is known about the file
+static int mdaReader_update(mdaScanFile &file, const char *dataFile, int y_cpt) {
+	FILE *fp;
+	struct mda_scan *scan;
+	int last;
+
+	if (file.outerScan && (y_cpt <= file.rowsRead)) return(0);
+
+	fp = mdaReader_open(dataFile);
+	if (!fp) return(file.outerScan ? 0 : -1);
+
+	// the outer scan alone, its offsets tell where the rows are
+	scan = mda_subscan_load(fp, 0, NULL, 0);
+	if (!scan) {
+		fclose(fp);
+		return(file.outerScan ? 0 : -1);
+	}
+	if (file.outerScan && (file.outerScan->requested_points == scan->requested_points) && (file.outerScan->scan_rank == scan->scan_rank)) {
+		scan->sub_scans = file.outerScan->sub_scans;
+		file.outerScan->sub_scans = NULL;
+		mda_scan_unload(file.outerScan);
+	} else {
+		mdaReader_clear(file);
+	}
+	file.outerScan = scan;
+
+	if (file.outerScan->scan_rank > 1) {
+		if (file.outerScan->sub_scans == NULL) {
+			file.outerScan->sub_scans = (struct mda_scan **) calloc(file.outerScan->requested_points, sizeof(struct mda_scan *));
+		}
+		// last_point is the number of rows acquired, the ones before it do not change any more
+		last = qMin(file.outerScan->last_point, file.outerScan->requested_points);
+		for (; file.rowsRead < last; file.rowsRead++) {
+			file.outerScan->sub_scans[file.rowsRead] = mda_scan_load_at(fp, file.outerScan->offsets[file.rowsRead], 1);
+			// not readable yet, tried again with the next row
+			if (file.outerScan->sub_scans[file.rowsRead] == NULL) break;
+		}
+	}
+	fclose(fp);
+	PRINT(printf("mdaReader_update: %d rows of '%s'\n", file.rowsRead, dataFile));
+	return(0);
+}
+
+// copies the rows first up to the rows read of the file for the detector into data, returns the row after the last one copied
+// -1 and data cleared when the detector is not in the file
+static int mdaReader_copyRows(mdaScanFile &file, const char *pvName, float *data, int nx, int ny, int first) {
+	int i, j, index, detNum, xcpt, end;
+	struct mda_scan *thisScan;
 
-    strcpy(pvName, qasc(QS_pvName));
 	detNum = atol(&(pvName[strlen(pvName)-4]));
 	detNum--; // convert from pvName number 01..70 to array index 0..69
 	if (detNum < 0) {
-		PRINT(printf("mdaReader_gimmeYerData: '%s' not found in pv name\n", pvName));
+		PRINT(printf("mdaReader_copyRows: '%s' not found in pv name\n", pvName));
 		return(-1);
 	}
-	PRINT(printf("Somebody requested data for %s (detNum=%d), y_cpt=%d\n", pvName, detNum, y_cpt));
-	
-	// This should be a message to a reader thread.  For now, we just read the whole file.
-    mdaReaderThread(qasc(QS_dataFile), y_cpt);
-	if (!mdaData) {
+
+	PRINT(printf("top-level scan name %s\n", file.outerScan->name));
+	if (strncmp(file.outerScan->name, pvName, strlen(file.outerScan->name)) == 0) return(first);
+	if ((file.outerScan->scan_rank < 2) || (file.outerScan->sub_scans == NULL)) return(-1);
+	if (file.rowsRead == 0) return(first);
+
+	thisScan = file.outerScan->sub_scans[0]; // 2D data is one rank down in file
+	// Find detector index in file that corresponds to detNum
+	for (index=0; index < thisScan->number_detectors; index++) {
+		if (detNum == thisScan->detectors[index]->number) break;
+	}
+	if (index == thisScan->number_detectors) {
+		PRINT(printf("detNum %d does not occur in data file\n", detNum));
+		for (i=0; i<ny; i++) {
+			for (j=0; j<nx; j++) data[i*nx+j] = 0.;
+		}
 		return(-1);
 	}
 
-	PRINT(printf("top-level scan name %s\n", mdaData->scan->name));
-	if (strncmp(mdaData->scan->name, pvName, strlen(mdaData->scan->name))) {
-		if (mdaData->scan->scan_rank < 2) {
-			return(-1);
-		}
-		thisScan = mdaData->scan->sub_scans[0]; // 2D data is one rank down in file
-		// Find detector index in file that corresponds to detNum
-		for (index=0; index < thisScan->number_detectors; index++) {
-			if (detNum == thisScan->detectors[index]->number) break;
-		}
-		if (index == thisScan->number_detectors) {
-			PRINT(printf("detNum %d does not occur in data file\n", detNum));
-			for (i=0; i<ny; i++) {
-				for (j=0; j<nx; j++) data[i*nx+j] = 0.;
-			}
-			return(-1);
-		}
-		PRINT(printf("2D data from %s\n", mdaData->scan->sub_scans[0]->name));
-		// last_point is the number of data points acquired
-		ycpt = mdaData->scan->last_point;
-		if (mdaData->scan->sub_scans == NULL) {
-			PRINT(printf("Expected 2D data not found\n"));
-			return(-1);
-		}
-		for (i=0; i<ycpt; i++) {
-			thisScan = mdaData->scan->sub_scans[i];
-			if (thisScan == NULL) {
-				PRINT(printf("Expected 2D data (sub_scans[%d]) not found\n", i));
-				for (j=0; j<nx; j++) data[i*nx+j] = 0.;
-				continue;
-			}
-			xcpt = thisScan->last_point;
-			if (thisScan->detectors_data[index] == NULL) {
-				PRINT(printf("Expected 2D data (detectors_data[%d]) not found\n", index));
-				for (j=0; j<nx; j++) data[i*nx+j] = 0.;
-				continue;
-			}
-			for (j=0; j<xcpt; j++) {
-				data[i*nx+j] = thisScan->detectors_data[index][j];
-			}
-			for(; j<nx; j++) {
-				data[i*nx+j] = 0.;
-			}
-		}
-		for (; i<ny; i++) {
-			for (j=0; j<nx; j++) {
-				data[i*nx+j] = 0.;
-			}
+	end = qMin(file.rowsRead, ny);
+	for (i=first; i<end; i++) {
+		thisScan = file.outerScan->sub_scans[i];
+		j = 0;
+		if ((index < thisScan->number_detectors) && (thisScan->detectors_data[index] != NULL)) {
+			xcpt = qMin(thisScan->last_point, (int32_t) nx);
+			for (; j<xcpt; j++) data[i*nx+j] = thisScan->detectors_data[index][j];
+		} else {
+			PRINT(printf("Expected 2D data (detectors_data[%d]) not found\n", index));
 		}
+		for (; j<nx; j++) data[i*nx+j] = 0.;
 	}
-	
-	return(0);
-};
+	return(qMax(end, first));
+}
 
+int mdaReader_gimmeYerData(QString QS_dataFile, QString QS_pvName, float *data, int nx, int ny, int y_cpt) {
+	int i, j, end;
+	char pvName[60] = "";
 
-// Should have a thread to read the data file.  For now, just do it in the GUI thread.
+    qstrncpy(pvName, qasc(QS_pvName), 60);
+	PRINT(printf("Somebody requested data for %s, y_cpt=%d\n", pvName, y_cpt));
 
-#define NAMELEN 100
-void mdaReaderThread(const char *dataFile, int y_cpt) {
-	FILE *fp;
-	static char saved_dataFile[NAMELEN] = "";
-	static int saved_ycpt = 0;
-    char fname[NAMELEN] = "";
+	mdaScanFile &file = mdaReader_file(QS_dataFile);
+	if (mdaReader_update(file, qasc(QS_dataFile), y_cpt) < 0) return(-1);
 
-	if ((strncmp(dataFile, saved_dataFile, NAMELEN) == 0) && (y_cpt <= saved_ycpt)) {
-		return;
+	end = mdaReader_copyRows(file, pvName, data, nx, ny, 0);
+	if (end < 0) return(-1);
+	if (end == 0 && strncmp(file.outerScan->name, pvName, strlen(file.outerScan->name)) == 0) return(0);
+	for (i=end; i<ny; i++) {
+		for (j=0; j<nx; j++) data[i*nx+j] = 0.;
 	}
+	return(0);
+}
 
-    qstrncpy(saved_dataFile, dataFile, NAMELEN);
-	saved_ycpt = y_cpt;
+int mdaReader_gimmeNewRows(QString QS_dataFile, QString QS_pvName, float *data, int nx, int ny, int y_cpt, int firstRow) {
+	char pvName[60] = "";
 
-	// for now, because mda_load doesn't know how to add to data structure
-	if (mdaData) mda_unload(mdaData);
+    qstrncpy(pvName, qasc(QS_pvName), 60);
+	PRINT(printf("Somebody requested rows from %d for %s, y_cpt=%d\n", firstRow, pvName, y_cpt));
 
-	if (strncmp(dataFile, "//", strlen("//")) == 0) {
-		// a vxWorks IOC has a filepath specification that's different from that of
-		// a linux soft ioc.  The form is "//server/dir1/dir2/file", and I assume
-		// a valid path to file is "/net/server/dir1/dir2/file".  I don't know how
-		// portable this is, but sysadmins here suggest it's common for an automounter.
-		// I'm out of my league here.
-        qstrncpy(fname, "/net",NAMELEN);
-        strncat(fname, dataFile,NAMELEN-1);
-	} else {
-        strncat(fname, dataFile,NAMELEN-1);
-	}
-	fp = fopen(fname, "rb");
-	if (fp) mdaData = mda_load(fp);
-	PRINT(printf("mdaReaderThread: read '%s'\n", fname));
+	mdaScanFile &file = mdaReader_file(QS_dataFile);
+	if (mdaReader_update(file, qasc(QS_dataFile), y_cpt) < 0) return(-1);
+	return(mdaReader_copyRows(file, pvName, data, nx, ny, firstRow));
 }
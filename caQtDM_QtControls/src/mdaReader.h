@@ -5,4 +5,6 @@
 
 void mdaReader_RegisterPV(QString pvName);
 int mdaReader_gimmeYerData(QString QS_dataFile, QString QS_pvName, float *data, int nx, int ny, int y_cpt);
+// copies only the rows from firstRow on that were read from the file up to now, returns the row after them or -1
+int mdaReader_gimmeNewRows(QString QS_dataFile, QString QS_pvName, float *data, int nx, int ny, int y_cpt, int firstRow);
 #endif
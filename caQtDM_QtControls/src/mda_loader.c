@@ -641,6 +641,37 @@ struct mda_scan *mda_subscan_load( FILE *fptr, int depth, int *indices,
 }
 
 
+/* loads the scan starting at offset, as found in the offsets of the scan
+   above it; lets a reader load the rows of a running scan one by one */
+struct mda_scan *mda_scan_load_at( FILE *fptr, long offset, int recursive)
+{
+  struct mda_scan *scan;
+
+#ifndef XDR_HACK
+  XDR xdrs;
+#endif
+  XDR *xdrstream;
+
+#ifdef XDR_HACK
+  xdrstream = fptr;
+#else
+  xdrstream = &xdrs;
+  xdrstdio_create(xdrstream, fptr, XDR_DECODE);
+#endif
+
+  if( (offset <= 0) || !xdr_setpos( xdrstream, offset))
+    scan = NULL;
+  else
+    scan = scan_read( xdrstream, recursive);
+
+#ifndef XDR_HACK
+  xdr_destroy( xdrstream);
+#endif
+
+  return scan;
+}
+
+
 // logic here is screwy, as a NULL return could mean there are no extra PV's
 struct mda_extra *mda_extra_load( FILE *fptr)
 {
@@ -0,0 +1,275 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+
+#if defined(_MSC_VER)
+#define NOMINMAX
+#include <windows.h>
+#define QWT_DLL
+#endif
+
+#include "qwtplotcurvedecimated.h"
+#include <qwt_symbol.h>
+#include <qnumeric.h>
+#include <cmath>
+
+CartesianSeriesData::CartesianSeriesData(const double *x, const double *y, int size) :
+    X(x), Y(y), Size(qMax(size, 0)), Limits(false), BoundingRect(1.0, 1.0, -2.0, -2.0), Monotonic(-1), Decimated(false)
+{
+    NanX = NanY = qQNaN();
+    FloorX = FloorY = -qInf();
+    DecimatedS1 = DecimatedS2 = DecimatedP1 = DecimatedP2 = 0.0;
+}
+
+void CartesianSeriesData::setLimits(double nanX, double floorX, double nanY, double floorY)
+{
+    NanX = nanX;
+    FloorX = floorX;
+    NanY = nanY;
+    FloorY = floorY;
+    Limits = true;
+    BoundingRect = QRectF(1.0, 1.0, -2.0, -2.0);
+}
+
+size_t CartesianSeriesData::size() const
+{
+    if(Decimated) return (size_t) Points.size();
+    return (size_t) Size;
+}
+
+QPointF CartesianSeriesData::sample(size_t i) const
+{
+    if(Decimated) return Points.at((int) i);
+    return QPointF(x((int) i), y((int) i));
+}
+
+QRectF CartesianSeriesData::boundingRect() const
+{
+    // calculated once over all points, the data of this object never changes
+    if(BoundingRect.width() < 0.0) {
+        const bool decimated = Decimated;
+        Decimated = false;
+        BoundingRect = qwtBoundingRect(*this);
+        Decimated = decimated;
+    }
+    return BoundingRect;
+}
+
+bool CartesianSeriesData::isMonotonic() const
+{
+    if(Monotonic < 0) {
+        Monotonic = 1;
+        for(int i = 0; i < Size; i++) {
+            if(qIsNaN(x(i)) || (i > 0 && x(i) < x(i-1))) {
+                Monotonic = 0;
+                break;
+            }
+        }
+    }
+    return (Monotonic == 1);
+}
+
+// first point with x not smaller than the given value
+int CartesianSeriesData::lowerBound(double x) const
+{
+    int lo = 0;
+    int hi = Size;
+    while(lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if(this->x(mid) < x) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+// first point with x bigger than the given value
+int CartesianSeriesData::upperBound(double x) const
+{
+    int lo = 0;
+    int hi = Size;
+    while(lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if(this->x(mid) <= x) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+// the points of one column in their original order, each point only once
+void CartesianSeriesData::appendColumn(int iFirst, int iMin, int iMax, int iLast) const
+{
+    int idx[4] = {iFirst, qMin(iMin, iMax), qMax(iMin, iMax), iLast};
+    for(int k = 0; k < 4; k++) {
+        if(k > 0 && idx[k] == idx[k-1]) continue;
+        Points.append(QPointF(x(idx[k]), y(idx[k])));
+    }
+}
+
+bool CartesianSeriesData::decimate(const QwtScaleMap &xMap) const
+{
+    // the points are kept as long as the scale and the size of the canvas did not change
+    if(Decimated && xMap.s1() == DecimatedS1 && xMap.s2() == DecimatedS2 && xMap.p1() == DecimatedP1 && xMap.p2() == DecimatedP2) return true;
+    Decimated = false;
+
+    const double pMin = qMin(xMap.p1(), xMap.p2());
+    const int columns = (int) ceil(qAbs(xMap.p2() - xMap.p1())) + 1;
+    if(columns < 1 || Size <= 4 * columns || !isMonotonic()) return false;
+
+    // only the visible points and one neighbour on each side, these give the lines leaving the canvas
+    const int first = qMax(0, lowerBound(qMin(xMap.s1(), xMap.s2())) - 1);
+    const int last = qMin(Size - 1, upperBound(qMax(xMap.s1(), xMap.s2())));
+
+    Points.clear();
+    Points.reserve(4 * columns + 8);
+
+    bool open = false;
+    int column = 0;
+    int iFirst = 0, iLast = 0, iMin = 0, iMax = 0;
+    for(int i = first; i <= last; i++) {
+        // the neighbours outside of the canvas get their own column
+        const int c = qBound(-1, (int) floor(xMap.transform(x(i)) - pMin), columns);
+        if(open && c == column) {
+            const double value = y(i);
+            iLast = i;
+            if(qIsNaN(y(iMin)) || value < y(iMin)) iMin = i;
+            if(qIsNaN(y(iMax)) || value > y(iMax)) iMax = i;
+            continue;
+        }
+        if(open) appendColumn(iFirst, iMin, iMax, iLast);
+        column = c;
+        iFirst = iLast = iMin = iMax = i;
+        open = true;
+    }
+    if(open) appendColumn(iFirst, iMin, iMax, iLast);
+
+    if(Points.size() >= Size) {
+        Points.clear();
+        return false;
+    }
+
+    Decimated = true;
+    DecimatedS1 = xMap.s1();
+    DecimatedS2 = xMap.s2();
+    DecimatedP1 = xMap.p1();
+    DecimatedP2 = xMap.p2();
+    return true;
+}
+
+void CartesianSeriesData::undecimate() const
+{
+    Decimated = false;
+    Points.clear();
+}
+
+void CartesianRing::Extreme::push(qint64 sequence, double value)
+{
+    if(qIsNaN(value) || (Positive && value <= 0.0)) return;
+    while(!Candidates.empty() && (Minimum ? Candidates.back().second >= value : Candidates.back().second <= value)) Candidates.pop_back();
+    Candidates.push_back(std::make_pair(sequence, value));
+}
+
+double CartesianRing::Extreme::value() const
+{
+    if(Candidates.empty()) return qQNaN();
+    return Candidates.front().second;
+}
+
+CartesianRing::CartesianRing() :
+    MinX(true), MaxX(false), MinPositiveX(true, true), MinY(true), MaxY(false), MinPositiveY(true, true)
+{
+    Capacity = Head = Count = 0;
+    Sequence = 0;
+    NanCountX = NanCountY = 0;
+}
+
+void CartesianRing::clear()
+{
+    Head = Count = 0;
+    NanCountX = NanCountY = 0;
+    MinX.clear(); MaxX.clear(); MinPositiveX.clear();
+    MinY.clear(); MaxY.clear(); MinPositiveY.clear();
+}
+
+void CartesianRing::setCapacity(int capacity)
+{
+    capacity = qMax(capacity, 0);
+    if(capacity == Capacity) return;
+
+    const int keep = qMin(Count, capacity);
+    QVector<double> x(keep), y(keep);
+    for(int i = 0; i < keep; i++) {
+        x[i] = xData()[Count - keep + i];
+        y[i] = yData()[Count - keep + i];
+    }
+
+    Capacity = capacity;
+    Xs.fill(0.0, 2 * capacity);
+    Ys.fill(0.0, 2 * capacity);
+    clear();
+    for(int i = 0; i < keep; i++) append(x.at(i), y.at(i));
+}
+
+void CartesianRing::append(double x, double y)
+{
+    if(Capacity < 1) return;
+
+    // drop the oldest point
+    if(Count == Capacity) {
+        if(qIsNaN(Xs.at(Head))) NanCountX--;
+        if(qIsNaN(Ys.at(Head))) NanCountY--;
+        Head = (Head + 1) % Capacity;
+        Count--;
+    }
+
+    const int pos = (Head + Count) % Capacity;
+    Xs[pos] = Xs[pos + Capacity] = x;
+    Ys[pos] = Ys[pos + Capacity] = y;
+    if(qIsNaN(x)) NanCountX++;
+    if(qIsNaN(y)) NanCountY++;
+    Count++;
+
+    MinX.push(Sequence, x); MaxX.push(Sequence, x); MinPositiveX.push(Sequence, x);
+    MinY.push(Sequence, y); MaxY.push(Sequence, y); MinPositiveY.push(Sequence, y);
+    Sequence++;
+
+    const qint64 oldest = Sequence - Count;
+    MinX.expire(oldest); MaxX.expire(oldest); MinPositiveX.expire(oldest);
+    MinY.expire(oldest); MaxY.expire(oldest); MinPositiveY.expire(oldest);
+}
+
+QwtPlotCurveDecimated::QwtPlotCurveDecimated(const QString &title) : QwtPlotCurve(title)
+{
+    Decimation = false;
+}
+
+void QwtPlotCurveDecimated::drawSeries(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvRect, int from, int to) const
+{
+    const CartesianSeriesData *series = dynamic_cast<const CartesianSeriesData *>(data());
+    if(series == Q_NULLPTR) {
+        QwtPlotCurve::drawSeries(painter, xMap, yMap, canvRect, from, to);
+        return;
+    }
+
+    const bool lines = (style() == QwtPlotCurve::Lines) && (symbol() == Q_NULLPTR || symbol()->style() == QwtSymbol::NoSymbol);
+    if(Decimation && lines && from == 0 && to < 0 && series->decimate(xMap)) {
+        QwtPlotCurve::drawSeries(painter, xMap, yMap, canvRect, 0, -1);
+    } else {
+        series->undecimate();
+        QwtPlotCurve::drawSeries(painter, xMap, yMap, canvRect, from, to);
+    }
+}
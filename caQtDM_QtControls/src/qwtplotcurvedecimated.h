@@ -0,0 +1,167 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+
+#ifndef QWTPLOTCURVEDECIMATED_H
+#define QWTPLOTCURVEDECIMATED_H
+
+#include <qtcontrols_global.h>
+#include <qwt_plot_curve.h>
+#include <qwt_series_data.h>
+#include <qwt_scale_map.h>
+#include <QVector>
+#include <qnumeric.h>
+#include <deque>
+#include <utility>
+
+// series data for caCartesianPlot, uses the arrays of the plot without copying them, like setRawSamples
+// for x values in increasing order the points can be reduced to the first, last, minimum and maximum of every pixel column (M4),
+// the lines drawn from these points give the same picture as the lines through all points
+// the bounding rect is always the one of all points, so autoscaling does not depend on the decimation
+
+class QTCON_EXPORT CartesianSeriesData : public QwtSeriesData<QPointF>
+{
+
+public:
+
+    CartesianSeriesData(const double *x, const double *y, int size);
+    virtual size_t size() const;
+    virtual QPointF sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+
+    // values replacing NaN and lower limits applied when reading, like the auxiliary arrays used for the logarithmic scales
+    void setLimits(double nanX, double floorX, double nanY, double floorY);
+    // bounding rect already known by the caller, avoids looking at all points
+    void setBoundingRect(const QRectF &rect) {BoundingRect = rect;}
+
+    bool isMonotonic() const;
+    // serve the decimated points for the given map, returns false when decimating would not reduce the number of points
+    bool decimate(const QwtScaleMap &xMap) const;
+    void undecimate() const;
+
+private:
+
+    inline double x(int i) const {
+        double v = X[i];
+        if(Limits) {if(qIsNaN(v)) v = NanX; else if(v < FloorX) v = FloorX;}
+        return v;
+    }
+    inline double y(int i) const {
+        double v = Y[i];
+        if(Limits) {if(qIsNaN(v)) v = NanY; else if(v < FloorY) v = FloorY;}
+        return v;
+    }
+    int lowerBound(double x) const;
+    int upperBound(double x) const;
+    void appendColumn(int iFirst, int iMin, int iMax, int iLast) const;
+
+    const double *X;
+    const double *Y;
+    int Size;
+    bool Limits;
+    double NanX, FloorX, NanY, FloorY;
+    mutable QRectF BoundingRect;
+    mutable int Monotonic;   // -1 not yet checked
+
+    mutable bool Decimated;
+    mutable QVector<QPointF> Points;
+    mutable double DecimatedS1, DecimatedS2, DecimatedP1, DecimatedP2;
+};
+
+// points accumulated by caCartesianPlot, the oldest point is dropped when the ring is full
+// every point is stored twice, so that the points from the oldest to the newest are always contiguous in memory
+// and can be handed to CartesianSeriesData without copying; the extremes are kept up to date with every point
+
+class QTCON_EXPORT CartesianRing
+{
+
+public:
+
+    CartesianRing();
+
+    // a changed capacity keeps the newest points
+    void setCapacity(int capacity);
+    void clear();
+    void append(double x, double y);
+
+    int size() const {return Count;}
+    int capacity() const {return Capacity;}
+    const double *xData() const {return Xs.constData() + Head;}
+    const double *yData() const {return Ys.constData() + Head;}
+
+    // extremes of the points in the ring without NaN values, NaN when there is no such value
+    double minX() const {return MinX.value();}
+    double maxX() const {return MaxX.value();}
+    double minPositiveX() const {return MinPositiveX.value();}
+    double minY() const {return MinY.value();}
+    double maxY() const {return MaxY.value();}
+    double minPositiveY() const {return MinPositiveY.value();}
+    int nanCountX() const {return NanCountX;}
+    int nanCountY() const {return NanCountY;}
+
+private:
+
+    // minimum or maximum over the points in the ring, a candidate is dropped as soon as a newer point is at least as extreme
+    class Extreme
+    {
+    public:
+        Extreme(bool minimum = true, bool positive = false) : Minimum(minimum), Positive(positive) {}
+        void clear() {Candidates.clear();}
+        void push(qint64 sequence, double value);
+        void expire(qint64 oldest) {while(!Candidates.empty() && Candidates.front().first < oldest) Candidates.pop_front();}
+        double value() const;
+    private:
+        std::deque<std::pair<qint64, double> > Candidates;
+        bool Minimum;
+        bool Positive;
+    };
+
+    QVector<double> Xs;
+    QVector<double> Ys;
+    int Capacity;
+    int Head;
+    int Count;
+    qint64 Sequence;   // number of points appended, the oldest point in the ring has Sequence - Count
+    int NanCountX, NanCountY;
+    Extreme MinX, MaxX, MinPositiveX, MinY, MaxY, MinPositiveY;
+};
+
+// curve drawing the decimated points of its data when the decimation is enabled
+// only lines without symbols are decimated, dots and symbols need every point
+
+class QTCON_EXPORT QwtPlotCurveDecimated : public QwtPlotCurve
+{
+
+public:
+
+    QwtPlotCurveDecimated(const QString &title = Q_NULLPTR);
+    void setDecimation(bool decimate) {Decimation = decimate;}
+    bool decimation() const {return Decimation;}
+
+protected:
+
+    virtual void drawSeries(QPainter *painter, const QwtScaleMap &xMap, const QwtScaleMap &yMap, const QRectF &canvRect, int from, int to) const;
+
+private:
+
+    bool Decimation;
+};
+
+#endif // QWTPLOTCURVEDECIMATED_H
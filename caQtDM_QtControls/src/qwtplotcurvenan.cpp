@@ -30,14 +30,53 @@
 
 #include "qwtplotcurvenan.h"
 
-QwtPlotCurveNaN::QwtPlotCurveNaN(const QString& title)
+StripPlotSeriesData::StripPlotSeriesData(const StripPlotRing<QPointF> *ring, const double *offset) :
+    Ring(ring), Offset(offset)
+{
+}
+
+size_t StripPlotSeriesData::size() const
+{
+    return (size_t) Ring->size();
+}
+
+QPointF StripPlotSeriesData::sample(size_t i) const
+{
+    const QPointF &P = Ring->at((int) i);
+    return QPointF(P.x() - *Offset, P.y());
+}
+
+QRectF StripPlotSeriesData::boundingRect() const
+{
+    // the ring changes with every tick, so nothing is cached; qwt only asks for it when an axis is autoscaled by qwt itself
+    return qwtBoundingRect(*this);
+}
+
+StripPlotIntervalSeriesData::StripPlotIntervalSeriesData(const StripPlotRing<QwtIntervalSample> *ring, const double *offset) :
+    Ring(ring), Offset(offset)
 {
-    setTitle(title);
 }
 
-void QwtPlotCurveNaN::setSamplesList(const QVector<QPointF>& Samples)
+size_t StripPlotIntervalSeriesData::size() const
 {
-    samples = Samples;
+    return (size_t) Ring->size();
+}
+
+QwtIntervalSample StripPlotIntervalSeriesData::sample(size_t i) const
+{
+    const QwtIntervalSample &P = Ring->at((int) i);
+    return QwtIntervalSample(P.value - *Offset, P.interval);
+}
+
+QRectF StripPlotIntervalSeriesData::boundingRect() const
+{
+    return qwtBoundingRect(*this);
+}
+
+QwtPlotCurveNaN::QwtPlotCurveNaN(const QString& title)
+{
+    setTitle(title);
+    MinimumX = -qInf();
 }
 
 void QwtPlotCurveNaN::drawSeries(QPainter *painter, const QwtScaleMap &xMap,const QwtScaleMap &yMap, const QRectF &canvRect, int from, int to) const
@@ -46,19 +85,21 @@ void QwtPlotCurveNaN::drawSeries(QPainter *painter, const QwtScaleMap &xMap,cons
     Q_UNUSED(to);
 
     //int nbCount = 0;
-    if(samples.size() < 1) return;
-    QPointF Pstart = samples.at(0);
+    const int size = (int) dataSize();
+    if(size < 1) return;
+    QPointF Pstart = sample(0);
     QPointF P;
 
-    for (int counter = 1; counter < samples.size(); counter++)
+    for (int counter = 1; counter < size; counter++)
     {
-        P = samples.at(counter);
+        P = sample(counter);
 
         if(qIsNaN(P.y())) continue;  // continue = skip next instruction in loop
         if((CurvType == ValueCurv) && (P.x() < -Interval)) break;
         else if((CurvType == TimeCurv) && ((P.x() - Pstart.x()) < -Interval)) break;
 
         QwtPlotCurve::drawSeries(painter, xMap, yMap, canvRect, counter-1, counter);
+        if(P.x() < MinimumX) break;
 
         //nbCount++;
     }
@@ -74,11 +115,7 @@ void QwtPlotCurveNaN::setInterval(curvType type, double interval)
 QwtPlotIntervalCurveNaN::QwtPlotIntervalCurveNaN(const QString& title)
 {
     setTitle(title);
-}
-
-void QwtPlotIntervalCurveNaN::setSamplesList(const QVector<QwtIntervalSample> &Samples)
-{
-    samples = Samples;
+    MinimumX = -qInf();
 }
 
 
@@ -89,19 +126,21 @@ void QwtPlotIntervalCurveNaN::drawSeries(QPainter *painter, const QwtScaleMap &x
 
     //int nbCount = 0;
 
-    if(samples.size() < 1) return;
-    QwtIntervalSample Pstart = samples.at(0);
+    const int size = (int) dataSize();
+    if(size < 1) return;
+    QwtIntervalSample Pstart = sample(0);
     QwtIntervalSample P;
 
-    for (int counter = 1; counter < samples.size(); counter++)
+    for (int counter = 1; counter < size; counter++)
     {
-        P = samples.at(counter);
+        P = sample(counter);
 
         if(qIsNaN(P.interval.minValue()) || qIsNaN(P.interval.maxValue())) continue; // continue = skip next instruction in loop
         if((CurvType == ValueCurv) && (P.value < -Interval)) break;
         else if((CurvType == TimeCurv)  && ((P.value - Pstart.value) < -Interval)) break;
 
         QwtPlotIntervalCurve::drawSeries(painter, xMap, yMap, canvRect, counter-1, counter);
+        if(P.value < MinimumX) break;
 
         //nbCount++;
     }
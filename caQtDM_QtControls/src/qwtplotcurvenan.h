@@ -31,8 +31,142 @@ enum curvType {TimeCurv=0, ValueCurv};
 #include <qtcontrols_global.h>
 #include <qwt_plot_curve.h>
 #include <qwt_plot_intervalcurve.h>
+#include <qwt_series_data.h>
 #include <qnumeric.h>
+#include <QVector>
 #include <stdio.h>
+#include <deque>
+
+// fixed capacity circular buffer, index 0 is always the newest sample
+// advancing the head reuses the slot of the oldest sample, so nothing has to be moved in memory
+
+template <typename T>
+class StripPlotRing
+{
+
+public:
+
+    StripPlotRing() : head(0) {}
+
+    void reset(int capacity, const T &fill) {
+        samples.fill(fill, capacity);
+        head = 0;
+    }
+
+    int size() const { return samples.size(); }
+
+    // make room for a new sample at index 0, the oldest sample is dropped
+    void advance(const T &fill) {
+        if(samples.isEmpty()) return;
+        head = (head == 0) ? samples.size() - 1 : head - 1;
+        samples[head] = fill;
+    }
+
+    T &operator[](int i) { return samples[(head + i) % samples.size()]; }
+    const T &at(int i) const { return samples.at((head + i) % samples.size()); }
+
+private:
+
+    QVector<T> samples;
+    int head;
+};
+
+// sliding minimum and maximum over the newest samples of a ring, NaN values are skipped
+// every sample enters and leaves the window once, so an update costs O(1) amortized instead of a scan of the ring
+
+class StripPlotExtremes
+{
+
+public:
+
+    StripPlotExtremes() : Sequence(0) {}
+
+    void clear() {
+        Min.clear();
+        Max.clear();
+        Sequence = 0;
+    }
+
+    // a new sample was put at index 0 of the ring
+    void push(double min, double max) {
+        Sequence++;
+        if(!qIsNaN(min)) {
+            while(!Min.empty() && Min.back().value >= min) Min.pop_back();
+            Min.push_back(entry(Sequence, min));
+        }
+        if(!qIsNaN(max)) {
+            while(!Max.empty() && Max.back().value <= max) Max.pop_back();
+            Max.push_back(entry(Sequence, max));
+        }
+    }
+
+    // only the newest count samples are part of the window
+    void limit(int count) {
+        const qint64 oldest = Sequence - count + 1;
+        while(!Min.empty() && Min.front().sequence < oldest) Min.pop_front();
+        while(!Max.empty() && Max.front().sequence < oldest) Max.pop_front();
+    }
+
+    // after the ring was rewritten as a whole
+    template <typename Ring>
+    void rebuild(const Ring &ring, int count) {
+        clear();
+        for(int j = qMin(count, ring.size()) - 1; j >= 0; j--) {
+            push(ring.at(j).interval.minValue(), ring.at(j).interval.maxValue());
+        }
+    }
+
+    bool isEmpty() const { return Min.empty() || Max.empty(); }
+    double minimum() const { return Min.front().value; }
+    double maximum() const { return Max.front().value; }
+
+private:
+
+    struct entry {
+        entry(qint64 s, double v) : sequence(s), value(v) {}
+        qint64 sequence;
+        double value;
+    };
+
+    std::deque<entry> Min, Max;
+    qint64 Sequence;
+};
+
+// series data handed to qwt, reads the ring of the plot in place, so advancing the ring never copies it
+// the x offset is subtracted on read, so that stored time stamps never have to be rewritten
+// ring and offset belong to the plot and are only changed with the plot mutex held, which the plot also holds while painting
+
+class QTCON_EXPORT StripPlotSeriesData : public QwtSeriesData<QPointF>
+{
+
+public:
+
+    StripPlotSeriesData(const StripPlotRing<QPointF> *ring, const double *offset);
+    virtual size_t size() const;
+    virtual QPointF sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+
+private:
+
+    const StripPlotRing<QPointF> *Ring;
+    const double *Offset;
+};
+
+class QTCON_EXPORT StripPlotIntervalSeriesData : public QwtSeriesData<QwtIntervalSample>
+{
+
+public:
+
+    StripPlotIntervalSeriesData(const StripPlotRing<QwtIntervalSample> *ring, const double *offset);
+    virtual size_t size() const;
+    virtual QwtIntervalSample sample(size_t i) const;
+    virtual QRectF boundingRect() const;
+
+private:
+
+    const StripPlotRing<QwtIntervalSample> *Ring;
+    const double *Offset;
+};
 
 // this class allows to skip NaN numbers when drawing curves
 
@@ -42,9 +176,10 @@ class QTCON_EXPORT  QwtPlotCurveNaN : public QwtPlotCurve
 public:
 
     QwtPlotCurveNaN(const QString &title = Q_NULLPTR );
-    void setSamplesList(const QVector<QPointF>& Samples);
     void getLimits(double &ymin, double &ymax);
     void setInterval(curvType type, double interval);
+    // stop drawing after the first segment left of this x value, used to redraw only the newest part of the curve
+    void setMinimumX(double x) {MinimumX = x;}
 
 protected:
 
@@ -52,8 +187,8 @@ protected:
 
 private:
 
-    QVector<QPointF> samples;
     double Interval;
+    double MinimumX;
     curvType CurvType;
 };
 
@@ -64,9 +199,10 @@ class QTCON_EXPORT  QwtPlotIntervalCurveNaN : public QwtPlotIntervalCurve
 public:
 
     QwtPlotIntervalCurveNaN(const QString &title = Q_NULLPTR );
-    void setSamplesList(const QVector<QwtIntervalSample>& Samples);
     void getLimits(double &ymin, double &ymax);
     void setInterval(curvType type, double interval);
+    // stop drawing after the first segment left of this x value, used to redraw only the newest part of the curve
+    void setMinimumX(double x) {MinimumX = x;}
 
 protected:
 
@@ -74,8 +210,8 @@ protected:
 
 private:
 
-    QVector<QwtIntervalSample> samples;
     double Interval;
+    double MinimumX;
     curvType CurvType;
 };
 #endif // QWTPLOTCURVENAN_H
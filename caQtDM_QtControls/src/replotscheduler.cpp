@@ -0,0 +1,144 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+
+#include "replotscheduler.h"
+#include <QMetaObject>
+#include <QEvent>
+
+ReplotScheduler::ReplotScheduler() : QObject()
+{
+    Rate = REPLOT_DEFAULT_RATE;
+    QByteArray rate = qgetenv("CAQTDM_REPLOT_RATE");
+    if(!rate.isEmpty()) {
+        bool ok;
+        double value = rate.toDouble(&ok);
+        if(ok) Rate = qMax(0.0, value);
+    }
+
+    Timer.setSingleShot(true);
+    connect(&Timer, SIGNAL(timeout()), this, SLOT(replotDirty()));
+    LastFrame.start();
+}
+
+ReplotScheduler *ReplotScheduler::instance()
+{
+    static ReplotScheduler *scheduler = Q_NULLPTR;
+    if(scheduler == (ReplotScheduler *) Q_NULLPTR) scheduler = new ReplotScheduler();
+    return scheduler;
+}
+
+void ReplotScheduler::setRate(double rate)
+{
+    Rate = qMax(0.0, rate);
+}
+
+bool ReplotScheduler::schedule(QWidget *widget)
+{
+    if(Rate <= 0.0 || widget == (QWidget *) Q_NULLPTR) return false;
+
+    if(!Statistics.contains(widget)) {
+        replotStatistics empty = {0.0, 0.0, 0};
+        Statistics.insert(widget, empty);
+        connect(widget, SIGNAL(destroyed(QObject*)), this, SLOT(widgetDestroyed(QObject*)));
+        widget->installEventFilter(this);
+    }
+
+    // a hidden plot only remembers that it has to be replotted
+    if(Hidden.contains(widget)) return true;
+    if(!Dirty.contains(widget)) Dirty.append(widget);
+    startFrame();
+    return true;
+}
+
+// the next frame comes one period after the last one, at once when the plots were idle
+void ReplotScheduler::startFrame()
+{
+    if(Timer.isActive()) return;
+    const qint64 period = (qint64) (1000.0 / qMax(Rate, 1.0));
+    Timer.start((int) qMax((qint64) 0, period - LastFrame.elapsed()));
+}
+
+void ReplotScheduler::replotDirty()
+{
+    LastFrame.restart();
+
+    QList<QWidget *> widgets = Dirty;
+    Dirty.clear();
+
+    foreach(QWidget *widget, widgets) {
+        // a plot not on the screen waits for its show or paint event
+        if(!widget->isVisible() || widget->visibleRegion().isEmpty()) {
+            Hidden.append(widget);
+            continue;
+        }
+        QElapsedTimer elapsed;
+        elapsed.start();
+        QMetaObject::invokeMethod(widget, "scheduledReplot", Qt::DirectConnection);
+        const double time = (double) elapsed.nsecsElapsed() / 1.0e6;
+        replotStatistics &stat = Statistics[widget];
+        stat.totalTime += time;
+        stat.maxTime = qMax(stat.maxTime, time);
+        stat.count++;
+    }
+}
+
+// a plot put aside comes back with the next frame when it gets shown or a part of it gets exposed
+bool ReplotScheduler::eventFilter(QObject *obj, QEvent *event)
+{
+    if(event->type() == QEvent::Show || event->type() == QEvent::Paint) {
+        QWidget *widget = (QWidget *) obj;
+        if(Hidden.removeAll(widget) > 0) {
+            if(!Dirty.contains(widget)) Dirty.append(widget);
+            startFrame();
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
+
+void ReplotScheduler::widgetDestroyed(QObject *obj)
+{
+    Dirty.removeAll((QWidget *) obj);
+    Hidden.removeAll((QWidget *) obj);
+    Statistics.remove(obj);
+}
+
+QList<ReplotScheduler::replotTiming> ReplotScheduler::replotTimes()
+{
+    QList<replotTiming> times;
+    QHash<QObject *, replotStatistics>::iterator it;
+    for(it = Statistics.begin(); it != Statistics.end(); ++it) {
+        QWidget *widget = (QWidget *) it.key();
+        replotTiming timing;
+        timing.name = widget->objectName();
+        timing.className = widget->metaObject()->className();
+        timing.window = widget->window()->windowTitle();
+        timing.count = it.value().count;
+        timing.average = (it.value().count > 0) ? it.value().totalTime / (double) it.value().count : 0.0;
+        timing.maximum = it.value().maxTime;
+        timing.hidden = Hidden.contains(widget);
+        times.append(timing);
+
+        it.value().totalTime = 0.0;
+        it.value().maxTime = 0.0;
+        it.value().count = 0;
+    }
+    return times;
+}
@@ -0,0 +1,98 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+
+#ifndef REPLOTSCHEDULER_H
+#define REPLOTSCHEDULER_H
+
+#include <qtcontrols_global.h>
+#include <QObject>
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+// replots per second when nothing else is specified, the environment variable CAQTDM_REPLOT_RATE changes it, 0 replots at once
+#define REPLOT_DEFAULT_RATE 25
+
+// replots of the plot widgets, shared by all plots of the application
+// a plot with new data only marks itself dirty, all dirty plots are replotted together at most once per frame
+// by calling their slot scheduledReplot; plots not visible on the screen are put aside without keeping the timer
+// running and are scheduled again when they get shown or painted
+
+class QTCON_EXPORT ReplotScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    static ReplotScheduler *instance();
+
+    // returns false when scheduling is switched off, the caller has to replot itself
+    bool schedule(QWidget *widget);
+
+    double rate() const {return Rate;}
+    void setRate(double rate);
+
+    // replot times of one plot since the previous call of replotTimes
+    typedef struct {
+        QString name;
+        QString className;
+        QString window;     // title of the window showing the plot
+        int count;
+        double average;     // ms
+        double maximum;     // ms
+        bool hidden;
+    } replotTiming;
+
+    // replot times of every scheduled plot since the last call, the statistics are started again
+    QList<replotTiming> replotTimes();
+
+protected:
+
+    bool eventFilter(QObject *obj, QEvent *event);
+
+private slots:
+
+    void replotDirty();
+    void widgetDestroyed(QObject *obj);
+
+private:
+
+    ReplotScheduler();
+    void startFrame();
+
+    typedef struct {
+        double totalTime;   // ms
+        double maxTime;     // ms
+        int count;
+    } replotStatistics;
+
+    QTimer Timer;
+    QElapsedTimer LastFrame;
+    double Rate;
+    QList<QWidget *> Dirty;
+    QList<QWidget *> Hidden;
+    QHash<QObject *, replotStatistics> Statistics;
+};
+
+#endif // REPLOTSCHEDULER_H
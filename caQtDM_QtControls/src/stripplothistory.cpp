@@ -0,0 +1,206 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#include "stripplothistory.h"
+#include <qnumeric.h>
+#include <cmath>
+
+StripPlotHistory::StripPlotHistory()
+{
+    rawFirst = rawCount = 0;
+    rawDuration = HISTORY_RAW_SECONDS;
+    double width = HISTORY_BASE_WIDTH;
+    for(int l = 0; l < HISTORY_LEVELS; l++) {
+        widths[l] = width;
+        newest[l] = -1;
+        width *= HISTORY_LEVEL_FACTOR;
+    }
+}
+
+void StripPlotHistory::setRawDuration(double seconds)
+{
+    rawDuration = qMax(0.0, seconds);
+}
+
+void StripPlotHistory::clear()
+{
+    raw.clear();
+    rawFirst = rawCount = 0;
+    for(int l = 0; l < HISTORY_LEVELS; l++) {
+        buckets[l].clear();
+        newest[l] = -1;
+    }
+}
+
+void StripPlotHistory::append(double time, double value)
+{
+    if(qIsNaN(time) || qIsNaN(value)) return;
+
+    // raw samples in a ring, it grows up to its maximum size, from then on the oldest sample is overwritten
+    if(rawCount == raw.size()) {
+        if(raw.size() < HISTORY_RAW_MAXSAMPLES) {
+            const int size = qMin(qMax(1024, 2 * (int) raw.size()), HISTORY_RAW_MAXSAMPLES);
+            QVector<QPointF> grown;
+            grown.reserve(size);
+            for(int i = 0; i < rawCount; i++) grown.append(raw.at((rawFirst + i) % raw.size()));
+            grown.resize(size);
+            raw = grown;
+            rawFirst = 0;
+        } else {
+            rawFirst = (rawFirst + 1) % raw.size();
+            rawCount--;
+        }
+    }
+    raw[(rawFirst + rawCount) % raw.size()] = QPointF(time, value);
+    rawCount++;
+
+    // forget the raw samples that are older than the configured duration
+    while(rawCount > 1 && raw.at(rawFirst).x() < time - rawDuration) {
+        rawFirst = (rawFirst + 1) % raw.size();
+        rawCount--;
+    }
+
+    // update the bucket of every level, a bucket still holding an older time range is started again
+    for(int l = 0; l < HISTORY_LEVELS; l++) {
+        if(buckets[l].isEmpty()) {
+            bucket empty = {-1, 0.0, 0.0, 0.0};
+            buckets[l].fill(empty, HISTORY_BUCKETS);
+        }
+        const qint64 index = (qint64) floor(time / widths[l]);
+        bucket &b = buckets[l][(int) (index % HISTORY_BUCKETS)];
+        if(b.index != index) {
+            b.index = index;
+            b.min = b.max = value;
+        } else {
+            if(value < b.min) b.min = value;
+            if(value > b.max) b.max = value;
+        }
+        b.last = value;
+        if(index > newest[l]) newest[l] = index;
+    }
+}
+
+void StripPlotHistory::addToColumn(column &col, double min, double max, double last, double lastTime)
+{
+    if(qIsNaN(col.min) || min < col.min) col.min = min;
+    if(qIsNaN(col.max) || max > col.max) col.max = max;
+    if(lastTime >= col.lastTime) {
+        col.last = last;
+        col.lastTime = lastTime;
+    }
+}
+
+int StripPlotHistory::rawLowerBound(double time) const
+{
+    // samples are in time order, look for the first one not older than the given time
+    const int size = (int) raw.size();
+    int lo = 0;
+    int hi = rawCount;
+    while(lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if(raw.at((rawFirst + mid) % size).x() < time) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+void StripPlotHistory::rawEnvelope(double start, double end, double width, QVector<column> &columns) const
+{
+    const int size = (int) raw.size();
+    for(int i = rawLowerBound(start); i < rawCount; i++) {
+        const QPointF &P = raw.at((rawFirst + i) % size);
+        if(P.x() > end) break;
+        const int c = qBound(0, (int) floor((P.x() - start) / width), (int) columns.size() - 1);
+        addToColumn(columns[c], P.y(), P.y(), P.y(), P.x());
+    }
+}
+
+double StripPlotHistory::levelEnvelope(int level, double start, double end, double width, QVector<column> &columns) const
+{
+    const QVector<bucket> &levelBuckets = buckets[level];
+    if(levelBuckets.isEmpty()) return end;
+
+    const double w = widths[level];
+    const qint64 oldest = newest[level] - HISTORY_BUCKETS + 1;
+    const qint64 first = qMax(oldest, (qint64) floor(start / w));
+    const qint64 last = qMin(newest[level], (qint64) floor(end / w));
+
+    for(qint64 index = first; index <= last; index++) {
+        const bucket &b = levelBuckets.at((int) (index % HISTORY_BUCKETS));
+        if(b.index != index) continue;
+
+        // a bucket wider than a column goes into every column it overlaps
+        const int c0 = qMax(0, (int) floor(((double) index * w - start) / width));
+        const int c1 = qMin((int) columns.size() - 1, (int) ceil(((double) (index + 1) * w - start) / width) - 1);
+        for(int c = c0; c <= c1; c++) {
+            addToColumn(columns[c], b.min, b.max, b.last, (double) (index + 1) * w);
+        }
+    }
+
+    return qMax(start, (double) oldest * w);
+}
+
+bool StripPlotHistory::envelope(double start, double end, int columns, QVector<double> &minY, QVector<double> &maxY) const
+{
+    minY.fill(qQNaN(), qMax(columns, 0));
+    maxY.fill(qQNaN(), qMax(columns, 0));
+    if(columns < 1 || !(end > start)) return false;
+
+    const double width = (end - start) / (double) columns;
+    column empty = {qQNaN(), qQNaN(), qQNaN(), -1.0};
+    QVector<column> cols;
+    cols.fill(empty, columns);
+
+    // the raw samples are used when even the finest level is too coarse for the columns
+    double covered = end;
+    if(rawCount > 0 && width < widths[0]) {
+        rawEnvelope(start, end, width, cols);
+        covered = qMax(start, raw.at(rawFirst).x());
+    }
+
+    // the coarsest level not wider than a column, the older part of the range is taken from the coarser levels reaching back further
+    int level = 0;
+    while(level < HISTORY_LEVELS - 1 && widths[level + 1] <= width) level++;
+    for(; level < HISTORY_LEVELS && covered > start; level++) {
+        covered = qMin(covered, levelEnvelope(level, start, covered, width, cols));
+    }
+
+    // a column without samples holds the last value, like the running plot does between two updates
+    // the raw buffer always keeps the newest sample, so a channel that did not change for a long time still has a value
+    bool known = false;
+    double held = qQNaN();
+    const int before = rawLowerBound(start) - 1;
+    if(before >= 0) held = raw.at((rawFirst + before) % raw.size()).y();
+    for(int c = 0; c < columns; c++) {
+        column &col = cols[c];
+        if(!qIsNaN(col.min)) {
+            if(!qIsNaN(held)) {
+                col.min = qMin(col.min, held);
+                col.max = qMax(col.max, held);
+            }
+            held = col.last;
+        } else if(!qIsNaN(held)) {
+            col.min = col.max = held;
+        }
+        minY[c] = col.min;
+        maxY[c] = col.max;
+        if(!qIsNaN(col.min)) known = true;
+    }
+    return known;
+}
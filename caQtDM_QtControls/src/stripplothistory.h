@@ -0,0 +1,92 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+#ifndef STRIPPLOTHISTORY_H
+#define STRIPPLOTHISTORY_H
+
+#include <qtcontrols_global.h>
+#include <QVector>
+#include <QPointF>
+
+// default time in seconds for which the raw samples are kept, can be changed with the property rawHistoryDuration of caStripPlot
+#define HISTORY_RAW_SECONDS 600
+// upper limit for the raw samples of one curve, the buffer grows up to this size
+#define HISTORY_RAW_MAXSAMPLES 100000
+// min/max pyramid: number of levels, buckets per level, width of a bucket on the finest level and the factor between levels
+// with these values the coarsest level reaches back about ten days
+#define HISTORY_LEVELS 8
+#define HISTORY_BUCKETS 512
+#define HISTORY_BASE_WIDTH 0.1
+#define HISTORY_LEVEL_FACTOR 4
+
+// history of one strip plot curve, independent of the canvas width and of the period
+// the raw samples are kept for a limited time, older data is only known through the min/max pyramid
+// appending a sample costs the same for any history, the memory used is bounded
+
+class QTCON_EXPORT StripPlotHistory
+{
+
+public:
+
+    StripPlotHistory();
+
+    void setRawDuration(double seconds);
+    void clear();
+
+    // time in seconds since epoch
+    void append(double time, double value);
+
+    // fills minY and maxY with the envelope of the given time range divided in columns, the oldest column first
+    // a column without any sample gets the value held from the column before, columns before the first known value are NaN
+    // returns false if nothing is known about the range
+    bool envelope(double start, double end, int columns, QVector<double> &minY, QVector<double> &maxY) const;
+
+private:
+
+    typedef struct {
+        qint64 index;   // number of the bucket since epoch, identifies buckets overwritten by newer ones
+        double min;
+        double max;
+        double last;
+    } bucket;
+
+    typedef struct {
+        double min;
+        double max;
+        double last;
+        double lastTime;
+    } column;
+
+    static void addToColumn(column &col, double min, double max, double last, double lastTime);
+    int rawLowerBound(double time) const;
+    void rawEnvelope(double start, double end, double width, QVector<column> &columns) const;
+    double levelEnvelope(int level, double start, double end, double width, QVector<column> &columns) const;
+
+    QVector<QPointF> raw;   // x = time, y = value
+    int rawFirst;
+    int rawCount;
+    double rawDuration;
+
+    QVector<bucket> buckets[HISTORY_LEVELS];
+    qint64 newest[HISTORY_LEVELS];
+    double widths[HISTORY_LEVELS];
+};
+
+#endif // STRIPPLOTHISTORY_H
@@ -0,0 +1,202 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+// micro benchmark of the decoding of archiveHTTP responses, the binary transfer format against json; every case is timed
+// as the best of some repeats. Without a file the same points are generated in both formats and the decoded vectors are
+// compared. A recorded response body (uncompressed, json or binary) given as file is decoded in its own format.
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QVector>
+#include <QtEndian>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <climits>
+#include "httpretrieval.h"
+
+static int Points = 200000;
+static int Repeats = 10;
+
+#define BEST_OF(result, statement) { \
+    result = 1.0e30; \
+    for(int r = 0; r < Repeats; r++) { \
+        QElapsedTimer timer; \
+        timer.start(); \
+        statement; \
+        const double ms = (double) timer.nsecsElapsed() / 1.0e6; \
+        if(ms < result) result = ms; \
+    } \
+}
+
+// the same pseudo random data for every run
+static quint32 Seed = 12345;
+static quint32 nextRandom()
+{
+    Seed = Seed * 1664525u + 1013904223u;
+    return Seed;
+}
+
+typedef struct {
+    QVector<double> x, y, minY, maxY;
+    QDateTime continueAt;
+    QString error;
+    int count;
+} decoded;
+
+static void decode(const QByteArray &data, bool binary, double seconds, int secondsPast, bool binned, decoded &result)
+{
+    result.x.clear();
+    result.y.clear();
+    result.minY.clear();
+    result.maxY.clear();
+    if(binary) {
+        result.count = HttpRetrieval::decodeBinaryResponse(data, seconds, secondsPast, binned, false, result.x, result.y,
+                                                           result.minY, result.maxY, result.continueAt, result.error);
+    } else {
+        result.count = HttpRetrieval::decodeJsonResponse(data, seconds, secondsPast, binned, false, result.x, result.y,
+                                                         result.minY, result.maxY, result.continueAt, result.error);
+    }
+}
+
+static void appendColumn(QByteArray &json, const char *name, const QVector<double> &column, bool integer)
+{
+    json.append(",\"").append(name).append("\":[");
+    for(int k = 0; k < column.size(); k++) {
+        if(k > 0) json.append(',');
+        if(integer) json.append(QByteArray::number((qint64) column.at(k)));
+        else json.append(QByteArray::number(column.at(k), 'g', 17));
+    }
+    json.append(']');
+}
+
+// the timestamps are whole seconds, as the json decoding divides the integer milliseconds
+static void generate(int points, bool binned, qint64 anchor, QByteArray &json, QByteArray &binary)
+{
+    const int numberOfColumns = binned ? 5 : 2;
+    QVector<QVector<double> > columns(numberOfColumns);
+    for(int k = 0; k < points; k++) {
+        const double value = (double) (nextRandom() >> 8) / 1677.7216 - 5000.0;
+        if(binned) {
+            columns[0].append(k * 2000.0);
+            columns[1].append(k * 2000.0 + 2000.0);
+            columns[2].append(value - 1.5);
+            columns[3].append(value + 2.5);
+            columns[4].append(value);
+        } else {
+            columns[0].append(k * 1000.0);
+            columns[1].append(value);
+        }
+    }
+
+    json = "{\"tsAnchor\":" + QByteArray::number(anchor);
+    if(binned) {
+        appendColumn(json, "ts1Ms", columns[0], true);
+        appendColumn(json, "ts2Ms", columns[1], true);
+        appendColumn(json, "mins", columns[2], false);
+        appendColumn(json, "maxs", columns[3], false);
+        appendColumn(json, "avgs", columns[4], false);
+    } else {
+        appendColumn(json, "tsMs", columns[0], true);
+        appendColumn(json, "values", columns[1], false);
+    }
+    json.append('}');
+
+    binary.fill(0, HTTP_BINARY_HEADER_SIZE + numberOfColumns * points * (int) sizeof(double));
+    uchar *header = reinterpret_cast<uchar *>(binary.data());
+    memcpy(header, HTTP_BINARY_MAGIC, 4);
+    qToLittleEndian<quint32>(HTTP_BINARY_VERSION, header + 4);
+    qToLittleEndian<quint32>(binned ? HTTP_BINARY_FLAG_BINNED : 0, header + 8);
+    qToLittleEndian<quint32>(points, header + 12);
+    qToLittleEndian<qint64>(anchor, header + 16);
+    for(int c = 0; c < numberOfColumns; c++) {
+        memcpy(header + HTTP_BINARY_HEADER_SIZE + c * points * sizeof(double), columns.at(c).constData(), points * sizeof(double));
+    }
+}
+
+static void benchGenerated(bool binned)
+{
+    const qint64 anchor = 1700000000;
+    // requested are the newest 90 percent, so the leading points are skipped
+    const int span = binned ? 2 * Points : Points;
+    const double seconds = anchor + span;
+    const int secondsPast = span - span / 10;
+
+    QByteArray json, binary;
+    generate(Points, binned, anchor, json, binary);
+
+    decoded fromJson, fromBinary;
+    double jsonMs, binaryMs;
+    BEST_OF(jsonMs, decode(json, false, seconds, secondsPast, binned, fromJson));
+    BEST_OF(binaryMs, decode(binary, true, seconds, secondsPast, binned, fromBinary));
+
+    const bool same = fromJson.count == fromBinary.count && fromJson.x == fromBinary.x && fromJson.y == fromBinary.y
+                      && fromJson.minY == fromBinary.minY && fromJson.maxY == fromBinary.maxY;
+    printf("%-6s %8d points   json %7.1f MB %9.2f ms   binary %7.1f MB %8.2f ms   %6.1fx   %s\n", binned ? "binned" : "raw",
+           Points, json.size() / 1.0e6, jsonMs, binary.size() / 1.0e6, binaryMs, jsonMs / binaryMs,
+           same ? "same result" : "DIFFERENT RESULT");
+    if(fromJson.count < 0) printf("         json: %s\n", qPrintable(fromJson.error));
+    if(fromBinary.count < 0) printf("         binary: %s\n", qPrintable(fromBinary.error));
+}
+
+static int benchRecorded(const char *fileName, bool binned)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        printf("can not open %s\n", fileName);
+        return 1;
+    }
+    const QByteArray data = file.readAll();
+    const bool binary = data.startsWith(HTTP_BINARY_MAGIC);
+
+    // everything since the epoch is requested, so no point is skipped
+    const double seconds = (double) QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    const int secondsPast = INT_MAX;
+    decoded result;
+    double ms;
+    BEST_OF(ms, decode(data, binary, seconds, secondsPast, binned, result));
+    if(result.count < 0) {
+        printf("%s: %s\n", fileName, qPrintable(result.error));
+        return 1;
+    }
+    printf("%s   %s %s %.1f MB   %d points   %.2f ms\n", fileName, binned ? "binned" : "raw", binary ? "binary" : "json",
+           data.size() / 1.0e6, result.count, ms);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc > 1 && QFile::exists(argv[1])) {
+        if(argc > 3) Repeats = qMax(1, atoi(argv[3]));
+        return benchRecorded(argv[1], argc > 2 && strcmp(argv[2], "binned") == 0);
+    }
+    if(argc > 2) {
+        // the json decoding adds the integer milliseconds of a bin in an int
+        Points = qBound(1, atoi(argv[1]), 500000);
+        Repeats = qMax(1, atoi(argv[2]));
+    }
+    printf("best of %d\n\n", Repeats);
+    benchGenerated(false);
+    benchGenerated(true);
+    return 0;
+}
@@ -0,0 +1,31 @@
+# micro benchmark of the archiveHTTP response decoding, binary transfer format against json, not part of all.pro
+# build with qmake and make in this directory, run ./archivebench [points repeats]
+# ./archivebench response [raw|binned [repeats]] times a recorded, uncompressed response body
+
+include(../../caQtDM_Viewer/qtdefs.pri)
+
+contains(QT_VER_MAJ, 5) {
+  QT += widgets
+  DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x000000
+}
+contains(QT_VER_MAJ, 6) {
+  QT += widgets
+}
+
+TEMPLATE = app
+CONFIG += console release
+CONFIG -= app_bundle
+QT += core gui network
+
+unix: LIBS += -lz
+
+INCLUDEPATH += ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveHTTP
+
+HEADERS += ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveHTTP/httpretrieval.h \
+    ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveHTTP/urlhandlerhttp.h
+
+SOURCES += archivebench.cpp \
+    ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveHTTP/httpretrieval.cpp \
+    ../../caQtDM_Lib/caQtDM_Plugins/archive/archiveHTTP/urlhandlerhttp.cpp
+
+TARGET = archivebench
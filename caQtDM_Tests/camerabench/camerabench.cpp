@@ -0,0 +1,657 @@
+/*
+ *  This file is part of the caQtDM Framework, developed at the Paul Scherrer Institut,
+ *  Villigen, Switzerland
+ *
+ *  The caQtDM Framework is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  The caQtDM Framework is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with the caQtDM Framework.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright (c) 2010 - 2024
+ */
+
+// micro benchmark of the caCamera pixel conversions and of the caWaterfallPlot colors, every case is timed as the best
+// of some repeats over one frame; the results are compared with the loops they replaced, so a wrong kernel shows up here too
+
+#include <QtGlobal>
+#include <QColor>
+#include <QVector>
+#include <QElapsedTimer>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <climits>
+#include "camerakernels.h"
+#include "colormaps.h"
+
+static int Width = 2048;
+static int Height = 2048;
+static int Repeats = 20;
+
+#define BEST_OF(result, statement) { \
+    result = 1.0e30; \
+    for(int r = 0; r < Repeats; r++) { \
+        QElapsedTimer timer; \
+        timer.start(); \
+        statement; \
+        const double ms = (double) timer.nsecsElapsed() / 1.0e6; \
+        if(ms < result) result = ms; \
+    } \
+}
+
+// the same pseudo random data for every run
+static quint32 Seed = 12345;
+static quint32 nextRandom()
+{
+    Seed = Seed * 1664525u + 1013904223u;
+    return Seed;
+}
+
+static int differences(const QVector<uint> &a, const QVector<uint> &b)
+{
+    int count = 0;
+    for(int k = 0; k < a.size(); k++) if(a.at(k) != b.at(k)) count++;
+    return count;
+}
+
+static void report(const char *type, const char *mode, double loop, double kernel, int differ, bool extremes)
+{
+    printf("%-8s %-9s loop %8.2f ms   kernel %8.2f ms   %5.1fx   %s\n", type, mode, loop, kernel, loop / kernel,
+           (differ == 0 && extremes) ? "same result" : "DIFFERENT RESULT");
+    if(differ != 0) printf("         %d pixels differ\n", differ);
+    if(!extremes) printf("         the extremes differ\n");
+}
+
+// ------------------------------------------------------------------------------------------------------------------
+// caCHAR, caSHORT, caLONG and caFLOAT mono against the loops of caCamera::calcImageMono before the kernels
+
+template <typename T> static void loopTable(const T *src, uint *dst, long count, const uint *table, uint Max[2], uint Min[2])
+{
+    for(long k = 0; k < count; k++) {
+        Max[(src[k] > Max[1])] = src[k];
+        Min[(src[k] < Min[1])] = src[k];
+        dst[k] = table[src[k]];
+    }
+}
+
+// only fed with values the old cast to uint and int could take
+template <typename T> static void loopScale(const T *src, uint *dst, long count, float correction, uint minvalue,
+                                            const uint *colormap, int colors, uint Max[2], uint Min[2])
+{
+    for(long k = 0; k < count; k++) {
+        Max[(src[k] > Max[1])] = src[k];
+        Min[(src[k] < Min[1])] = src[k];
+        if(colormap == (const uint *) Q_NULLPTR) {
+            int indx1 = src[k] * correction;
+            if(indx1 > 255) indx1 = 255;
+            dst[k] = qRgb(indx1, indx1, indx1);
+        } else {
+            int indx1 = (src[k] - minvalue) * correction;
+            if(indx1 < 0) indx1 = 0;
+            if(indx1 >= colors) indx1 = colors - 1;
+            dst[k] = colormap[indx1];
+        }
+    }
+}
+
+template <typename T> static void benchTable(const char *type, int bits)
+{
+    const long count = (long) Width * Height;
+    const int size = 1 << bits;
+    QVector<T> src(count);
+    QVector<uint> table(size), loopOut(count), kernelOut(count);
+    for(long k = 0; k < count; k++) src[k] = (T) (nextRandom() >> (32 - bits));
+    for(int v = 0; v < size; v++) table[v] = nextRandom() | 0xFF000000;
+
+    uint Max[2], Min[2], kMax = 0, kMin = 0;
+    double loop, kernel;
+    BEST_OF(loop, Max[1] = 0; Min[1] = UINT_MAX; loopTable(src.constData(), loopOut.data(), count, table.constData(), Max, Min));
+    BEST_OF(kernel, kMax = 0; kMin = UINT_MAX; CameraKernels::monoTable(src.constData(), kernelOut.data(), count, table.constData(), kMax, kMin));
+    report(type, "table", loop, kernel, differences(loopOut, kernelOut), kMax == Max[1] && kMin == Min[1]);
+}
+
+template <typename T> static void benchScale(const char *type, const QVector<T> &src, float range, uint minvalue, const QVector<uint> &colormap)
+{
+    const long count = src.size();
+    QVector<uint> loopOut(count), kernelOut(count);
+
+    for(int mode = 0; mode < 2; mode++) {
+        const uint *colors = (mode == 0) ? (const uint *) Q_NULLPTR : colormap.constData();
+        const float correction = (mode == 0) ? 255.0f / range : (float) (colormap.size() - 1) / (range - (float) minvalue);
+        uint Max[2], Min[2], kMax = 0, kMin = 0;
+        double loop, kernel;
+        BEST_OF(loop, Max[1] = 0; Min[1] = UINT_MAX;
+                loopScale(src.constData(), loopOut.data(), count, correction, minvalue, colors, colormap.size(), Max, Min));
+        BEST_OF(kernel, kMax = 0; kMin = UINT_MAX;
+                CameraKernels::monoScale(src.constData(), kernelOut.data(), count, correction, minvalue, colors, colormap.size(), kMax, kMin));
+        report(type, (mode == 0) ? "grey" : "colormap", loop, kernel, differences(loopOut, kernelOut), kMax == Max[1] && kMin == Min[1]);
+    }
+}
+
+// float values the old loop could not take, what the kernels do with them is given in camerakernels.h
+static void checkFloatSpecials(const QVector<uint> &colormap)
+{
+    const long count = 100003;
+    QVector<float> src(count);
+    for(long k = 0; k < count; k++) {
+        src[k] = ((float) nextRandom() / 4294967296.0f - 0.25f) * 1.0e10f;
+        if(k % 97 == 0) src[k] = qQNaN();
+        if(k % 101 == 0) src[k] = -qInf();
+    }
+    QVector<uint> out(count);
+    uint Max = 0, Min = UINT_MAX;
+    CameraKernels::monoScale(src.constData(), out.data(), count, 255.0f / 1.0e10f, 0, (const uint *) Q_NULLPTR, 0, Max, Min);
+    printf("caFLOAT  negative, NaN and infinite values: Max=%u Min=%u (expected %u and 0)\n", Max, Min, UINT_MAX);
+}
+
+// ------------------------------------------------------------------------------------------------------------------
+// value tables of caCamera for 8 and 16 bit mono data against the per pixel arithmetic of calcImageMono they replaced
+
+// the same as caCamera::updateValueTable
+static void buildValueTable(QVector<uint> &table, int size, uint minvalue, uint maxvalue, const uint *colormap, int colors)
+{
+    table.resize(size);
+    if(colormap == (const uint *) Q_NULLPTR) {
+        const float correction =  (float) 255 / (float) (maxvalue - minvalue);
+        for(int v = 0; v < size; v++) {
+            int indx1 = v * correction;
+            if(indx1 > 255) indx1 = 255;
+            table[v] = qRgb(indx1,indx1,indx1);
+        }
+    } else {
+        const float correction =  (float)(colors-1) / (float) (maxvalue - minvalue);
+        for(int v = 0; v < size; v++) {
+            int indx1 = ((uint) v < minvalue) ? 0 : (int) ((float) (v - (int) minvalue) * correction);
+            if(indx1 < 0) indx1 = 0;
+            if(indx1 >= colors) indx1 = colors - 1;
+            table[v] = colormap[indx1];
+        }
+    }
+}
+
+// the values stay between minvalue and maxvalue, below minvalue the unsigned difference of the old loop wraps
+template <typename T> static void benchValueTable(const char *type, int bits, int width, int height, const char *name, const uint *colormap, int colors)
+{
+    const long count = (long) width * height;
+    const uint minvalue = (1u << bits) / 16, maxvalue = (1u << bits) - minvalue;
+    QVector<T> src(count);
+    for(long k = 0; k < count; k++) src[k] = (T) (minvalue + nextRandom() % (maxvalue - minvalue + 1));
+    QVector<uint> table, pixelOut(count), tableOut(count);
+
+    const float correction = (colormap == (const uint *) Q_NULLPTR) ? 255.0f / (float) (maxvalue - minvalue) : (float) (colors - 1) / (float) (maxvalue - minvalue);
+    uint Max[2], Min[2], tMax[2], tMin[2];
+    double pixel, build, lookup;
+    BEST_OF(pixel, Max[1] = 0; Min[1] = UINT_MAX;
+            loopScale(src.constData(), pixelOut.data(), count, correction, minvalue, colormap, colors, Max, Min));
+    BEST_OF(build, table = QVector<uint>(); buildValueTable(table, 1 << bits, minvalue, maxvalue, colormap, colors));
+    BEST_OF(lookup, tMax[1] = 0; tMin[1] = UINT_MAX; loopTable(src.constData(), tableOut.data(), count, table.constData(), tMax, tMin));
+
+    const int differ = differences(pixelOut, tableOut);
+    printf("%-8s %4dx%-4d %-6s pixel %8.2f ms   table %6.3f ms + lookup %8.2f ms   %5.1fx   %s\n", type, width, height, name,
+           pixel, build, lookup, pixel / (build + lookup), (differ == 0 && Max[1] == tMax[1] && Min[1] == tMin[1]) ? "same result" : "DIFFERENT RESULT");
+    if(differ != 0) printf("         %d pixels differ\n", differ);
+}
+
+// ------------------------------------------------------------------------------------------------------------------
+// caWaterfallPlot rows colored through the table of colorMaps::colorTable against QwtColorMap::rgb for every value
+
+#define COLORTABLE 4096     // WATERFALL_COLORTABLE of cawaterfallplot.h
+
+static int channelDifference(QRgb a, QRgb b)
+{
+    return qMax(qAbs(qRed(a) - qRed(b)), qMax(qAbs(qGreen(a) - qGreen(b)), qAbs(qBlue(a) - qBlue(b))));
+}
+
+static void benchColorTable(const char *name, const QwtLinearColorMap &colormap, int width, int rows)
+{
+    const long count = (long) width * rows;
+    const QwtInterval range(-100.0, 900.0);
+    QVector<double> values(count);
+    for(long k = 0; k < count; k++) values[k] = range.minValue() + range.width() * ((double) nextRandom() / 4294967296.0);
+    QVector<QRgb> table, mapOut(count), tableOut(count);
+
+    double map, build, lookup;
+    BEST_OF(map, for(long k = 0; k < count; k++) mapOut[k] = colormap.rgb(range, values.at(k)));
+    BEST_OF(build, table = colorMaps::colorTable(&colormap, range, COLORTABLE));
+
+    // the same as WaterfallSpectrogram::colorizeRow
+    const double scale = (double) (COLORTABLE - 1) / range.width();
+    const int last = COLORTABLE - 1;
+    BEST_OF(lookup, for(long k = 0; k < count; k++) {
+                const double pos = (values.at(k) - range.minValue()) * scale;
+                tableOut[k] = table.at(pos <= 0.0 ? 0 : (pos >= last ? last : (int) (pos + 0.5)));
+            });
+
+    // the table holds the colors of 4096 values only, so a color may be off by a little
+    int largest = 0;
+    for(long k = 0; k < count; k++) largest = qMax(largest, channelDifference(mapOut.at(k), tableOut.at(k)));
+    printf("waterfall %4dx%-4d %-10s colormap %8.2f ms   table %6.3f ms + lookup %8.2f ms   %5.1fx   largest channel difference %d\n",
+           width, rows, name, map, build, lookup, map / (build + lookup), largest);
+}
+
+// ------------------------------------------------------------------------------------------------------------------
+// packed, bayer, yuv and rgb frames: the full frame functions caCamera had before the row kernels against the row path
+// of caCamera::CameraPackedConvert and CameraColorConvert, both on one thread and without binning
+
+// the former caCamera::buf_unpack_* functions
+static void buf_unpack_12bitpacked_msb(void* target, void* source, size_t destcount, size_t targetcount)
+{
+    size_t x1, x2;
+    unsigned char b0, b1, b2;
+    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 3, x2 = x2 + 2) {
+        b0 = ((char*) source) [x1];
+        b1 = ((char*) source) [x1 + 1];
+        b2 = ((char*) source) [x1 + 2];
+        ((unsigned short*) target) [x2] = (b1 & 0xf) + (b0 << 4);
+        ((unsigned short*) target) [x2 + 1] = ((b1 & 0xf0) >> 4) + (b2 << 4);
+        if (targetcount<x1+3) return;
+    }
+}
+
+static void buf_unpack_12bitpacked_lsb(void* target, void* source, size_t destcount, size_t targetcount)
+{
+    size_t x1, x2;
+    unsigned char b0, b1, b2;
+    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 3, x2 = x2 + 2) {
+        b0 = ((char*) source) [x1];
+        b1 = ((char*) source) [x1 + 1];
+        b2 = ((char*) source) [x1 + 2];
+        ((unsigned short*) target) [x2] = ((b1 & 0xf)<<8) + (b0);
+        ((unsigned short*) target) [x2 + 1] = ((b1 & 0xf0) >> 4) + (b2 << 4);
+        if (targetcount<x1+3) return;
+    }
+}
+
+static void buf_unpack_10bitpacked(void* target, void* source, size_t destcount, size_t targetcount)
+{
+    size_t x1, x2;
+    unsigned char b0, b1, b2;
+    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 3, x2 = x2 + 2) {
+        b0 = ((char*) source) [x1];
+        b1 = ((char*) source) [x1 + 1];
+        b2 = ((char*) source) [x1 + 2];
+        ((unsigned short*) target) [x2] = ((b1 & 0x30) >> 4 ) + (b0 << 2);
+        ((unsigned short*) target) [x2 + 1] = ((b1 & 0x03) ) + (b2  << 2);
+        if (targetcount<x1+3) return;
+    }
+}
+
+static void buf_unpack_10bitp(void* target, void* source, size_t destcount, size_t targetcount)
+{
+    size_t x1, x2;
+    unsigned char b0, b1, b2, b3, b4;
+    for (x1 = 0, x2 = 0; x2 < (destcount / 2); x1 = x1 + 5, x2 = x2 + 4) {
+        b0 = ((char*) source) [x1];
+        b1 = ((char*) source) [x1 + 1];
+        b2 = ((char*) source) [x1 + 2];
+        b3 = ((char*) source) [x1 + 3];
+        b4 = ((char*) source) [x1 + 4];
+        ((unsigned short*) target) [x2] = ((b1 & 0x03)) + (b0);
+        ((unsigned short*) target) [x2 + 1] = ((b1 & 0xFC)>>2) + ((b2 & 0x0F) << 6);
+        ((unsigned short*) target) [x2 + 2] = ((b2 & 0xF0)>>4) + ((b3 & 0x1F) << 4);
+        ((unsigned short*) target) [x2 + 3] = ((b3 & 0xC0)>>6) + (b4<<2);
+        if (targetcount<x1+5) return;
+    }
+}
+
+static void benchUnpack(const char *name, CameraKernels::packing format, int bytes, int values)
+{
+    const long count = ((long) Width * Height) & ~3L;
+    const long size = count / values * bytes;
+    QVector<uchar> src(size);
+    for(long k = 0; k < size; k++) src[k] = (uchar) (nextRandom() >> 24);
+    QVector<ushort> loopOut(count), kernelOut(count);
+    uchar *data = src.data();
+
+    double loop, kernel;
+    switch(format) {
+    case CameraKernels::packed12lsb: BEST_OF(loop, buf_unpack_12bitpacked_lsb(loopOut.data(), data, count * 2, size)); break;
+    case CameraKernels::packed12msb: BEST_OF(loop, buf_unpack_12bitpacked_msb(loopOut.data(), data, count * 2, size)); break;
+    case CameraKernels::packed10: BEST_OF(loop, buf_unpack_10bitpacked(loopOut.data(), data, count * 2, size)); break;
+    default: BEST_OF(loop, buf_unpack_10bitp(loopOut.data(), data, count * 2, size)); break;
+    }
+    long unpacked = 0;
+    BEST_OF(kernel, unpacked = CameraKernels::unpack(format, data, size, 0, count, kernelOut.data()));
+
+    int differ = (int) (count - unpacked);
+    for(long k = 0; k < unpacked; k++) if(loopOut.at(k) != kernelOut.at(k)) differ++;
+    printf("%-8s %-9s loop %8.2f ms   kernel %8.2f ms   %5.1fx   %s\n", name, "unpack", loop, kernel, loop / kernel,
+           differ == 0 ? "same result" : "DIFFERENT RESULT");
+    if(differ != 0) printf("         %d values differ\n", differ);
+}
+
+// the former caCamera::FilterBayer, writing 3 uint per pixel
+enum {BAYER_RGGB = 0, BAYER_GBRG, BAYER_GRBG, BAYER_BGGR};
+template <typename pureData> static void FilterBayer(const pureData *bayer, uint *rgb, int sx, int sy, int tile, int datasize)
+{
+    const int bayerStep = sx;
+    const int rgbStep = 3 * sx;
+    uchar *rgbStart=(uchar *)rgb;
+    const uchar *bayerStart=(const uchar *)bayer;
+
+    int width = sx;
+    int height = sy;
+    int blue = tile == BAYER_BGGR || tile == BAYER_GBRG ? -1 : 1;
+    int start_with_green = tile == BAYER_GBRG|| tile == BAYER_GRBG;
+    int i, iinc, imax;
+
+    imax = sx * sy * 3;
+    for (i = sx * (sy - 1) * 3; i < imax; i++) {
+        rgb[i] = 0;
+    }
+    iinc = (sx - 1) * 3;
+    for (i = (sx - 1) * 3; i < imax; i += iinc) {
+        rgb[i++] = 0;
+        rgb[i++] = 0;
+        rgb[i++] = 0;
+    }
+
+    rgb += 1;
+    height -= 1;
+    width -= 1;
+    for (; height--; bayer += bayerStep, rgb += rgbStep) {
+        const pureData *bayerEnd = bayer + width;
+        if (((uchar *)(rgb+rgbStep)<((uchar *)rgbStart+3*sx*sy*sizeof(uint)))&&((const uchar *)(bayer+bayerStep)<((const uchar *)bayerStart+datasize))){
+            if (start_with_green) {
+                rgb[-blue] = bayer[1];
+                rgb[0] = bayer[bayerStep + 1];
+                rgb[blue] = bayer[bayerStep];
+                bayer++;
+                rgb += 3;
+            }
+
+            if (blue > 0) {
+                for (; bayer <= bayerEnd - 2; bayer += 2, rgb += 6) {
+                    rgb[-1] = bayer[0];
+                    rgb[0] = bayer[1];
+                    rgb[1] = bayer[bayerStep + 1];
+
+                    rgb[2] = bayer[2];
+                    rgb[3] = bayer[bayerStep + 2];
+                    rgb[4] = bayer[bayerStep + 1];
+                }
+            } else {
+                for (; bayer <= bayerEnd - 2; bayer += 2, rgb += 6) {
+                    rgb[1] = bayer[0];
+                    rgb[0] = bayer[1];
+                    rgb[-1] = bayer[bayerStep + 1];
+
+                    rgb[4] = bayer[2];
+                    rgb[3] = bayer[bayerStep + 2];
+                    rgb[2] = bayer[bayerStep + 1];
+                }
+            }
+
+            if (bayer < bayerEnd) {
+                rgb[-blue] = bayer[0];
+                rgb[0] = bayer[1];
+                rgb[blue] = bayer[bayerStep + 1];
+                bayer++;
+                rgb += 3;
+            }
+
+            bayer -= width;
+            rgb -= width * 3;
+
+            blue = -blue;
+            start_with_green = !start_with_green;
+        }
+    }
+}
+
+// the former caCamera::PROC_YUYV422 and PROC_RGB8 for COLOR_RGB
+#define GET_R_FROM_YUV(y,cb,cr) 298.082*y/256 +                      408.583 * cr / 256 - 222.291 ;
+#define GET_G_FROM_YUV(y,cb,cr) 298.082*y/256 - 100.291 * cb / 256 - 208.120 * cr / 256 + 135.576 ;
+#define GET_B_FROM_YUV(y,cb,cr) 298.082*y/256 + 561.412 * cb / 256                      - 276.836 ;
+
+static void PROC_YUYV422(const uchar *YUV, uint *rgb, int sx, int sy, int datasize)
+{
+    const uchar *max_data = YUV + datasize;
+    for (long i = 0; i < (long) sx * sy / 2; ++i) {
+        int Y1, Cr, Y2, Cb;
+        long r,g,b;
+        long min=0;
+        Y1 = YUV[0];
+        Cb = YUV[1];
+        Y2 = YUV[2];
+        Cr = YUV[3];
+        YUV += 4;
+
+        r=GET_R_FROM_YUV(Y1,Cb,Cr);
+        g=GET_G_FROM_YUV(Y1,Cb,Cr);
+        b=GET_B_FROM_YUV(Y1,Cb,Cr);
+        rgb[0]=qMax(min,r);
+        rgb[1]=qMax(min,g);
+        rgb[2]=qMax(min,b);
+        rgb += 3;
+
+        r=GET_R_FROM_YUV(Y2,Cb,Cr);
+        g=GET_G_FROM_YUV(Y2,Cb,Cr);
+        b=GET_B_FROM_YUV(Y2,Cb,Cr);
+        rgb[0]=qMax(min,r);
+        rgb[1]=qMax(min,g);
+        rgb[2]=qMax(min,b);
+        rgb += 3;
+        if (max_data < YUV) break;
+    }
+}
+
+static void PROC_RGB8(const uchar *RGB, uint *rgb, int sx, int sy, int datasize)
+{
+    const uchar *max_data = RGB + datasize;
+    for (long i = 0; i < (long) sx * sy ; ++i) {
+        rgb[0] = RGB[0];
+        rgb[1] = RGB[1];
+        rgb[2] = RGB[2];
+        RGB += 3;
+        rgb += 3;
+        if (max_data <= RGB) return;
+    }
+}
+
+// the rgb part of caCamera::calcImage for interleaved values
+static void rgbLoop(const uint *ptr, uint *dst, long count, float redcoeff, float greencoeff, float bluecoeff, uint Max[2], uint Min[2])
+{
+    for(long k = 0, i = 0; k < count; k++, i += 3) {
+        uint intensity = qMax(qMax(ptr[i], ptr[i+1]), ptr[i+2]);
+        dst[k] =  qRgb((int) (ptr[i] * redcoeff), (int) (ptr[i+1] * greencoeff), (int) (ptr[i+2] * bluecoeff));
+        Max[(intensity > Max[1])] = intensity;
+        Min[(intensity < Min[1])] = intensity;
+    }
+}
+
+// the same as caCamera::rawFrame and caCamera::bayerRow
+typedef struct {
+    const uchar *data;
+    long size;
+    bool bayer;
+    bool greenFirst;
+    bool redFirst;
+    int bits;
+    bool packed;
+    CameraKernels::packing packing;
+    CameraKernels::colorFormat format;
+} rawFrame;
+
+static bool bayerRow(const rawFrame &source, int row, int width, int x, int count, ushort *values)
+{
+    const long first = (long) row * width + x;
+    if(source.bits == 8) {
+        if(first + count > source.size) return false;
+        const uchar *data = source.data + first;
+        for(int k = 0; k < count; k++) values[k] = data[k];
+        return true;
+    } else if(!source.packed) {
+        if(2 * (first + count) > source.size) return false;
+        memcpy(values, source.data + 2 * first, count * sizeof(ushort));
+        return true;
+    }
+    return CameraKernels::unpack(source.packing, source.data, source.size, first, count, values) == count;
+}
+
+// the rows of caCamera::CameraColorConvert over the whole frame
+static void colorRows(const rawFrame &source, int width, int height, ushort *rows, uint *dst,
+                      float redcoeff, float greencoeff, float bluecoeff, uint &Max, uint &Min)
+{
+    ushort *red = rows;
+    ushort *green = red + width;
+    ushort *blue = green + width;
+    ushort *top = blue + width;
+    ushort *bottom = top + width;
+    int loaded = -1;
+
+    for (int y = 0; y < height; ++y) {
+        if(source.bayer) {
+            bool ok = (y + 1 < height);
+            if(ok) {
+                if(loaded == y) qSwap(top, bottom);
+                else ok = bayerRow(source, y, width, 0, width, top);
+                loaded = -1;
+                if(ok && bayerRow(source, y + 1, width, 0, width, bottom)) loaded = y + 1;
+                else ok = false;
+            }
+            if(ok) {
+                const bool odd = (y & 1) != 0;
+                const bool redTop = (source.redFirst != odd);
+                CameraKernels::demosaicRow(top, bottom, width, source.greenFirst != odd, redTop ? red : blue, green, redTop ? blue : red);
+            } else {
+                memset(red, 0, 3 * width * sizeof(ushort));
+            }
+        } else {
+            CameraKernels::colorRow(source.format, source.data, source.size, (long) y * width, width, red, green, blue);
+        }
+        CameraKernels::rgbPlanarScale(red, green, blue, dst + (long) y * width, width, redcoeff, greencoeff, bluecoeff, Max, Min);
+    }
+}
+
+enum frameKind {bayer8, bayer12, bayer12packed, yuyv422, rgb8};
+
+static void benchFrame(const char *name, frameKind kind)
+{
+    const long count = (long) Width * Height;
+    const int bits = (kind == bayer8 || kind == yuyv422 || kind == rgb8) ? 8 : 12;
+    long size;
+    if(kind == bayer8) size = count;
+    else if(kind == bayer12 || kind == yuyv422) size = 2 * count;
+    else if(kind == bayer12packed) size = count / 2 * 3;
+    else size = 3 * count;
+
+    QVector<uchar> src(size);
+    for(long k = 0; k < size; k++) src[k] = (uchar) (nextRandom() >> 24);
+    if(kind == bayer12) for(long k = 1; k < size; k += 2) src[k] &= 0x0F;     // 12 bit values in 16 bit
+    const uchar *data = src.constData();
+
+    rawFrame source;
+    source.data = data;
+    source.size = size;
+    source.bayer = (kind == bayer8 || kind == bayer12 || kind == bayer12packed);
+    source.greenFirst = false;
+    source.redFirst = true;
+    source.bits = bits;
+    source.packed = (kind == bayer12packed);
+    source.packing = CameraKernels::packed12lsb;
+    source.format = (kind == rgb8) ? CameraKernels::rgb8 : CameraKernels::yuyv422;
+
+    const float correction = 255.0f / (float) ((1 << bits) - 1);
+    QVector<uint> rgb(3 * count), loopOut(count), kernelOut(count);
+    QVector<ushort> rows(5 * Width);
+    uint Max[2], Min[2], kMax = 0, kMin = 0;
+
+    // the former path converted the frame into rgb first, the packed values were unpacked into a buffer of every frame
+    double loop, kernel;
+    BEST_OF(loop, Max[1] = 0; Min[1] = UINT_MAX;
+            switch(kind) {
+            case bayer8: FilterBayer(data, rgb.data(), Width, Height, BAYER_RGGB, size); break;
+            case bayer12: FilterBayer((const ushort *) data, rgb.data(), Width, Height, BAYER_RGGB, size); break;
+            case bayer12packed: {
+                const int unpacked_datasize = 2 * sizeof(ushort) * size + 1;
+                ushort *unpacked = (ushort *) malloc(unpacked_datasize);
+                buf_unpack_12bitpacked_lsb(unpacked, (void *) data, count * 2, size);
+                FilterBayer(unpacked, rgb.data(), Width, Height, BAYER_RGGB, unpacked_datasize);
+                free(unpacked);
+            }
+                break;
+            case yuyv422: PROC_YUYV422(data, rgb.data(), Width, Height, size); break;
+            case rgb8: PROC_RGB8(data, rgb.data(), Width, Height, size); break;
+            }
+            rgbLoop(rgb.constData(), loopOut.data(), count, correction, correction, correction, Max, Min));
+    BEST_OF(kernel, kMax = 0; kMin = UINT_MAX;
+            colorRows(source, Width, Height, rows.data(), kernelOut.data(), correction, correction, correction, kMax, kMin));
+    report(name, "frame", loop, kernel, differences(loopOut, kernelOut), kMax == Max[1] && kMin == Min[1]);
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc > 3) {
+        Width = qMax(1, atoi(argv[1]));
+        Height = qMax(1, atoi(argv[2]));
+        Repeats = qMax(1, atoi(argv[3]));
+    }
+    printf("frame %dx%d, best of %d, instruction set %s\n\n", Width, Height, Repeats, CameraKernels::instructionSet());
+
+    const long count = (long) Width * Height;
+    QVector<uint> colormap(256);
+    for(int k = 0; k < colormap.size(); k++) colormap[k] = nextRandom() | 0xFF000000;
+
+    benchTable<uchar>("caCHAR", 8);
+    benchTable<ushort>("caSHORT", 16);
+
+    QVector<uint> longs(count);
+    for(long k = 0; k < count; k++) longs[k] = nextRandom() >> 12;
+    // below minvalue the unsigned difference of the old loop wraps to values an int cannot take
+    benchScale<uint>("caLONG", longs, 1048576.0f, 0, colormap);
+
+    QVector<float> floats(count);
+    for(long k = 0; k < count; k++) floats[k] = (float) (nextRandom() >> 8) / 1677.7216f;
+    benchScale<float>("caFLOAT", floats, 10000.0f, 1000, colormap);
+
+    printf("\n");
+    checkFloatSpecials(colormap);
+
+    // the camera colormaps as caCamera gets them
+    colorMaps colormaps;
+    uint hot[256], jet[256];
+    colormaps.getColormap(colorMaps::spectrum_hot, false, QStringList(), 256, hot, (QwtScaleWidget *) Q_NULLPTR);
+    colormaps.getColormap(colorMaps::spectrum_jet, false, QStringList(), 256, jet, (QwtScaleWidget *) Q_NULLPTR);
+
+    const int sizes[3][2] = {{640, 480}, {1280, 1024}, {Width, Height}};
+    printf("\n");
+    for(int s = 0; s < 3; s++) {
+        benchValueTable<uchar>("caCHAR", 8, sizes[s][0], sizes[s][1], "grey", (const uint *) Q_NULLPTR, 256);
+        benchValueTable<uchar>("caCHAR", 8, sizes[s][0], sizes[s][1], "hot", hot, 256);
+        benchValueTable<ushort>("caSHORT", 16, sizes[s][0], sizes[s][1], "grey", (const uint *) Q_NULLPTR, 256);
+        benchValueTable<ushort>("caSHORT", 16, sizes[s][0], sizes[s][1], "jet", jet, 256);
+    }
+
+    printf("\n");
+    benchUnpack("mono12", CameraKernels::packed12lsb, 3, 2);
+    benchUnpack("mono12m", CameraKernels::packed12msb, 3, 2);
+    benchUnpack("mono10", CameraKernels::packed10, 3, 2);
+    benchUnpack("mono10p", CameraKernels::packed10p, 5, 4);
+    benchFrame("bayer8", bayer8);
+    benchFrame("bayer12", bayer12);
+    benchFrame("bayer12p", bayer12packed);
+    benchFrame("yuyv422", yuyv422);
+    benchFrame("rgb8", rgb8);
+
+    ColorMap_Grey grey;
+    ColorMap_Hot spectrumHot;
+    ColorMap_Jet spectrumJet;
+    ColorMap_Wavelength wavelength;
+    printf("\n");
+    for(int rows = 256; rows <= 1024; rows *= 4) {
+        benchColorTable("grey", grey, 1024, rows);
+        benchColorTable("hot", spectrumHot, 1024, rows);
+        benchColorTable("jet", spectrumJet, 1024, rows);
+        benchColorTable("wavelength", wavelength, 1024, rows);
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+# micro benchmark of the caCamera pixel conversions and caWaterfallPlot colors, not part of all.pro
+# build with qmake and make in this directory, run ./camerabench [width height repeats]
+# CAQTDM_CAMERA_NOSIMD=1 ./camerabench times the plain c++ loops of the kernels
+
+include(../../caQtDM_Viewer/qtdefs.pri)
+
+contains(QT_VER_MAJ, 5) {
+  QT += widgets
+  DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x000000
+}
+contains(QT_VER_MAJ, 6) {
+  QT += widgets
+}
+
+TEMPLATE = app
+CONFIG += console release qwt
+CONFIG -= app_bundle
+QT += core gui
+
+INCLUDEPATH += ../../caQtDM_QtControls/src
+
+SOURCES += camerabench.cpp \
+    ../../caQtDM_QtControls/src/camerakernels.cpp \
+    ../../caQtDM_QtControls/src/colormaps.cpp
+
+TARGET = camerabench
@@ -48,12 +48,14 @@ bool HTTPCONFIGURATOR = false;
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <algorithm>
 
 #include <QFileDialog>
 #include <QString>
 #include "messagebox.h"
 #include "configDialog.h"
 #include "caQtDM_Lib_global.h"
+#include "replotscheduler.h"
 
 #ifdef linux
 #include <sys/resource.h>
@@ -286,6 +288,7 @@ FileOpenWindow::FileOpenWindow(QMainWindow* parent,  QString filename, QString m
     connect( this->ui.exitAction, SIGNAL( triggered() ), this, SLOT(Callback_ActionExit()) );
     connect( this->ui.reloadAction, SIGNAL( triggered() ), this, SLOT(Callback_ActionReload()) );
     connect( this->ui.unconnectedAction, SIGNAL( triggered() ), this, SLOT(Callback_ActionUnconnected()) );
+    connect( this->ui.plotTimingAction, SIGNAL( triggered() ), this, SLOT(Callback_ActionPlotTiming()) );
     connect( this->ui.timedAction, SIGNAL( triggered() ), this, SLOT(Callback_ActionTimed()) );
     connect( this->ui.directAction, SIGNAL( triggered() ), this, SLOT(Callback_ActionDirect()) );
     connect( this->ui.helpAction, SIGNAL( triggered() ), this, SLOT(Callback_ActionHelp()) );
@@ -415,6 +418,8 @@ FileOpenWindow::FileOpenWindow(QMainWindow* parent,  QString filename, QString m
 
     pvWindow = (QMainWindow*) Q_NULLPTR;
     pvTable = (QTableWidget*) Q_NULLPTR;
+    plotWindow = (QMainWindow*) Q_NULLPTR;
+    plotTable = (QTableWidget*) Q_NULLPTR;
 
 //************************************************************************************************************************************************
     if(HTTPCONFIGURATOR) {
@@ -819,6 +824,23 @@ void FileOpenWindow::timerEvent(QTimerEvent *event)
         } else {
             strcpy(msg, asc);
         }
+
+        // time spent replotting the slowest plot, all plots are listed in the plot timing window
+        QString slowPlot;
+        double slowTime = 0.0;
+        QList<ReplotScheduler::replotTiming> times = ReplotScheduler::instance()->replotTimes();
+        for(int i=0; i < times.count(); i++) {
+            if(times.at(i).count > 0 && times.at(i).average > slowTime) {
+                slowTime = times.at(i).average;
+                slowPlot = times.at(i).name.isEmpty() ? times.at(i).className : times.at(i).name;
+            }
+        }
+        if(plotWindow != (QMainWindow*) Q_NULLPTR && plotWindow->isVisible()) fillPlotTable(times);
+        if(slowTime > 0.0) {
+            char asc1[MAX_STRING_LENGTH];
+            snprintf(asc1, MAX_STRING_LENGTH, ", slowest plot=%s with %.1f ms", qasc(slowPlot), slowTime);
+            if(strlen(msg) + strlen(asc1) < MAX_STRING_LENGTH) strcat(msg, asc1);
+        }
         statusBar()->showMessage(msg);
     }
     QString filename_save=qgetenv("CAQTDM_SCREENSHOT_NAME");
@@ -1650,6 +1672,72 @@ void FileOpenWindow::Callback_PVwindowExit()
     pvWindow->hide();
 }
 
+/**
+ * slot for the plot timing window, refreshed every second by the timer
+ */
+void FileOpenWindow::Callback_ActionPlotTiming()
+{
+    if(plotWindow != (QMainWindow*) Q_NULLPTR) {
+        plotWindow->show();
+        return;
+    }
+    plotWindow = new QMainWindow();
+    plotWindow->setWindowTitle(QString::fromUtf8("plot timing"));
+    plotWindow->setWindowFlags(Qt::CustomizeWindowHint | Qt::WindowMinMaxButtonsHint | Qt::WindowCloseButtonHint);
+
+    QVBoxLayout *l = new QVBoxLayout();
+
+    plotWindow->resize(600, 250);
+
+    plotTable = new QTableWidget();
+    plotTable->setColumnCount(6);
+    plotTable->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
+    plotTable->setHorizontalHeaderLabels(QString("plot;class;window;replots/s;average ms;maximum ms").split(";"));
+    plotTable->setAlternatingRowColors(true);
+
+    QPushButton *pushbutton = new QPushButton("close");
+    connect(pushbutton, SIGNAL(clicked()), this, SLOT(Callback_PlotWindowExit()));
+
+    l->addWidget(plotTable);
+    l->addWidget(pushbutton);
+
+    QWidget* widg = new QWidget();
+    widg->setLayout(l);
+
+    plotWindow->setCentralWidget(widg);
+    plotWindow->show();
+}
+
+void FileOpenWindow::Callback_PlotWindowExit()
+{
+    plotWindow->hide();
+}
+
+static bool slowerReplot(const ReplotScheduler::replotTiming &a, const ReplotScheduler::replotTiming &b)
+{
+    return a.average > b.average;
+}
+
+// one row per plot with the replots of the last second, the slowest first; plots put aside while hidden are marked
+void FileOpenWindow::fillPlotTable(const QList<ReplotScheduler::replotTiming> &times)
+{
+    if(plotTable == (QTableWidget*) Q_NULLPTR) return;
+
+    QList<ReplotScheduler::replotTiming> sorted = times;
+    std::sort(sorted.begin(), sorted.end(), slowerReplot);
+
+    plotTable->setRowCount(sorted.count());
+    for(int i=0; i < sorted.count(); i++) {
+        const ReplotScheduler::replotTiming &timing = sorted.at(i);
+        plotTable->setItem(i, 0, new QTableWidgetItem(timing.name));
+        plotTable->setItem(i, 1, new QTableWidgetItem(timing.className));
+        plotTable->setItem(i, 2, new QTableWidgetItem(timing.window));
+        plotTable->setItem(i, 3, new QTableWidgetItem(timing.hidden ? QString("hidden") : QString::number(timing.count)));
+        plotTable->setItem(i, 4, new QTableWidgetItem(QString::number(timing.average, 'f', 2)));
+        plotTable->setItem(i, 5, new QTableWidgetItem(QString::number(timing.maximum, 'f', 2)));
+    }
+}
+
 void FileOpenWindow::fillPVtable(int &countPV, int &countNotConnected, int &countDisplayed)
 {
     int count = 0;
@@ -54,6 +54,7 @@
 #include "knobData.h"
 #include "mutexKnobData.h"
 #include "caqtdm_lib.h"
+#include "replotscheduler.h"
 #include "ui_main.h"
 #include <stdio.h>
 
@@ -105,6 +106,7 @@
      bool isRunning();
      bool sendMessage(const QString &message);
      void fillPVtable(int &countPV, int &countnotConnected, int &countDisplayed);
+     void fillPlotTable(const QList<ReplotScheduler::replotTiming> &times);
      int ReadInteger(char *string, char **NextString);
      int parseGeometry(const char* string, int* x, int* y, int* width, int* height);
      void parse_and_set_Geometry(QMainWindow *w, QString parsestring);
@@ -228,11 +230,13 @@
      void Callback_ActionHelp();
      void Callback_ActionReload();
      void Callback_ActionUnconnected();
+     void Callback_ActionPlotTiming();
      void Callback_EmptyCache();
      void Callback_OpenNewFile(const QString&, const QString&, const QString&, const QString&);
      void checkForMessage();
      void onReloadTimeout();
      void Callback_PVwindowExit();
+     void Callback_PlotWindowExit();
 
 #if QT_VERSION > 0x050000
      void onApplicationStateChange(Qt::ApplicationState state);
@@ -284,6 +288,8 @@ private:
 
      QMainWindow *pvWindow;
      QTableWidget* pvTable;
+     QMainWindow *plotWindow;
+     QTableWidget* plotTable;
      QTimer *timer;
 
      bool mustOpenFile;